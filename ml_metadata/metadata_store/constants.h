@@ -21,6 +21,9 @@ namespace ml_metadata {
 // any MetadataSource.
 static constexpr char kMetadataSourceNull[] = "__MLMD_NULL__";
 
+// The max number of resources returned by a List operation, i.e., in a page.
+static constexpr int kMaxListOperationResultSize = 100;
+
 // The node type_kind enum values used for internal storage. The enum value
 // should not be modified, in order to be backward compatible with stored types.
 // LINT.IfChange
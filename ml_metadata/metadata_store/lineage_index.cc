@@ -0,0 +1,392 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "ml_metadata/metadata_store/lineage_index.h"
+
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+namespace ml_metadata {
+namespace {
+
+// The min number of added edges which are compacted into the rows.
+constexpr int64 kMinEdgesToCompact = 1024;
+
+bool EdgeLess(const LineageIndex::Edge& a, const LineageIndex::Edge& b) {
+  return std::tie(a.artifact_id, a.execution_id, a.type, a.event_id) <
+         std::tie(b.artifact_id, b.execution_id, b.type, b.event_id);
+}
+
+bool EdgeEqual(const LineageIndex::Edge& a, const LineageIndex::Edge& b) {
+  return a.artifact_id == b.artifact_id && a.execution_id == b.execution_id &&
+         a.type == b.type && a.event_id == b.event_id;
+}
+
+// The artifacts or the executions of a traversal.
+struct TraversedNodes {
+  // The ids of the reached nodes.
+  absl::flat_hash_set<int64> ids;
+  // The ids of the nodes whose edges are followed.
+  absl::flat_hash_set<int64> expanded_ids;
+  // The ids of the nodes reached in the last hop, whose edges are followed in
+  // the next hop.
+  std::vector<int64> frontier;
+};
+
+// Returns the number of nodes reached by the `traversal`.
+int64 NumNodes(const LineageTraversal& traversal) {
+  return traversal.artifact_ids.size() + traversal.execution_ids.size();
+}
+
+// Follows the `edges` of a hop to their artifacts if `to_artifacts`, else to
+// their executions, which are in `nodes` and `node_ids`, until the limits of
+// the request are reached.
+void FollowEdges(const std::vector<LineageIndex::Edge>& edges,
+                 const bool to_artifacts, const GetLineageGraphRequest& request,
+                 TraversedNodes* nodes, std::vector<int64>* node_ids,
+                 std::vector<int64>* next_frontier,
+                 LineageTraversal* traversal) {
+  for (const LineageIndex::Edge& edge : edges) {
+    const int64 id = to_artifacts ? edge.artifact_id : edge.execution_id;
+    if (static_cast<int64>(traversal->events.size()) >=
+        request.max_num_events()) {
+      traversal->is_truncated = true;
+      break;
+    }
+    if (!nodes->ids.contains(id)) {
+      if (NumNodes(*traversal) >= request.max_num_nodes()) {
+        traversal->is_truncated = true;
+        continue;
+      }
+      nodes->ids.insert(id);
+      node_ids->push_back(id);
+      next_frontier->push_back(id);
+    }
+    Event event;
+    event.set_artifact_id(edge.artifact_id);
+    event.set_execution_id(edge.execution_id);
+    event.set_type(edge.type);
+    traversal->events.push_back(std::move(event));
+    traversal->event_ids.push_back(edge.event_id);
+  }
+}
+
+}  // namespace
+
+bool IsInputEventType(const Event::Type type) {
+  return type == Event::INPUT || type == Event::DECLARED_INPUT ||
+         type == Event::INTERNAL_INPUT;
+}
+
+bool IsOutputEventType(const Event::Type type) {
+  return type == Event::OUTPUT || type == Event::DECLARED_OUTPUT ||
+         type == Event::INTERNAL_OUTPUT;
+}
+
+bool IsFollowedFromArtifact(const Event::Type type,
+                            const GetLineageGraphRequest::Direction direction) {
+  switch (direction) {
+    case GetLineageGraphRequest::UPSTREAM:
+      return IsOutputEventType(type);
+    case GetLineageGraphRequest::DOWNSTREAM:
+      return IsInputEventType(type);
+    default:
+      return true;
+  }
+}
+
+bool IsFollowedFromExecution(
+    const Event::Type type, const GetLineageGraphRequest::Direction direction) {
+  switch (direction) {
+    case GetLineageGraphRequest::UPSTREAM:
+      return IsInputEventType(type);
+    case GetLineageGraphRequest::DOWNSTREAM:
+      return IsOutputEventType(type);
+    default:
+      return true;
+  }
+}
+
+LineageIndex::Edge LineageIndex::ToEdge(const int64 event_id,
+                                        const Event& event) {
+  return {event.artifact_id(), event.execution_id(), event.type(), event_id};
+}
+
+LineageIndex::LineageIndex() : rows_(std::make_shared<const Rows>()) {}
+
+void LineageIndex::Reset(std::vector<Edge> edges, const int64 max_event_id) {
+  absl::MutexLock compact_lock(&compact_mu_);
+  std::sort(edges.begin(), edges.end(), EdgeLess);
+  edges.erase(std::unique(edges.begin(), edges.end(), EdgeEqual), edges.end());
+  std::shared_ptr<const Rows> rows = BuildRows(edges);
+  absl::MutexLock lock(&mu_);
+  rows_.swap(rows);
+  compacting_ = nullptr;
+  added_ = AddedEdges();
+  max_event_id_ = max_event_id;
+}
+
+void LineageIndex::AddEdges(const std::vector<Edge>& edges) {
+  absl::MutexLock lock(&mu_);
+  for (const Edge& edge : edges) {
+    if (Contains(edge)) continue;
+    added_.event_ids.insert(edge.event_id);
+    added_.artifact_to_executions[edge.artifact_id].push_back(
+        {edge.execution_id, edge.type, edge.event_id});
+    added_.execution_to_artifacts[edge.execution_id].push_back(
+        {edge.artifact_id, edge.type, edge.event_id});
+  }
+}
+
+void LineageIndex::AddEvents(const std::vector<int64>& event_ids,
+                             const std::vector<Event>& events) {
+  std::vector<Edge> edges;
+  edges.reserve(events.size());
+  for (int64 i = 0; i < static_cast<int64>(events.size()); ++i) {
+    edges.push_back(ToEdge(event_ids[i], events[i]));
+  }
+  AddEdges(edges);
+}
+
+bool LineageIndex::NeedsCompaction() const {
+  absl::ReaderMutexLock lock(&mu_);
+  const int64 num_added_edges = added_.event_ids.size();
+  const int64 num_row_edges = rows_->artifact_to_executions.neighbors.size();
+  return num_added_edges >= kMinEdgesToCompact &&
+         num_added_edges * 8 >= num_row_edges;
+}
+
+void LineageIndex::Compact() {
+  absl::MutexLock compact_lock(&compact_mu_);
+  // Only Compact and Reset replace the rows, and the added edges taken here
+  // are not changed until the new rows are swapped in, so both are read
+  // without the lock.
+  std::shared_ptr<const Rows> rows;
+  std::shared_ptr<const AddedEdges> compacting;
+  {
+    absl::MutexLock lock(&mu_);
+    if (added_.event_ids.empty()) return;
+    rows = rows_;
+    compacting = std::make_shared<const AddedEdges>(std::move(added_));
+    added_ = AddedEdges();
+    compacting_ = compacting;
+  }
+  const Row& row = rows->artifact_to_executions;
+  std::vector<Edge> edges;
+  edges.reserve(row.neighbors.size() + compacting->event_ids.size());
+  const int64 num_offsets = row.offsets.size();
+  for (int64 id = 0; id + 1 < num_offsets; ++id) {
+    for (int64 i = row.offsets[id]; i < row.offsets[id + 1]; ++i) {
+      const Neighbor& execution = row.neighbors[i];
+      edges.push_back({id, execution.id, execution.type, execution.event_id});
+    }
+  }
+  for (const auto& artifact_and_executions :
+       compacting->artifact_to_executions) {
+    for (const Neighbor& execution : artifact_and_executions.second) {
+      edges.push_back({artifact_and_executions.first, execution.id,
+                       execution.type, execution.event_id});
+    }
+  }
+  std::sort(edges.begin(), edges.end(), EdgeLess);
+  std::shared_ptr<const Rows> compacted_rows = BuildRows(edges);
+  {
+    absl::MutexLock lock(&mu_);
+    rows_.swap(compacted_rows);
+    compacting_ = nullptr;
+  }
+  // The old rows and the compacted edges are freed here, without the lock.
+}
+
+int64 LineageIndex::max_event_id() const {
+  absl::ReaderMutexLock lock(&mu_);
+  return max_event_id_;
+}
+
+void LineageIndex::AdvanceMaxEventId(const int64 max_event_id) {
+  absl::MutexLock lock(&mu_);
+  max_event_id_ = std::max(max_event_id_, max_event_id);
+}
+
+int64 LineageIndex::num_edges() const {
+  absl::ReaderMutexLock lock(&mu_);
+  int64 num_edges =
+      rows_->artifact_to_executions.neighbors.size() + added_.event_ids.size();
+  if (compacting_ != nullptr) num_edges += compacting_->event_ids.size();
+  return num_edges;
+}
+
+bool LineageIndex::Contains(const Edge& edge) const {
+  const Row& row = rows_->artifact_to_executions;
+  const int64 num_offsets = row.offsets.size();
+  if (edge.artifact_id >= 0 && edge.artifact_id + 1 < num_offsets) {
+    const auto begin = row.neighbors.begin() + row.offsets[edge.artifact_id];
+    const auto end = row.neighbors.begin() + row.offsets[edge.artifact_id + 1];
+    const auto it = std::lower_bound(
+        begin, end, edge, [](const Neighbor& neighbor, const Edge& target) {
+          return std::tie(neighbor.id, neighbor.type, neighbor.event_id) <
+                 std::tie(target.execution_id, target.type, target.event_id);
+        });
+    if (it != end && it->event_id == edge.event_id) {
+      return true;
+    }
+  }
+  return added_.event_ids.contains(edge.event_id) ||
+         (compacting_ != nullptr &&
+          compacting_->event_ids.contains(edge.event_id));
+}
+
+std::shared_ptr<const LineageIndex::Rows> LineageIndex::BuildRows(
+    const std::vector<Edge>& edges) {
+  int64 max_artifact_id = -1;
+  int64 max_execution_id = -1;
+  for (const Edge& edge : edges) {
+    max_artifact_id = std::max(max_artifact_id, edge.artifact_id);
+    max_execution_id = std::max(max_execution_id, edge.execution_id);
+  }
+  auto rows = std::make_shared<Rows>();
+  Row& artifact_row = rows->artifact_to_executions;
+  Row& execution_row = rows->execution_to_artifacts;
+  artifact_row.offsets.assign(max_artifact_id + 2, 0);
+  execution_row.offsets.assign(max_execution_id + 2, 0);
+  for (const Edge& edge : edges) {
+    ++artifact_row.offsets[edge.artifact_id + 1];
+    ++execution_row.offsets[edge.execution_id + 1];
+  }
+  for (int64 id = 0; id <= max_artifact_id; ++id) {
+    artifact_row.offsets[id + 1] += artifact_row.offsets[id];
+  }
+  for (int64 id = 0; id <= max_execution_id; ++id) {
+    execution_row.offsets[id + 1] += execution_row.offsets[id];
+  }
+
+  // The edges are sorted by artifact id, so the neighbors of each execution
+  // are placed in the order of their artifact ids too.
+  artifact_row.neighbors.reserve(edges.size());
+  execution_row.neighbors.resize(edges.size());
+  std::vector<int64> next_execution_neighbor(execution_row.offsets.begin(),
+                                             execution_row.offsets.end() - 1);
+  for (const Edge& edge : edges) {
+    artifact_row.neighbors.push_back(
+        {edge.execution_id, edge.type, edge.event_id});
+    execution_row.neighbors[next_execution_neighbor[edge.execution_id]++] = {
+        edge.artifact_id, edge.type, edge.event_id};
+  }
+  return rows;
+}
+
+template <typename Visit>
+void LineageIndex::ForEachNeighbor(const bool from_artifact, const int64 id,
+                                   const Visit& visit) const {
+  const Row& row = from_artifact ? rows_->artifact_to_executions
+                                 : rows_->execution_to_artifacts;
+  const int64 num_offsets = row.offsets.size();
+  if (id >= 0 && id + 1 < num_offsets) {
+    for (int64 i = row.offsets[id]; i < row.offsets[id + 1]; ++i) {
+      visit(row.neighbors[i]);
+    }
+  }
+  // The compacted edges were added before the ones added since.
+  for (const AddedEdges* added : {compacting_.get(), &added_}) {
+    if (added == nullptr) continue;
+    const NeighborLists& lists = from_artifact ? added->artifact_to_executions
+                                               : added->execution_to_artifacts;
+    const auto it = lists.find(id);
+    if (it != lists.end()) {
+      for (const Neighbor& neighbor : it->second) {
+        visit(neighbor);
+      }
+    }
+  }
+}
+
+void LineageIndex::Traverse(const GetLineageGraphRequest& request,
+                            const std::vector<int64>& seed_artifact_ids,
+                            const std::vector<int64>& seed_execution_ids,
+                            LineageTraversal* traversal) const {
+  *traversal = LineageTraversal();
+  TraversedNodes artifacts;
+  for (const int64 id : seed_artifact_ids) {
+    if (artifacts.ids.insert(id).second) {
+      traversal->artifact_ids.push_back(id);
+      artifacts.frontier.push_back(id);
+    }
+  }
+  TraversedNodes executions;
+  for (const int64 id : seed_execution_ids) {
+    if (executions.ids.insert(id).second) {
+      traversal->execution_ids.push_back(id);
+      executions.frontier.push_back(id);
+    }
+  }
+  if (NumNodes(*traversal) > request.max_num_nodes()) {
+    traversal->is_truncated = true;
+  }
+
+  absl::ReaderMutexLock lock(&mu_);
+  for (int hop = 0; hop < request.max_num_hops(); hop++) {
+    if (traversal->is_truncated ||
+        (artifacts.frontier.empty() && executions.frontier.empty())) {
+      break;
+    }
+    // An edge between two expanded nodes is followed from one of them only:
+    // from the artifact, if it can be, else from the execution.
+    artifacts.expanded_ids.insert(artifacts.frontier.begin(),
+                                  artifacts.frontier.end());
+    std::vector<Edge> edges_to_executions;
+    for (const int64 artifact_id : artifacts.frontier) {
+      ForEachNeighbor(
+          /*from_artifact=*/true, artifact_id, [&](const Neighbor& execution) {
+            if (!IsFollowedFromArtifact(execution.type, request.direction()) ||
+                (executions.expanded_ids.contains(execution.id) &&
+                 IsFollowedFromExecution(execution.type,
+                                         request.direction()))) {
+              return;
+            }
+            edges_to_executions.push_back(
+                {artifact_id, execution.id, execution.type,
+                 execution.event_id});
+          });
+    }
+    executions.expanded_ids.insert(executions.frontier.begin(),
+                                   executions.frontier.end());
+    std::vector<Edge> edges_to_artifacts;
+    for (const int64 execution_id : executions.frontier) {
+      ForEachNeighbor(
+          /*from_artifact=*/false, execution_id, [&](const Neighbor& artifact) {
+            if (!IsFollowedFromExecution(artifact.type, request.direction()) ||
+                (artifacts.expanded_ids.contains(artifact.id) &&
+                 IsFollowedFromArtifact(artifact.type, request.direction()))) {
+              return;
+            }
+            edges_to_artifacts.push_back(
+                {artifact.id, execution_id, artifact.type, artifact.event_id});
+          });
+    }
+
+    std::vector<int64> next_artifact_frontier;
+    std::vector<int64> next_execution_frontier;
+    FollowEdges(edges_to_executions, /*to_artifacts=*/false, request,
+                &executions, &traversal->execution_ids,
+                &next_execution_frontier, traversal);
+    FollowEdges(edges_to_artifacts, /*to_artifacts=*/true, request, &artifacts,
+                &traversal->artifact_ids, &next_artifact_frontier, traversal);
+    artifacts.frontier = std::move(next_artifact_frontier);
+    executions.frontier = std::move(next_execution_frontier);
+  }
+}
+
+}  // namespace ml_metadata
@@ -0,0 +1,202 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef ML_METADATA_METADATA_STORE_LINEAGE_INDEX_H_
+#define ML_METADATA_METADATA_STORE_LINEAGE_INDEX_H_
+
+#include <memory>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+#include "ml_metadata/metadata_store/types.h"
+#include "ml_metadata/proto/metadata_store.pb.h"
+#include "ml_metadata/proto/metadata_store_service.pb.h"
+
+namespace ml_metadata {
+
+// The artifacts, executions and events reached by a traversal of a
+// LineageIndex, in the order they are reached.
+struct LineageTraversal {
+  // The ids of the reached artifacts and executions, including the seeds.
+  std::vector<int64> artifact_ids;
+  std::vector<int64> execution_ids;
+  // The followed edges. Only the artifact_id, execution_id and type of the
+  // events are set.
+  std::vector<Event> events;
+  // The ids of the followed events, index-aligned with `events`.
+  std::vector<int64> event_ids;
+  // True if the traversal stopped at a limit of the request.
+  bool is_truncated = false;
+};
+
+// Returns true if an event of `type` is an input of its execution.
+bool IsInputEventType(Event::Type type);
+
+// Returns true if an event of `type` is an output of its execution.
+bool IsOutputEventType(Event::Type type);
+
+// Returns true if a lineage traversal in `direction` follows an event of
+// `type` from its artifact to its execution.
+bool IsFollowedFromArtifact(Event::Type type,
+                            GetLineageGraphRequest::Direction direction);
+
+// Returns true if a lineage traversal in `direction` follows an event of
+// `type` from its execution to its artifact.
+bool IsFollowedFromExecution(Event::Type type,
+                             GetLineageGraphRequest::Direction direction);
+
+// An in-memory, thread-safe index of the edges of the lineage graph, i.e., of
+// the artifact id, execution id, type and id of the events.
+//
+// The edges are kept in two compressed sparse rows, one from the artifacts to
+// their executions and one from the executions to their artifacts, each with
+// an offset per node id into an array of the neighbors of the nodes, sorted by
+// neighbor id, event type and event id. The edges added after the rows are
+// built are kept in per node lists. Once they have about an eighth of the
+// edges of the rows, NeedsCompaction returns true, and Compact builds new rows
+// with all the edges, from a snapshot and without the lock of the index, so
+// that the traversals and the additions go on meanwhile.
+//
+// An edge is kept per event, and the events are known by their ids, so adding
+// the same events again does not change the index. The event ids let the
+// followed events be read by id.
+//
+// Usage example:
+//   LineageIndex index;
+//   index.Reset(edges, max_event_id);
+//   index.AddEvents(new_event_ids, new_events);
+//   // In a background thread.
+//   if (index.NeedsCompaction()) index.Compact();
+//   LineageTraversal traversal;
+//   index.Traverse(request, seed_artifact_ids, seed_execution_ids,
+//                  &traversal);
+class LineageIndex {
+ public:
+  // An edge of the lineage graph, i.e., an event.
+  struct Edge {
+    int64 artifact_id;
+    int64 execution_id;
+    Event::Type type;
+    int64 event_id;
+  };
+
+  LineageIndex();
+  LineageIndex(const LineageIndex&) = delete;
+  LineageIndex& operator=(const LineageIndex&) = delete;
+
+  // Returns the edge of the event with id `event_id`.
+  static Edge ToEdge(int64 event_id, const Event& event);
+
+  // Replaces the edges of the index with `edges`, which have the events whose
+  // ids are not greater than `max_event_id`.
+  void Reset(std::vector<Edge> edges, int64 max_event_id);
+
+  // Adds the `edges` which are not in the index yet.
+  void AddEdges(const std::vector<Edge>& edges);
+
+  // Adds the edges of the `events`, whose ids are `event_ids`, which are not
+  // in the index yet. The `event_ids` are index-aligned with the `events`.
+  void AddEvents(const std::vector<int64>& event_ids,
+                 const std::vector<Event>& events);
+
+  // Returns true if the added edges are to be compacted into the rows.
+  bool NeedsCompaction() const;
+
+  // Rebuilds the rows with all the edges of the index. The lock of the index
+  // is only held to take the added edges, which are then kept apart, and to
+  // swap in the new rows. The edges added meanwhile are compacted by the next
+  // call.
+  void Compact();
+
+  // Returns the max id of the events known to be in the index. The events
+  // with greater ids may be in the index too.
+  int64 max_event_id() const;
+
+  // Raises the max_event_id to `max_event_id`, if it is greater.
+  void AdvanceMaxEventId(int64 max_event_id);
+
+  // Returns the number of edges of the index.
+  int64 num_edges() const;
+
+  // Traverses the lineage graph breadth first from the seeds, like
+  // MetadataStore::GetLineageGraph: within the max_num_hops of the request in
+  // its direction, and up to its max_num_nodes and max_num_events, which
+  // truncates the traversal. The limits of the request must be valid. The
+  // type names of the request are ignored, as the index has no node types.
+  void Traverse(const GetLineageGraphRequest& request,
+                const std::vector<int64>& seed_artifact_ids,
+                const std::vector<int64>& seed_execution_ids,
+                LineageTraversal* traversal) const;
+
+ private:
+  // A neighbor of a node in a row, through the event with id `event_id`.
+  struct Neighbor {
+    int64 id;
+    Event::Type type;
+    int64 event_id;
+  };
+
+  // A compressed sparse row of the neighbors of the nodes of a kind. The
+  // neighbors of node `id` are neighbors[offsets[id]:offsets[id + 1]], and the
+  // nodes with ids beyond the offsets have none.
+  struct Row {
+    std::vector<int64> offsets;
+    std::vector<Neighbor> neighbors;
+  };
+
+  // The rows from the artifacts to their executions, and back.
+  struct Rows {
+    Row artifact_to_executions;
+    Row execution_to_artifacts;
+  };
+
+  // The neighbors of the nodes of a kind, by node id.
+  using NeighborLists = absl::flat_hash_map<int64, std::vector<Neighbor>>;
+
+  // The edges added after the rows are built.
+  struct AddedEdges {
+    NeighborLists artifact_to_executions;
+    NeighborLists execution_to_artifacts;
+    absl::flat_hash_set<int64> event_ids;
+  };
+
+  // Returns true if the index has the `edge`.
+  bool Contains(const Edge& edge) const ABSL_SHARED_LOCKS_REQUIRED(mu_);
+
+  // Builds the rows of `edges`, which are sorted and unique.
+  static std::shared_ptr<const Rows> BuildRows(const std::vector<Edge>& edges);
+
+  // Calls `visit` with each neighbor of the artifact `id` if `from_artifact`,
+  // else of the execution `id`.
+  template <typename Visit>
+  void ForEachNeighbor(bool from_artifact, int64 id, const Visit& visit) const
+      ABSL_SHARED_LOCKS_REQUIRED(mu_);
+
+  // Held by Compact and Reset, so that the rows are replaced by one of them
+  // at a time.
+  absl::Mutex compact_mu_ ABSL_ACQUIRED_BEFORE(mu_);
+
+  mutable absl::Mutex mu_;
+  std::shared_ptr<const Rows> rows_ ABSL_GUARDED_BY(mu_);
+  // The added edges being compacted into new rows, if any.
+  std::shared_ptr<const AddedEdges> compacting_ ABSL_GUARDED_BY(mu_);
+  AddedEdges added_ ABSL_GUARDED_BY(mu_);
+  int64 max_event_id_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace ml_metadata
+
+#endif  // ML_METADATA_METADATA_STORE_LINEAGE_INDEX_H_
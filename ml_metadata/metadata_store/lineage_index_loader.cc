@@ -0,0 +1,139 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "ml_metadata/metadata_store/lineage_index_loader.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
+
+namespace ml_metadata {
+namespace {
+
+// Gets the max id of the events with a store borrowed from the pool.
+tensorflow::Status GetMaxEventId(MetadataStorePool* metadata_store_pool,
+                                 int64* max_event_id) {
+  MetadataStorePool::Handle metadata_store;
+  TF_RETURN_IF_ERROR(metadata_store_pool->Borrow(&metadata_store));
+  return metadata_store->GetMaxEventId(max_event_id);
+}
+
+// Reads the edges of the events with ids in (min_event_id, max_event_id] with
+// a store borrowed from the pool.
+tensorflow::Status ReadEdgesInRange(MetadataStorePool* metadata_store_pool,
+                                    const int64 min_event_id,
+                                    const int64 max_event_id,
+                                    std::vector<LineageIndex::Edge>* edges) {
+  MetadataStorePool::Handle metadata_store;
+  TF_RETURN_IF_ERROR(metadata_store_pool->Borrow(&metadata_store));
+  std::vector<int64> event_ids;
+  std::vector<Event> events;
+  TF_RETURN_IF_ERROR(metadata_store->GetEventsByIdRange(
+      min_event_id, max_event_id, &event_ids, &events));
+  edges->reserve(events.size());
+  for (int64 i = 0; i < static_cast<int64>(events.size()); ++i) {
+    edges->push_back(LineageIndex::ToEdge(event_ids[i], events[i]));
+  }
+  return tensorflow::Status::OK();
+}
+
+// Reads the edges of the events with ids in (min_event_id, max_event_id] in
+// ranges of load_batch_size ids, with up to num_loader_threads threads.
+tensorflow::Status ReadEdges(const LineageIndexConfig& config,
+                             MetadataStorePool* metadata_store_pool,
+                             const int64 min_event_id,
+                             const int64 max_event_id,
+                             std::vector<LineageIndex::Edge>* edges) {
+  const int64 batch_size = config.load_batch_size();
+  const int64 num_ranges =
+      (max_event_id - min_event_id + batch_size - 1) / batch_size;
+  if (num_ranges <= 0) return tensorflow::Status::OK();
+  std::vector<std::vector<LineageIndex::Edge>> range_edges(num_ranges);
+  std::vector<tensorflow::Status> range_statuses(num_ranges);
+  {
+    tensorflow::thread::ThreadPool loaders(
+        tensorflow::Env::Default(), "mlmd_lineage_index_loader",
+        std::min<int64>(config.num_loader_threads(), num_ranges));
+    for (int64 i = 0; i < num_ranges; ++i) {
+      loaders.Schedule([&, i]() {
+        const int64 range_min_event_id = min_event_id + i * batch_size;
+        range_statuses[i] = ReadEdgesInRange(
+            metadata_store_pool, range_min_event_id,
+            std::min(max_event_id, range_min_event_id + batch_size),
+            &range_edges[i]);
+      });
+    }
+    // Destroying the pool waits for the scheduled ranges.
+  }
+  int64 num_edges = 0;
+  for (int64 i = 0; i < num_ranges; ++i) {
+    TF_RETURN_IF_ERROR(range_statuses[i]);
+    num_edges += range_edges[i].size();
+  }
+  edges->reserve(edges->size() + num_edges);
+  for (std::vector<LineageIndex::Edge>& range : range_edges) {
+    edges->insert(edges->end(), range.begin(), range.end());
+    std::vector<LineageIndex::Edge>().swap(range);
+  }
+  return tensorflow::Status::OK();
+}
+
+}  // namespace
+
+tensorflow::Status ValidateLineageIndexConfig(
+    const LineageIndexConfig& config) {
+  if (config.num_loader_threads() <= 0 || config.load_batch_size() <= 0 ||
+      config.catch_up_interval_sec() < 0) {
+    return tensorflow::errors::InvalidArgument(
+        "The num_loader_threads and load_batch_size must be positive, and the "
+        "catch_up_interval_sec must not be negative: ",
+        config.DebugString());
+  }
+  return tensorflow::Status::OK();
+}
+
+tensorflow::Status LoadLineageIndex(const LineageIndexConfig& config,
+                                    MetadataStorePool* metadata_store_pool,
+                                    LineageIndex* lineage_index) {
+  TF_RETURN_IF_ERROR(ValidateLineageIndexConfig(config));
+  int64 max_event_id = 0;
+  TF_RETURN_IF_ERROR(GetMaxEventId(metadata_store_pool, &max_event_id));
+  std::vector<LineageIndex::Edge> edges;
+  TF_RETURN_IF_ERROR(ReadEdges(config, metadata_store_pool,
+                               /*min_event_id=*/0, max_event_id, &edges));
+  lineage_index->Reset(std::move(edges), max_event_id);
+  return tensorflow::Status::OK();
+}
+
+tensorflow::Status CatchUpLineageIndex(const LineageIndexConfig& config,
+                                       MetadataStorePool* metadata_store_pool,
+                                       LineageIndex* lineage_index) {
+  TF_RETURN_IF_ERROR(ValidateLineageIndexConfig(config));
+  int64 max_event_id = 0;
+  TF_RETURN_IF_ERROR(GetMaxEventId(metadata_store_pool, &max_event_id));
+  const int64 min_event_id = std::max<int64>(
+      0, lineage_index->max_event_id() - config.load_batch_size());
+  std::vector<LineageIndex::Edge> edges;
+  TF_RETURN_IF_ERROR(ReadEdges(config, metadata_store_pool, min_event_id,
+                               max_event_id, &edges));
+  lineage_index->AddEdges(edges);
+  lineage_index->AdvanceMaxEventId(max_event_id);
+  return tensorflow::Status::OK();
+}
+
+}  // namespace ml_metadata
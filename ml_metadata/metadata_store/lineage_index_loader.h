@@ -0,0 +1,52 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef ML_METADATA_METADATA_STORE_LINEAGE_INDEX_LOADER_H_
+#define ML_METADATA_METADATA_STORE_LINEAGE_INDEX_LOADER_H_
+
+#include "ml_metadata/metadata_store/lineage_index.h"
+#include "ml_metadata/metadata_store/metadata_store_pool.h"
+#include "ml_metadata/proto/metadata_store.pb.h"
+#include "tensorflow/core/lib/core/status.h"
+
+namespace ml_metadata {
+
+// Returns INVALID_ARGUMENT error, if the lineage index config is not valid.
+tensorflow::Status ValidateLineageIndexConfig(const LineageIndexConfig& config);
+
+// Replaces the edges of `lineage_index` with the ones of all the events of the
+// metadata source. The events are read in ranges of load_batch_size ids by
+// num_loader_threads threads, each with a store borrowed from
+// `metadata_store_pool`. The events written while loading may be missing
+// until the next catch up.
+// Returns INVALID_ARGUMENT error, if the config is not valid.
+// Returns the errors of MetadataStorePool::Borrow, GetMaxEventId and
+// GetEventsByIdRange.
+tensorflow::Status LoadLineageIndex(const LineageIndexConfig& config,
+                                    MetadataStorePool* metadata_store_pool,
+                                    LineageIndex* lineage_index);
+
+// Adds to `lineage_index` the edges of the events written since its
+// max_event_id, then raises it to the max event id of the metadata source.
+// The load_batch_size ids before the max_event_id are read again, as
+// concurrent transactions may commit their events out of the order of their
+// ids.
+// Returns the errors of LoadLineageIndex.
+tensorflow::Status CatchUpLineageIndex(const LineageIndexConfig& config,
+                                       MetadataStorePool* metadata_store_pool,
+                                       LineageIndex* lineage_index);
+
+}  // namespace ml_metadata
+
+#endif  // ML_METADATA_METADATA_STORE_LINEAGE_INDEX_LOADER_H_
@@ -0,0 +1,141 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "ml_metadata/metadata_store/lineage_index_loader.h"
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "ml_metadata/metadata_store/lineage_index.h"
+#include "ml_metadata/metadata_store/metadata_store_pool.h"
+#include "ml_metadata/metadata_store/test_util.h"
+#include "ml_metadata/proto/metadata_store.pb.h"
+#include "ml_metadata/proto/metadata_store_service.pb.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+
+namespace ml_metadata {
+namespace {
+
+using testing::ParseTextProtoOrDie;
+
+// Returns a pool with a single in-memory SQLite store, so that all the
+// loaders see the same database.
+std::unique_ptr<MetadataStorePool> CreateSqlitePool() {
+  ConnectionConfig connection_config;
+  connection_config.mutable_sqlite();
+  ConnectionPoolConfig pool_config;
+  pool_config.set_max_pool_size(1);
+  std::unique_ptr<MetadataStorePool> pool;
+  TF_CHECK_OK(MetadataStorePool::Create(connection_config, pool_config, &pool));
+  return pool;
+}
+
+// Puts a chain of `num_executions` executions after the artifact
+// `artifact_id`, each taking the last artifact as input and giving a new one as
+// output, with the types of `types`, and returns the id of the last artifact.
+int64 PutChain(MetadataStore* metadata_store, const PutTypesResponse& types,
+               int64 artifact_id, const int num_executions) {
+  for (int i = 0; i < num_executions; i++) {
+    PutExecutionRequest request;
+    request.mutable_execution()->set_type_id(types.execution_type_ids(0));
+    PutExecutionRequest::ArtifactAndEvent* input =
+        request.add_artifact_event_pairs();
+    input->mutable_event()->set_artifact_id(artifact_id);
+    input->mutable_event()->set_type(Event::INPUT);
+    PutExecutionRequest::ArtifactAndEvent* output =
+        request.add_artifact_event_pairs();
+    output->mutable_artifact()->set_type_id(types.artifact_type_ids(0));
+    output->mutable_event()->set_type(Event::OUTPUT);
+    PutExecutionResponse response;
+    TF_CHECK_OK(metadata_store->PutExecution(request, &response));
+    artifact_id = response.artifact_ids(1);
+  }
+  return artifact_id;
+}
+
+// Returns the ids of the artifacts downstream of `artifact_id`.
+std::vector<int64> DownstreamArtifactIds(const LineageIndex& lineage_index,
+                                         const int64 artifact_id) {
+  GetLineageGraphRequest request;
+  request.set_direction(GetLineageGraphRequest::DOWNSTREAM);
+  LineageTraversal traversal;
+  lineage_index.Traverse(request, {artifact_id}, {}, &traversal);
+  return traversal.artifact_ids;
+}
+
+TEST(LineageIndexLoaderTest, InvalidConfig) {
+  std::unique_ptr<MetadataStorePool> pool = CreateSqlitePool();
+  for (const char* config : {"num_loader_threads: 0", "load_batch_size: 0",
+                             "catch_up_interval_sec: -1"}) {
+    LineageIndex lineage_index;
+    EXPECT_TRUE(tensorflow::errors::IsInvalidArgument(LoadLineageIndex(
+        ParseTextProtoOrDie<LineageIndexConfig>(config), pool.get(),
+        &lineage_index)));
+  }
+}
+
+TEST(LineageIndexLoaderTest, LoadAndCatchUp) {
+  std::unique_ptr<MetadataStorePool> pool = CreateSqlitePool();
+  const LineageIndexConfig config = ParseTextProtoOrDie<LineageIndexConfig>(
+      "num_loader_threads: 3 load_batch_size: 2");
+  LineageIndex lineage_index;
+  TF_ASSERT_OK(LoadLineageIndex(config, pool.get(), &lineage_index));
+  EXPECT_EQ(lineage_index.num_edges(), 0);
+  EXPECT_EQ(lineage_index.max_event_id(), 0);
+
+  PutTypesResponse types;
+  int64 first_artifact_id;
+  int64 last_artifact_id;
+  int64 max_event_id;
+  {
+    MetadataStorePool::Handle metadata_store;
+    TF_ASSERT_OK(pool->Borrow(&metadata_store));
+    TF_ASSERT_OK(metadata_store->PutTypes(
+        ParseTextProtoOrDie<PutTypesRequest>(R"(
+          artifact_types: { name: 'data' }
+          execution_types: { name: 'trainer' }
+        )"),
+        &types));
+    PutArtifactsRequest request;
+    request.add_artifacts()->set_type_id(types.artifact_type_ids(0));
+    PutArtifactsResponse response;
+    TF_ASSERT_OK(metadata_store->PutArtifacts(request, &response));
+    first_artifact_id = response.artifact_ids(0);
+    last_artifact_id =
+        PutChain(metadata_store.get(), types, first_artifact_id, 5);
+    TF_ASSERT_OK(metadata_store->GetMaxEventId(&max_event_id));
+  }
+  TF_ASSERT_OK(LoadLineageIndex(config, pool.get(), &lineage_index));
+  EXPECT_EQ(lineage_index.num_edges(), 10);
+  EXPECT_EQ(lineage_index.max_event_id(), max_event_id);
+  EXPECT_EQ(DownstreamArtifactIds(lineage_index, first_artifact_id).size(), 6);
+
+  {
+    MetadataStorePool::Handle metadata_store;
+    TF_ASSERT_OK(pool->Borrow(&metadata_store));
+    last_artifact_id =
+        PutChain(metadata_store.get(), types, last_artifact_id, 2);
+    TF_ASSERT_OK(metadata_store->GetMaxEventId(&max_event_id));
+  }
+  TF_ASSERT_OK(CatchUpLineageIndex(config, pool.get(), &lineage_index));
+  EXPECT_EQ(lineage_index.num_edges(), 14);
+  EXPECT_EQ(lineage_index.max_event_id(), max_event_id);
+  EXPECT_EQ(DownstreamArtifactIds(lineage_index, first_artifact_id).size(), 8);
+  EXPECT_EQ(DownstreamArtifactIds(lineage_index, last_artifact_id).size(), 1);
+}
+
+}  // namespace
+}  // namespace ml_metadata
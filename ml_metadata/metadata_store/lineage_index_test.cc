@@ -0,0 +1,239 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "ml_metadata/metadata_store/lineage_index.h"
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "ml_metadata/proto/metadata_store.pb.h"
+#include "ml_metadata/proto/metadata_store_service.pb.h"
+
+namespace ml_metadata {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+Event MakeEvent(const int64 artifact_id, const int64 execution_id,
+                const Event::Type type) {
+  Event event;
+  event.set_artifact_id(artifact_id);
+  event.set_execution_id(execution_id);
+  event.set_type(type);
+  return event;
+}
+
+// Returns the index of the chain a1 -> e1 -> a2 -> e2 -> a3, in which the
+// executions take the artifacts before them as inputs, and output the ones
+// after them.
+// The events have ids 1 to 4 along the chain.
+std::vector<LineageIndex::Edge> ChainEdges() {
+  return {{1, 1, Event::INPUT, 1},
+          {2, 1, Event::OUTPUT, 2},
+          {2, 2, Event::INPUT, 3},
+          {3, 2, Event::OUTPUT, 4}};
+}
+
+GetLineageGraphRequest MakeRequest(
+    const GetLineageGraphRequest::Direction direction) {
+  GetLineageGraphRequest request;
+  request.set_direction(direction);
+  return request;
+}
+
+TEST(LineageIndexTest, FollowsEventsByDirection) {
+  EXPECT_TRUE(IsFollowedFromArtifact(Event::DECLARED_INPUT,
+                                     GetLineageGraphRequest::DOWNSTREAM));
+  EXPECT_FALSE(IsFollowedFromArtifact(Event::INTERNAL_INPUT,
+                                      GetLineageGraphRequest::UPSTREAM));
+  EXPECT_TRUE(IsFollowedFromExecution(Event::INTERNAL_OUTPUT,
+                                      GetLineageGraphRequest::DOWNSTREAM));
+  EXPECT_FALSE(IsFollowedFromExecution(Event::OUTPUT,
+                                       GetLineageGraphRequest::UPSTREAM));
+  EXPECT_TRUE(IsFollowedFromArtifact(Event::OUTPUT,
+                                     GetLineageGraphRequest::BIDIRECTIONAL));
+  EXPECT_TRUE(IsFollowedFromExecution(Event::INPUT,
+                                      GetLineageGraphRequest::BIDIRECTIONAL));
+}
+
+TEST(LineageIndexTest, TraverseDownstream) {
+  LineageIndex index;
+  index.Reset(ChainEdges(), /*max_event_id=*/4);
+  EXPECT_EQ(index.num_edges(), 4);
+  EXPECT_EQ(index.max_event_id(), 4);
+
+  LineageTraversal traversal;
+  index.Traverse(MakeRequest(GetLineageGraphRequest::DOWNSTREAM),
+                 /*seed_artifact_ids=*/{1}, /*seed_execution_ids=*/{},
+                 &traversal);
+  EXPECT_THAT(traversal.artifact_ids, ElementsAre(1, 2, 3));
+  EXPECT_THAT(traversal.execution_ids, ElementsAre(1, 2));
+  EXPECT_EQ(traversal.events.size(), 4);
+  EXPECT_THAT(traversal.event_ids, ElementsAre(1, 2, 3, 4));
+  EXPECT_FALSE(traversal.is_truncated);
+
+  // Nothing is downstream of the last artifact.
+  index.Traverse(MakeRequest(GetLineageGraphRequest::DOWNSTREAM),
+                 /*seed_artifact_ids=*/{3}, /*seed_execution_ids=*/{},
+                 &traversal);
+  EXPECT_THAT(traversal.artifact_ids, ElementsAre(3));
+  EXPECT_THAT(traversal.execution_ids, IsEmpty());
+  EXPECT_THAT(traversal.events, IsEmpty());
+}
+
+TEST(LineageIndexTest, TraverseUpstreamWithinMaxNumHops) {
+  LineageIndex index;
+  index.Reset(ChainEdges(), /*max_event_id=*/4);
+  GetLineageGraphRequest request =
+      MakeRequest(GetLineageGraphRequest::UPSTREAM);
+  request.set_max_num_hops(2);
+
+  LineageTraversal traversal;
+  index.Traverse(request, /*seed_artifact_ids=*/{3},
+                 /*seed_execution_ids=*/{}, &traversal);
+  EXPECT_THAT(traversal.artifact_ids, ElementsAre(3, 2));
+  EXPECT_THAT(traversal.execution_ids, ElementsAre(2));
+  ASSERT_EQ(traversal.events.size(), 2);
+  EXPECT_EQ(traversal.events[0].artifact_id(), 3);
+  EXPECT_EQ(traversal.events[0].execution_id(), 2);
+  EXPECT_EQ(traversal.events[0].type(), Event::OUTPUT);
+  EXPECT_THAT(traversal.event_ids, ElementsAre(4, 3));
+  EXPECT_FALSE(traversal.is_truncated);
+}
+
+TEST(LineageIndexTest, TraverseBidirectionalFollowsEachEdgeOnce) {
+  LineageIndex index;
+  index.Reset(ChainEdges(), /*max_event_id=*/4);
+
+  LineageTraversal traversal;
+  index.Traverse(MakeRequest(GetLineageGraphRequest::BIDIRECTIONAL),
+                 /*seed_artifact_ids=*/{2}, /*seed_execution_ids=*/{2},
+                 &traversal);
+  EXPECT_THAT(traversal.artifact_ids, ElementsAre(2, 3, 1));
+  EXPECT_THAT(traversal.execution_ids, ElementsAre(2, 1));
+  EXPECT_EQ(traversal.events.size(), 4);
+}
+
+TEST(LineageIndexTest, TraverseTruncatesAtLimits) {
+  LineageIndex index;
+  index.Reset(ChainEdges(), /*max_event_id=*/4);
+  GetLineageGraphRequest request =
+      MakeRequest(GetLineageGraphRequest::DOWNSTREAM);
+  request.set_max_num_nodes(3);
+
+  LineageTraversal traversal;
+  index.Traverse(request, /*seed_artifact_ids=*/{1},
+                 /*seed_execution_ids=*/{}, &traversal);
+  EXPECT_THAT(traversal.artifact_ids, ElementsAre(1, 2));
+  EXPECT_THAT(traversal.execution_ids, ElementsAre(1));
+  EXPECT_EQ(traversal.events.size(), 2);
+  EXPECT_TRUE(traversal.is_truncated);
+
+  request.clear_max_num_nodes();
+  request.set_max_num_events(1);
+  index.Traverse(request, /*seed_artifact_ids=*/{1},
+                 /*seed_execution_ids=*/{}, &traversal);
+  EXPECT_THAT(traversal.artifact_ids, ElementsAre(1));
+  EXPECT_THAT(traversal.execution_ids, ElementsAre(1));
+  EXPECT_EQ(traversal.events.size(), 1);
+  EXPECT_TRUE(traversal.is_truncated);
+}
+
+TEST(LineageIndexTest, AddEventsSkipsKnownEvents) {
+  LineageIndex index;
+  index.Reset(ChainEdges(), /*max_event_id=*/4);
+  index.AddEvents(/*event_ids=*/{1, 4}, {MakeEvent(1, 1, Event::INPUT),
+                                         MakeEvent(3, 2, Event::OUTPUT)});
+  EXPECT_EQ(index.num_edges(), 4);
+
+  // a3 -> e3 -> a4 extends the chain.
+  const std::vector<Event> events = {MakeEvent(3, 3, Event::INPUT),
+                                     MakeEvent(4, 3, Event::OUTPUT)};
+  index.AddEvents(/*event_ids=*/{5, 6}, events);
+  index.AddEvents(/*event_ids=*/{5, 6}, events);
+  EXPECT_EQ(index.num_edges(), 6);
+  EXPECT_EQ(index.max_event_id(), 4);
+  index.AdvanceMaxEventId(6);
+  index.AdvanceMaxEventId(5);
+  EXPECT_EQ(index.max_event_id(), 6);
+
+  LineageTraversal traversal;
+  index.Traverse(MakeRequest(GetLineageGraphRequest::UPSTREAM),
+                 /*seed_artifact_ids=*/{4}, /*seed_execution_ids=*/{},
+                 &traversal);
+  EXPECT_THAT(traversal.artifact_ids, ElementsAre(4, 3, 2, 1));
+  EXPECT_THAT(traversal.execution_ids, ElementsAre(3, 2, 1));
+  EXPECT_THAT(traversal.event_ids, ElementsAre(6, 5, 4, 3, 2, 1));
+}
+
+TEST(LineageIndexTest, TraverseFollowsEachEventOfAnEdge) {
+  LineageIndex index;
+  index.Reset(ChainEdges(), /*max_event_id=*/4);
+  // a1 is an input of e1 once more.
+  index.AddEvents(/*event_ids=*/{5}, {MakeEvent(1, 1, Event::INPUT)});
+  EXPECT_EQ(index.num_edges(), 5);
+
+  GetLineageGraphRequest request =
+      MakeRequest(GetLineageGraphRequest::DOWNSTREAM);
+  request.set_max_num_hops(1);
+  LineageTraversal traversal;
+  index.Traverse(request, /*seed_artifact_ids=*/{1},
+                 /*seed_execution_ids=*/{}, &traversal);
+  EXPECT_THAT(traversal.execution_ids, ElementsAre(1));
+  EXPECT_THAT(traversal.event_ids, ElementsAre(1, 5));
+}
+
+TEST(LineageIndexTest, CompactAddedEdges) {
+  LineageIndex index;
+  // A fan out of one artifact into many executions, with an output each.
+  constexpr int64 kNumExecutions = 3000;
+  std::vector<int64> event_ids;
+  std::vector<Event> events;
+  for (int64 i = 1; i <= kNumExecutions; ++i) {
+    events.push_back(MakeEvent(1, i, Event::INPUT));
+    events.push_back(MakeEvent(1 + i, i, Event::OUTPUT));
+    event_ids.push_back(2 * i - 1);
+    event_ids.push_back(2 * i);
+  }
+  EXPECT_FALSE(index.NeedsCompaction());
+  index.AddEvents(event_ids, events);
+  EXPECT_TRUE(index.NeedsCompaction());
+  index.Compact();
+  EXPECT_FALSE(index.NeedsCompaction());
+  // The compacted edges are known in the rows.
+  index.AddEvents(event_ids, events);
+  EXPECT_EQ(index.num_edges(), 2 * kNumExecutions);
+  EXPECT_FALSE(index.NeedsCompaction());
+
+  // An edge added after the compaction is followed with the compacted ones.
+  index.AddEvents(/*event_ids=*/{2 * kNumExecutions + 1},
+                  {MakeEvent(1, kNumExecutions + 1, Event::INPUT)});
+  EXPECT_EQ(index.num_edges(), 2 * kNumExecutions + 1);
+
+  GetLineageGraphRequest request =
+      MakeRequest(GetLineageGraphRequest::DOWNSTREAM);
+  request.set_max_num_nodes(2 * kNumExecutions + 2);
+  LineageTraversal traversal;
+  index.Traverse(request, /*seed_artifact_ids=*/{1},
+                 /*seed_execution_ids=*/{}, &traversal);
+  EXPECT_EQ(traversal.artifact_ids.size(), kNumExecutions + 1);
+  EXPECT_EQ(traversal.execution_ids.size(), kNumExecutions + 1);
+  EXPECT_EQ(traversal.events.size(), 2 * kNumExecutions + 1);
+  EXPECT_FALSE(traversal.is_truncated);
+}
+
+}  // namespace
+}  // namespace ml_metadata
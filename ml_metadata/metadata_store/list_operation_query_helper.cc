@@ -14,9 +14,15 @@ limitations under the License.
 ==============================================================================*/
 #include "ml_metadata/metadata_store/list_operation_query_helper.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
+#include "ml_metadata/metadata_store/constants.h"
 #include "ml_metadata/metadata_store/list_operation_util.h"
 #include "ml_metadata/proto/metadata_store.pb.h"
 #include "tensorflow/core/lib/core/errors.h"
@@ -25,9 +31,6 @@ namespace ml_metadata {
 
 namespace {
 
-// Default maximum number of returned resources for List operation.
-constexpr int kDefaultMaxListOperationResultSize = 100;
-
 // Helper method to map Proto ListOperationOptions::OrderByField::Field to
 // Database column name.
 tensorflow::Status GetDbColumnNameForProtoField(
@@ -52,6 +55,82 @@ tensorflow::Status GetDbColumnNameForProtoField(
 
   return tensorflow::Status::OK();
 }
+
+// Helper method to map Proto PropertyPredicate::Operator to SQL operator.
+tensorflow::Status GetSqlOperatorForPropertyPredicate(
+    const ListOperationOptions::Filter::PropertyPredicate::Operator op,
+    std::string& sql_operator) {
+  switch (op) {
+    case ListOperationOptions::Filter::PropertyPredicate::EQ:
+      sql_operator = "=";
+      break;
+    case ListOperationOptions::Filter::PropertyPredicate::NE:
+      sql_operator = "<>";
+      break;
+    case ListOperationOptions::Filter::PropertyPredicate::LT:
+      sql_operator = "<";
+      break;
+    case ListOperationOptions::Filter::PropertyPredicate::LE:
+      sql_operator = "<=";
+      break;
+    case ListOperationOptions::Filter::PropertyPredicate::GT:
+      sql_operator = ">";
+      break;
+    case ListOperationOptions::Filter::PropertyPredicate::GE:
+      sql_operator = ">=";
+      break;
+    default:
+      return tensorflow::errors::InvalidArgument(absl::StrCat(
+          "Unsupported operator: ",
+          ListOperationOptions::Filter::PropertyPredicate::Operator_Name(op),
+          " specified in ListOperationOptions"));
+  }
+  return tensorflow::Status::OK();
+}
+
+// Generates the predicate of a property of the nodes, which selects the ids of
+// the nodes with a matching property from |property_table|. The property name
+// and value are appended to |parameters| in the order of their placeholders.
+tensorflow::Status GetPropertyPredicate(
+    const ListOperationOptions::Filter::PropertyPredicate& predicate,
+    const absl::string_view property_table, const absl::string_view id_column,
+    std::string& sql_predicate, std::vector<QueryParameter>& parameters) {
+  if (predicate.name().empty()) {
+    return tensorflow::errors::InvalidArgument(
+        "The property name of a predicate is not set in ListOperationOptions");
+  }
+  std::string sql_operator;
+  TF_RETURN_IF_ERROR(
+      GetSqlOperatorForPropertyPredicate(predicate.op(), sql_operator));
+  absl::string_view value_column;
+  QueryParameter value;
+  switch (predicate.value().value_case()) {
+    case Value::kIntValue:
+      value_column = "int_value";
+      value = static_cast<int64>(predicate.value().int_value());
+      break;
+    case Value::kDoubleValue:
+      value_column = "double_value";
+      value = predicate.value().double_value();
+      break;
+    case Value::kStringValue:
+      value_column = "string_value";
+      value = predicate.value().string_value();
+      break;
+    default:
+      return tensorflow::errors::InvalidArgument(absl::StrCat(
+          "The value of the predicate of property ", predicate.name(),
+          " is not set in ListOperationOptions"));
+  }
+  sql_predicate = absl::Substitute(
+      "`id` IN (SELECT `$0` FROM `$1` WHERE `name` = ? AND "
+      "`is_custom_property` = $2 AND `$3` $4 ?)",
+      id_column, property_table, predicate.is_custom_property() ? 1 : 0,
+      value_column, sql_operator);
+  parameters.push_back(predicate.name());
+  parameters.push_back(std::move(value));
+  return tensorflow::Status::OK();
+}
 }  // namespace
 
 tensorflow::Status AppendOrderingThresholdClause(
@@ -77,6 +156,99 @@ tensorflow::Status AppendOrderingThresholdClause(
   return tensorflow::Status::OK();
 }
 
+tensorflow::Status AppendFilterClause(
+    const ListOperationOptions& options, const TypeKind type_kind,
+    std::string& sql_query_clause, std::vector<QueryParameter>& parameters) {
+  if (!options.has_filter()) return tensorflow::Status::OK();
+  const ListOperationOptions::Filter& filter = options.filter();
+  std::vector<std::string> predicates;
+  if (filter.has_type_id()) {
+    predicates.push_back(absl::StrCat("`type_id` = ", filter.type_id()));
+  }
+  if (filter.has_type_name()) {
+    predicates.push_back(absl::StrCat(
+        "`type_id` IN (SELECT `id` FROM `Type` WHERE `name` = ? AND "
+        "`type_kind` = ",
+        static_cast<int>(type_kind), ")"));
+    parameters.push_back(filter.type_name());
+  }
+  if (!filter.artifact_states().empty()) {
+    if (type_kind != TypeKind::ARTIFACT_TYPE) {
+      return tensorflow::errors::InvalidArgument(
+          "artifact_states can only be specified in ListOperationOptions to "
+          "list artifacts");
+    }
+    predicates.push_back(absl::StrCat(
+        "`state` IN (", absl::StrJoin(filter.artifact_states(), ", "), ")"));
+  }
+  if (!filter.execution_states().empty()) {
+    if (type_kind != TypeKind::EXECUTION_TYPE) {
+      return tensorflow::errors::InvalidArgument(
+          "execution_states can only be specified in ListOperationOptions to "
+          "list executions");
+    }
+    predicates.push_back(
+        absl::StrCat("`last_known_state` IN (",
+                     absl::StrJoin(filter.execution_states(), ", "), ")"));
+  }
+  if (filter.has_min_create_time_since_epoch()) {
+    predicates.push_back(absl::StrCat("`create_time_since_epoch` >= ",
+                                      filter.min_create_time_since_epoch()));
+  }
+  if (filter.has_max_create_time_since_epoch()) {
+    predicates.push_back(absl::StrCat("`create_time_since_epoch` < ",
+                                      filter.max_create_time_since_epoch()));
+  }
+  if (filter.has_min_last_update_time_since_epoch()) {
+    predicates.push_back(
+        absl::StrCat("`last_update_time_since_epoch` >= ",
+                     filter.min_last_update_time_since_epoch()));
+  }
+  if (filter.has_max_last_update_time_since_epoch()) {
+    predicates.push_back(
+        absl::StrCat("`last_update_time_since_epoch` < ",
+                     filter.max_last_update_time_since_epoch()));
+  }
+  if (!filter.name_prefix().empty()) {
+    // SUBSTR counts the characters, instead of the bytes, of UTF-8 strings.
+    const int64 num_characters = std::count_if(
+        filter.name_prefix().begin(), filter.name_prefix().end(),
+        [](const char c) { return (c & 0xC0) != 0x80; });
+    predicates.push_back(
+        absl::StrCat("SUBSTR(`name`, 1, ", num_characters, ") = ?"));
+    parameters.push_back(filter.name_prefix());
+  }
+  absl::string_view property_table, id_column;
+  switch (type_kind) {
+    case TypeKind::ARTIFACT_TYPE:
+      property_table = "ArtifactProperty";
+      id_column = "artifact_id";
+      break;
+    case TypeKind::EXECUTION_TYPE:
+      property_table = "ExecutionProperty";
+      id_column = "execution_id";
+      break;
+    case TypeKind::CONTEXT_TYPE:
+      property_table = "ContextProperty";
+      id_column = "context_id";
+      break;
+  }
+  for (const ListOperationOptions::Filter::PropertyPredicate& predicate :
+       filter.property_predicates()) {
+    std::string sql_predicate;
+    TF_RETURN_IF_ERROR(GetPropertyPredicate(predicate, property_table,
+                                            id_column, sql_predicate,
+                                            parameters));
+    predicates.push_back(sql_predicate);
+  }
+
+  if (!predicates.empty()) {
+    absl::StrAppend(&sql_query_clause, " AND ",
+                    absl::StrJoin(predicates, " AND "), " ");
+  }
+  return tensorflow::Status::OK();
+}
+
 tensorflow::Status AppendOrderByClause(const ListOperationOptions& options,
                                        std::string& sql_query_clause) {
   const std::string ordering_direction =
@@ -108,7 +280,7 @@ tensorflow::Status AppendLimitClause(const ListOperationOptions& options,
   }
 
   const int max_result_size =
-      std::min(options.max_result_size(), kDefaultMaxListOperationResultSize);
+      std::min(options.max_result_size(), kMaxListOperationResultSize);
   absl::SubstituteAndAppend(&sql_query_clause, " LIMIT $0 ", max_result_size);
   return tensorflow::Status::OK();
 }
@@ -15,6 +15,11 @@ limitations under the License.
 #ifndef THIRD_PARTY_ML_METADATA_METADATA_STORE_LIST_OPERATION_QUERY_HELPER_H_
 #define THIRD_PARTY_ML_METADATA_METADATA_STORE_LIST_OPERATION_QUERY_HELPER_H_
 
+#include <string>
+#include <vector>
+
+#include "ml_metadata/metadata_store/constants.h"
+#include "ml_metadata/metadata_store/metadata_source.h"
 #include "ml_metadata/metadata_store/types.h"
 #include "ml_metadata/proto/metadata_store.pb.h"
 #include "tensorflow/core/lib/core/errors.h"
@@ -49,6 +54,35 @@ tensorflow::Status AppendOrderingThresholdClause(
     const ListOperationOptions& options, int64 id_offset, int64 field_offset,
     std::string& sql_query_clause);
 
+// Generates the filter predicates for ListOperation.
+// On success `sql_query_clause` is appended with an AND predicate for each
+// field set in the filter of |options|, on the table of the nodes whose types
+// are of |type_kind|. The names and property values of the filter are not
+// inlined: they have `?` placeholders, and are appended to `parameters` in
+// the order of the placeholders, to be bound by
+// MetadataSource::ExecuteUncachedQuery.
+// NOTE: The predicates are appended to a clause which is not empty, e.g., the
+// one generated by AppendOrderingThresholdClause.
+// Returns INVALID_ARGUMENT error if the filter specified is invalid for the
+// nodes, e.g., it has execution states and artifacts are listed.
+// For example, given a ListOperationOptions message:
+// {
+//    max_result_size: 1,
+//    filter: {
+//      type_id: 1,
+//      execution_states: [RUNNING],
+//      name_prefix: "run"
+//    }
+// }
+// and |type_kind| EXECUTION_TYPE, appends
+// " AND `type_id` = 1 AND `last_known_state` IN (2) AND
+// SUBSTR(`name`, 1, 3) = ? " at the end of `sql_query_clause`, and "run" to
+// `parameters`.
+tensorflow::Status AppendFilterClause(const ListOperationOptions& options,
+                                      TypeKind type_kind,
+                                      std::string& sql_query_clause,
+                                      std::vector<QueryParameter>& parameters);
+
 // Generates the ORDER BY clause for ListOperation.
 // On success `sql_query_clause` is appended with the constructed ORDER BY
 // clause based on |options|.
@@ -14,8 +14,13 @@ limitations under the License.
 ==============================================================================*/
 #include "ml_metadata/metadata_store/list_operation_query_helper.h"
 
+#include <string>
+#include <vector>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/types/variant.h"
+#include "ml_metadata/metadata_store/metadata_source.h"
 #include "ml_metadata/metadata_store/test_util.h"
 #include "ml_metadata/proto/metadata_store.pb.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
@@ -23,6 +28,8 @@ limitations under the License.
 namespace ml_metadata {
 namespace {
 
+using ::testing::IsEmpty;
+
 ListOperationOptions BasicListOperationOptionsDesc() {
   return testing::ParseTextProtoOrDie<ListOperationOptions>(R"pb(
     max_result_size: 1,
@@ -67,6 +74,84 @@ TEST(ListOperationQueryHelperTest, OrderingWhereClauseById) {
   EXPECT_EQ(where_clause, " `id` < 100 ");
 }
 
+TEST(ListOperationQueryHelperTest, FilterClause) {
+  const ListOperationOptions options =
+      testing::ParseTextProtoOrDie<ListOperationOptions>(R"pb(
+        max_result_size: 1,
+        filter: {
+          type_name: 'pipeline\'s run'
+          execution_states: [ RUNNING, NEW ]
+          min_create_time_since_epoch: 100
+          max_last_update_time_since_epoch: 200
+          name_prefix: 'r\303\251'
+          property_predicates: {
+            name: 'p'
+            op: GE
+            value: { int_value: 3 }
+          }
+          property_predicates: {
+            name: 'q'
+            is_custom_property: true
+            op: EQ
+            value: { string_value: 'it\'s' }
+          }
+        }
+      )pb");
+  std::string where_clause;
+  std::vector<QueryParameter> parameters;
+  TF_ASSERT_OK(AppendFilterClause(options, TypeKind::EXECUTION_TYPE,
+                                  where_clause, parameters));
+  EXPECT_EQ(where_clause,
+            " AND `type_id` IN (SELECT `id` FROM `Type` WHERE "
+            "`name` = ? AND `type_kind` = 0) AND "
+            "`last_known_state` IN (2, 1) AND "
+            "`create_time_since_epoch` >= 100 AND "
+            "`last_update_time_since_epoch` < 200 AND "
+            "SUBSTR(`name`, 1, 2) = ? AND "
+            "`id` IN (SELECT `execution_id` FROM `ExecutionProperty` WHERE "
+            "`name` = ? AND `is_custom_property` = 0 AND `int_value` >= ?) "
+            "AND `id` IN (SELECT `execution_id` FROM `ExecutionProperty` WHERE "
+            "`name` = ? AND `is_custom_property` = 1 AND "
+            "`string_value` = ?) ");
+  // The strings are bound as they are, without escaping.
+  ASSERT_EQ(parameters.size(), 6);
+  EXPECT_EQ(absl::get<std::string>(parameters[0]), "pipeline's run");
+  EXPECT_EQ(absl::get<std::string>(parameters[1]), "r\303\251");
+  EXPECT_EQ(absl::get<std::string>(parameters[2]), "p");
+  EXPECT_EQ(absl::get<int64>(parameters[3]), 3);
+  EXPECT_EQ(absl::get<std::string>(parameters[4]), "q");
+  EXPECT_EQ(absl::get<std::string>(parameters[5]), "it's");
+}
+
+TEST(ListOperationQueryHelperTest, EmptyFilterClause) {
+  const ListOperationOptions options = BasicListOperationOptionsDesc();
+  std::string where_clause;
+  std::vector<QueryParameter> parameters;
+  TF_ASSERT_OK(AppendFilterClause(options, TypeKind::ARTIFACT_TYPE,
+                                  where_clause, parameters));
+  EXPECT_EQ(where_clause, "");
+  EXPECT_THAT(parameters, IsEmpty());
+}
+
+TEST(ListOperationQueryHelperTest, InvalidFilterClause) {
+  for (const char* filter :
+       {"execution_states: [ RUNNING ]",
+        "property_predicates: { name: 'p' value: { int_value: 1 } }",
+        "property_predicates: { name: 'p' op: EQ }",
+        "property_predicates: { op: EQ value: { int_value: 1 } }"}) {
+    ListOperationOptions options = BasicListOperationOptionsDesc();
+    *options.mutable_filter() =
+        testing::ParseTextProtoOrDie<ListOperationOptions::Filter>(filter);
+    std::string where_clause;
+    std::vector<QueryParameter> parameters;
+    EXPECT_EQ(AppendFilterClause(options, TypeKind::ARTIFACT_TYPE,
+                                 where_clause, parameters)
+                  .code(),
+              tensorflow::error::INVALID_ARGUMENT)
+        << filter;
+  }
+}
+
 TEST(ListOperationQueryHelperTest, OrderByClauseDesc) {
   const ListOperationOptions options = BasicListOperationOptionsDesc();
   std::string order_by_clause;
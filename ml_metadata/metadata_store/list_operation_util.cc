@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "ml_metadata/metadata_store/list_operation_util.h"
 
+#include "google/protobuf/util/message_differencer.h"
 #include "absl/strings/escaping.h"
 
 namespace ml_metadata {
@@ -51,7 +52,9 @@ tensorflow::Status ValidateListOperationOptionsAreIdentical(
   if (previous_options.order_by_field().is_asc() ==
           current_options.order_by_field().is_asc() &&
       previous_options.order_by_field().field() ==
-          current_options.order_by_field().field()) {
+          current_options.order_by_field().field() &&
+      google::protobuf::util::MessageDifferencer::Equals(
+          previous_options.filter(), current_options.filter())) {
     return tensorflow::Status::OK();
   }
 
@@ -68,7 +68,8 @@ tensorflow::Status BuildListOperationNextPageToken(
 // Ensures that ListOperationOptions have not changed between
 // calls. |previous_options| represents options used in the previous call and
 // |current_options| represents options used in the current call.
-// Validation only validates order_by_fields in ListOperationOptions.
+// Validation only validates order_by_fields and filter in
+// ListOperationOptions.
 tensorflow::Status ValidateListOperationOptionsAreIdentical(
     const ListOperationOptions& previous_options,
     const ListOperationOptions& current_options);
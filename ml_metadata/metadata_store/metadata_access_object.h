@@ -119,6 +119,21 @@ class MetadataAccessObject {
   virtual tensorflow::Status FindTypeById(int64 type_id,
                                           ContextType* context_type) = 0;
 
+  // Queries types by a collection of ids. A type is one of
+  // {ArtifactType, ExecutionType, ContextType}
+  // The found types are appended in the order of `type_ids`, and the ids that
+  // cannot be found are skipped.
+  // Returns detailed INTERNAL error, if query execution fails.
+  virtual tensorflow::Status FindTypesByIds(
+      const std::vector<int64>& type_ids,
+      std::vector<ArtifactType>* artifact_types) = 0;
+  virtual tensorflow::Status FindTypesByIds(
+      const std::vector<int64>& type_ids,
+      std::vector<ExecutionType>* execution_types) = 0;
+  virtual tensorflow::Status FindTypesByIds(
+      const std::vector<int64>& type_ids,
+      std::vector<ContextType>* context_types) = 0;
+
   // Queries a type by its name. A type is one of
   // {ArtifactType, ExecutionType, ContextType}
   // Returns NOT_FOUND error, if the given name cannot be found.
@@ -153,12 +168,28 @@ class MetadataAccessObject {
   virtual tensorflow::Status CreateArtifact(const Artifact& artifact,
                                             int64* artifact_id) = 0;
 
+  // Creates a collection of artifacts together, returns the assigned artifact
+  // ids in the order of `artifacts`. It is faster than creating the artifacts
+  // one by one. The id fields of the artifacts are ignored.
+  // Returns the same errors as CreateArtifact, if any artifact is invalid.
+  virtual tensorflow::Status CreateArtifacts(
+      const std::vector<Artifact>& artifacts,
+      std::vector<int64>* artifact_ids) = 0;
+
   // Queries an artifact by an id.
   // Returns NOT_FOUND error, if the given artifact_id cannot be found.
   // Returns detailed INTERNAL error, if query execution fails.
   virtual tensorflow::Status FindArtifactById(int64 artifact_id,
                                               Artifact* artifact) = 0;
 
+  // Queries artifacts by a collection of ids, with a few queries in total.
+  // The artifacts are returned in the order of `artifact_ids`, once per id.
+  // Returns NOT_FOUND error, if any of the given artifact_ids cannot be found.
+  // Returns detailed INTERNAL error, if query execution fails.
+  virtual tensorflow::Status FindArtifactsById(
+      const std::vector<int64>& artifact_ids,
+      std::vector<Artifact>* artifacts) = 0;
+
   // Queries artifacts stored in the metadata source
   // Returns detailed INTERNAL error, if query execution fails.
   virtual tensorflow::Status FindArtifacts(
@@ -255,12 +286,29 @@ class MetadataAccessObject {
   virtual tensorflow::Status CreateExecution(const Execution& execution,
                                              int64* execution_id) = 0;
 
+  // Creates a collection of executions together, returns the assigned
+  // execution ids in the order of `executions`. It is faster than creating the
+  // executions one by one. The id fields of the executions are ignored.
+  // Returns the same errors as CreateExecution, if any execution is invalid.
+  virtual tensorflow::Status CreateExecutions(
+      const std::vector<Execution>& executions,
+      std::vector<int64>* execution_ids) = 0;
+
   // Queries an entity by an id.
   // Returns NOT_FOUND error, if the given execution_id cannot be found.
   // Returns detailed INTERNAL error, if query execution fails.
   virtual tensorflow::Status FindExecutionById(int64 execution_id,
                                                Execution* execution) = 0;
 
+  // Queries executions by a collection of ids, with a few queries in total.
+  // The executions are returned in the order of `execution_ids`, once per id.
+  // Returns NOT_FOUND error, if any of the given execution_ids cannot be
+  // found.
+  // Returns detailed INTERNAL error, if query execution fails.
+  virtual tensorflow::Status FindExecutionsById(
+      const std::vector<int64>& execution_ids,
+      std::vector<Execution>* executions) = 0;
+
   // Queries executions stored in the metadata source
   // Returns detailed INTERNAL error, if query execution fails.
   virtual tensorflow::Status FindExecutions(
@@ -304,6 +352,15 @@ class MetadataAccessObject {
   virtual tensorflow::Status CreateContext(const Context& context,
                                            int64* context_id) = 0;
 
+  // Creates a collection of contexts together, returns the assigned context
+  // ids in the order of `contexts`. It is faster than creating the contexts
+  // one by one. The id fields of the contexts are ignored.
+  // Returns the same errors as CreateContext, if any context is invalid or
+  //   has the name of another context of its type, including the given ones.
+  virtual tensorflow::Status CreateContexts(
+      const std::vector<Context>& contexts,
+      std::vector<int64>* context_ids) = 0;
+
   // Queries a context by an id.
   // Returns NOT_FOUND error, if the given context_id cannot be found.
   // Returns detailed INTERNAL error, if query execution fails.
@@ -345,6 +402,13 @@ class MetadataAccessObject {
   virtual tensorflow::Status CreateEvent(const Event& event,
                                          int64* event_id) = 0;
 
+  // Creates a collection of events together, returns the assigned event ids
+  // in the order of `events`. The artifacts and executions are checked, and
+  // the events and their paths are written, with a few queries in total.
+  // Returns the same errors as CreateEvent, if any event is invalid.
+  virtual tensorflow::Status CreateEvents(const std::vector<Event>& events,
+                                          std::vector<int64>* event_ids) = 0;
+
   // Queries the events associated with a collection of artifact_ids.
   // Returns INVALID_ARGUMENT error, if the `events` is null.
   virtual tensorflow::Status FindEventsByArtifacts(
@@ -355,6 +419,28 @@ class MetadataAccessObject {
   virtual tensorflow::Status FindEventsByExecutions(
       const std::vector<int64>& execution_ids, std::vector<Event>* events) = 0;
 
+  // Queries the events with ids in (min_event_id, max_event_id], in the order
+  // of ids, without their paths, e.g., to index the lineage graph. The ids of
+  // the events are returned in `event_ids`, index-aligned with `events`.
+  // Returns INVALID_ARGUMENT error, if the `event_ids` or `events` is null.
+  // Returns detailed INTERNAL error, if query execution fails.
+  virtual tensorflow::Status FindEventsByIdRange(
+      int64 min_event_id, int64 max_event_id, std::vector<int64>* event_ids,
+      std::vector<Event>* events) = 0;
+
+  // Queries the events with the `event_ids`, with their paths, e.g., to read
+  // the events of the edges of a lineage index. The `events` are
+  // index-aligned with the `event_ids`.
+  // Returns INVALID_ARGUMENT error, if the `events` is null.
+  // Returns NOT_FOUND error, if an event cannot be found.
+  // Returns detailed INTERNAL error, if query execution fails.
+  virtual tensorflow::Status FindEventsById(
+      const std::vector<int64>& event_ids, std::vector<Event>* events) = 0;
+
+  // Queries the largest event id, or 0 if there is no event.
+  // Returns detailed INTERNAL error, if query execution fails.
+  virtual tensorflow::Status FindMaxEventId(int64* max_event_id) = 0;
+
   // Creates an association, returns the assigned association id.
   // Returns INVALID_ARGUMENT error, if no context matches the context_id.
   // Returns INVALID_ARGUMENT error, if no execution matches the execution_id.
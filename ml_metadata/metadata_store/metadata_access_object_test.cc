@@ -20,6 +20,7 @@ limitations under the License.
 #include "google/protobuf/repeated_field.h"
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/strings/str_cat.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "ml_metadata/metadata_store/test_util.h"
@@ -175,6 +176,8 @@ QueryConfigMetadataAccessObjectContainer::SetDatabaseVersionIncompatible() {
 namespace {
 
 using ::ml_metadata::testing::ParseTextProtoOrDie;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
 using ::testing::UnorderedElementsAre;
 
 TEST_P(MetadataAccessObjectTest, InitMetadataSourceCheckSchemaVersion) {
@@ -185,6 +188,19 @@ TEST_P(MetadataAccessObjectTest, InitMetadataSourceCheckSchemaVersion) {
   EXPECT_EQ(schema_version, local_schema_version);
 }
 
+TEST_P(MetadataAccessObjectTest, InitMetadataSourceCreatesSecondaryIndices) {
+  TF_ASSERT_OK(Init());
+  // A new database has the same indices as an upgraded one, which are checked
+  // by the verification of the upgrade to the library version.
+  int64 lib_version = metadata_access_object_->GetLibraryVersion();
+  if (!metadata_access_object_container_->HasUpgradeVerification(
+          lib_version)) {
+    return;
+  }
+  TF_EXPECT_OK(
+      metadata_access_object_container_->UpgradeVerification(lib_version));
+}
+
 TEST_P(MetadataAccessObjectTest, InitMetadataSourceIfNotExists) {
   // creates the schema and insert some records
   TF_EXPECT_OK(metadata_access_object_->InitMetadataSourceIfNotExists());
@@ -646,6 +662,41 @@ TEST_P(MetadataAccessObjectTest, FindAllArtifactTypes) {
                                               EqualsProto(want_type_3)));
 }
 
+TEST_P(MetadataAccessObjectTest, FindTypesByIds) {
+  TF_ASSERT_OK(Init());
+  ArtifactType want_type_1 = ParseTextProtoOrDie<ArtifactType>(R"(
+    name: 'test_type_1'
+    properties { key: 'property_1' value: INT }
+    properties { key: 'property_2' value: STRING }
+  )");
+  int64 type_id;
+  TF_ASSERT_OK(metadata_access_object_->CreateType(want_type_1, &type_id));
+  want_type_1.set_id(type_id);
+
+  ArtifactType want_type_2 = ParseTextProtoOrDie<ArtifactType>(R"(
+    name: 'test_type_2'
+    properties { key: 'property_3' value: DOUBLE }
+  )");
+  TF_ASSERT_OK(metadata_access_object_->CreateType(want_type_2, &type_id));
+  want_type_2.set_id(type_id);
+
+  // A type of another kind is not returned.
+  ExecutionType execution_type = ParseTextProtoOrDie<ExecutionType>(R"(
+    name: 'test_type_3'
+  )");
+  int64 execution_type_id;
+  TF_ASSERT_OK(
+      metadata_access_object_->CreateType(execution_type, &execution_type_id));
+
+  const int64 unknown_type_id = want_type_2.id() + 100;
+  std::vector<ArtifactType> got_types;
+  TF_EXPECT_OK(metadata_access_object_->FindTypesByIds(
+      {want_type_2.id(), unknown_type_id, execution_type_id, want_type_1.id()},
+      &got_types));
+  EXPECT_THAT(got_types,
+              ElementsAre(EqualsProto(want_type_2), EqualsProto(want_type_1)));
+}
+
 TEST_P(MetadataAccessObjectTest, FindAllExecutionTypes) {
   TF_ASSERT_OK(Init());
   ExecutionType want_type_1 = ParseTextProtoOrDie<ExecutionType>(R"(
@@ -919,6 +970,98 @@ TEST_P(MetadataAccessObjectTest, FindAllArtifacts) {
                                               "last_update_time_since_epoch"}));
 }
 
+TEST_P(MetadataAccessObjectTest, FindArtifactsByTypeIdWithProperties) {
+  TF_ASSERT_OK(Init());
+  const ArtifactType type = ParseTextProtoOrDie<ArtifactType>(R"(
+    name: 'test_type'
+    properties { key: 'property_1' value: INT }
+  )");
+  int64 type_id;
+  TF_ASSERT_OK(metadata_access_object_->CreateType(type, &type_id));
+
+  std::vector<Artifact> want_artifacts(5);
+  for (int i = 0; i < want_artifacts.size(); i++) {
+    Artifact& artifact = want_artifacts[i];
+    artifact.set_type_id(type_id);
+    artifact.set_uri(absl::StrCat("uri_", i));
+    (*artifact.mutable_properties())["property_1"].set_int_value(i);
+    // Only some of the artifacts have custom properties.
+    if (i % 2 == 0) {
+      (*artifact.mutable_custom_properties())["custom"].set_string_value(
+          absl::StrCat("custom_", i));
+    }
+    int64 artifact_id;
+    TF_ASSERT_OK(
+        metadata_access_object_->CreateArtifact(artifact, &artifact_id));
+    artifact.set_id(artifact_id);
+  }
+
+  std::vector<Artifact> got_artifacts;
+  TF_ASSERT_OK(
+      metadata_access_object_->FindArtifactsByTypeId(type_id, &got_artifacts));
+  ASSERT_EQ(got_artifacts.size(), want_artifacts.size());
+  for (int i = 0; i < want_artifacts.size(); i++) {
+    EXPECT_THAT(want_artifacts[i],
+                EqualsProto(got_artifacts[i], /*ignore_fields=*/{
+                                "create_time_since_epoch",
+                                "last_update_time_since_epoch"}));
+  }
+}
+
+TEST_P(MetadataAccessObjectTest, CreateArtifacts) {
+  TF_ASSERT_OK(Init());
+  const ArtifactType type = ParseTextProtoOrDie<ArtifactType>(R"(
+    name: 'test_type'
+    properties { key: 'property_1' value: INT }
+    properties { key: 'property_2' value: DOUBLE }
+    properties { key: 'property_3' value: STRING }
+  )");
+  int64 type_id;
+  TF_ASSERT_OK(metadata_access_object_->CreateType(type, &type_id));
+  // The artifacts are created after an existing one.
+  int64 existing_artifact_id;
+  Artifact existing_artifact;
+  existing_artifact.set_type_id(type_id);
+  TF_ASSERT_OK(metadata_access_object_->CreateArtifact(existing_artifact,
+                                                       &existing_artifact_id));
+
+  std::vector<Artifact> want_artifacts(5);
+  for (int i = 0; i < want_artifacts.size(); i++) {
+    Artifact& artifact = want_artifacts[i];
+    artifact.set_type_id(type_id);
+    artifact.set_uri(absl::StrCat("uri_'", i));
+    // Only some of the artifacts have a name, a state and properties.
+    if (i % 2 == 0) {
+      artifact.set_name(absl::StrCat("artifact_", i));
+      artifact.set_state(Artifact::LIVE);
+      (*artifact.mutable_properties())["property_1"].set_int_value(i);
+      (*artifact.mutable_properties())["property_2"].set_double_value(i + 0.5);
+      (*artifact.mutable_custom_properties())["custom"].set_string_value(
+          absl::StrCat("custom_", i));
+    } else {
+      (*artifact.mutable_properties())["property_3"].set_string_value("'3'");
+    }
+  }
+  std::vector<int64> artifact_ids;
+  TF_ASSERT_OK(
+      metadata_access_object_->CreateArtifacts(want_artifacts, &artifact_ids));
+  ASSERT_EQ(artifact_ids.size(), want_artifacts.size());
+  for (int i = 0; i < want_artifacts.size(); i++) {
+    EXPECT_EQ(artifact_ids[i], existing_artifact_id + i + 1);
+    want_artifacts[i].set_id(artifact_ids[i]);
+  }
+
+  for (const Artifact& want_artifact : want_artifacts) {
+    Artifact got_artifact;
+    TF_ASSERT_OK(metadata_access_object_->FindArtifactById(want_artifact.id(),
+                                                           &got_artifact));
+    EXPECT_THAT(got_artifact,
+                EqualsProto(want_artifact, /*ignore_fields=*/{
+                                "create_time_since_epoch",
+                                "last_update_time_since_epoch"}));
+  }
+}
+
 TEST_P(MetadataAccessObjectTest, ListArtifactsInvalidPageSize) {
   TF_ASSERT_OK(Init());
   const ListOperationOptions list_options =
@@ -1297,6 +1440,82 @@ TEST_P(MetadataAccessObjectTest, ListExecutionsWithIdFieldOptions) {
   EXPECT_EQ(stored_executions_count, seen_executions_count);
 }
 
+TEST_P(MetadataAccessObjectTest, ListExecutionsWithFilter) {
+  TF_ASSERT_OK(Init());
+  ExecutionType type = ParseTextProtoOrDie<ExecutionType>(R"(
+    name: 'test_type'
+    properties { key: 'property_1' value: INT }
+  )");
+  int64 type_id;
+  TF_ASSERT_OK(metadata_access_object_->CreateType(type, &type_id));
+  int64 other_type_id;
+  TF_ASSERT_OK(metadata_access_object_->CreateType(
+      ParseTextProtoOrDie<ExecutionType>("name: 'other_type'"),
+      &other_type_id));
+
+  // Only the executions of test_type, which are RUNNING and whose property_1
+  // is at least 2 match the filter.
+  std::vector<int64> want_execution_ids;
+  for (int i = 0; i < 8; i++) {
+    Execution execution;
+    execution.set_type_id(i == 7 ? other_type_id : type_id);
+    execution.set_name(absl::StrCat("run_", i));
+    execution.set_last_known_state(i % 2 == 0 ? Execution::RUNNING
+                                              : Execution::COMPLETE);
+    if (i != 7) {
+      (*execution.mutable_properties())["property_1"].set_int_value(i);
+    }
+    int64 execution_id;
+    TF_ASSERT_OK(
+        metadata_access_object_->CreateExecution(execution, &execution_id));
+    if (i != 7 && i % 2 == 0 && i >= 2) {
+      want_execution_ids.push_back(execution_id);
+    }
+  }
+
+  ListOperationOptions list_options =
+      ParseTextProtoOrDie<ListOperationOptions>(R"(
+        max_result_size: 1,
+        order_by_field: { field: ID is_asc: true }
+        filter: {
+          type_name: 'test_type'
+          execution_states: [ RUNNING ]
+          name_prefix: 'run_'
+          property_predicates: {
+            name: 'property_1'
+            op: GE
+            value: { int_value: 2 }
+          }
+        }
+      )");
+  std::string next_page_token;
+  std::vector<int64> got_execution_ids;
+  do {
+    std::vector<Execution> got_executions;
+    TF_ASSERT_OK(metadata_access_object_->ListExecutions(
+        list_options, &got_executions, &next_page_token));
+    EXPECT_LE(got_executions.size(), 1);
+    for (const Execution& execution : got_executions) {
+      got_execution_ids.push_back(execution.id());
+    }
+    list_options.set_next_page_token(next_page_token);
+  } while (!next_page_token.empty());
+  EXPECT_EQ(got_execution_ids, want_execution_ids);
+
+  // The filter cannot change between the pages.
+  list_options.clear_next_page_token();
+  std::vector<Execution> got_executions;
+  TF_ASSERT_OK(metadata_access_object_->ListExecutions(
+      list_options, &got_executions, &next_page_token));
+  list_options.set_next_page_token(next_page_token);
+  list_options.mutable_filter()->clear_execution_states();
+  EXPECT_EQ(metadata_access_object_
+                ->ListExecutions(list_options, &got_executions,
+                                 &next_page_token)
+                .code(),
+            tensorflow::error::INVALID_ARGUMENT);
+}
+
 TEST_P(MetadataAccessObjectTest, ListContextsWithNonIdFieldOptions) {
   TF_ASSERT_OK(Init());
   ContextType type = ParseTextProtoOrDie<ContextType>(R"(
@@ -2079,6 +2298,43 @@ TEST_P(MetadataAccessObjectTest, CreateContextError2) {
   TF_ASSERT_OK(metadata_source_->Begin());
 }
 
+TEST_P(MetadataAccessObjectTest, CreateContextsError) {
+  TF_ASSERT_OK(Init());
+  ContextType type = ParseTextProtoOrDie<ContextType>(R"(
+    name: 'test_type'
+    properties { key: 'property_1' value: INT }
+  )");
+  int64 type_id;
+  TF_ASSERT_OK(metadata_access_object_->CreateType(type, &type_id));
+  std::vector<Context> contexts(2);
+  contexts[0].set_type_id(type_id);
+  contexts[0].set_name("context_1");
+  contexts[1].set_type_id(type_id);
+  std::vector<int64> context_ids;
+
+  // empty name
+  EXPECT_EQ(
+      metadata_access_object_->CreateContexts(contexts, &context_ids).code(),
+      tensorflow::error::INVALID_ARGUMENT);
+
+  // type mismatch
+  contexts[1].set_name("context_2");
+  (*contexts[1].mutable_properties())["property_1"].set_string_value("3");
+  EXPECT_EQ(
+      metadata_access_object_->CreateContexts(contexts, &context_ids).code(),
+      tensorflow::error::INVALID_ARGUMENT);
+
+  // duplicated name
+  (*contexts[1].mutable_properties())["property_1"].set_int_value(3);
+  contexts[1].set_name("context_1");
+  EXPECT_EQ(
+      metadata_access_object_->CreateContexts(contexts, &context_ids).code(),
+      tensorflow::error::ALREADY_EXISTS);
+
+  TF_ASSERT_OK(metadata_source_->Rollback());
+  TF_ASSERT_OK(metadata_source_->Begin());
+}
+
 TEST_P(MetadataAccessObjectTest, UpdateContext) {
   TF_ASSERT_OK(Init());
   ContextType type = ParseTextProtoOrDie<ContextType>(R"(
@@ -2490,6 +2746,150 @@ TEST_P(MetadataAccessObjectTest, PutEventsWithPaths) {
   EXPECT_EQ(events_with_execution.size(), 2);
 }
 
+TEST_P(MetadataAccessObjectTest, CreateEvents) {
+  TF_ASSERT_OK(Init());
+  int64 artifact_type_id = InsertType<ArtifactType>("test_artifact_type");
+  int64 execution_type_id = InsertType<ExecutionType>("test_execution_type");
+  Artifact artifact;
+  artifact.set_type_id(artifact_type_id);
+  int64 artifact_id;
+  TF_ASSERT_OK(metadata_access_object_->CreateArtifact(artifact, &artifact_id));
+  Execution execution;
+  execution.set_type_id(execution_type_id);
+  int64 execution_id;
+  TF_ASSERT_OK(
+      metadata_access_object_->CreateExecution(execution, &execution_id));
+
+  std::vector<Event> want_events(3);
+  for (int i = 0; i < want_events.size(); i++) {
+    Event& event = want_events[i];
+    event.set_artifact_id(artifact_id);
+    event.set_execution_id(execution_id);
+    event.set_type(i % 2 == 0 ? Event::INPUT : Event::OUTPUT);
+    event.set_milliseconds_since_epoch(12345 + i);
+    // Only some of the events have paths.
+    if (i % 2 == 0) {
+      event.mutable_path()->add_steps()->set_index(i);
+      event.mutable_path()->add_steps()->set_key(absl::StrCat("key_'", i));
+    }
+  }
+  std::vector<int64> event_ids;
+  TF_ASSERT_OK(metadata_access_object_->CreateEvents(want_events, &event_ids));
+  ASSERT_EQ(event_ids.size(), want_events.size());
+  EXPECT_NE(event_ids[0], event_ids[1]);
+
+  std::vector<Event> got_events;
+  TF_ASSERT_OK(metadata_access_object_->FindEventsByExecutions({execution_id},
+                                                               &got_events));
+  EXPECT_THAT(got_events, UnorderedElementsAre(EqualsProto(want_events[0]),
+                                               EqualsProto(want_events[1]),
+                                               EqualsProto(want_events[2])));
+
+  // None of the events is created if an execution does not exist.
+  Event unknown_execution_event = want_events[0];
+  unknown_execution_event.set_execution_id(execution_id + 1);
+  EXPECT_EQ(metadata_access_object_
+                ->CreateEvents({want_events[0], unknown_execution_event},
+                               &event_ids)
+                .code(),
+            tensorflow::error::INVALID_ARGUMENT);
+  std::vector<Event> got_events_after_error;
+  TF_ASSERT_OK(metadata_access_object_->FindEventsByExecutions(
+      {execution_id}, &got_events_after_error));
+  EXPECT_EQ(got_events_after_error.size(), want_events.size());
+}
+
+TEST_P(MetadataAccessObjectTest, FindEventsByIdRange) {
+  TF_ASSERT_OK(Init());
+  int64 max_event_id = -1;
+  TF_ASSERT_OK(metadata_access_object_->FindMaxEventId(&max_event_id));
+  EXPECT_EQ(max_event_id, 0);
+
+  int64 artifact_type_id = InsertType<ArtifactType>("test_artifact_type");
+  int64 execution_type_id = InsertType<ExecutionType>("test_execution_type");
+  Artifact artifact;
+  artifact.set_type_id(artifact_type_id);
+  int64 artifact_id;
+  TF_ASSERT_OK(metadata_access_object_->CreateArtifact(artifact, &artifact_id));
+  Execution execution;
+  execution.set_type_id(execution_type_id);
+  int64 execution_id;
+  TF_ASSERT_OK(
+      metadata_access_object_->CreateExecution(execution, &execution_id));
+
+  std::vector<Event> want_events(4);
+  for (int i = 0; i < want_events.size(); i++) {
+    Event& event = want_events[i];
+    event.set_artifact_id(artifact_id);
+    event.set_execution_id(execution_id);
+    event.set_type(i % 2 == 0 ? Event::INPUT : Event::OUTPUT);
+  }
+  std::vector<int64> want_event_ids;
+  TF_ASSERT_OK(
+      metadata_access_object_->CreateEvents(want_events, &want_event_ids));
+  TF_ASSERT_OK(metadata_access_object_->FindMaxEventId(&max_event_id));
+  EXPECT_EQ(max_event_id, want_event_ids.back());
+
+  // The range excludes its start and includes its end.
+  std::vector<int64> got_event_ids;
+  std::vector<Event> got_events;
+  TF_ASSERT_OK(metadata_access_object_->FindEventsByIdRange(
+      want_event_ids[0], want_event_ids[2], &got_event_ids, &got_events));
+  EXPECT_THAT(got_event_ids, ElementsAre(want_event_ids[1], want_event_ids[2]));
+  ASSERT_EQ(got_events.size(), 2);
+  EXPECT_EQ(got_events[0].artifact_id(), artifact_id);
+  EXPECT_EQ(got_events[0].execution_id(), execution_id);
+  EXPECT_EQ(got_events[0].type(), Event::OUTPUT);
+  EXPECT_EQ(got_events[1].type(), Event::INPUT);
+
+  TF_ASSERT_OK(metadata_access_object_->FindEventsByIdRange(
+      max_event_id, max_event_id + 10, &got_event_ids, &got_events));
+  EXPECT_THAT(got_event_ids, IsEmpty());
+  EXPECT_THAT(got_events, IsEmpty());
+}
+
+TEST_P(MetadataAccessObjectTest, FindEventsById) {
+  TF_ASSERT_OK(Init());
+  int64 artifact_type_id = InsertType<ArtifactType>("test_artifact_type");
+  int64 execution_type_id = InsertType<ExecutionType>("test_execution_type");
+  Artifact artifact;
+  artifact.set_type_id(artifact_type_id);
+  int64 artifact_id;
+  TF_ASSERT_OK(metadata_access_object_->CreateArtifact(artifact, &artifact_id));
+  Execution execution;
+  execution.set_type_id(execution_type_id);
+  int64 execution_id;
+  TF_ASSERT_OK(
+      metadata_access_object_->CreateExecution(execution, &execution_id));
+
+  std::vector<Event> want_events(3);
+  for (int i = 0; i < want_events.size(); i++) {
+    Event& event = want_events[i];
+    event.set_artifact_id(artifact_id);
+    event.set_execution_id(execution_id);
+    event.set_type(i % 2 == 0 ? Event::INPUT : Event::OUTPUT);
+    event.set_milliseconds_since_epoch(12345 + i);
+    event.mutable_path()->add_steps()->set_index(i);
+  }
+  std::vector<int64> want_event_ids;
+  TF_ASSERT_OK(
+      metadata_access_object_->CreateEvents(want_events, &want_event_ids));
+
+  // The events are returned in the order of the given ids, with their paths.
+  std::vector<Event> got_events;
+  TF_ASSERT_OK(metadata_access_object_->FindEventsById(
+      {want_event_ids[2], want_event_ids[0]}, &got_events));
+  EXPECT_THAT(got_events, ElementsAre(EqualsProto(want_events[2]),
+                                      EqualsProto(want_events[0])));
+
+  TF_ASSERT_OK(metadata_access_object_->FindEventsById({}, &got_events));
+  EXPECT_THAT(got_events, IsEmpty());
+  EXPECT_EQ(metadata_access_object_
+                ->FindEventsById({want_event_ids[2] + 1}, &got_events)
+                .code(),
+            tensorflow::error::NOT_FOUND);
+}
+
 TEST_P(MetadataAccessObjectTest, MigrateToCurrentLibVersion) {
   // setup the database using the previous version.
   // Calling this with the minimum version sets up the original database.
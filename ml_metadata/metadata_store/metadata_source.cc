@@ -14,6 +14,11 @@ limitations under the License.
 ==============================================================================*/
 #include "ml_metadata/metadata_store/metadata_source.h"
 
+#include <algorithm>
+
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 
@@ -48,6 +53,125 @@ tensorflow::Status MetadataSource::ExecuteQuery(const std::string& query,
   return ExecuteQueryImpl(query, results);
 }
 
+tensorflow::Status MetadataSource::ExecuteTypedQuery(const std::string& query,
+                                                     TypedRecordSet* results) {
+  if (!is_connected_)
+    return tensorflow::errors::FailedPrecondition(
+        "No opened connection for querying.");
+  if (!transaction_open_)
+    return tensorflow::errors::FailedPrecondition("Transaction not open.");
+  return ExecuteTypedQueryImpl(query, results);
+}
+
+tensorflow::Status MetadataSource::ExecuteInsertQuery(const std::string& query,
+                                                      int64* insert_id) {
+  if (!is_connected_)
+    return tensorflow::errors::FailedPrecondition(
+        "No opened connection for querying.");
+  if (!transaction_open_)
+    return tensorflow::errors::FailedPrecondition("Transaction not open.");
+  return ExecuteInsertQueryImpl(query, insert_id);
+}
+
+tensorflow::Status MetadataSource::ExecuteQuery(
+    const std::string& query, const std::vector<QueryParameter>& parameters,
+    RecordSet* results) {
+  if (!is_connected_)
+    return tensorflow::errors::FailedPrecondition(
+        "No opened connection for querying.");
+  if (!transaction_open_)
+    return tensorflow::errors::FailedPrecondition("Transaction not open.");
+  return ExecuteParameterizedQueryImpl(query, parameters, results);
+}
+
+tensorflow::Status MetadataSource::ExecuteUncachedQuery(
+    const std::string& query, const std::vector<QueryParameter>& parameters,
+    RecordSet* results) {
+  if (!is_connected_)
+    return tensorflow::errors::FailedPrecondition(
+        "No opened connection for querying.");
+  if (!transaction_open_)
+    return tensorflow::errors::FailedPrecondition("Transaction not open.");
+  return ExecuteUncachedQueryImpl(query, parameters, results);
+}
+
+tensorflow::Status MetadataSource::ExecuteInsertQuery(
+    const std::string& query, const std::vector<QueryParameter>& parameters,
+    int64* insert_id) {
+  if (!is_connected_)
+    return tensorflow::errors::FailedPrecondition(
+        "No opened connection for querying.");
+  if (!transaction_open_)
+    return tensorflow::errors::FailedPrecondition("Transaction not open.");
+  return ExecuteParameterizedInsertQueryImpl(query, parameters, insert_id);
+}
+
+std::string MetadataSource::BindParameter(
+    const QueryParameter& parameter) const {
+  if (absl::holds_alternative<int64>(parameter)) {
+    return absl::StrCat(absl::get<int64>(parameter));
+  }
+  if (absl::holds_alternative<double>(parameter)) {
+    // Keeps enough digits for the value to be parsed back exactly.
+    return absl::StrFormat("%.17g", absl::get<double>(parameter));
+  }
+  if (absl::holds_alternative<std::string>(parameter)) {
+    return absl::StrCat("'", EscapeString(absl::get<std::string>(parameter)),
+                        "'");
+  }
+  if (absl::holds_alternative<BlobParameter>(parameter)) {
+    return absl::StrCat(
+        "X'", absl::BytesToHexString(absl::get<BlobParameter>(parameter).value),
+        "'");
+  }
+  return "NULL";
+}
+
+tensorflow::Status MetadataSource::ComposeQuery(
+    const std::string& query, const std::vector<QueryParameter>& parameters,
+    std::string* composed_query) const {
+  if (static_cast<size_t>(std::count(query.begin(), query.end(), '?')) !=
+      parameters.size()) {
+    return tensorflow::errors::InvalidArgument(
+        "The number of placeholders does not match the ", parameters.size(),
+        " parameters of query: ", query);
+  }
+  composed_query->clear();
+  auto parameter = parameters.begin();
+  for (const char c : query) {
+    if (c == '?') {
+      absl::StrAppend(composed_query, BindParameter(*parameter++));
+    } else {
+      composed_query->push_back(c);
+    }
+  }
+  return tensorflow::Status::OK();
+}
+
+tensorflow::Status MetadataSource::ExecuteTypedQueryImpl(
+    const std::string& query, TypedRecordSet* results) {
+  RecordSet record_set;
+  TF_RETURN_IF_ERROR(ExecuteQueryImpl(query, &record_set));
+  results->AppendRecordSet(record_set);
+  return tensorflow::Status::OK();
+}
+
+tensorflow::Status MetadataSource::ExecuteParameterizedQueryImpl(
+    const std::string& query, const std::vector<QueryParameter>& parameters,
+    RecordSet* results) {
+  std::string composed_query;
+  TF_RETURN_IF_ERROR(ComposeQuery(query, parameters, &composed_query));
+  return ExecuteQueryImpl(composed_query, results);
+}
+
+tensorflow::Status MetadataSource::ExecuteParameterizedInsertQueryImpl(
+    const std::string& query, const std::vector<QueryParameter>& parameters,
+    int64* insert_id) {
+  std::string composed_query;
+  TF_RETURN_IF_ERROR(ComposeQuery(query, parameters, &composed_query));
+  return ExecuteInsertQueryImpl(composed_query, insert_id);
+}
+
 tensorflow::Status MetadataSource::Begin() {
   if (!is_connected_)
     return tensorflow::errors::FailedPrecondition(
@@ -56,6 +180,19 @@ tensorflow::Status MetadataSource::Begin() {
     return tensorflow::errors::FailedPrecondition("Transaction already open.");
   TF_RETURN_IF_ERROR(BeginImpl());
   transaction_open_ = true;
+  transaction_id_++;
+  return tensorflow::Status::OK();
+}
+
+tensorflow::Status MetadataSource::BeginReadOnly() {
+  if (!is_connected_)
+    return tensorflow::errors::FailedPrecondition(
+        "No opened connection for querying.");
+  if (transaction_open_)
+    return tensorflow::errors::FailedPrecondition("Transaction already open.");
+  TF_RETURN_IF_ERROR(BeginReadOnlyImpl());
+  transaction_open_ = true;
+  transaction_id_++;
   return tensorflow::Status::OK();
 }
 
@@ -18,13 +18,27 @@ limitations under the License.
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "absl/strings/string_view.h"
+#include "absl/types/variant.h"
+#include "ml_metadata/metadata_store/typed_record_set.h"
 #include "ml_metadata/metadata_store/types.h"
 #include "ml_metadata/proto/metadata_source.pb.h"
 #include "tensorflow/core/lib/core/status.h"
 
 namespace ml_metadata {
 
+// A binary string bound to a placeholder as a BLOB, e.g., a serialized proto.
+struct BlobParameter {
+  std::string value;
+};
+
+// The value bound to a placeholder of a parameterized query. absl::monostate
+// binds a NULL.
+using QueryParameter =
+    absl::variant<absl::monostate, int64, double, std::string, BlobParameter>;
+
 // The base class for all metadata data sources. It provides an interface used
 // by MetadataAccessObject. Each concrete MetadataSource provides a physical
 // backend to persist and query metadata. An implementation of MetadataSource
@@ -83,11 +97,65 @@ class MetadataSource {
   // Returns FAILED_PRECONDITION error, if a transaction has not begun.
   tensorflow::Status ExecuteQuery(const std::string& query, RecordSet* results);
 
+  // Runs a query returning many rows, and appends the rows to `results`, with
+  // typed values when the backend supports it. If `results` has no columns, the
+  // columns of the query are added to it; otherwise they must be the same.
+  // Returns FAILED_PRECONDITION error, if Connection() is not opened.
+  // Returns detailed INTERNAL error, if query execution fails.
+  // Returns FAILED_PRECONDITION error, if a transaction has not begun.
+  tensorflow::Status ExecuteTypedQuery(const std::string& query,
+                                       TypedRecordSet* results);
+
+  // Runs an INSERT query on data source, and returns the id that the backend
+  // generated for the first inserted row in `insert_id`, without querying it
+  // again. The ids of the other rows are given by GetInsertIdIncrement.
+  // Returns FAILED_PRECONDITION error, if Connection() is not opened.
+  // Returns detailed INTERNAL error, if query execution fails.
+  // Returns FAILED_PRECONDITION error, if a transaction has not begun.
+  tensorflow::Status ExecuteInsertQuery(const std::string& query,
+                                        int64* insert_id);
+
+  // Runs a parameterized query, whose `?` placeholders are bound to the
+  // `parameters` in order. The query text must not contain `?` otherwise. The
+  // sources may prepare a query once and keep it for the lifetime of the
+  // connection, so a parameterized query should not be composed per call.
+  // Returns FAILED_PRECONDITION error, if Connection() is not opened.
+  // Returns detailed INTERNAL error, if query execution fails.
+  // Returns FAILED_PRECONDITION error, if a transaction has not begun.
+  tensorflow::Status ExecuteQuery(const std::string& query,
+                                  const std::vector<QueryParameter>& parameters,
+                                  RecordSet* results);
+
+  // Runs a parameterized query like ExecuteQuery, for the queries which are
+  // composed per call, e.g., from the filter of a list operation. The sources
+  // do not keep such a query prepared after it runs.
+  // Returns FAILED_PRECONDITION error, if Connection() is not opened.
+  // Returns detailed INTERNAL error, if query execution fails.
+  // Returns FAILED_PRECONDITION error, if a transaction has not begun.
+  tensorflow::Status ExecuteUncachedQuery(
+      const std::string& query, const std::vector<QueryParameter>& parameters,
+      RecordSet* results);
+
+  // Runs a parameterized INSERT query, and returns the id that the backend
+  // generated for the first inserted row in `insert_id`.
+  // Returns FAILED_PRECONDITION error, if Connection() is not opened.
+  // Returns detailed INTERNAL error, if query execution fails.
+  // Returns FAILED_PRECONDITION error, if a transaction has not begun.
+  tensorflow::Status ExecuteInsertQuery(
+      const std::string& query, const std::vector<QueryParameter>& parameters,
+      int64* insert_id);
+
   // Begins (opens) a transaction.
   // Returns FAILED_PRECONDITION error, if Connection() is not opened.
   // Returns FAILED_PRECONDITION error, if a transaction has already begun.
   tensorflow::Status Begin();
 
+  // Begins (opens) a transaction which only reads, so that the backend can
+  // skip taking write locks. Queries writing to the database may fail in it.
+  // Returns FAILED_PRECONDITION error, if Connection() is not opened.
+  // Returns FAILED_PRECONDITION error, if a transaction has already begun.
+  tensorflow::Status BeginReadOnly();
+
   // Commits a transaction.
   // Returns FAILED_PRECONDITION error, if Connection() is not opened.
   // Returns FAILED_PRECONDITION error, if a transaction has not begun.
@@ -106,8 +174,31 @@ class MetadataSource {
   // escaping characters and method depends on the metadata source backend.
   virtual std::string EscapeString(absl::string_view value) const = 0;
 
+  // Returns the SQL literal of a parameter, e.g., NULL, 1, an escaped and
+  // quoted string, or a hex literal X'...' of a blob, for the queries that are
+  // composed as text.
+  std::string BindParameter(const QueryParameter& parameter) const;
+
+  // Returns an identifier of the database the source connects to, which is the
+  // same for all the sources that share the database in a process, e.g., a
+  // file name, or a server address and a database name. It is used to cache
+  // per database information across connections.
+  // Returns an empty string if the database is private to the source, e.g., an
+  // in memory database, or cannot be identified.
+  virtual std::string GetDatabaseIdentifier() const { return ""; }
+
+  // Returns the step between the ids that the backend gives to the rows of a
+  // single INSERT query, starting from the id returned by ExecuteInsertQuery,
+  // or 0 if the ids of the rows after the first one cannot be derived from it.
+  virtual int64 GetInsertIdIncrement() const { return 1; }
+
   bool is_connected() const { return is_connected_; }
 
+  // Returns the id of the current transaction, or of the last one if no
+  // transaction is open. The ids increase with each successful Begin(), so
+  // that the callers can keep information for the duration of a transaction.
+  int64 transaction_id() const { return transaction_id_; }
+
  protected:
   bool transaction_open() const { return transaction_open_; }
 
@@ -126,9 +217,51 @@ class MetadataSource {
   virtual tensorflow::Status ExecuteQueryImpl(const std::string& query,
                                               RecordSet* results) = 0;
 
+  // Implementation of executing insert queries.
+  virtual tensorflow::Status ExecuteInsertQueryImpl(const std::string& query,
+                                                    int64* insert_id) = 0;
+
+  // Implementation of executing queries with typed results. By default, the
+  // rows returned by ExecuteQueryImpl are appended as string columns.
+  virtual tensorflow::Status ExecuteTypedQueryImpl(const std::string& query,
+                                                   TypedRecordSet* results);
+
+  // Implementation of executing parameterized queries. By default, the
+  // parameters are bound as literals with BindParameter, and the composed
+  // query is run by ExecuteQueryImpl.
+  virtual tensorflow::Status ExecuteParameterizedQueryImpl(
+      const std::string& query, const std::vector<QueryParameter>& parameters,
+      RecordSet* results);
+
+  // Implementation of executing parameterized queries which are not kept
+  // prepared. By default, it is ExecuteParameterizedQueryImpl, which composes
+  // the query.
+  virtual tensorflow::Status ExecuteUncachedQueryImpl(
+      const std::string& query, const std::vector<QueryParameter>& parameters,
+      RecordSet* results) {
+    return ExecuteParameterizedQueryImpl(query, parameters, results);
+  }
+
+  // Implementation of executing parameterized insert queries. By default, the
+  // composed query is run by ExecuteInsertQueryImpl.
+  virtual tensorflow::Status ExecuteParameterizedInsertQueryImpl(
+      const std::string& query, const std::vector<QueryParameter>& parameters,
+      int64* insert_id);
+
+  // Binds `parameters` as literals to the placeholders of `query`.
+  // Returns INVALID_ARGUMENT error, if the numbers of placeholders and
+  // parameters differ.
+  tensorflow::Status ComposeQuery(const std::string& query,
+                                  const std::vector<QueryParameter>& parameters,
+                                  std::string* composed_query) const;
+
   // Implementation of opening a transaction.
   virtual tensorflow::Status BeginImpl() = 0;
 
+  // Implementation of opening a read only transaction. By default, it opens a
+  // transaction with BeginImpl.
+  virtual tensorflow::Status BeginReadOnlyImpl() { return BeginImpl(); }
+
   // Implementation of a transaction commit.
   virtual tensorflow::Status CommitImpl() = 0;
 
@@ -137,6 +270,7 @@ class MetadataSource {
 
   bool is_connected_ = false;
   bool transaction_open_ = false;
+  int64 transaction_id_ = 0;
 };
 
 }  // namespace ml_metadata
@@ -29,6 +29,8 @@ class MockMetadataSource : public MetadataSource {
   MOCK_METHOD(tensorflow::Status, BeginImpl, (), (override));
   MOCK_METHOD(tensorflow::Status, ExecuteQueryImpl,
               (const std::string& query, RecordSet* results), (override));
+  MOCK_METHOD(tensorflow::Status, ExecuteInsertQueryImpl,
+              (const std::string& query, int64* insert_id), (override));
   MOCK_METHOD(tensorflow::Status, CommitImpl, (), (override));
   MOCK_METHOD(tensorflow::Status, RollbackImpl, (), (override));
   MOCK_METHOD(std::string, EscapeString, (absl::string_view value),
@@ -85,6 +87,39 @@ TEST(MetadataSourceTest, TestExecuteQueryWithoutBegin) {
   EXPECT_EQ(s.code(), tensorflow::error::FAILED_PRECONDITION);
 }
 
+TEST(MetadataSourceTest, TestExecuteInsertQueryWithoutBegin) {
+  MockMetadataSource mock_metadata_source;
+  std::string query = "some query";
+  int64 insert_id;
+  EXPECT_CALL(mock_metadata_source, ExecuteInsertQueryImpl(query, &insert_id))
+      .Times(0);
+  TF_EXPECT_OK(mock_metadata_source.Connect());
+  tensorflow::Status s =
+      mock_metadata_source.ExecuteInsertQuery(query, &insert_id);
+  EXPECT_EQ(s.code(), tensorflow::error::FAILED_PRECONDITION);
+}
+
+TEST(MetadataSourceTest, TestExecuteParameterizedQuery) {
+  MockMetadataSource mock_metadata_source;
+  EXPECT_CALL(mock_metadata_source, EscapeString(absl::string_view("v'1")))
+      .WillOnce(::testing::Return("v''1"));
+  RecordSet result;
+  EXPECT_CALL(mock_metadata_source,
+              ExecuteQueryImpl("SELECT * FROM t1 WHERE c1 = 1 AND c2 = 'v''1' "
+                               "AND c3 = 0.5 AND c4 IS NULL",
+                               &result))
+      .Times(1);
+  TF_EXPECT_OK(mock_metadata_source.Connect());
+  TF_EXPECT_OK(mock_metadata_source.Begin());
+  // Without prepared statements, the parameters are bound as literals.
+  TF_EXPECT_OK(mock_metadata_source.ExecuteQuery(
+      "SELECT * FROM t1 WHERE c1 = ? AND c2 = ? AND c3 = ? AND c4 IS ?",
+      {int64{1}, std::string("v'1"), 0.5, QueryParameter()}, &result));
+  tensorflow::Status s = mock_metadata_source.ExecuteQuery(
+      "SELECT * FROM t1 WHERE c1 = ?", {}, &result);
+  EXPECT_EQ(s.code(), tensorflow::error::INVALID_ARGUMENT);
+}
+
 TEST(MetadataSourceTest, TestBeginAndCommit) {
   MockMetadataSource mock_metadata_source;
   {
@@ -20,6 +20,7 @@ limitations under the License.
 #include "absl/strings/substitute.h"
 #include "ml_metadata/metadata_store/constants.h"
 #include "ml_metadata/metadata_store/test_util.h"
+#include "ml_metadata/metadata_store/typed_record_set.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 
@@ -211,6 +212,68 @@ TEST_P(MetadataSourceTestSuite, TestNull) {
   EXPECT_THAT(query_results, EqualsProto(expected_results));
 }
 
+// Test parameterized query execution.
+// Initialization: creates table t1 (c1 INT, c2 VARCHAR(255)) and adds 3 rows
+// (1,'v1'), (2,'v2'), (3, 'v3') into t1.
+// Execution: Inserts rows with bound parameters, including a NULL and a string
+// with quotes, and runs a parameterized select repetitively.
+// Expectation: the parameters are bound as values in both queries.
+TEST_P(MetadataSourceTestSuite, TestParameterizedQuery) {
+  metadata_source_container_->InitSchemaAndPopulateRows();
+  TF_ASSERT_OK(metadata_source_->Begin());
+  const std::string insert_query = "INSERT INTO t1 VALUES (?, ?)";
+  TF_ASSERT_OK(metadata_source_->ExecuteQuery(
+      insert_query, {int64{4}, std::string("v'4\"")}, nullptr));
+  TF_ASSERT_OK(metadata_source_->ExecuteQuery(
+      insert_query, {int64{5}, QueryParameter()}, nullptr));
+  const std::string select_query = "SELECT * FROM t1 WHERE c1 >= ? AND c1 < ?";
+  RecordSet query_results;
+  TF_ASSERT_OK(metadata_source_->ExecuteQuery(
+      select_query, {int64{3}, int64{6}}, &query_results));
+  EXPECT_THAT(query_results,
+              EqualsProto(ParseTextProtoOrDie<RecordSet>(absl::Substitute(
+                  R"(column_names: "c1"
+                     column_names: "c2"
+                     records: { values: "3" values: "v3" }
+                     records: { values: "4" values: "v'4\"" }
+                     records: { values: "5" values: "$0" })",
+                  kMetadataSourceNull))));
+  query_results.Clear();
+  TF_ASSERT_OK(metadata_source_->ExecuteQuery(
+      select_query, {int64{1}, int64{2}}, &query_results));
+  EXPECT_THAT(query_results, EqualsProto(ParseTextProtoOrDie<RecordSet>(R"(
+                column_names: "c1"
+                column_names: "c2"
+                records: { values: "1" values: "v1" })")));
+  TF_ASSERT_OK(metadata_source_->Commit());
+}
+
+// Test typed query execution.
+// Initialization: creates table t1 (c1 INT, c2 VARCHAR(255)) and adds 3 rows
+// (1,'v1'), (2,'v2'), (3, 'v3') into t1.
+// Execution: Inserts a row with a NULL, and selects the rows into a
+// TypedRecordSet.
+// Expectation: the values of the rows are read from the typed record set,
+// regardless of the column types chosen by the source.
+TEST_P(MetadataSourceTestSuite, TestTypedQuery) {
+  metadata_source_container_->InitSchemaAndPopulateRows();
+  TF_ASSERT_OK(metadata_source_->Begin());
+  TF_ASSERT_OK(metadata_source_->ExecuteQuery("INSERT INTO t1 VALUES (4, NULL)",
+                                              nullptr));
+  TypedRecordSet query_results;
+  TF_ASSERT_OK(metadata_source_->ExecuteTypedQuery(
+      "SELECT * FROM t1 WHERE c1 >= 3 ORDER BY c1", &query_results));
+  TF_ASSERT_OK(metadata_source_->Commit());
+  ASSERT_EQ(query_results.num_columns(), 2);
+  ASSERT_EQ(query_results.num_rows(), 2);
+  EXPECT_EQ(query_results.column_name(0), "c1");
+  EXPECT_EQ(query_results.column_name(1), "c2");
+  EXPECT_EQ(query_results.GetInt64(0, 0), 3);
+  EXPECT_EQ(query_results.GetString(0, 1), "v3");
+  EXPECT_EQ(query_results.GetInt64(1, 0), 4);
+  EXPECT_TRUE(query_results.IsNull(1, 1));
+}
+
 }  // namespace
 }  // namespace testing
 }  // namespace ml_metadata
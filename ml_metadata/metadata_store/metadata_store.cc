@@ -14,9 +14,15 @@ limitations under the License.
 ==============================================================================*/
 #include "ml_metadata/metadata_store/metadata_store.h"
 
+#include <algorithm>
+#include <iterator>
+
 #include "google/protobuf/descriptor.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/memory/memory.h"
+#include "ml_metadata/metadata_store/constants.h"
+#include "ml_metadata/metadata_store/lineage_index.h"
 #include "ml_metadata/metadata_store/metadata_access_object_factory.h"
 #include "ml_metadata/proto/metadata_store_service.pb.h"
 #include "tensorflow/core/lib/core/errors.h"
@@ -25,6 +31,47 @@ namespace ml_metadata {
 namespace {
 using std::unique_ptr;
 
+// Lists a page of the nodes of a kind with the `metadata_access_object`.
+tensorflow::Status ListNodes(MetadataAccessObject* metadata_access_object,
+                             const ListOperationOptions& options,
+                             std::vector<Artifact>* artifacts,
+                             std::string* next_page_token) {
+  return metadata_access_object->ListArtifacts(options, artifacts,
+                                               next_page_token);
+}
+
+tensorflow::Status ListNodes(MetadataAccessObject* metadata_access_object,
+                             const ListOperationOptions& options,
+                             std::vector<Execution>* executions,
+                             std::string* next_page_token) {
+  return metadata_access_object->ListExecutions(options, executions,
+                                                next_page_token);
+}
+
+tensorflow::Status ListNodes(MetadataAccessObject* metadata_access_object,
+                             const ListOperationOptions& options,
+                             std::vector<Context>* contexts,
+                             std::string* next_page_token) {
+  return metadata_access_object->ListContexts(options, contexts,
+                                              next_page_token);
+}
+
+// Returns the nodes of a streamed response.
+google::protobuf::RepeatedPtrField<Artifact>* MutableNodes(
+    StreamArtifactsResponse* response) {
+  return response->mutable_artifacts();
+}
+
+google::protobuf::RepeatedPtrField<Execution>* MutableNodes(
+    StreamExecutionsResponse* response) {
+  return response->mutable_executions();
+}
+
+google::protobuf::RepeatedPtrField<Context>* MutableNodes(
+    StreamContextsResponse* response) {
+  return response->mutable_contexts();
+}
+
 // Checks if the `other_type` have the same names and all list of properties.
 // Returns true if the types are consistent.
 // For a type to be consistent:
@@ -136,6 +183,112 @@ tensorflow::Status UpsertContext(const Context& context,
   return tensorflow::Status::OK();
 }
 
+// Updates or inserts a collection of nodes, which are one of {Artifact,
+// Execution, Context}, and appends their ids to `node_ids` in the order of
+// `nodes`. When there are several new nodes, i.e., nodes without an id, they
+// are created together by `create_nodes`, which is much faster than creating
+// them one by one. The stored nodes are updated one by one by `upsert_node`.
+template <typename Node, typename UpsertNodeFn, typename CreateNodesFn>
+tensorflow::Status UpsertNodes(
+    const google::protobuf::RepeatedPtrField<Node>& nodes,
+    const UpsertNodeFn& upsert_node, const CreateNodesFn& create_nodes,
+    google::protobuf::RepeatedField<google::protobuf::int64>* node_ids) {
+  std::vector<Node> new_nodes;
+  for (const Node& node : nodes) {
+    if (!node.has_id()) new_nodes.push_back(node);
+  }
+  std::vector<int64> new_node_ids;
+  if (new_nodes.size() > 1) {
+    TF_RETURN_IF_ERROR(create_nodes(new_nodes, &new_node_ids));
+  }
+  auto new_node_id = new_node_ids.begin();
+  for (const Node& node : nodes) {
+    int64 node_id = -1;
+    if (node.has_id() || new_node_ids.empty()) {
+      TF_RETURN_IF_ERROR(upsert_node(node, &node_id));
+    } else {
+      node_id = *new_node_id++;
+    }
+    node_ids->Add(node_id);
+  }
+  return tensorflow::Status::OK();
+}
+
+// Updates or inserts a collection of artifacts, and appends their ids to
+// `artifact_ids` in the order of `artifacts`.
+tensorflow::Status UpsertArtifacts(
+    const google::protobuf::RepeatedPtrField<Artifact>& artifacts,
+    MetadataAccessObject* metadata_access_object,
+    google::protobuf::RepeatedField<google::protobuf::int64>* artifact_ids) {
+  return UpsertNodes(
+      artifacts,
+      [metadata_access_object](const Artifact& artifact, int64* artifact_id) {
+        return UpsertArtifact(artifact, metadata_access_object, artifact_id);
+      },
+      [metadata_access_object](const std::vector<Artifact>& new_artifacts,
+                               std::vector<int64>* new_artifact_ids) {
+        return metadata_access_object->CreateArtifacts(new_artifacts,
+                                                       new_artifact_ids);
+      },
+      artifact_ids);
+}
+
+// Updates or inserts a collection of executions, and appends their ids to
+// `execution_ids` in the order of `executions`.
+tensorflow::Status UpsertExecutions(
+    const google::protobuf::RepeatedPtrField<Execution>& executions,
+    MetadataAccessObject* metadata_access_object,
+    google::protobuf::RepeatedField<google::protobuf::int64>* execution_ids) {
+  return UpsertNodes(
+      executions,
+      [metadata_access_object](const Execution& execution,
+                               int64* execution_id) {
+        return UpsertExecution(execution, metadata_access_object,
+                               execution_id);
+      },
+      [metadata_access_object](const std::vector<Execution>& new_executions,
+                               std::vector<int64>* new_execution_ids) {
+        return metadata_access_object->CreateExecutions(new_executions,
+                                                        new_execution_ids);
+      },
+      execution_ids);
+}
+
+// Updates or inserts a collection of contexts, and appends their ids to
+// `context_ids` in the order of `contexts`.
+tensorflow::Status UpsertContexts(
+    const google::protobuf::RepeatedPtrField<Context>& contexts,
+    MetadataAccessObject* metadata_access_object,
+    google::protobuf::RepeatedField<google::protobuf::int64>* context_ids) {
+  return UpsertNodes(
+      contexts,
+      [metadata_access_object](const Context& context, int64* context_id) {
+        return UpsertContext(context, metadata_access_object, context_id);
+      },
+      [metadata_access_object](const std::vector<Context>& new_contexts,
+                               std::vector<int64>* new_context_ids) {
+        return metadata_access_object->CreateContexts(new_contexts,
+                                                      new_context_ids);
+      },
+      context_ids);
+}
+
+// Gets the id of the node at `index` of the `num_nodes` nodes of a BulkPut
+// request, whose ids start at `offset` in `node_ids`.
+// Returns INVALID_ARGUMENT error, if the index is out of range.
+tensorflow::Status GetBulkPutNodeId(
+    const int index, const int num_nodes, const int offset,
+    const google::protobuf::RepeatedField<google::protobuf::int64>& node_ids,
+    int64* node_id) {
+  if (index < 0 || index >= num_nodes) {
+    return tensorflow::errors::InvalidArgument(
+        "The node index ", index, " is out of the range [0, ", num_nodes,
+        ") of the request.");
+  }
+  *node_id = node_ids.Get(offset + index);
+  return tensorflow::Status::OK();
+}
+
 // Inserts an association. If the association already exists it returns OK.
 tensorflow::Status InsertAssociationIfNotExist(
     int64 context_id, int64 execution_id,
@@ -171,11 +324,14 @@ tensorflow::Status InsertAttributionIfNotExist(
 // Updates or inserts a pair of {Artifact, Event}. If artifact is not given,
 // the event.artifact_id must exist, and it inserts the event, and returns the
 // artifact_id. Otherwise if artifact is given, event.artifact_id is optional,
-// if set, then artifact.id and event.artifact_id must align.
+// if set, then artifact.id and event.artifact_id must align. The id of the
+// inserted event, if any, is returned in `event_id`.
 tensorflow::Status UpsertArtifactAndEvent(
     const PutExecutionRequest::ArtifactAndEvent& artifact_and_event,
-    MetadataAccessObject* metadata_access_object, int64* artifact_id) {
+    MetadataAccessObject* metadata_access_object, int64* artifact_id,
+    int64* event_id) {
   CHECK(artifact_id) << "The output artifact_id pointer should not be null";
+  CHECK(event_id) << "The output event_id pointer should not be null";
   if (!artifact_and_event.has_artifact() && !artifact_and_event.has_event()) {
     return tensorflow::Status::OK();
   }
@@ -219,8 +375,391 @@ tensorflow::Status UpsertArtifactAndEvent(
   } else {
     *artifact_id = event.artifact_id();
   }
-  int64 dummy_event_id = -1;
-  return metadata_access_object->CreateEvent(event, &dummy_event_id);
+  return metadata_access_object->CreateEvent(event, event_id);
+}
+
+// Builds the list options of a Get*ByProperty request, whose filter matches the
+// type and the property value or range of the request, in addition to the
+// filter of the options of the request.
+// Returns INVALID_ARGUMENT error, if the property name is not given, or
+// neither or both of the value and the range are given.
+template <typename Request>
+tensorflow::Status GetListOperationOptionsByProperty(
+    const Request& request, ListOperationOptions* options) {
+  if (request.property_name().empty()) {
+    return tensorflow::errors::InvalidArgument(
+        "The property_name of the request is not given: ",
+        request.DebugString());
+  }
+  const bool has_range = request.has_min_value() || request.has_max_value();
+  if (request.has_value() == has_range) {
+    return tensorflow::errors::InvalidArgument(
+        "Either the value or the range of the property must be given: ",
+        request.DebugString());
+  }
+  *options = request.options();
+  ListOperationOptions::Filter* filter = options->mutable_filter();
+  if (request.has_type_name()) {
+    filter->set_type_name(request.type_name());
+  }
+  const auto add_predicate =
+      [&request, filter](
+          ListOperationOptions::Filter::PropertyPredicate::Operator op,
+          const Value& value) {
+        ListOperationOptions::Filter::PropertyPredicate* predicate =
+            filter->add_property_predicates();
+        predicate->set_name(request.property_name());
+        predicate->set_is_custom_property(request.is_custom_property());
+        predicate->set_op(op);
+        *predicate->mutable_value() = value;
+      };
+  if (request.has_value()) {
+    add_predicate(ListOperationOptions::Filter::PropertyPredicate::EQ,
+                  request.value());
+  }
+  if (request.has_min_value()) {
+    add_predicate(ListOperationOptions::Filter::PropertyPredicate::GE,
+                  request.min_value());
+  }
+  if (request.has_max_value()) {
+    add_predicate(ListOperationOptions::Filter::PropertyPredicate::LT,
+                  request.max_value());
+  }
+  return tensorflow::Status::OK();
+}
+
+// The artifacts or the executions of a lineage traversal.
+struct LineageNodes {
+  // If set, only the nodes of the types of `type_ids` are traversed.
+  bool has_type_filter = false;
+  absl::flat_hash_set<int64> type_ids;
+  // The ids of the returned nodes.
+  absl::flat_hash_set<int64> ids;
+  // The ids of the nodes which are not traversed because of their type.
+  absl::flat_hash_set<int64> excluded_ids;
+  // The ids of the nodes whose events are read.
+  absl::flat_hash_set<int64> expanded_ids;
+  // The ids of the nodes returned in the last hop, whose events are read in
+  // the next hop.
+  std::vector<int64> frontier;
+};
+
+// Resolves the ids of the types of `type_names`. The unknown names are
+// skipped.
+template <typename Type>
+tensorflow::Status FindTypeIdsByNames(
+    const google::protobuf::RepeatedPtrField<std::string>& type_names,
+    MetadataAccessObject* metadata_access_object,
+    absl::flat_hash_set<int64>* type_ids) {
+  for (const std::string& type_name : type_names) {
+    Type type;
+    const tensorflow::Status status =
+        metadata_access_object->FindTypeByName(type_name, &type);
+    if (tensorflow::errors::IsNotFound(status)) {
+      continue;
+    } else if (!status.ok()) {
+      return status;
+    }
+    type_ids->insert(type.id());
+  }
+  return tensorflow::Status::OK();
+}
+
+// Finds the nodes of a kind by ids with the `metadata_access_object`.
+tensorflow::Status FindNodesById(MetadataAccessObject* metadata_access_object,
+                                 const std::vector<int64>& ids,
+                                 std::vector<Artifact>* artifacts) {
+  return metadata_access_object->FindArtifactsById(ids, artifacts);
+}
+
+tensorflow::Status FindNodesById(MetadataAccessObject* metadata_access_object,
+                                 const std::vector<int64>& ids,
+                                 std::vector<Execution>* executions) {
+  return metadata_access_object->FindExecutionsById(ids, executions);
+}
+
+// Returns the nodes of a kind of a lineage graph.
+google::protobuf::RepeatedPtrField<Artifact>* MutableNodes(
+    GetLineageGraphResponse* response, const Artifact&) {
+  return response->mutable_artifacts();
+}
+
+google::protobuf::RepeatedPtrField<Execution>* MutableNodes(
+    GetLineageGraphResponse* response, const Execution&) {
+  return response->mutable_executions();
+}
+
+// Follows the `events` of a hop to their nodes of type `Node`, which are in
+// `nodes`. The nodes which are not returned yet are read at once, and the ones
+// of the traversed types are returned, and added to the next frontier, until
+// the limits of the request are reached, which truncates the response.
+template <typename Node>
+tensorflow::Status FollowLineageEvents(
+    const std::vector<Event>& events, const GetLineageGraphRequest& request,
+    MetadataAccessObject* metadata_access_object, LineageNodes* nodes,
+    std::vector<int64>* next_frontier, GetLineageGraphResponse* response) {
+  constexpr bool is_artifact = std::is_same<Node, Artifact>::value;
+  const auto node_id = [](const Event& event) {
+    return is_artifact ? event.artifact_id() : event.execution_id();
+  };
+  std::vector<int64> new_node_ids;
+  for (const Event& event : events) {
+    if (!nodes->ids.contains(node_id(event))) {
+      new_node_ids.push_back(node_id(event));
+    }
+  }
+  std::vector<Node> found_nodes;
+  if (!new_node_ids.empty()) {
+    TF_RETURN_IF_ERROR(
+        FindNodesById(metadata_access_object, new_node_ids, &found_nodes));
+  }
+  absl::flat_hash_map<int64, Node> new_nodes;
+  for (Node& node : found_nodes) {
+    if (!nodes->has_type_filter || nodes->type_ids.contains(node.type_id())) {
+      new_nodes.insert({node.id(), std::move(node)});
+    } else {
+      nodes->excluded_ids.insert(node.id());
+    }
+  }
+
+  for (const Event& event : events) {
+    const int64 id = node_id(event);
+    if (nodes->excluded_ids.contains(id)) continue;
+    if (response->events_size() >= request.max_num_events()) {
+      response->set_is_truncated(true);
+      break;
+    }
+    if (!nodes->ids.contains(id)) {
+      if (response->artifacts_size() + response->executions_size() >=
+          request.max_num_nodes()) {
+        response->set_is_truncated(true);
+        continue;
+      }
+      const Node& node = new_nodes.at(id);
+      *MutableNodes(response, node)->Add() = node;
+      nodes->ids.insert(id);
+      next_frontier->push_back(id);
+    }
+    *response->add_events() = event;
+  }
+  return tensorflow::Status::OK();
+}
+
+// Returns INVALID_ARGUMENT error, if the limits of the lineage graph request
+// are invalid.
+tensorflow::Status ValidateLineageGraphLimits(
+    const GetLineageGraphRequest& request) {
+  if (request.max_num_hops() < 0 || request.max_num_nodes() <= 0 ||
+      request.max_num_events() < 0) {
+    return tensorflow::errors::InvalidArgument(
+        "The max_num_hops and max_num_events must not be negative, and the "
+        "max_num_nodes must be positive: ",
+        request.DebugString());
+  }
+  return tensorflow::Status::OK();
+}
+
+// Traverses the lineage graph of the request breadth first. Each hop reads
+// the events of the artifacts and the executions of the frontier, then the
+// nodes they reach, with a few batched queries.
+// Returns INVALID_ARGUMENT error, if the limits of the request are invalid.
+// Returns NOT_FOUND error, if a seed cannot be found.
+tensorflow::Status GetLineageGraphImpl(
+    const GetLineageGraphRequest& request,
+    MetadataAccessObject* metadata_access_object,
+    GetLineageGraphResponse* response) {
+  TF_RETURN_IF_ERROR(ValidateLineageGraphLimits(request));
+  LineageNodes artifacts;
+  artifacts.has_type_filter = !request.artifact_type_names().empty();
+  LineageNodes executions;
+  executions.has_type_filter = !request.execution_type_names().empty();
+  TF_RETURN_IF_ERROR(FindTypeIdsByNames<ArtifactType>(
+      request.artifact_type_names(), metadata_access_object,
+      &artifacts.type_ids));
+  TF_RETURN_IF_ERROR(FindTypeIdsByNames<ExecutionType>(
+      request.execution_type_names(), metadata_access_object,
+      &executions.type_ids));
+
+  std::vector<Artifact> seed_artifacts;
+  if (request.artifact_ids_size() > 0) {
+    TF_RETURN_IF_ERROR(metadata_access_object->FindArtifactsById(
+        {request.artifact_ids().begin(), request.artifact_ids().end()},
+        &seed_artifacts));
+  }
+  for (const Artifact& artifact : seed_artifacts) {
+    *response->add_artifacts() = artifact;
+    artifacts.ids.insert(artifact.id());
+    artifacts.frontier.push_back(artifact.id());
+  }
+  std::vector<Execution> seed_executions;
+  if (request.execution_ids_size() > 0) {
+    TF_RETURN_IF_ERROR(metadata_access_object->FindExecutionsById(
+        {request.execution_ids().begin(), request.execution_ids().end()},
+        &seed_executions));
+  }
+  for (const Execution& execution : seed_executions) {
+    *response->add_executions() = execution;
+    executions.ids.insert(execution.id());
+    executions.frontier.push_back(execution.id());
+  }
+  if (response->artifacts_size() + response->executions_size() >
+      request.max_num_nodes()) {
+    response->set_is_truncated(true);
+  }
+
+  for (int hop = 0; hop < request.max_num_hops(); hop++) {
+    if (response->is_truncated() ||
+        (artifacts.frontier.empty() && executions.frontier.empty())) {
+      break;
+    }
+    std::vector<Event> artifact_events;
+    if (!artifacts.frontier.empty()) {
+      const tensorflow::Status status =
+          metadata_access_object->FindEventsByArtifacts(artifacts.frontier,
+                                                        &artifact_events);
+      if (!status.ok() && !tensorflow::errors::IsNotFound(status)) {
+        return status;
+      }
+    }
+    std::vector<Event> execution_events;
+    if (!executions.frontier.empty()) {
+      const tensorflow::Status status =
+          metadata_access_object->FindEventsByExecutions(executions.frontier,
+                                                         &execution_events);
+      if (!status.ok() && !tensorflow::errors::IsNotFound(status)) {
+        return status;
+      }
+    }
+
+    // An event between two expanded nodes is followed from one of them only:
+    // from the artifact, if it can be, else from the execution.
+    artifacts.expanded_ids.insert(artifacts.frontier.begin(),
+                                  artifacts.frontier.end());
+    std::vector<Event> events_to_executions;
+    for (const Event& event : artifact_events) {
+      if (!IsFollowedFromArtifact(event.type(), request.direction()) ||
+          executions.excluded_ids.contains(event.execution_id())) {
+        continue;
+      }
+      if (executions.expanded_ids.contains(event.execution_id()) &&
+          IsFollowedFromExecution(event.type(), request.direction())) {
+        continue;
+      }
+      events_to_executions.push_back(event);
+    }
+    executions.expanded_ids.insert(executions.frontier.begin(),
+                                   executions.frontier.end());
+    std::vector<Event> events_to_artifacts;
+    for (const Event& event : execution_events) {
+      if (!IsFollowedFromExecution(event.type(), request.direction()) ||
+          artifacts.excluded_ids.contains(event.artifact_id())) {
+        continue;
+      }
+      if (artifacts.expanded_ids.contains(event.artifact_id()) &&
+          IsFollowedFromArtifact(event.type(), request.direction())) {
+        continue;
+      }
+      events_to_artifacts.push_back(event);
+    }
+
+    std::vector<int64> next_artifact_frontier;
+    std::vector<int64> next_execution_frontier;
+    TF_RETURN_IF_ERROR(FollowLineageEvents<Execution>(
+        events_to_executions, request, metadata_access_object, &executions,
+        &next_execution_frontier, response));
+    TF_RETURN_IF_ERROR(FollowLineageEvents<Artifact>(
+        events_to_artifacts, request, metadata_access_object, &artifacts,
+        &next_artifact_frontier, response));
+    artifacts.frontier = std::move(next_artifact_frontier);
+    executions.frontier = std::move(next_execution_frontier);
+  }
+  return tensorflow::Status::OK();
+}
+
+// Finds the nodes of a kind with the `ids` which are not in `nodes` yet, and
+// appends them to `nodes`.
+template <typename Node>
+tensorflow::Status AppendNodesById(
+    const std::vector<int64>& ids, MetadataAccessObject* metadata_access_object,
+    std::vector<Node>* nodes) {
+  absl::flat_hash_set<int64> found_ids;
+  for (const Node& node : *nodes) {
+    found_ids.insert(node.id());
+  }
+  std::vector<int64> missing_ids;
+  for (const int64 id : ids) {
+    if (!found_ids.contains(id)) missing_ids.push_back(id);
+  }
+  if (missing_ids.empty()) return tensorflow::Status::OK();
+  std::vector<Node> found_nodes;
+  TF_RETURN_IF_ERROR(
+      FindNodesById(metadata_access_object, missing_ids, &found_nodes));
+  std::move(found_nodes.begin(), found_nodes.end(), std::back_inserter(*nodes));
+  return tensorflow::Status::OK();
+}
+
+// Adds the `nodes` to the response in the order of their `ids`.
+template <typename Node>
+void AddNodesInOrder(const std::vector<int64>& ids, std::vector<Node>* nodes,
+                     GetLineageGraphResponse* response) {
+  absl::flat_hash_map<int64, Node*> nodes_by_id;
+  for (Node& node : *nodes) {
+    nodes_by_id[node.id()] = &node;
+  }
+  for (const int64 id : ids) {
+    const auto it = nodes_by_id.find(id);
+    if (it == nodes_by_id.end()) continue;
+    *MutableNodes(response, *it->second)->Add() = std::move(*it->second);
+  }
+}
+
+// Traverses the lineage graph of the request with the `lineage_index`, then
+// reads the seeds, the reached nodes, and the followed events by id, with a
+// few batched queries.
+// Returns INVALID_ARGUMENT error, if the limits of the request are invalid.
+// Returns NOT_FOUND error, if a seed or a followed event cannot be found.
+tensorflow::Status GetLineageGraphFromIndex(
+    const GetLineageGraphRequest& request, const LineageIndex& lineage_index,
+    MetadataAccessObject* metadata_access_object,
+    GetLineageGraphResponse* response) {
+  TF_RETURN_IF_ERROR(ValidateLineageGraphLimits(request));
+  std::vector<Artifact> artifacts;
+  TF_RETURN_IF_ERROR(AppendNodesById(
+      {request.artifact_ids().begin(), request.artifact_ids().end()},
+      metadata_access_object, &artifacts));
+  std::vector<Execution> executions;
+  TF_RETURN_IF_ERROR(AppendNodesById(
+      {request.execution_ids().begin(), request.execution_ids().end()},
+      metadata_access_object, &executions));
+  std::vector<int64> seed_artifact_ids;
+  for (const Artifact& artifact : artifacts) {
+    seed_artifact_ids.push_back(artifact.id());
+  }
+  std::vector<int64> seed_execution_ids;
+  for (const Execution& execution : executions) {
+    seed_execution_ids.push_back(execution.id());
+  }
+  LineageTraversal traversal;
+  lineage_index.Traverse(request, seed_artifact_ids, seed_execution_ids,
+                         &traversal);
+
+  TF_RETURN_IF_ERROR(AppendNodesById(traversal.artifact_ids,
+                                     metadata_access_object, &artifacts));
+  TF_RETURN_IF_ERROR(AppendNodesById(traversal.execution_ids,
+                                     metadata_access_object, &executions));
+  AddNodesInOrder(traversal.artifact_ids, &artifacts, response);
+  AddNodesInOrder(traversal.execution_ids, &executions, response);
+  response->set_is_truncated(traversal.is_truncated);
+  if (traversal.event_ids.empty()) return tensorflow::Status::OK();
+
+  // The traversal follows each event once, within the max_num_events.
+  std::vector<Event> events;
+  TF_RETURN_IF_ERROR(
+      metadata_access_object->FindEventsById(traversal.event_ids, &events));
+  for (Event& event : events) {
+    *response->add_events() = std::move(event);
+  }
+  return tensorflow::Status::OK();
 }
 
 }  // namespace
@@ -240,6 +779,20 @@ tensorflow::Status MetadataStore::InitMetadataStoreIfNotExists(
       });
 }
 
+tensorflow::Status MetadataStore::HealthCheck() {
+  return transaction_executor_->ExecuteReadOnly(
+      [this]() -> tensorflow::Status {
+        int64 db_version = 0;
+        const tensorflow::Status status =
+            metadata_access_object_->GetSchemaVersion(&db_version);
+        // An empty database is still a reachable one.
+        if (!status.ok() && !tensorflow::errors::IsNotFound(status)) {
+          return status;
+        }
+        return tensorflow::Status::OK();
+      });
+}
+
 tensorflow::Status MetadataStore::PutTypes(const PutTypesRequest& request,
                                            PutTypesResponse* response) {
   if (request.can_delete_fields()) {
@@ -339,7 +892,7 @@ tensorflow::Status MetadataStore::PutContextType(
 
 tensorflow::Status MetadataStore::GetArtifactType(
     const GetArtifactTypeRequest& request, GetArtifactTypeResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         return metadata_access_object_->FindTypeByName(
@@ -350,7 +903,7 @@ tensorflow::Status MetadataStore::GetArtifactType(
 tensorflow::Status MetadataStore::GetExecutionType(
     const GetExecutionTypeRequest& request,
     GetExecutionTypeResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         return metadata_access_object_->FindTypeByName(
@@ -360,7 +913,7 @@ tensorflow::Status MetadataStore::GetExecutionType(
 
 tensorflow::Status MetadataStore::GetContextType(
     const GetContextTypeRequest& request, GetContextTypeResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         return metadata_access_object_->FindTypeByName(
@@ -371,18 +924,16 @@ tensorflow::Status MetadataStore::GetContextType(
 tensorflow::Status MetadataStore::GetArtifactTypesByID(
     const GetArtifactTypesByIDRequest& request,
     GetArtifactTypesByIDResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
-        for (const int64 type_id : request.type_ids()) {
-          ArtifactType artifact_type;
-          const tensorflow::Status status =
-              metadata_access_object_->FindTypeById(type_id, &artifact_type);
-          if (status.ok()) {
-            *response->mutable_artifact_types()->Add() = artifact_type;
-          } else if (!tensorflow::errors::IsNotFound(status)) {
-            return status;
-          }
+        const std::vector<int64> type_ids(request.type_ids().begin(),
+                                          request.type_ids().end());
+        std::vector<ArtifactType> artifact_types;
+        TF_RETURN_IF_ERROR(
+            metadata_access_object_->FindTypesByIds(type_ids, &artifact_types));
+        for (const ArtifactType& artifact_type : artifact_types) {
+          *response->mutable_artifact_types()->Add() = artifact_type;
         }
         return tensorflow::Status::OK();
       });
@@ -391,18 +942,16 @@ tensorflow::Status MetadataStore::GetArtifactTypesByID(
 tensorflow::Status MetadataStore::GetExecutionTypesByID(
     const GetExecutionTypesByIDRequest& request,
     GetExecutionTypesByIDResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
-        for (const int64 type_id : request.type_ids()) {
-          ExecutionType execution_type;
-          const tensorflow::Status status =
-              metadata_access_object_->FindTypeById(type_id, &execution_type);
-          if (status.ok()) {
-            *response->mutable_execution_types()->Add() = execution_type;
-          } else if (!tensorflow::errors::IsNotFound(status)) {
-            return status;
-          }
+        const std::vector<int64> type_ids(request.type_ids().begin(),
+                                          request.type_ids().end());
+        std::vector<ExecutionType> execution_types;
+        TF_RETURN_IF_ERROR(metadata_access_object_->FindTypesByIds(
+            type_ids, &execution_types));
+        for (const ExecutionType& execution_type : execution_types) {
+          *response->mutable_execution_types()->Add() = execution_type;
         }
         return tensorflow::Status::OK();
       });
@@ -411,18 +960,16 @@ tensorflow::Status MetadataStore::GetExecutionTypesByID(
 tensorflow::Status MetadataStore::GetContextTypesByID(
     const GetContextTypesByIDRequest& request,
     GetContextTypesByIDResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
-        for (const int64 type_id : request.type_ids()) {
-          ContextType context_type;
-          const tensorflow::Status status =
-              metadata_access_object_->FindTypeById(type_id, &context_type);
-          if (status.ok()) {
-            *response->mutable_context_types()->Add() = context_type;
-          } else if (!tensorflow::errors::IsNotFound(status)) {
-            return status;
-          }
+        const std::vector<int64> type_ids(request.type_ids().begin(),
+                                          request.type_ids().end());
+        std::vector<ContextType> context_types;
+        TF_RETURN_IF_ERROR(
+            metadata_access_object_->FindTypesByIds(type_ids, &context_types));
+        for (const ContextType& context_type : context_types) {
+          *response->mutable_context_types()->Add() = context_type;
         }
         return tensorflow::Status::OK();
       });
@@ -431,7 +978,7 @@ tensorflow::Status MetadataStore::GetContextTypesByID(
 tensorflow::Status MetadataStore::GetArtifactsByID(
     const GetArtifactsByIDRequest& request,
     GetArtifactsByIDResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         for (const int64 artifact_id : request.artifact_ids()) {
@@ -451,26 +998,27 @@ tensorflow::Status MetadataStore::GetArtifactsByID(
 tensorflow::Status MetadataStore::GetExecutionsByID(
     const GetExecutionsByIDRequest& request,
     GetExecutionsByIDResponse* response) {
-  return transaction_executor_->Execute([this, &request,
-                                         &response]() -> tensorflow::Status {
-    response->Clear();
-    for (const int64 execution_id : request.execution_ids()) {
-      Execution execution;
-      const tensorflow::Status status =
-          metadata_access_object_->FindExecutionById(execution_id, &execution);
-      if (status.ok()) {
-        *response->mutable_executions()->Add() = execution;
-      } else if (!tensorflow::errors::IsNotFound(status)) {
-        return status;
-      }
-    }
-    return tensorflow::Status::OK();
-  });
+  return transaction_executor_->ExecuteReadOnly(
+      [this, &request, &response]() -> tensorflow::Status {
+        response->Clear();
+        for (const int64 execution_id : request.execution_ids()) {
+          Execution execution;
+          const tensorflow::Status status =
+              metadata_access_object_->FindExecutionById(execution_id,
+                                                         &execution);
+          if (status.ok()) {
+            *response->mutable_executions()->Add() = execution;
+          } else if (!tensorflow::errors::IsNotFound(status)) {
+            return status;
+          }
+        }
+        return tensorflow::Status::OK();
+      });
 }
 
 tensorflow::Status MetadataStore::GetContextsByID(
     const GetContextsByIDRequest& request, GetContextsByIDResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         for (const int64 context_id : request.context_ids()) {
@@ -492,13 +1040,9 @@ tensorflow::Status MetadataStore::PutArtifacts(
   return transaction_executor_->Execute(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
-        for (const Artifact& artifact : request.artifacts()) {
-          int64 artifact_id = -1;
-          TF_RETURN_IF_ERROR(UpsertArtifact(
-              artifact, metadata_access_object_.get(), &artifact_id));
-          response->add_artifact_ids(artifact_id);
-        }
-        return tensorflow::Status::OK();
+        return UpsertArtifacts(request.artifacts(),
+                               metadata_access_object_.get(),
+                               response->mutable_artifact_ids());
       });
 }
 
@@ -507,13 +1051,9 @@ tensorflow::Status MetadataStore::PutExecutions(
   return transaction_executor_->Execute(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
-        for (const Execution& execution : request.executions()) {
-          int64 execution_id = -1;
-          TF_RETURN_IF_ERROR(UpsertExecution(
-              execution, metadata_access_object_.get(), &execution_id));
-          response->add_execution_ids(execution_id);
-        }
-        return tensorflow::Status::OK();
+        return UpsertExecutions(request.executions(),
+                                metadata_access_object_.get(),
+                                response->mutable_execution_ids());
       });
 }
 
@@ -522,13 +1062,9 @@ tensorflow::Status MetadataStore::PutContexts(const PutContextsRequest& request,
   return transaction_executor_->Execute(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
-        for (const Context& context : request.contexts()) {
-          int64 context_id = -1;
-          TF_RETURN_IF_ERROR(UpsertContext(
-              context, metadata_access_object_.get(), &context_id));
-          response->add_context_ids(context_id);
-        }
-        return tensorflow::Status::OK();
+        return UpsertContexts(request.contexts(),
+                              metadata_access_object_.get(),
+                              response->mutable_context_ids());
       });
 }
 
@@ -566,11 +1102,10 @@ tensorflow::Status MetadataStore::PutEvents(const PutEventsRequest& request,
   return transaction_executor_->Execute(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
-        for (const Event& event : request.events()) {
-          int64 dummy_event_id = -1;
-          TF_RETURN_IF_ERROR(
-              metadata_access_object_->CreateEvent(event, &dummy_event_id));
-        }
+        std::vector<int64> event_ids;
+        TF_RETURN_IF_ERROR(metadata_access_object_->CreateEvents(
+            {request.events().begin(), request.events().end()}, &event_ids));
+        response->mutable_event_ids()->Add(event_ids.begin(), event_ids.end());
         return tensorflow::Status::OK();
       });
 }
@@ -606,9 +1141,15 @@ tensorflow::Status MetadataStore::PutExecution(
         event->set_execution_id(execution_id);
       }
       int64 artifact_id = -1;
-      TF_RETURN_IF_ERROR(UpsertArtifactAndEvent(
-          artifact_and_event, metadata_access_object_.get(), &artifact_id));
+      int64 event_id = -1;
+      TF_RETURN_IF_ERROR(
+          UpsertArtifactAndEvent(artifact_and_event,
+                                 metadata_access_object_.get(), &artifact_id,
+                                 &event_id));
       response->add_artifact_ids(artifact_id);
+      if (artifact_and_event.has_event()) {
+        response->add_event_ids(event_id);
+      }
     }
     // 3. Upsert contexts and insert associations and attributions.
     for (const Context& context : request.contexts()) {
@@ -630,7 +1171,7 @@ tensorflow::Status MetadataStore::PutExecution(
 tensorflow::Status MetadataStore::GetEventsByExecutionIDs(
     const GetEventsByExecutionIDsRequest& request,
     GetEventsByExecutionIDsResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         std::vector<Event> events;
@@ -654,7 +1195,7 @@ tensorflow::Status MetadataStore::GetEventsByExecutionIDs(
 tensorflow::Status MetadataStore::GetEventsByArtifactIDs(
     const GetEventsByArtifactIDsRequest& request,
     GetEventsByArtifactIDsResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         std::vector<Event> events;
@@ -675,9 +1216,19 @@ tensorflow::Status MetadataStore::GetEventsByArtifactIDs(
       });
 }
 
+tensorflow::Status MetadataStore::GetLineageGraph(
+    const GetLineageGraphRequest& request, GetLineageGraphResponse* response) {
+  return transaction_executor_->ExecuteReadOnly(
+      [this, &request, &response]() -> tensorflow::Status {
+        response->Clear();
+        return GetLineageGraphImpl(request, metadata_access_object_.get(),
+                                   response);
+      });
+}
+
 tensorflow::Status MetadataStore::GetExecutions(
     const GetExecutionsRequest& request, GetExecutionsResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         std::vector<Execution> executions;
@@ -709,7 +1260,7 @@ tensorflow::Status MetadataStore::GetExecutions(
 
 tensorflow::Status MetadataStore::GetArtifacts(
     const GetArtifactsRequest& request, GetArtifactsResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         std::vector<Artifact> artifacts;
@@ -742,7 +1293,7 @@ tensorflow::Status MetadataStore::GetArtifacts(
 
 tensorflow::Status MetadataStore::GetContexts(const GetContextsRequest& request,
                                               GetContextsResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         std::vector<Context> contexts;
@@ -776,7 +1327,7 @@ tensorflow::Status MetadataStore::GetContexts(const GetContextsRequest& request,
 tensorflow::Status MetadataStore::GetArtifactTypes(
     const GetArtifactTypesRequest& request,
     GetArtifactTypesResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &response]() -> tensorflow::Status {
         response->Clear();
         std::vector<ArtifactType> artifact_types;
@@ -797,7 +1348,7 @@ tensorflow::Status MetadataStore::GetArtifactTypes(
 tensorflow::Status MetadataStore::GetExecutionTypes(
     const GetExecutionTypesRequest& request,
     GetExecutionTypesResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &response]() -> tensorflow::Status {
         response->Clear();
         std::vector<ExecutionType> execution_types;
@@ -817,7 +1368,7 @@ tensorflow::Status MetadataStore::GetExecutionTypes(
 
 tensorflow::Status MetadataStore::GetContextTypes(
     const GetContextTypesRequest& request, GetContextTypesResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &response]() -> tensorflow::Status {
         response->Clear();
         std::vector<ContextType> context_types;
@@ -850,7 +1401,7 @@ tensorflow::Status MetadataStore::GetArtifactsByURI(
           request.DebugString());
     }
   }
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         absl::flat_hash_set<std::string> uris(request.uris().begin(),
@@ -872,10 +1423,38 @@ tensorflow::Status MetadataStore::GetArtifactsByURI(
       });
 }
 
+tensorflow::Status MetadataStore::GetArtifactsByProperty(
+    const GetArtifactsByPropertyRequest& request,
+    GetArtifactsByPropertyResponse* response) {
+  ListOperationOptions options;
+  TF_RETURN_IF_ERROR(GetListOperationOptionsByProperty(request, &options));
+  return transaction_executor_->ExecuteReadOnly(
+      [this, &options, &response]() -> tensorflow::Status {
+        response->Clear();
+        std::vector<Artifact> artifacts;
+        std::string next_page_token;
+        const tensorflow::Status status =
+            metadata_access_object_->ListArtifacts(options, &artifacts,
+                                                   &next_page_token);
+        if (tensorflow::errors::IsNotFound(status)) {
+          return tensorflow::Status::OK();
+        } else if (!status.ok()) {
+          return status;
+        }
+        for (const Artifact& artifact : artifacts) {
+          *response->mutable_artifacts()->Add() = artifact;
+        }
+        if (!next_page_token.empty()) {
+          response->set_next_page_token(next_page_token);
+        }
+        return tensorflow::Status::OK();
+      });
+}
+
 tensorflow::Status MetadataStore::GetArtifactsByType(
     const GetArtifactsByTypeRequest& request,
     GetArtifactsByTypeResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         ArtifactType artifact_type;
@@ -904,7 +1483,7 @@ tensorflow::Status MetadataStore::GetArtifactsByType(
 tensorflow::Status MetadataStore::GetArtifactByTypeAndName(
     const GetArtifactByTypeAndNameRequest& request,
     GetArtifactByTypeAndNameResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         ArtifactType artifact_type;
@@ -931,7 +1510,7 @@ tensorflow::Status MetadataStore::GetArtifactByTypeAndName(
 tensorflow::Status MetadataStore::GetExecutionsByType(
     const GetExecutionsByTypeRequest& request,
     GetExecutionsByTypeResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         ExecutionType execution_type;
@@ -960,7 +1539,7 @@ tensorflow::Status MetadataStore::GetExecutionsByType(
 tensorflow::Status MetadataStore::GetExecutionByTypeAndName(
     const GetExecutionByTypeAndNameRequest& request,
     GetExecutionByTypeAndNameResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         ExecutionType execution_type;
@@ -984,10 +1563,38 @@ tensorflow::Status MetadataStore::GetExecutionByTypeAndName(
       });
 }
 
+tensorflow::Status MetadataStore::GetExecutionsByProperty(
+    const GetExecutionsByPropertyRequest& request,
+    GetExecutionsByPropertyResponse* response) {
+  ListOperationOptions options;
+  TF_RETURN_IF_ERROR(GetListOperationOptionsByProperty(request, &options));
+  return transaction_executor_->ExecuteReadOnly(
+      [this, &options, &response]() -> tensorflow::Status {
+        response->Clear();
+        std::vector<Execution> executions;
+        std::string next_page_token;
+        const tensorflow::Status status =
+            metadata_access_object_->ListExecutions(options, &executions,
+                                                    &next_page_token);
+        if (tensorflow::errors::IsNotFound(status)) {
+          return tensorflow::Status::OK();
+        } else if (!status.ok()) {
+          return status;
+        }
+        for (const Execution& execution : executions) {
+          *response->mutable_executions()->Add() = execution;
+        }
+        if (!next_page_token.empty()) {
+          response->set_next_page_token(next_page_token);
+        }
+        return tensorflow::Status::OK();
+      });
+}
+
 tensorflow::Status MetadataStore::GetContextsByType(
     const GetContextsByTypeRequest& request,
     GetContextsByTypeResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         ContextType context_type;
@@ -1016,7 +1623,7 @@ tensorflow::Status MetadataStore::GetContextsByType(
 tensorflow::Status MetadataStore::GetContextByTypeAndName(
     const GetContextByTypeAndNameRequest& request,
     GetContextByTypeAndNameResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         ContextType context_type;
@@ -1040,6 +1647,34 @@ tensorflow::Status MetadataStore::GetContextByTypeAndName(
       });
 }
 
+tensorflow::Status MetadataStore::GetContextsByProperty(
+    const GetContextsByPropertyRequest& request,
+    GetContextsByPropertyResponse* response) {
+  ListOperationOptions options;
+  TF_RETURN_IF_ERROR(GetListOperationOptionsByProperty(request, &options));
+  return transaction_executor_->ExecuteReadOnly(
+      [this, &options, &response]() -> tensorflow::Status {
+        response->Clear();
+        std::vector<Context> contexts;
+        std::string next_page_token;
+        const tensorflow::Status status =
+            metadata_access_object_->ListContexts(options, &contexts,
+                                                  &next_page_token);
+        if (tensorflow::errors::IsNotFound(status)) {
+          return tensorflow::Status::OK();
+        } else if (!status.ok()) {
+          return status;
+        }
+        for (const Context& context : contexts) {
+          *response->mutable_contexts()->Add() = context;
+        }
+        if (!next_page_token.empty()) {
+          response->set_next_page_token(next_page_token);
+        }
+        return tensorflow::Status::OK();
+      });
+}
+
 tensorflow::Status MetadataStore::PutAttributionsAndAssociations(
     const PutAttributionsAndAssociationsRequest& request,
     PutAttributionsAndAssociationsResponse* response) {
@@ -1063,7 +1698,7 @@ tensorflow::Status MetadataStore::PutAttributionsAndAssociations(
 tensorflow::Status MetadataStore::GetContextsByArtifact(
     const GetContextsByArtifactRequest& request,
     GetContextsByArtifactResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         std::vector<Context> contexts;
@@ -1079,7 +1714,7 @@ tensorflow::Status MetadataStore::GetContextsByArtifact(
 tensorflow::Status MetadataStore::GetContextsByExecution(
     const GetContextsByExecutionRequest& request,
     GetContextsByExecutionResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         std::vector<Context> contexts;
@@ -1095,7 +1730,7 @@ tensorflow::Status MetadataStore::GetContextsByExecution(
 tensorflow::Status MetadataStore::GetArtifactsByContext(
     const GetArtifactsByContextRequest& request,
     GetArtifactsByContextResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         std::vector<Artifact> artifacts;
@@ -1111,7 +1746,7 @@ tensorflow::Status MetadataStore::GetArtifactsByContext(
 tensorflow::Status MetadataStore::GetExecutionsByContext(
     const GetExecutionsByContextRequest& request,
     GetExecutionsByContextResponse* response) {
-  return transaction_executor_->Execute(
+  return transaction_executor_->ExecuteReadOnly(
       [this, &request, &response]() -> tensorflow::Status {
         response->Clear();
         std::vector<Execution> executions;
@@ -1124,6 +1759,263 @@ tensorflow::Status MetadataStore::GetExecutionsByContext(
       });
 }
 
+tensorflow::Status MetadataStore::StreamArtifacts(
+    const StreamArtifactsRequest& request, const StoreRunner& with_store,
+    const std::function<tensorflow::Status(const StreamArtifactsResponse&)>&
+        write) {
+  return StreamNodes<Artifact>(request.options(), with_store, write);
+}
+
+tensorflow::Status MetadataStore::StreamExecutions(
+    const StreamExecutionsRequest& request, const StoreRunner& with_store,
+    const std::function<tensorflow::Status(const StreamExecutionsResponse&)>&
+        write) {
+  return StreamNodes<Execution>(request.options(), with_store, write);
+}
+
+tensorflow::Status MetadataStore::StreamContexts(
+    const StreamContextsRequest& request, const StoreRunner& with_store,
+    const std::function<tensorflow::Status(const StreamContextsResponse&)>&
+        write) {
+  return StreamNodes<Context>(request.options(), with_store, write);
+}
+
+tensorflow::Status MetadataStore::ReadArtifactsPage(
+    const StreamArtifactsRequest& request, const StoreRunner& with_store,
+    StreamArtifactsResponse* response) {
+  return ReadNodesPage<Artifact>(request.options(), with_store, response);
+}
+
+tensorflow::Status MetadataStore::ReadExecutionsPage(
+    const StreamExecutionsRequest& request, const StoreRunner& with_store,
+    StreamExecutionsResponse* response) {
+  return ReadNodesPage<Execution>(request.options(), with_store, response);
+}
+
+tensorflow::Status MetadataStore::ReadContextsPage(
+    const StreamContextsRequest& request, const StoreRunner& with_store,
+    StreamContextsResponse* response) {
+  return ReadNodesPage<Context>(request.options(), with_store, response);
+}
+
+tensorflow::Status MetadataStore::StreamArtifacts(
+    const StreamArtifactsRequest& request,
+    const std::function<tensorflow::Status(const StreamArtifactsResponse&)>&
+        write) {
+  return StreamArtifacts(request, WithThisStore(), write);
+}
+
+tensorflow::Status MetadataStore::StreamExecutions(
+    const StreamExecutionsRequest& request,
+    const std::function<tensorflow::Status(const StreamExecutionsResponse&)>&
+        write) {
+  return StreamExecutions(request, WithThisStore(), write);
+}
+
+tensorflow::Status MetadataStore::StreamContexts(
+    const StreamContextsRequest& request,
+    const std::function<tensorflow::Status(const StreamContextsResponse&)>&
+        write) {
+  return StreamContexts(request, WithThisStore(), write);
+}
+
+tensorflow::Status MetadataStore::BulkPut(
+    const std::vector<BulkPutRequest>& requests, BulkPutResponse::Batch* batch,
+    std::vector<Event>* events) {
+  return transaction_executor_->Execute([this, &requests, batch,
+                                         events]() -> tensorflow::Status {
+    batch->clear_artifact_ids();
+    batch->clear_execution_ids();
+    batch->clear_context_ids();
+    batch->clear_event_ids();
+    // The nodes of all the requests are upserted together, so that the new
+    // nodes are created with a few multi-row inserts.
+    google::protobuf::RepeatedPtrField<Artifact> artifacts;
+    google::protobuf::RepeatedPtrField<Execution> executions;
+    google::protobuf::RepeatedPtrField<Context> contexts;
+    for (const BulkPutRequest& request : requests) {
+      artifacts.MergeFrom(request.artifacts());
+      executions.MergeFrom(request.executions());
+      contexts.MergeFrom(request.contexts());
+    }
+    TF_RETURN_IF_ERROR(UpsertArtifacts(artifacts, metadata_access_object_.get(),
+                                       batch->mutable_artifact_ids()));
+    TF_RETURN_IF_ERROR(UpsertExecutions(executions,
+                                        metadata_access_object_.get(),
+                                        batch->mutable_execution_ids()));
+    TF_RETURN_IF_ERROR(UpsertContexts(contexts, metadata_access_object_.get(),
+                                      batch->mutable_context_ids()));
+
+    // The node indexes of the edges are resolved to the ids of the nodes of
+    // their request, which start at the offsets.
+    std::vector<Event> inserted_events;
+    int artifact_offset = 0;
+    int execution_offset = 0;
+    int context_offset = 0;
+    for (const BulkPutRequest& request : requests) {
+      for (const BulkPutRequest::EventRecord& record : request.events()) {
+        Event event = record.event();
+        int64 node_id;
+        if (record.has_artifact_index()) {
+          TF_RETURN_IF_ERROR(GetBulkPutNodeId(
+              record.artifact_index(), request.artifacts_size(),
+              artifact_offset, batch->artifact_ids(), &node_id));
+          event.set_artifact_id(node_id);
+        }
+        if (record.has_execution_index()) {
+          TF_RETURN_IF_ERROR(GetBulkPutNodeId(
+              record.execution_index(), request.executions_size(),
+              execution_offset, batch->execution_ids(), &node_id));
+          event.set_execution_id(node_id);
+        }
+        inserted_events.push_back(std::move(event));
+      }
+      for (const BulkPutRequest::AttributionRecord& record :
+           request.attributions()) {
+        int64 artifact_id = record.attribution().artifact_id();
+        if (record.has_artifact_index()) {
+          TF_RETURN_IF_ERROR(GetBulkPutNodeId(
+              record.artifact_index(), request.artifacts_size(),
+              artifact_offset, batch->artifact_ids(), &artifact_id));
+        }
+        int64 context_id = record.attribution().context_id();
+        if (record.has_context_index()) {
+          TF_RETURN_IF_ERROR(GetBulkPutNodeId(
+              record.context_index(), request.contexts_size(), context_offset,
+              batch->context_ids(), &context_id));
+        }
+        TF_RETURN_IF_ERROR(InsertAttributionIfNotExist(
+            context_id, artifact_id, metadata_access_object_.get()));
+      }
+      for (const BulkPutRequest::AssociationRecord& record :
+           request.associations()) {
+        int64 execution_id = record.association().execution_id();
+        if (record.has_execution_index()) {
+          TF_RETURN_IF_ERROR(GetBulkPutNodeId(
+              record.execution_index(), request.executions_size(),
+              execution_offset, batch->execution_ids(), &execution_id));
+        }
+        int64 context_id = record.association().context_id();
+        if (record.has_context_index()) {
+          TF_RETURN_IF_ERROR(GetBulkPutNodeId(
+              record.context_index(), request.contexts_size(), context_offset,
+              batch->context_ids(), &context_id));
+        }
+        TF_RETURN_IF_ERROR(InsertAssociationIfNotExist(
+            context_id, execution_id, metadata_access_object_.get()));
+      }
+      artifact_offset += request.artifacts_size();
+      execution_offset += request.executions_size();
+      context_offset += request.contexts_size();
+    }
+    std::vector<int64> event_ids;
+    TF_RETURN_IF_ERROR(
+        metadata_access_object_->CreateEvents(inserted_events, &event_ids));
+    batch->mutable_event_ids()->Add(event_ids.begin(), event_ids.end());
+    if (events != nullptr) {
+      *events = std::move(inserted_events);
+    }
+    return tensorflow::Status::OK();
+  });
+}
+
+tensorflow::Status MetadataStore::GetLineageGraph(
+    const GetLineageGraphRequest& request, const LineageIndex& lineage_index,
+    GetLineageGraphResponse* response) {
+  return transaction_executor_->ExecuteReadOnly(
+      [this, &request, &lineage_index, &response]() -> tensorflow::Status {
+        response->Clear();
+        if (!request.artifact_type_names().empty() ||
+            !request.execution_type_names().empty()) {
+          return GetLineageGraphImpl(request, metadata_access_object_.get(),
+                                     response);
+        }
+        return GetLineageGraphFromIndex(request, lineage_index,
+                                        metadata_access_object_.get(),
+                                        response);
+      });
+}
+
+tensorflow::Status MetadataStore::GetMaxEventId(int64* max_event_id) {
+  return transaction_executor_->ExecuteReadOnly(
+      [this, &max_event_id]() -> tensorflow::Status {
+        return metadata_access_object_->FindMaxEventId(max_event_id);
+      });
+}
+
+tensorflow::Status MetadataStore::GetEventsByIdRange(
+    const int64 min_event_id, const int64 max_event_id,
+    std::vector<int64>* event_ids, std::vector<Event>* events) {
+  return transaction_executor_->ExecuteReadOnly(
+      [this, &min_event_id, &max_event_id, &event_ids,
+       &events]() -> tensorflow::Status {
+        return metadata_access_object_->FindEventsByIdRange(
+            min_event_id, max_event_id, event_ids, events);
+      });
+}
+
+template <typename Node, typename Response>
+tensorflow::Status MetadataStore::StreamNodes(
+    const ListOperationOptions& options, const StoreRunner& with_store,
+    const std::function<tensorflow::Status(const Response&)>& write) {
+  ListOperationOptions page_options = options;
+  while (true) {
+    Response response;
+    TF_RETURN_IF_ERROR(
+        ReadNodesPage<Node>(page_options, with_store, &response));
+    // The page is written once the store is released, so that a slow client
+    // keeps neither a transaction nor a connection.
+    TF_RETURN_IF_ERROR(write(response));
+    if (response.next_page_token().empty()) {
+      return tensorflow::Status::OK();
+    }
+    page_options.set_next_page_token(response.next_page_token());
+  }
+}
+
+template <typename Node, typename Response>
+tensorflow::Status MetadataStore::ReadNodesPage(
+    const ListOperationOptions& options, const StoreRunner& with_store,
+    Response* response) {
+  // The pages are capped to the max page size of the list operations, as the
+  // next page token is only returned for full pages.
+  ListOperationOptions page_options = options;
+  page_options.set_max_result_size(
+      std::min(options.max_result_size(), kMaxListOperationResultSize));
+  std::string next_page_token;
+  TF_RETURN_IF_ERROR(with_store([&page_options, response, &next_page_token](
+                                    MetadataStore* store) {
+    return store->transaction_executor_->ExecuteReadOnly(
+        [store, &page_options, response,
+         &next_page_token]() -> tensorflow::Status {
+          response->Clear();
+          next_page_token.clear();
+          std::vector<Node> nodes;
+          const tensorflow::Status status =
+              ListNodes(store->metadata_access_object_.get(), page_options,
+                        &nodes, &next_page_token);
+          if (tensorflow::errors::IsNotFound(status)) {
+            return tensorflow::Status::OK();
+          } else if (!status.ok()) {
+            return status;
+          }
+          for (Node& node : nodes) {
+            *MutableNodes(response)->Add() = std::move(node);
+          }
+          return tensorflow::Status::OK();
+        });
+  }));
+  if (!next_page_token.empty()) {
+    response->set_next_page_token(next_page_token);
+  }
+  return tensorflow::Status::OK();
+}
+
+MetadataStore::StoreRunner MetadataStore::WithThisStore() {
+  return [this](const std::function<tensorflow::Status(MetadataStore*)>& run) {
+    return run(this);
+  };
+}
 
 MetadataStore::MetadataStore(
     std::unique_ptr<MetadataSource> metadata_source,
@@ -15,8 +15,11 @@ limitations under the License.
 #ifndef ML_METADATA_METADATA_STORE_METADATA_STORE_H_
 #define ML_METADATA_METADATA_STORE_METADATA_STORE_H_
 
+#include <functional>
 #include <memory>
+#include <vector>
 
+#include "ml_metadata/metadata_store/lineage_index.h"
 #include "ml_metadata/metadata_store/metadata_access_object.h"
 #include "ml_metadata/metadata_store/metadata_source.h"
 #include "ml_metadata/metadata_store/metadata_store_service_interface.h"
@@ -62,6 +65,12 @@ class MetadataStore : public MetadataStoreServiceInterface {
   tensorflow::Status InitMetadataStoreIfNotExists(
       bool enable_upgrade_migration = false);
 
+  // Checks that the metadata source is still reachable, by reading the schema
+  // version in a transaction. It is used to validate long-lived stores, e.g.,
+  // the ones kept in a MetadataStorePool, before reusing them.
+  // Returns detailed INTERNAL error, if query execution fails.
+  tensorflow::Status HealthCheck();
+
   // Inserts or updates an artifact type.
   //
   // If no artifact type exists in the database with the given name, it creates
@@ -328,6 +337,18 @@ class MetadataStore : public MetadataStoreServiceInterface {
       const GetEventsByArtifactIDsRequest& request,
       GetEventsByArtifactIDsResponse* response) override;
 
+  // Gets the artifacts, executions and events reachable from the seed
+  // artifacts and executions of the request, breadth first, within
+  // max_num_hops events in the given direction. Each hop reads the events of
+  // the whole frontier, then the newly reached nodes, with a few queries.
+  // Returns INVALID_ARGUMENT error, if a limit of the request is negative, or
+  // max_num_nodes is not positive.
+  // Returns NOT_FOUND error, if a seed cannot be found.
+  // Returns detailed INTERNAL error, if query execution fails.
+  tensorflow::Status GetLineageGraph(
+      const GetLineageGraphRequest& request,
+      GetLineageGraphResponse* response) override;
+
   // Gets a list of artifacts by ID.
   // If no artifact with an ID exists, the artifact is skipped.
   // Sets the error field if any other internal errors are returned.
@@ -363,6 +384,15 @@ class MetadataStore : public MetadataStoreServiceInterface {
       const GetArtifactsByURIRequest& request,
       GetArtifactsByURIResponse* response) override;
 
+  // Gets a page of the artifacts whose property equals the value, or is in the
+  // range, of the request, with the ListOperationOptions of the request.
+  // Returns INVALID_ARGUMENT error, if the property name is not given, or
+  // neither or both of the value and the range are given.
+  // Returns detailed INTERNAL error, if query execution fails.
+  tensorflow::Status GetArtifactsByProperty(
+      const GetArtifactsByPropertyRequest& request,
+      GetArtifactsByPropertyResponse* response) override;
+
   // Gets a list of executions by ID.
   // If no execution with an ID exists, the execution is skipped.
   // Sets the error field if any other internal errors are returned.
@@ -391,6 +421,15 @@ class MetadataStore : public MetadataStoreServiceInterface {
       const GetExecutionByTypeAndNameRequest& request,
       GetExecutionByTypeAndNameResponse* response) override;
 
+  // Gets a page of the executions whose property equals the value, or is in the
+  // range, of the request, with the ListOperationOptions of the request.
+  // Returns INVALID_ARGUMENT error, if the property name is not given, or
+  // neither or both of the value and the range are given.
+  // Returns detailed INTERNAL error, if query execution fails.
+  tensorflow::Status GetExecutionsByProperty(
+      const GetExecutionsByPropertyRequest& request,
+      GetExecutionsByPropertyResponse* response) override;
+
   // Gets a list of contexts by ID.
   // If no context with an ID exists, the context is skipped.
   // Sets the error field if any other internal errors are returned.
@@ -419,6 +458,15 @@ class MetadataStore : public MetadataStoreServiceInterface {
       const GetContextByTypeAndNameRequest& request,
       GetContextByTypeAndNameResponse* response) override;
 
+  // Gets a page of the contexts whose property equals the value, or is in the
+  // range, of the request, with the ListOperationOptions of the request.
+  // Returns INVALID_ARGUMENT error, if the property name is not given, or
+  // neither or both of the value and the range are given.
+  // Returns detailed INTERNAL error, if query execution fails.
+  tensorflow::Status GetContextsByProperty(
+      const GetContextsByPropertyRequest& request,
+      GetContextsByPropertyResponse* response) override;
+
   // Inserts attribution and association relationships in the database.
   // The context_id, artifact_id, and execution_id must already exist.
   // If the relationship exists, this call does nothing. Once added, the
@@ -454,6 +502,112 @@ class MetadataStore : public MetadataStoreServiceInterface {
       const GetExecutionsByContextRequest& request,
       GetExecutionsByContextResponse* response) override;
 
+  // Runs the function it is given with a metadata store, e.g., one borrowed
+  // from a pool for the duration of the call, and returns its status.
+  using StoreRunner = std::function<tensorflow::Status(
+      const std::function<tensorflow::Status(MetadataStore*)>&)>;
+
+  // Streams all the artifacts in pages of the list options of the request,
+  // and passes each page to `write` as a response. Each page is read in its
+  // own read only transaction, with the store given by its own call of
+  // `with_store`. `write` is called once that call has returned, so that the
+  // store is not held while the page is written. The stream stops at the
+  // first error of `write`, which is returned.
+  // Returns INVALID_ARGUMENT error, if the list options are not valid.
+  // Returns the errors of `with_store`.
+  // Returns detailed INTERNAL error, if query execution fails.
+  static tensorflow::Status StreamArtifacts(
+      const StreamArtifactsRequest& request, const StoreRunner& with_store,
+      const std::function<tensorflow::Status(const StreamArtifactsResponse&)>&
+          write);
+
+  // Streams all the executions in pages, see StreamArtifacts.
+  static tensorflow::Status StreamExecutions(
+      const StreamExecutionsRequest& request, const StoreRunner& with_store,
+      const std::function<tensorflow::Status(const StreamExecutionsResponse&)>&
+          write);
+
+  // Streams all the contexts in pages, see StreamArtifacts.
+  static tensorflow::Status StreamContexts(
+      const StreamContextsRequest& request, const StoreRunner& with_store,
+      const std::function<tensorflow::Status(const StreamContextsResponse&)>&
+          write);
+
+  // Reads the first page of the artifacts of a StreamArtifacts request, i.e.,
+  // its first response, in one read only transaction with the store given by
+  // `with_store`. The pages after it are read with the next_page_token of the
+  // response in the list options of the request, so that the caller writes
+  // each page before it reads the next one.
+  // Returns INVALID_ARGUMENT error, if the list options are not valid.
+  // Returns the errors of `with_store`.
+  // Returns detailed INTERNAL error, if query execution fails.
+  static tensorflow::Status ReadArtifactsPage(
+      const StreamArtifactsRequest& request, const StoreRunner& with_store,
+      StreamArtifactsResponse* response);
+
+  // Reads the first page of the executions, see ReadArtifactsPage.
+  static tensorflow::Status ReadExecutionsPage(
+      const StreamExecutionsRequest& request, const StoreRunner& with_store,
+      StreamExecutionsResponse* response);
+
+  // Reads the first page of the contexts, see ReadArtifactsPage.
+  static tensorflow::Status ReadContextsPage(
+      const StreamContextsRequest& request, const StoreRunner& with_store,
+      StreamContextsResponse* response);
+
+  // Streams all the artifacts in pages with this store, see StreamArtifacts.
+  tensorflow::Status StreamArtifacts(
+      const StreamArtifactsRequest& request,
+      const std::function<tensorflow::Status(const StreamArtifactsResponse&)>&
+          write);
+
+  // Streams all the executions in pages with this store, see StreamArtifacts.
+  tensorflow::Status StreamExecutions(
+      const StreamExecutionsRequest& request,
+      const std::function<tensorflow::Status(const StreamExecutionsResponse&)>&
+          write);
+
+  // Streams all the contexts in pages with this store, see StreamArtifacts.
+  tensorflow::Status StreamContexts(
+      const StreamContextsRequest& request,
+      const std::function<tensorflow::Status(const StreamContextsResponse&)>&
+          write);
+
+  // Commits a batch of BulkPut requests in one transaction, and returns the
+  // ids of their nodes and events in `batch`, in the order of the requests.
+  // The nodes of all the requests are upserted first, the new ones with
+  // multi-row inserts, then the edges are inserted, the events with multi-row
+  // inserts. If `events` is not null, the inserted events, with the ids of
+  // their nodes, are returned in it, index-aligned with the event_ids.
+  // Returns INVALID_ARGUMENT error, if a node index of an edge is out of the
+  // range of the nodes of its request.
+  // Returns the errors of PutArtifacts, PutExecutions, PutContexts, PutEvents
+  // and PutAttributionsAndAssociations, if a record is invalid.
+  tensorflow::Status BulkPut(const std::vector<BulkPutRequest>& requests,
+                             BulkPutResponse::Batch* batch,
+                             std::vector<Event>* events);
+
+  // Answers the GetLineageGraph request with a traversal of `lineage_index`
+  // instead of reading the events hop by hop. The seeds, the reached nodes and
+  // the followed events, by id, are read in one read only transaction, with a
+  // few queries whatever the number of hops. The requests with type
+  // names are traversed in the database, as the index has no node types.
+  // Returns the errors of GetLineageGraph.
+  tensorflow::Status GetLineageGraph(const GetLineageGraphRequest& request,
+                                     const LineageIndex& lineage_index,
+                                     GetLineageGraphResponse* response);
+
+  // Gets the max id of the events, or 0 if there is no event.
+  // Returns detailed INTERNAL error, if query execution fails.
+  tensorflow::Status GetMaxEventId(int64* max_event_id);
+
+  // Gets the events whose ids are greater than `min_event_id` and not greater
+  // than `max_event_id`, ordered by id, without their paths. The ids of the
+  // events are returned in `event_ids`, index-aligned with `events`.
+  // Returns detailed INTERNAL error, if query execution fails.
+  tensorflow::Status GetEventsByIdRange(int64 min_event_id, int64 max_event_id,
+                                        std::vector<int64>* event_ids,
+                                        std::vector<Event>* events);
 
  private:
   // To construct the object, see Create(...).
@@ -461,6 +615,24 @@ class MetadataStore : public MetadataStoreServiceInterface {
                 std::unique_ptr<MetadataAccessObject> metadata_access_object,
                 std::unique_ptr<TransactionExecutor> transaction_executor);
 
+  // Streams the `Node`s, which are one of {Artifact, Execution, Context}, in
+  // pages of `options` as `Response`s, each read with a store of
+  // `with_store`.
+  template <typename Node, typename Response>
+  static tensorflow::Status StreamNodes(
+      const ListOperationOptions& options, const StoreRunner& with_store,
+      const std::function<tensorflow::Status(const Response&)>& write);
+
+  // Reads the first page of the `Node`s of `options` in `response`, with a
+  // store of `with_store`.
+  template <typename Node, typename Response>
+  static tensorflow::Status ReadNodesPage(const ListOperationOptions& options,
+                                          const StoreRunner& with_store,
+                                          Response* response);
+
+  // Returns a StoreRunner which runs the functions with this store.
+  StoreRunner WithThisStore();
+
   std::unique_ptr<MetadataSource> metadata_source_;
   std::unique_ptr<MetadataAccessObject> metadata_access_object_;
   std::unique_ptr<TransactionExecutor> transaction_executor_;
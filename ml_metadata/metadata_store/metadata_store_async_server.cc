@@ -0,0 +1,589 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "ml_metadata/metadata_store/metadata_store_async_server.h"
+
+#include "grpcpp/support/async_stream.h"
+#include "grpcpp/support/async_unary_call.h"
+#include "grpcpp/support/status_code_enum.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/monitoring/counter.h"
+
+namespace ml_metadata {
+namespace {
+
+// The counter of the requests that failed with RESOURCE_EXHAUSTED, across all
+// the servers of the process.
+tensorflow::monitoring::Counter<0>* RejectedRequestsCounter() {
+  static auto* counter = tensorflow::monitoring::Counter<0>::New(
+      "/ml_metadata/async_server/rejected_requests",
+      "The number of requests rejected as the queue of workers was full.");
+  return counter;
+}
+
+}  // namespace
+
+class MetadataStoreAsyncServer::Call {
+ public:
+  virtual ~Call() = default;
+
+  // Proceeds the call when its pending operation completes, with `ok` from
+  // the completion queue.
+  virtual void Proceed(bool ok) = 0;
+};
+
+// A call of a unary method. It requests a call of the method when created, and
+// when the call arrives, creates the next call of the method and runs the
+// request with `handler` in a worker. It deletes itself once the response is
+// sent.
+template <typename Request, typename Response>
+class MetadataStoreAsyncServer::UnaryCall final
+    : public MetadataStoreAsyncServer::Call {
+ public:
+  // The method of the asynchronous service requesting a call.
+  using RequestMethod = void (MetadataStoreService::AsyncService::*)(
+      ::grpc::ServerContext*, Request*,
+      ::grpc::ServerAsyncResponseWriter<Response>*, ::grpc::CompletionQueue*,
+      ::grpc::ServerCompletionQueue*, void*);
+  // The method of the service running a request.
+  using Handler = ::grpc::Status (MetadataStoreService::Service::*)(
+      ::grpc::ServerContext*, const Request*, Response*);
+
+  UnaryCall(MetadataStoreAsyncServer* server, RequestMethod request_method,
+            Handler handler, ::grpc::ServerCompletionQueue* cq)
+      : server_(server),
+        request_method_(request_method),
+        handler_(handler),
+        cq_(cq),
+        responder_(&context_) {
+    (server_->async_service_.*request_method_)(&context_, &request_,
+                                               &responder_, cq_, cq_, this);
+  }
+
+  void Proceed(const bool ok) override {
+    if (finishing_) {
+      if (admitted_) server_->ReleaseRequest();
+      delete this;
+      return;
+    }
+    // The call is cancelled by the shut down of the server.
+    if (!ok) {
+      delete this;
+      return;
+    }
+    absl::ReaderMutexLock lock(&server_->shutdown_mu_);
+    if (server_->shutting_down_) {
+      delete this;
+      return;
+    }
+    new UnaryCall(server_, request_method_, handler_, cq_);
+    finishing_ = true;
+    if (!server_->AdmitRequest()) {
+      RejectedRequestsCounter()->GetCell()->IncrementBy(1);
+      responder_.FinishWithError(
+          ::grpc::Status(::grpc::StatusCode::RESOURCE_EXHAUSTED,
+                         "The metadata store server is overloaded."),
+          this);
+      return;
+    }
+    admitted_ = true;
+    server_->workers_->Schedule([this]() {
+      const ::grpc::Status status =
+          (server_->service_->*handler_)(&context_, &request_, &response_);
+      responder_.Finish(response_, status, this);
+    });
+  }
+
+ private:
+  MetadataStoreAsyncServer* const server_;
+  const RequestMethod request_method_;
+  const Handler handler_;
+  ::grpc::ServerCompletionQueue* const cq_;
+
+  ::grpc::ServerContext context_;
+  Request request_;
+  Response response_;
+  ::grpc::ServerAsyncResponseWriter<Response> responder_;
+
+  // Whether the response is being sent.
+  bool finishing_ = false;
+  // Whether the request is admitted to the workers.
+  bool admitted_ = false;
+};
+
+// A call of a server streaming method. The completion queue drives the writes
+// of the responses, and the workers only read the pages, each read admitted
+// like a request. The next page is read once the previous one is written, and
+// the last page is written with the status. If a page read is not admitted,
+// the stream fails with RESOURCE_EXHAUSTED, and the client resumes it with the
+// next_page_token of its last response. It deletes itself once the status is
+// sent.
+template <typename Request, typename Response>
+class MetadataStoreAsyncServer::StreamCall final
+    : public MetadataStoreAsyncServer::Call {
+ public:
+  // The method of the asynchronous service requesting a call.
+  using RequestMethod = void (MetadataStoreService::AsyncService::*)(
+      ::grpc::ServerContext*, Request*, ::grpc::ServerAsyncWriter<Response>*,
+      ::grpc::CompletionQueue*, ::grpc::ServerCompletionQueue*, void*);
+  // The method of the service reading the first page of a request.
+  using Handler = ::grpc::Status (MetadataStoreServiceImpl::*)(
+      ::grpc::ServerContext*, const Request*, Response*);
+
+  StreamCall(MetadataStoreAsyncServer* server, RequestMethod request_method,
+             Handler handler, ::grpc::ServerCompletionQueue* cq)
+      : server_(server),
+        request_method_(request_method),
+        handler_(handler),
+        cq_(cq),
+        writer_(&context_) {
+    (server_->async_service_.*request_method_)(&context_, &request_, &writer_,
+                                               cq_, cq_, this);
+  }
+
+  void Proceed(const bool ok) override {
+    if (state_ == State::kFinishing) {
+      delete this;
+      return;
+    }
+    // The call is cancelled by the shut down of the server.
+    if (state_ == State::kRequested && !ok) {
+      delete this;
+      return;
+    }
+    // The stream is closed by the client, or the call is cancelled.
+    if (state_ == State::kWriting && !ok) {
+      state_ = State::kFinishing;
+      writer_.Finish(::grpc::Status(::grpc::StatusCode::CANCELLED,
+                                    "The stream is closed."),
+                     this);
+      return;
+    }
+    absl::ReaderMutexLock lock(&server_->shutdown_mu_);
+    if (server_->shutting_down_) {
+      delete this;
+      return;
+    }
+    if (state_ == State::kRequested) {
+      new StreamCall(server_, request_method_, handler_, cq_);
+    }
+    ReadPage();
+  }
+
+ private:
+  enum class State { kRequested, kWriting, kFinishing };
+
+  // Reads the next page in a worker, and writes it.
+  void ReadPage() ABSL_SHARED_LOCKS_REQUIRED(server_->shutdown_mu_) {
+    if (!server_->AdmitRequest()) {
+      state_ = State::kFinishing;
+      RejectedRequestsCounter()->GetCell()->IncrementBy(1);
+      writer_.Finish(
+          ::grpc::Status(::grpc::StatusCode::RESOURCE_EXHAUSTED,
+                         "The metadata store server is overloaded."),
+          this);
+      return;
+    }
+    server_->workers_->Schedule([this]() {
+      const ::grpc::Status status =
+          (server_->service_->*handler_)(&context_, &request_, &response_);
+      server_->ReleaseRequest();
+      // No operation is pending, so the pollers do not read the state.
+      if (!status.ok()) {
+        state_ = State::kFinishing;
+        writer_.Finish(status, this);
+      } else if (response_.next_page_token().empty()) {
+        state_ = State::kFinishing;
+        writer_.WriteAndFinish(response_, ::grpc::WriteOptions(),
+                               ::grpc::Status::OK, this);
+      } else {
+        request_.mutable_options()->set_next_page_token(
+            response_.next_page_token());
+        state_ = State::kWriting;
+        writer_.Write(response_, this);
+      }
+    });
+  }
+
+  MetadataStoreAsyncServer* const server_;
+  const RequestMethod request_method_;
+  const Handler handler_;
+  ::grpc::ServerCompletionQueue* const cq_;
+
+  ::grpc::ServerContext context_;
+  Request request_;
+  // The page being written.
+  Response response_;
+  ::grpc::ServerAsyncWriter<Response> writer_;
+
+  State state_ = State::kRequested;
+};
+
+// A call of BulkPut. The completion queue drives the reads of the requests,
+// which the pollers add to a BulkPutStream, and the workers only commit the
+// due batches, each commit admitted like a request. A batch delayed by
+// max_batch_delay_ms is scheduled by the timer of the service. If a commit is
+// not admitted, the stream ends with the batches committed so far, and the
+// client sends the other requests again. It deletes itself once the response
+// is sent.
+class MetadataStoreAsyncServer::BulkPutCall final
+    : public MetadataStoreAsyncServer::Call {
+ public:
+  BulkPutCall(MetadataStoreAsyncServer* server,
+              ::grpc::ServerCompletionQueue* cq)
+      : server_(server), cq_(cq), reader_(&context_) {
+    server_->async_service_.RequestBulkPut(&context_, &reader_, cq_, cq_,
+                                           this);
+  }
+
+  void Proceed(const bool ok) override {
+    // One operation of the call is pending at a time, so its completion reads
+    // the state set when it started.
+    switch (state_) {
+      case State::kRequested:
+        Start(ok);
+        return;
+      case State::kReading:
+        OnRead(ok);
+        return;
+      case State::kFinishing:
+        delete this;
+        return;
+    }
+  }
+
+ private:
+  enum class State { kRequested, kReading, kFinishing };
+
+  // Creates the next call of the method, and reads the first request.
+  void Start(const bool ok) {
+    // The call is cancelled by the shut down of the server.
+    if (!ok) {
+      delete this;
+      return;
+    }
+    {
+      absl::ReaderMutexLock lock(&server_->shutdown_mu_);
+      if (server_->shutting_down_) {
+        delete this;
+        return;
+      }
+      new BulkPutCall(server_, cq_);
+    }
+    stream_ = server_->service_->StartBulkPut(&response_,
+                                              [this]() { OnBatchDue(); });
+    absl::MutexLock lock(&mu_);
+    StartRead();
+  }
+
+  // Adds the request read to the stream, or ends the stream if the read
+  // failed, which it does once the client closes the stream.
+  void OnRead(const bool ok) {
+    bool deleted;
+    {
+      absl::MutexLock lock(&mu_);
+      read_pending_ = false;
+      if (!ok || end_of_stream_ || !stream_->Add(std::move(request_))) {
+        end_of_stream_ = true;
+      }
+      request_.Clear();
+      deleted = Continue();
+    }
+    if (deleted) delete this;
+  }
+
+  // Called by the timer of the service once the pending batch is due. A read
+  // or a worker of the call is pending then, so the call is not deleted here.
+  void OnBatchDue() {
+    absl::MutexLock lock(&mu_);
+    Continue();
+  }
+
+  // Starts the next step of the call, unless a worker is running: schedules a
+  // worker to commit the due batch, or to finish the call once the stream
+  // ends and no read is pending, or else reads the next request. Returns true
+  // if the call is to be deleted, as the server is shutting down and no
+  // operation is pending.
+  bool Continue() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (work_scheduled_) return false;
+    if (end_of_stream_) {
+      return read_pending_ ? false : ScheduleWork();
+    }
+    if (stream_->IsBatchDue()) return ScheduleWork();
+    if (!read_pending_) StartRead();
+    return false;
+  }
+
+  void StartRead() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    read_pending_ = true;
+    state_ = State::kReading;
+    reader_.Read(&request_, this);
+  }
+
+  // Schedules a worker, unless the server is shutting down. See Continue.
+  bool ScheduleWork() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    absl::ReaderMutexLock lock(&server_->shutdown_mu_);
+    if (server_->shutting_down_) {
+      end_of_stream_ = true;
+      return !read_pending_;
+    }
+    // Finishing a rejected stream commits nothing, and is not admitted.
+    bool admitted = false;
+    if (!rejected_) {
+      admitted = server_->AdmitRequest();
+      if (!admitted) {
+        RejectedRequestsCounter()->GetCell()->IncrementBy(1);
+        rejected_ = true;
+        end_of_stream_ = true;
+        if (read_pending_) return false;
+      }
+    }
+    work_scheduled_ = true;
+    server_->workers_->Schedule([this, admitted]() { Work(admitted); });
+    return false;
+  }
+
+  // Commits the due batch, or finishes the call at the end of the stream.
+  void Work(const bool admitted) {
+    bool finish;
+    {
+      absl::MutexLock lock(&mu_);
+      finish = end_of_stream_ && !read_pending_;
+    }
+    if (finish) {
+      Finish(admitted);
+      return;
+    }
+    stream_->CommitDueBatch();
+    if (admitted) server_->ReleaseRequest();
+    bool deleted;
+    {
+      absl::MutexLock lock(&mu_);
+      work_scheduled_ = false;
+      if (stream_->IsDone()) end_of_stream_ = true;
+      deleted = Continue();
+    }
+    if (deleted) delete this;
+  }
+
+  // Commits the pending requests, and sends the response. The requests of a
+  // cancelled stream are dropped, as its response is lost, and so are the
+  // ones of a rejected stream, which the client sends again.
+  void Finish(const bool admitted) {
+    bool rejected;
+    {
+      absl::MutexLock lock(&mu_);
+      rejected = rejected_;
+    }
+    ::grpc::Status status = stream_->Finish(
+        /*commit_pending_requests=*/!rejected && !context_.IsCancelled());
+    if (admitted) server_->ReleaseRequest();
+    if (status.ok() && rejected && response_.batches_size() == 0) {
+      status = ::grpc::Status(::grpc::StatusCode::RESOURCE_EXHAUSTED,
+                              "The metadata store server is overloaded.");
+    }
+    // No operation is pending, so the pollers do not read the state.
+    state_ = State::kFinishing;
+    if (status.ok()) {
+      reader_.Finish(response_, status, this);
+    } else {
+      reader_.FinishWithError(status, this);
+    }
+  }
+
+  MetadataStoreAsyncServer* const server_;
+  ::grpc::ServerCompletionQueue* const cq_;
+
+  ::grpc::ServerContext context_;
+  BulkPutRequest request_;
+  BulkPutResponse response_;
+  ::grpc::ServerAsyncReader<BulkPutResponse, BulkPutRequest> reader_;
+
+  State state_ = State::kRequested;
+
+  absl::Mutex mu_;
+  // Whether a read of a request is pending.
+  bool read_pending_ ABSL_GUARDED_BY(mu_) = false;
+  // Whether a worker is scheduled to commit a batch or finish the call.
+  bool work_scheduled_ ABSL_GUARDED_BY(mu_) = false;
+  // Whether no request is added to the stream anymore.
+  bool end_of_stream_ ABSL_GUARDED_BY(mu_) = false;
+  // Whether a commit of the stream was not admitted.
+  bool rejected_ ABSL_GUARDED_BY(mu_) = false;
+
+  // Destroyed first, as it waits for a running OnBatchDue, which uses the
+  // other members.
+  std::unique_ptr<MetadataStoreServiceImpl::BulkPutStream> stream_;
+};
+
+tensorflow::Status MetadataStoreAsyncServer::Create(
+    const AsyncServerConfig& config, MetadataStoreServiceImpl* service,
+    ::grpc::ServerBuilder* builder,
+    std::unique_ptr<MetadataStoreAsyncServer>* result) {
+  if (config.num_completion_queues() <= 0) {
+    return tensorflow::errors::InvalidArgument(
+        "num_completion_queues must be positive: ",
+        config.num_completion_queues());
+  }
+  if (config.num_workers() <= 0) {
+    return tensorflow::errors::InvalidArgument(
+        "num_workers must be positive: ", config.num_workers());
+  }
+  if (config.max_queued_requests() < 0) {
+    return tensorflow::errors::InvalidArgument(
+        "max_queued_requests must not be negative: ",
+        config.max_queued_requests());
+  }
+  auto server = absl::WrapUnique(new MetadataStoreAsyncServer(config, service));
+  builder->RegisterService(&server->async_service_);
+  for (int i = 0; i < config.num_completion_queues(); ++i) {
+    server->cqs_.push_back(builder->AddCompletionQueue());
+  }
+  *result = std::move(server);
+  return tensorflow::Status::OK();
+}
+
+MetadataStoreAsyncServer::MetadataStoreAsyncServer(
+    const AsyncServerConfig& config, MetadataStoreServiceImpl* service)
+    : config_(config),
+      service_(service),
+      workers_(absl::make_unique<tensorflow::thread::ThreadPool>(
+          tensorflow::Env::Default(), "mlmd_async_server_worker",
+          config.num_workers())) {}
+
+MetadataStoreAsyncServer::~MetadataStoreAsyncServer() { Shutdown(); }
+
+void MetadataStoreAsyncServer::Start() {
+  for (int i = 0; i < cqs_.size(); ++i) {
+    ::grpc::ServerCompletionQueue* cq = cqs_[i].get();
+    RequestCalls(cq);
+    poller_threads_.emplace_back(tensorflow::Env::Default()->StartThread(
+        tensorflow::ThreadOptions(), absl::StrCat("mlmd_async_server_cq_", i),
+        [this, cq]() { PollCompletionQueue(cq); }));
+  }
+}
+
+void MetadataStoreAsyncServer::Shutdown() {
+  {
+    absl::MutexLock lock(&shutdown_mu_);
+    if (shutting_down_) return;
+    shutting_down_ = true;
+  }
+  // The running requests send their responses before the queues are shut
+  // down.
+  workers_.reset();
+  for (const auto& cq : cqs_) {
+    cq->Shutdown();
+  }
+  if (poller_threads_.empty()) {
+    // The server is not started, and the queues are drained here.
+    for (const auto& cq : cqs_) {
+      PollCompletionQueue(cq.get());
+    }
+  }
+  // Destroying the threads joins them, once they have drained their queues.
+  poller_threads_.clear();
+}
+
+// Creates a call of `method` of the service, which deletes itself.
+#define MLMD_REQUEST_CALL(method, cq)                             \
+  new UnaryCall<method##Request, method##Response>(               \
+      this, &MetadataStoreService::AsyncService::Request##method, \
+      &MetadataStoreService::Service::method, cq)
+#define MLMD_REQUEST_STREAM_CALL(method, cq)                      \
+  new StreamCall<method##Request, method##Response>(              \
+      this, &MetadataStoreService::AsyncService::Request##method, \
+      &MetadataStoreServiceImpl::method##Page, cq)
+
+void MetadataStoreAsyncServer::RequestCalls(::grpc::ServerCompletionQueue* cq) {
+  MLMD_REQUEST_CALL(PutArtifactType, cq);
+  MLMD_REQUEST_CALL(GetArtifactType, cq);
+  MLMD_REQUEST_CALL(GetArtifactTypesByID, cq);
+  MLMD_REQUEST_CALL(GetArtifactTypes, cq);
+  MLMD_REQUEST_CALL(PutExecutionType, cq);
+  MLMD_REQUEST_CALL(GetExecutionType, cq);
+  MLMD_REQUEST_CALL(GetExecutionTypesByID, cq);
+  MLMD_REQUEST_CALL(GetExecutionTypes, cq);
+  MLMD_REQUEST_CALL(PutContextType, cq);
+  MLMD_REQUEST_CALL(GetContextType, cq);
+  MLMD_REQUEST_CALL(GetContextTypesByID, cq);
+  MLMD_REQUEST_CALL(GetContextTypes, cq);
+  MLMD_REQUEST_CALL(PutTypes, cq);
+  MLMD_REQUEST_CALL(PutArtifacts, cq);
+  MLMD_REQUEST_CALL(PutExecutions, cq);
+  MLMD_REQUEST_CALL(GetArtifactsByID, cq);
+  MLMD_REQUEST_CALL(GetExecutionsByID, cq);
+  MLMD_REQUEST_CALL(PutEvents, cq);
+  MLMD_REQUEST_CALL(PutExecution, cq);
+  MLMD_REQUEST_CALL(GetEventsByArtifactIDs, cq);
+  MLMD_REQUEST_CALL(GetEventsByExecutionIDs, cq);
+  MLMD_REQUEST_CALL(GetLineageGraph, cq);
+  MLMD_REQUEST_CALL(GetArtifacts, cq);
+  MLMD_REQUEST_CALL(GetArtifactsByType, cq);
+  MLMD_REQUEST_CALL(GetArtifactByTypeAndName, cq);
+  MLMD_REQUEST_CALL(GetArtifactsByURI, cq);
+  MLMD_REQUEST_CALL(GetArtifactsByProperty, cq);
+  MLMD_REQUEST_CALL(GetExecutions, cq);
+  MLMD_REQUEST_CALL(GetExecutionsByType, cq);
+  MLMD_REQUEST_CALL(GetExecutionByTypeAndName, cq);
+  MLMD_REQUEST_CALL(GetExecutionsByProperty, cq);
+  MLMD_REQUEST_CALL(PutContexts, cq);
+  MLMD_REQUEST_CALL(GetContextsByID, cq);
+  MLMD_REQUEST_CALL(GetContexts, cq);
+  MLMD_REQUEST_CALL(GetContextsByType, cq);
+  MLMD_REQUEST_CALL(GetContextByTypeAndName, cq);
+  MLMD_REQUEST_CALL(GetContextsByProperty, cq);
+  MLMD_REQUEST_CALL(PutAttributionsAndAssociations, cq);
+  MLMD_REQUEST_CALL(PutParentContexts, cq);
+  MLMD_REQUEST_CALL(GetContextsByArtifact, cq);
+  MLMD_REQUEST_CALL(GetContextsByExecution, cq);
+  MLMD_REQUEST_CALL(GetArtifactsByContext, cq);
+  MLMD_REQUEST_CALL(GetExecutionsByContext, cq);
+  MLMD_REQUEST_CALL(GetParentContextsByContext, cq);
+  MLMD_REQUEST_CALL(GetChildrenContextsByContext, cq);
+  MLMD_REQUEST_STREAM_CALL(StreamArtifacts, cq);
+  MLMD_REQUEST_STREAM_CALL(StreamExecutions, cq);
+  MLMD_REQUEST_STREAM_CALL(StreamContexts, cq);
+  new BulkPutCall(this, cq);
+}
+
+#undef MLMD_REQUEST_CALL
+#undef MLMD_REQUEST_STREAM_CALL
+
+void MetadataStoreAsyncServer::PollCompletionQueue(
+    ::grpc::ServerCompletionQueue* cq) {
+  void* tag;
+  bool ok;
+  while (cq->Next(&tag, &ok)) {
+    static_cast<Call*>(tag)->Proceed(ok);
+  }
+}
+
+bool MetadataStoreAsyncServer::AdmitRequest() {
+  const int max_admitted_requests =
+      config_.num_workers() + config_.max_queued_requests();
+  if (num_admitted_requests_.fetch_add(1) >= max_admitted_requests) {
+    num_admitted_requests_.fetch_sub(1);
+    return false;
+  }
+  return true;
+}
+
+void MetadataStoreAsyncServer::ReleaseRequest() {
+  num_admitted_requests_.fetch_sub(1);
+}
+
+}  // namespace ml_metadata
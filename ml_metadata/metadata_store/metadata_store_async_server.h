@@ -0,0 +1,132 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef ML_METADATA_METADATA_STORE_METADATA_STORE_ASYNC_SERVER_H_
+#define ML_METADATA_METADATA_STORE_METADATA_STORE_ASYNC_SERVER_H_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "grpcpp/server_builder.h"
+#include "absl/synchronization/mutex.h"
+#include "ml_metadata/metadata_store/metadata_store_service_impl.h"
+#include "ml_metadata/proto/metadata_store.pb.h"
+#include "ml_metadata/proto/metadata_store_service.grpc.pb.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
+
+namespace ml_metadata {
+
+// Serves the MetadataStoreService with the gRPC asynchronous API.
+//
+// The synchronous server runs each request in a gRPC thread, which blocks on
+// the database for the duration of the request, and creates more threads as
+// more requests arrive. Instead, this server receives the requests on a fixed
+// number of completion queues, and runs them with the methods of a
+// MetadataStoreServiceImpl in a pool of num_workers threads. At most
+// max_queued_requests requests wait for a worker; the requests received when
+// the queue is full fail at once with RESOURCE_EXHAUSTED. The streams are
+// written and read by the pollers, and only take a worker to read a page of
+// responses, or to commit a batch of BulkPut requests, so that slow or paused
+// clients do not hold the workers.
+//
+// Usage example:
+//   MetadataStoreServiceImpl service(connection_config);
+//   ::grpc::ServerBuilder builder;
+//   builder.AddListeningPort(...);
+//   std::unique_ptr<MetadataStoreAsyncServer> async_server;
+//   TF_CHECK_OK(MetadataStoreAsyncServer::Create(config, &service, &builder,
+//                                                &async_server));
+//   std::unique_ptr<::grpc::Server> server(builder.BuildAndStart());
+//   async_server->Start();
+//   ...
+//   server->Shutdown();
+//   async_server->Shutdown();
+class MetadataStoreAsyncServer {
+ public:
+  // Factory method that registers the asynchronous service and its completion
+  // queues to `builder`, to serve the requests with `service`, which must
+  // outlive the server. The requests are received once the server built by
+  // `builder` is started, and Start() is called.
+  // Returns INVALID_ARGUMENT error, if the config is not valid.
+  static tensorflow::Status Create(
+      const AsyncServerConfig& config, MetadataStoreServiceImpl* service,
+      ::grpc::ServerBuilder* builder,
+      std::unique_ptr<MetadataStoreAsyncServer>* result);
+
+  // Calls Shutdown().
+  ~MetadataStoreAsyncServer();
+
+  // Disallows copy.
+  MetadataStoreAsyncServer(const MetadataStoreAsyncServer&) = delete;
+  MetadataStoreAsyncServer& operator=(const MetadataStoreAsyncServer&) =
+      delete;
+
+  // Requests the calls of every method on every completion queue, and starts
+  // the threads polling the queues. It must be called once, after the server
+  // built with the builder given to Create is started.
+  void Start();
+
+  // Waits for the running requests, then shuts down the completion queues and
+  // joins their threads. The gRPC server must be shut down first.
+  void Shutdown();
+
+ private:
+  // A call of a method, which is the tag of its operations on its completion
+  // queue. See metadata_store_async_server.cc.
+  class Call;
+  template <typename Request, typename Response>
+  class UnaryCall;
+  template <typename Request, typename Response>
+  class StreamCall;
+  class BulkPutCall;
+
+  // To construct the object, see Create(...).
+  MetadataStoreAsyncServer(const AsyncServerConfig& config,
+                           MetadataStoreServiceImpl* service);
+
+  // Requests a call of each method on `cq`.
+  void RequestCalls(::grpc::ServerCompletionQueue* cq);
+
+  // Takes the tags of `cq` and proceeds their calls, until it is shut down.
+  void PollCompletionQueue(::grpc::ServerCompletionQueue* cq);
+
+  // Reserves a worker or a place in the queue for a request. Returns false if
+  // the queue is full.
+  bool AdmitRequest();
+
+  // Releases the reservation of an admitted request, once it is finished.
+  void ReleaseRequest();
+
+  const AsyncServerConfig config_;
+  MetadataStoreServiceImpl* const service_;
+  MetadataStoreService::AsyncService async_service_;
+  std::vector<std::unique_ptr<::grpc::ServerCompletionQueue>> cqs_;
+  std::vector<std::unique_ptr<tensorflow::Thread>> poller_threads_;
+  std::unique_ptr<tensorflow::thread::ThreadPool> workers_;
+
+  // The number of admitted requests that are not finished yet.
+  std::atomic<int> num_admitted_requests_{0};
+
+  // Once set, the calls take no new request, and the received requests are
+  // dropped. The readers are the calls scheduling workers.
+  absl::Mutex shutdown_mu_;
+  bool shutting_down_ ABSL_GUARDED_BY(shutdown_mu_) = false;
+};
+
+}  // namespace ml_metadata
+
+#endif  // ML_METADATA_METADATA_STORE_METADATA_STORE_ASYNC_SERVER_H_
@@ -0,0 +1,432 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "ml_metadata/metadata_store/metadata_store_async_server.h"
+
+#include <memory>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "grpcpp/create_channel.h"
+#include "grpcpp/security/credentials.h"
+#include "grpcpp/security/server_credentials.h"
+#include "grpcpp/server.h"
+#include "grpcpp/server_builder.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
+#include "ml_metadata/metadata_store/metadata_store_service_impl.h"
+#include "ml_metadata/metadata_store/test_util.h"
+#include "ml_metadata/proto/metadata_store.pb.h"
+#include "ml_metadata/proto/metadata_store_service.grpc.pb.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+
+namespace ml_metadata {
+namespace {
+
+using testing::EqualsProto;
+using testing::ParseTextProtoOrDie;
+
+// Returns a service with a single in-memory SQLite store, so that all the
+// requests see the same database.
+std::unique_ptr<MetadataStoreServiceImpl> CreateService() {
+  ConnectionConfig connection_config;
+  connection_config.mutable_sqlite();
+  ConnectionPoolConfig pool_config;
+  pool_config.set_max_pool_size(1);
+  return absl::make_unique<MetadataStoreServiceImpl>(connection_config,
+                                                     pool_config);
+}
+
+TEST(MetadataStoreAsyncServerTest, InvalidConfig) {
+  std::unique_ptr<MetadataStoreServiceImpl> service = CreateService();
+  for (const char* config : {"num_completion_queues: 0", "num_workers: 0",
+                             "max_queued_requests: -1"}) {
+    ::grpc::ServerBuilder builder;
+    std::unique_ptr<MetadataStoreAsyncServer> async_server;
+    EXPECT_TRUE(
+        tensorflow::errors::IsInvalidArgument(MetadataStoreAsyncServer::Create(
+            ParseTextProtoOrDie<AsyncServerConfig>(config), service.get(),
+            &builder, &async_server)));
+  }
+}
+
+TEST(MetadataStoreAsyncServerTest, InvalidBulkPutConfig) {
+  ConnectionConfig connection_config;
+  connection_config.mutable_sqlite();
+  for (const char* config : {"max_batch_size: 0", "max_batch_delay_ms: -1",
+                             "max_batches_per_stream: 0"}) {
+    std::unique_ptr<MetadataStoreServiceImpl> service;
+    EXPECT_TRUE(
+        tensorflow::errors::IsInvalidArgument(MetadataStoreServiceImpl::Create(
+            connection_config, ConnectionPoolConfig(),
+            ParseTextProtoOrDie<BulkPutConfig>(config), &service)));
+  }
+}
+
+// Returns a service with a single in-memory SQLite store and the
+// bulk_put_config, and puts an artifact type in `type_id`.
+std::unique_ptr<MetadataStoreServiceImpl> CreateBulkPutService(
+    const BulkPutConfig& bulk_put_config, int64* type_id) {
+  ConnectionConfig connection_config;
+  connection_config.mutable_sqlite();
+  ConnectionPoolConfig pool_config;
+  pool_config.set_max_pool_size(1);
+  std::unique_ptr<MetadataStoreServiceImpl> service;
+  TF_CHECK_OK(MetadataStoreServiceImpl::Create(
+      connection_config, pool_config, bulk_put_config, &service));
+  PutArtifactTypeRequest request;
+  request.mutable_artifact_type()->set_name("test_type");
+  PutArtifactTypeResponse response;
+  CHECK(service->PutArtifactType(/*context=*/nullptr, &request, &response)
+            .ok());
+  *type_id = response.type_id();
+  return service;
+}
+
+TEST(MetadataStoreAsyncServerTest, BulkPutEndsTheStreamAfterMaxBatches) {
+  int64 type_id;
+  std::unique_ptr<MetadataStoreServiceImpl> service =
+      CreateBulkPutService(ParseTextProtoOrDie<BulkPutConfig>(R"(
+                             max_batch_size: 1
+                             max_batch_delay_ms: 0
+                             max_batches_per_stream: 2
+                           )"),
+                           &type_id);
+  BulkPutResponse response;
+  std::unique_ptr<MetadataStoreServiceImpl::BulkPutStream> stream =
+      service->StartBulkPut(&response, /*on_batch_due=*/nullptr);
+  BulkPutRequest request;
+  request.add_artifacts()->set_type_id(type_id);
+  for (int i = 0; i < 2; i++) {
+    ASSERT_TRUE(stream->Add(request));
+    EXPECT_TRUE(stream->IsBatchDue());
+    stream->CommitDueBatch();
+  }
+  // The third request is not added once the stream has two batches.
+  EXPECT_TRUE(stream->IsDone());
+  EXPECT_FALSE(stream->Add(request));
+  ASSERT_TRUE(stream->Finish(/*commit_pending_requests=*/true).ok());
+  ASSERT_EQ(response.batches_size(), 2);
+  for (int i = 0; i < 2; i++) {
+    EXPECT_EQ(response.batches(i).first_request_index(), i);
+    EXPECT_EQ(response.batches(i).error_code(), 0);
+    EXPECT_EQ(response.batches(i).artifact_ids_size(), 1);
+  }
+}
+
+// Returns true once the service has `num_artifacts` artifacts, or false if
+// it does not have them after about 10 seconds.
+bool WaitForArtifacts(MetadataStoreServiceImpl* service, int num_artifacts) {
+  for (int i = 0; i < 1000; i++) {
+    GetArtifactsRequest request;
+    GetArtifactsResponse response;
+    CHECK(service->GetArtifacts(/*context=*/nullptr, &request, &response).ok());
+    if (response.artifacts_size() == num_artifacts) return true;
+    absl::SleepFor(absl::Milliseconds(10));
+  }
+  return false;
+}
+
+TEST(MetadataStoreAsyncServerTest, BulkPutCommitsADelayedBatchWhileWaiting) {
+  int64 type_id;
+  std::unique_ptr<MetadataStoreServiceImpl> service =
+      CreateBulkPutService(ParseTextProtoOrDie<BulkPutConfig>(R"(
+                             max_batch_size: 1000
+                             max_batch_delay_ms: 10
+                           )"),
+                           &type_id);
+  // The client pauses after its first request, and the timer commits the
+  // batch of the request once it is due.
+  BulkPutResponse response;
+  std::unique_ptr<MetadataStoreServiceImpl::BulkPutStream> stream =
+      service->StartBulkPut(&response, /*on_batch_due=*/nullptr);
+  BulkPutRequest request;
+  request.add_artifacts()->set_type_id(type_id);
+  ASSERT_TRUE(stream->Add(request));
+  EXPECT_TRUE(WaitForArtifacts(service.get(), 1));
+  ASSERT_TRUE(stream->Finish(/*commit_pending_requests=*/true).ok());
+  ASSERT_EQ(response.batches_size(), 1);
+  EXPECT_EQ(response.batches(0).num_requests(), 1);
+  EXPECT_EQ(response.batches(0).artifact_ids_size(), 1);
+}
+
+TEST(MetadataStoreAsyncServerTest, BulkPutCallsOnBatchDue) {
+  int64 type_id;
+  std::unique_ptr<MetadataStoreServiceImpl> service =
+      CreateBulkPutService(ParseTextProtoOrDie<BulkPutConfig>(R"(
+                             max_batch_size: 1000
+                             max_batch_delay_ms: 10
+                           )"),
+                           &type_id);
+  absl::Notification batch_due;
+  BulkPutResponse response;
+  std::unique_ptr<MetadataStoreServiceImpl::BulkPutStream> stream =
+      service->StartBulkPut(&response, [&batch_due]() { batch_due.Notify(); });
+  BulkPutRequest request;
+  request.add_artifacts()->set_type_id(type_id);
+  ASSERT_TRUE(stream->Add(request));
+  ASSERT_TRUE(batch_due.WaitForNotificationWithTimeout(absl::Seconds(10)));
+  // The timer leaves the commit to the caller.
+  EXPECT_TRUE(stream->IsBatchDue());
+  EXPECT_EQ(response.batches_size(), 0);
+  stream->CommitDueBatch();
+  ASSERT_TRUE(stream->Finish(/*commit_pending_requests=*/true).ok());
+  ASSERT_EQ(response.batches_size(), 1);
+  EXPECT_EQ(response.batches(0).artifact_ids_size(), 1);
+}
+
+TEST(MetadataStoreAsyncServerTest, BulkPutAddsTheEventsToTheLineageIndex) {
+  int64 artifact_type_id;
+  std::unique_ptr<MetadataStoreServiceImpl> service =
+      CreateBulkPutService(BulkPutConfig(), &artifact_type_id);
+  // Without catch ups, the index only has the events written by the service.
+  TF_ASSERT_OK(service->EnableLineageIndex(
+      ParseTextProtoOrDie<LineageIndexConfig>("catch_up_interval_sec: 0")));
+  PutExecutionTypeRequest put_type_request;
+  put_type_request.mutable_execution_type()->set_name("test_type");
+  PutExecutionTypeResponse put_type_response;
+  ASSERT_TRUE(service
+                  ->PutExecutionType(/*context=*/nullptr, &put_type_request,
+                                     &put_type_response)
+                  .ok());
+
+  BulkPutResponse response;
+  std::unique_ptr<MetadataStoreServiceImpl::BulkPutStream> stream =
+      service->StartBulkPut(&response, /*on_batch_due=*/nullptr);
+  ASSERT_TRUE(stream->Add(ParseTextProtoOrDie<BulkPutRequest>(absl::StrCat(
+      "artifacts: { type_id: ", artifact_type_id, " } ",
+      "executions: { type_id: ", put_type_response.type_id(), " } ",
+      "events: { event: { type: OUTPUT } artifact_index: 0 "
+      "execution_index: 0 }"))));
+  ASSERT_TRUE(stream->Finish(/*commit_pending_requests=*/true).ok());
+  ASSERT_EQ(response.batches_size(), 1);
+  ASSERT_EQ(response.batches(0).event_ids_size(), 1);
+
+  GetLineageGraphRequest request;
+  request.add_artifact_ids(response.batches(0).artifact_ids(0));
+  GetLineageGraphResponse graph;
+  ASSERT_TRUE(
+      service->GetLineageGraph(/*context=*/nullptr, &request, &graph).ok());
+  ASSERT_EQ(graph.executions_size(), 1);
+  EXPECT_EQ(graph.executions(0).id(), response.batches(0).execution_ids(0));
+  EXPECT_EQ(graph.events_size(), 1);
+}
+
+TEST(MetadataStoreAsyncServerTest, StreamReleasesTheStoreBetweenPages) {
+  // The pool has a single store, which the writes of the stream borrow.
+  std::unique_ptr<MetadataStoreServiceImpl> service = CreateService();
+  PutArtifactTypeRequest put_type_request;
+  put_type_request.mutable_artifact_type()->set_name("test_type");
+  PutArtifactTypeResponse put_type_response;
+  ASSERT_TRUE(service
+                  ->PutArtifactType(/*context=*/nullptr, &put_type_request,
+                                    &put_type_response)
+                  .ok());
+  PutArtifactsRequest put_artifacts_request;
+  for (int i = 0; i < 3; i++) {
+    put_artifacts_request.add_artifacts()->set_type_id(
+        put_type_response.type_id());
+  }
+  PutArtifactsResponse put_artifacts_response;
+  ASSERT_TRUE(service
+                  ->PutArtifacts(/*context=*/nullptr, &put_artifacts_request,
+                                 &put_artifacts_response)
+                  .ok());
+
+  StreamArtifactsRequest stream_request;
+  stream_request.mutable_options()->set_max_result_size(1);
+  int num_artifacts = 0;
+  int num_pages = 0;
+  while (true) {
+    StreamArtifactsResponse response;
+    ASSERT_TRUE(service
+                    ->StreamArtifactsPage(/*context=*/nullptr, &stream_request,
+                                          &response)
+                    .ok());
+    num_artifacts += response.artifacts_size();
+    num_pages++;
+    // The store of the page is returned once it is read.
+    GetArtifactTypesRequest request;
+    GetArtifactTypesResponse types_response;
+    ASSERT_TRUE(service
+                    ->GetArtifactTypes(/*context=*/nullptr, &request,
+                                       &types_response)
+                    .ok());
+    if (response.next_page_token().empty()) break;
+    stream_request.mutable_options()->set_next_page_token(
+        response.next_page_token());
+  }
+  EXPECT_EQ(num_artifacts, 3);
+  EXPECT_EQ(num_pages, 3);
+}
+
+TEST(MetadataStoreAsyncServerTest, ServeRequests) {
+  std::unique_ptr<MetadataStoreServiceImpl> service = CreateService();
+  ::grpc::ServerBuilder builder;
+  int port = 0;
+  builder.AddListeningPort("localhost:0", ::grpc::InsecureServerCredentials(),
+                           &port);
+  std::unique_ptr<MetadataStoreAsyncServer> async_server;
+  TF_ASSERT_OK(MetadataStoreAsyncServer::Create(
+      ParseTextProtoOrDie<AsyncServerConfig>(
+          "num_completion_queues: 2 num_workers: 2"),
+      service.get(), &builder, &async_server));
+  std::unique_ptr<::grpc::Server> server(builder.BuildAndStart());
+  ASSERT_GT(port, 0);
+  async_server->Start();
+
+  std::unique_ptr<MetadataStoreService::Stub> stub =
+      MetadataStoreService::NewStub(::grpc::CreateChannel(
+          absl::StrCat("localhost:", port),
+          ::grpc::InsecureChannelCredentials()));
+  PutArtifactTypeRequest put_request =
+      ParseTextProtoOrDie<PutArtifactTypeRequest>(R"(
+        all_fields_match: true
+        artifact_type: { name: 'test_type' properties { key: 'p' value: INT } }
+      )");
+  PutArtifactTypeResponse put_response;
+  {
+    ::grpc::ClientContext context;
+    ASSERT_TRUE(
+        stub->PutArtifactType(&context, put_request, &put_response).ok());
+  }
+
+  GetArtifactTypeRequest get_request;
+  get_request.set_type_name("test_type");
+  GetArtifactTypeResponse get_response;
+  {
+    ::grpc::ClientContext context;
+    ASSERT_TRUE(
+        stub->GetArtifactType(&context, get_request, &get_response).ok());
+  }
+  ArtifactType want_type = put_request.artifact_type();
+  want_type.set_id(put_response.type_id());
+  EXPECT_THAT(get_response.artifact_type(), EqualsProto(want_type));
+
+  // The streaming methods read the pages in the workers, and send them from
+  // the completion queues.
+  {
+    PutArtifactsRequest put_artifacts_request;
+    put_artifacts_request.add_artifacts()->set_type_id(put_response.type_id());
+    PutArtifactsResponse put_artifacts_response;
+    ::grpc::ClientContext put_context;
+    ASSERT_TRUE(stub->PutArtifacts(&put_context, put_artifacts_request,
+                                   &put_artifacts_response)
+                    .ok());
+
+    ::grpc::ClientContext context;
+    std::unique_ptr<::grpc::ClientReader<StreamArtifactsResponse>> reader =
+        stub->StreamArtifacts(&context, StreamArtifactsRequest());
+    StreamArtifactsResponse response;
+    ASSERT_TRUE(reader->Read(&response));
+    ASSERT_EQ(response.artifacts_size(), 1);
+    EXPECT_EQ(response.artifacts(0).id(),
+              put_artifacts_response.artifact_ids(0));
+    EXPECT_FALSE(reader->Read(&response));
+    EXPECT_TRUE(reader->Finish().ok());
+  }
+
+  // The client streaming methods read the requests from the completion
+  // queues, and commit them in the workers.
+  {
+    ::grpc::ClientContext context;
+    BulkPutResponse response;
+    std::unique_ptr<::grpc::ClientWriter<BulkPutRequest>> writer =
+        stub->BulkPut(&context, &response);
+    BulkPutRequest request;
+    request.add_artifacts()->set_type_id(put_response.type_id());
+    ASSERT_TRUE(writer->Write(request));
+    ASSERT_TRUE(writer->Write(request));
+    ASSERT_TRUE(writer->WritesDone());
+    ASSERT_TRUE(writer->Finish().ok());
+    ASSERT_EQ(response.batches_size(), 1);
+    EXPECT_EQ(response.batches(0).num_requests(), 2);
+    EXPECT_EQ(response.batches(0).error_code(), 0);
+    EXPECT_EQ(response.batches(0).artifact_ids_size(), 2);
+  }
+
+  // The methods the service does not implement are still answered.
+  {
+    ::grpc::ClientContext context;
+    PutTypesResponse response;
+    EXPECT_EQ(stub->PutTypes(&context, PutTypesRequest(), &response)
+                  .error_code(),
+              ::grpc::StatusCode::UNIMPLEMENTED);
+  }
+
+  server->Shutdown();
+  async_server->Shutdown();
+}
+
+TEST(MetadataStoreAsyncServerTest, PausedBulkPutDoesNotHoldAWorker) {
+  std::unique_ptr<MetadataStoreServiceImpl> service = CreateService();
+  ::grpc::ServerBuilder builder;
+  int port = 0;
+  builder.AddListeningPort("localhost:0", ::grpc::InsecureServerCredentials(),
+                           &port);
+  std::unique_ptr<MetadataStoreAsyncServer> async_server;
+  TF_ASSERT_OK(MetadataStoreAsyncServer::Create(
+      ParseTextProtoOrDie<AsyncServerConfig>(
+          "num_workers: 1 max_queued_requests: 1"),
+      service.get(), &builder, &async_server));
+  std::unique_ptr<::grpc::Server> server(builder.BuildAndStart());
+  ASSERT_GT(port, 0);
+  async_server->Start();
+
+  std::unique_ptr<MetadataStoreService::Stub> stub =
+      MetadataStoreService::NewStub(::grpc::CreateChannel(
+          absl::StrCat("localhost:", port),
+          ::grpc::InsecureChannelCredentials()));
+  PutArtifactTypeRequest put_type_request;
+  put_type_request.mutable_artifact_type()->set_name("test_type");
+  PutArtifactTypeResponse put_type_response;
+  {
+    ::grpc::ClientContext context;
+    ASSERT_TRUE(
+        stub->PutArtifactType(&context, put_type_request, &put_type_response)
+            .ok());
+  }
+
+  // The stream pauses with a pending batch, while the only worker runs other
+  // requests, which would wait for the worker until their deadline if the
+  // stream held it.
+  ::grpc::ClientContext bulk_put_context;
+  BulkPutResponse bulk_put_response;
+  std::unique_ptr<::grpc::ClientWriter<BulkPutRequest>> writer =
+      stub->BulkPut(&bulk_put_context, &bulk_put_response);
+  BulkPutRequest request;
+  request.add_artifacts()->set_type_id(put_type_response.type_id());
+  ASSERT_TRUE(writer->Write(request));
+  for (int i = 0; i < 3; i++) {
+    ::grpc::ClientContext context;
+    context.set_deadline(absl::ToChronoTime(absl::Now() + absl::Seconds(10)));
+    GetArtifactTypesResponse response;
+    EXPECT_TRUE(
+        stub->GetArtifactTypes(&context, GetArtifactTypesRequest(), &response)
+            .ok());
+  }
+  ASSERT_TRUE(writer->WritesDone());
+  ASSERT_TRUE(writer->Finish().ok());
+  ASSERT_EQ(bulk_put_response.batches_size(), 1);
+  EXPECT_EQ(bulk_put_response.batches(0).artifact_ids_size(), 1);
+
+  server->Shutdown();
+  async_server->Shutdown();
+}
+
+}  // namespace
+}  // namespace ml_metadata
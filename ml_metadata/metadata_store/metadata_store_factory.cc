@@ -28,14 +28,35 @@ namespace ml_metadata {
 
 namespace {
 
+// Returns InvalidArgument if the backoffs of `retry_options` are negative, or
+// the max backoff is less than the initial one.
+tensorflow::Status ValidateTransactionRetryOptions(
+    const RetryOptions::TransactionRetryOptions& retry_options) {
+  if (retry_options.max_num_retries() < 0 ||
+      retry_options.initial_backoff_ms() < 0 ||
+      retry_options.max_backoff_ms() < 0 || retry_options.deadline_ms() < 0) {
+    return tensorflow::errors::InvalidArgument(
+        "The transaction retry options must not be negative: ",
+        retry_options.DebugString());
+  }
+  if (retry_options.max_backoff_ms() < retry_options.initial_backoff_ms()) {
+    return tensorflow::errors::InvalidArgument(
+        "The max_backoff_ms of the transaction retry options must not be less "
+        "than the initial_backoff_ms: ",
+        retry_options.DebugString());
+  }
+  return tensorflow::Status::OK();
+}
+
 #ifndef _WIN32
 tensorflow::Status CreateMySQLMetadataStore(
     const MySQLDatabaseConfig& config,
     const MigrationOptions& migration_options,
+    const RetryOptions::TransactionRetryOptions& retry_options,
     std::unique_ptr<MetadataStore>* result) {
   auto metadata_source = absl::make_unique<MySqlMetadataSource>(config);
-  auto transaction_executor =
-      absl::make_unique<RdbmsTransactionExecutor>(metadata_source.get());
+  auto transaction_executor = absl::make_unique<RdbmsTransactionExecutor>(
+      metadata_source.get(), retry_options);
   TF_RETURN_IF_ERROR(MetadataStore::Create(
       util::GetMySqlMetadataSourceQueryConfig(), migration_options,
       std::move(metadata_source), std::move(transaction_executor), result));
@@ -46,6 +67,7 @@ tensorflow::Status CreateMySQLMetadataStore(
 tensorflow::Status CreateMySQLMetadataStore(
     const MySQLDatabaseConfig& config,
     const MigrationOptions& migration_options,
+    const RetryOptions::TransactionRetryOptions& retry_options,
     std::unique_ptr<MetadataStore>* result) {
   return tensorflow::errors::Unimplemented(
              "MySQL is not supported in Windows yet");
@@ -55,10 +77,11 @@ tensorflow::Status CreateMySQLMetadataStore(
 tensorflow::Status CreateSqliteMetadataStore(
     const SqliteMetadataSourceConfig& config,
     const MigrationOptions& migration_options,
+    const RetryOptions::TransactionRetryOptions& retry_options,
     std::unique_ptr<MetadataStore>* result) {
   auto metadata_source = absl::make_unique<SqliteMetadataSource>(config);
-  auto transaction_executor =
-      absl::make_unique<RdbmsTransactionExecutor>(metadata_source.get());
+  auto transaction_executor = absl::make_unique<RdbmsTransactionExecutor>(
+      metadata_source.get(), retry_options);
   TF_RETURN_IF_ERROR(MetadataStore::Create(
       util::GetSqliteMetadataSourceQueryConfig(), migration_options,
       std::move(metadata_source), std::move(transaction_executor), result));
@@ -72,6 +95,8 @@ tensorflow::Status CreateSqliteMetadataStore(
 tensorflow::Status CreateMetadataStore(const ConnectionConfig& config,
                                        const MigrationOptions& options,
                                        std::unique_ptr<MetadataStore>* result) {
+  TF_RETURN_IF_ERROR(ValidateTransactionRetryOptions(
+      config.retry_options().transaction_retry_options()));
   switch (config.config_case()) {
     case ConnectionConfig::CONFIG_NOT_SET:
       // TODO(b/123345695): make this longer when that bug is resolved.
@@ -79,12 +104,17 @@ tensorflow::Status CreateMetadataStore(const ConnectionConfig& config,
       return tensorflow::errors::InvalidArgument("Unset");
     case ConnectionConfig::kFakeDatabase:
       // Creates an in-memory SQLite database for testing.
-      return CreateSqliteMetadataStore(SqliteMetadataSourceConfig(), options,
-                                       result);
+      return CreateSqliteMetadataStore(
+          SqliteMetadataSourceConfig(), options,
+          config.retry_options().transaction_retry_options(), result);
     case ConnectionConfig::kMysql:
-      return CreateMySQLMetadataStore(config.mysql(), options, result);
+      return CreateMySQLMetadataStore(
+          config.mysql(), options,
+          config.retry_options().transaction_retry_options(), result);
     case ConnectionConfig::kSqlite:
-      return CreateSqliteMetadataStore(config.sqlite(), options, result);
+      return CreateSqliteMetadataStore(
+          config.sqlite(), options,
+          config.retry_options().transaction_retry_options(), result);
     default:
       return tensorflow::errors::Unimplemented("Unknown database type.");
   }
@@ -15,6 +15,7 @@ limitations under the License.
 #include "ml_metadata/metadata_store/metadata_store_factory.h"
 #include "ml_metadata/metadata_store/metadata_store.h"
 
+#include <limits>
 #include <memory>
 
 #include <gmock/gmock.h>
@@ -70,5 +71,26 @@ TEST(MetadataStoreFactoryTest, CreateSQLiteMetadataStore) {
   TestPutAndGetArtifactType(connection_config);
 }
 
+TEST(MetadataStoreFactoryTest, CreateRejectsInvalidTransactionRetryOptions) {
+  ConnectionConfig connection_config;
+  connection_config.mutable_sqlite();
+  RetryOptions::TransactionRetryOptions* retry_options =
+      connection_config.mutable_retry_options()
+          ->mutable_transaction_retry_options();
+  std::unique_ptr<MetadataStore> store;
+  retry_options->set_initial_backoff_ms(-1);
+  EXPECT_EQ(CreateMetadataStore(connection_config, &store).code(),
+            tensorflow::error::INVALID_ARGUMENT);
+
+  retry_options->set_initial_backoff_ms(100);
+  retry_options->set_max_backoff_ms(10);
+  EXPECT_EQ(CreateMetadataStore(connection_config, &store).code(),
+            tensorflow::error::INVALID_ARGUMENT);
+
+  retry_options->set_initial_backoff_ms(int64{1} << 40);
+  retry_options->set_max_backoff_ms(std::numeric_limits<int64>::max());
+  TF_EXPECT_OK(CreateMetadataStore(connection_config, &store));
+}
+
 }  // namespace
 }  // namespace ml_metadata
@@ -0,0 +1,174 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "ml_metadata/metadata_store/metadata_store_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "ml_metadata/metadata_store/metadata_store_factory.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace ml_metadata {
+
+MetadataStorePool::Handle::Handle(MetadataStorePool* pool,
+                                  std::unique_ptr<MetadataStore> store)
+    : pool_(pool), store_(std::move(store)) {}
+
+MetadataStorePool::Handle::~Handle() { Reset(); }
+
+MetadataStorePool::Handle::Handle(Handle&& other)
+    : pool_(other.pool_), store_(std::move(other.store_)) {
+  other.pool_ = nullptr;
+}
+
+MetadataStorePool::Handle& MetadataStorePool::Handle::operator=(
+    Handle&& other) {
+  if (this != &other) {
+    Reset();
+    pool_ = other.pool_;
+    store_ = std::move(other.store_);
+    other.pool_ = nullptr;
+  }
+  return *this;
+}
+
+void MetadataStorePool::Handle::Reset() {
+  if (pool_ != nullptr && store_ != nullptr) {
+    pool_->Return(std::move(store_));
+  }
+  pool_ = nullptr;
+  store_.reset();
+}
+
+tensorflow::Status MetadataStorePool::Create(
+    const ConnectionConfig& connection_config,
+    const ConnectionPoolConfig& pool_config,
+    std::unique_ptr<MetadataStorePool>* result) {
+  if (pool_config.max_pool_size() <= 0) {
+    return tensorflow::errors::InvalidArgument(
+        absl::StrCat("max_pool_size must be positive, but got ",
+                     pool_config.max_pool_size()));
+  }
+  result->reset(new MetadataStorePool(connection_config, pool_config));
+  return tensorflow::Status::OK();
+}
+
+MetadataStorePool::MetadataStorePool(const ConnectionConfig& connection_config,
+                                     const ConnectionPoolConfig& pool_config)
+    : connection_config_(connection_config),
+      // Each store of a fake database owns a separate in-memory database, so a
+      // single store is kept for the data to be visible across requests.
+      max_pool_size_(connection_config.has_fake_database()
+                         ? 1
+                         : pool_config.max_pool_size()),
+      idle_timeout_(pool_config.idle_timeout_sec() > 0
+                        ? absl::Seconds(pool_config.idle_timeout_sec())
+                        : absl::InfiniteDuration()),
+      health_check_interval_(
+          pool_config.health_check_interval_sec() >= 0
+              ? absl::Seconds(pool_config.health_check_interval_sec())
+              : absl::InfiniteDuration()) {}
+
+MetadataStorePool::~MetadataStorePool() {
+  absl::MutexLock lock(&mu_);
+  CHECK_EQ(num_borrowed_stores_, 0)
+      << "All borrowed stores must be returned before the pool is destroyed.";
+}
+
+tensorflow::Status MetadataStorePool::Borrow(Handle* handle) {
+  CHECK(handle != nullptr) << "The output handle should not be null";
+  handle->Reset();
+  std::unique_ptr<MetadataStore> store;
+  absl::Time last_used_time;
+  std::vector<std::unique_ptr<MetadataStore>> expired_stores;
+  {
+    absl::MutexLock lock(&mu_);
+    mu_.Await(absl::Condition(this, &MetadataStorePool::CanBorrow));
+    const absl::Time now = absl::Now();
+    RemoveExpiredStores(now, &expired_stores);
+    if (!idle_stores_.empty()) {
+      store = std::move(idle_stores_.back().store);
+      last_used_time = idle_stores_.back().last_used_time;
+      idle_stores_.pop_back();
+    }
+    // Reserves the slot, so that the connection can be opened without mu_.
+    num_borrowed_stores_++;
+  }
+  // Closes the expired connections outside of the critical section.
+  expired_stores.clear();
+
+  if (store != nullptr &&
+      absl::Now() - last_used_time >= health_check_interval_) {
+    const tensorflow::Status status = store->HealthCheck();
+    if (!status.ok()) {
+      LOG(WARNING) << "Reconnecting an idle metadata store which failed the "
+                      "health check: "
+                   << status;
+      store.reset();
+    }
+  }
+  if (store == nullptr) {
+    const tensorflow::Status status =
+        CreateMetadataStore(connection_config_, &store);
+    if (!status.ok()) {
+      absl::MutexLock lock(&mu_);
+      num_borrowed_stores_--;
+      return status;
+    }
+  }
+  *handle = Handle(this, std::move(store));
+  return tensorflow::Status::OK();
+}
+
+void MetadataStorePool::Return(std::unique_ptr<MetadataStore> store) {
+  absl::MutexLock lock(&mu_);
+  num_borrowed_stores_--;
+  idle_stores_.push_back({std::move(store), absl::Now()});
+}
+
+void MetadataStorePool::RemoveExpiredStores(
+    const absl::Time now,
+    std::vector<std::unique_ptr<MetadataStore>>* expired) {
+  // idle_stores_ is ordered by last_used_time, so the expired ones are a
+  // prefix of it.
+  auto first_unexpired = std::find_if(
+      idle_stores_.begin(), idle_stores_.end(), [&](const IdleStore& idle) {
+        return now - idle.last_used_time < idle_timeout_;
+      });
+  for (auto it = idle_stores_.begin(); it != first_unexpired; ++it) {
+    expired->push_back(std::move(it->store));
+  }
+  idle_stores_.erase(idle_stores_.begin(), first_unexpired);
+}
+
+bool MetadataStorePool::CanBorrow() const {
+  return !idle_stores_.empty() ||
+         num_borrowed_stores_ + static_cast<int>(idle_stores_.size()) <
+             max_pool_size_;
+}
+
+int MetadataStorePool::num_idle_stores() {
+  absl::MutexLock lock(&mu_);
+  return idle_stores_.size();
+}
+
+int MetadataStorePool::num_borrowed_stores() {
+  absl::MutexLock lock(&mu_);
+  return num_borrowed_stores_;
+}
+
+}  // namespace ml_metadata
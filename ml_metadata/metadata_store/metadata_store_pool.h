@@ -0,0 +1,135 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef ML_METADATA_METADATA_STORE_METADATA_STORE_POOL_H_
+#define ML_METADATA_METADATA_STORE_METADATA_STORE_POOL_H_
+
+#include <memory>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "ml_metadata/metadata_store/metadata_store.h"
+#include "ml_metadata/proto/metadata_store.pb.h"
+#include "tensorflow/core/lib/core/status.h"
+
+namespace ml_metadata {
+
+// A bounded, thread-safe pool of connected MetadataStores.
+//
+// Creating a MetadataStore opens a new connection and verifies the schema of
+// the metadata source, which is much more expensive than most requests. The
+// pool keeps the stores that are returned to it, and lends them to the later
+// callers of Borrow(). At most max_pool_size stores exist at the same time;
+// when all of them are borrowed, Borrow() blocks until one is returned.
+//
+// Idle stores are closed after idle_timeout_sec, and stores idle for longer
+// than health_check_interval_sec are checked before being lent again.
+//
+// Usage example:
+//   MetadataStorePool::Handle metadata_store;
+//   TF_RETURN_IF_ERROR(pool->Borrow(&metadata_store));
+//   TF_RETURN_IF_ERROR(metadata_store->GetArtifacts(request, &response));
+//   // The store goes back to the pool when `metadata_store` is destroyed.
+class MetadataStorePool {
+ public:
+  // A borrowed MetadataStore. It is movable but not copyable, and returns the
+  // store to the pool it was borrowed from when destroyed or reset.
+  class Handle {
+   public:
+    Handle() = default;
+    ~Handle();
+
+    Handle(Handle&& other);
+    Handle& operator=(Handle&& other);
+    Handle(const Handle&) = delete;
+    Handle& operator=(const Handle&) = delete;
+
+    MetadataStore* get() const { return store_.get(); }
+    MetadataStore* operator->() const { return store_.get(); }
+    explicit operator bool() const { return store_ != nullptr; }
+
+    // Returns the store to the pool. The handle becomes empty.
+    void Reset();
+
+   private:
+    friend class MetadataStorePool;
+    Handle(MetadataStorePool* pool, std::unique_ptr<MetadataStore> store);
+
+    MetadataStorePool* pool_ = nullptr;
+    std::unique_ptr<MetadataStore> store_;
+  };
+
+  // Factory method that creates a MetadataStorePool in result. No connection
+  // is opened until the first call to Borrow().
+  // Returns INVALID_ARGUMENT error, if the pool_config is not valid.
+  static tensorflow::Status Create(
+      const ConnectionConfig& connection_config,
+      const ConnectionPoolConfig& pool_config,
+      std::unique_ptr<MetadataStorePool>* result);
+
+  // All handles must be returned before the pool is destroyed.
+  ~MetadataStorePool();
+
+  // Lends a connected store in `handle`. Reuses an idle store if there is one,
+  // otherwise creates a new one if the pool is not full, otherwise waits for a
+  // store to be returned.
+  // Returns the errors of CreateMetadataStore, if a new store is needed and
+  // cannot be created.
+  tensorflow::Status Borrow(Handle* handle);
+
+  // Returns the number of stores that are idle in the pool.
+  int num_idle_stores();
+
+  // Returns the number of stores that are currently borrowed.
+  int num_borrowed_stores();
+
+ private:
+  // A returned store with the time it was returned at.
+  struct IdleStore {
+    std::unique_ptr<MetadataStore> store;
+    absl::Time last_used_time;
+  };
+
+  // To construct the object, see Create(...).
+  MetadataStorePool(const ConnectionConfig& connection_config,
+                    const ConnectionPoolConfig& pool_config);
+
+  // Called by Handle to put a borrowed store back to the pool.
+  void Return(std::unique_ptr<MetadataStore> store);
+
+  // Moves the stores idle for longer than the idle timeout to `expired`, so
+  // that they can be closed without holding mu_.
+  void RemoveExpiredStores(absl::Time now,
+                           std::vector<std::unique_ptr<MetadataStore>>* expired)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Returns true if a store can be lent without waiting.
+  bool CanBorrow() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const ConnectionConfig connection_config_;
+  const int max_pool_size_;
+  const absl::Duration idle_timeout_;
+  const absl::Duration health_check_interval_;
+
+  absl::Mutex mu_;
+  // The idle stores ordered by last_used_time; the most recently returned one
+  // is at the back, and is lent first, so that the rest of them can expire.
+  std::vector<IdleStore> idle_stores_ ABSL_GUARDED_BY(mu_);
+  int num_borrowed_stores_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace ml_metadata
+
+#endif  // ML_METADATA_METADATA_STORE_METADATA_STORE_POOL_H_
@@ -0,0 +1,148 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "ml_metadata/metadata_store/metadata_store_pool.h"
+
+#include <memory>
+#include <thread>  // NOLINT
+
+#include <gtest/gtest.h>
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "ml_metadata/metadata_store/test_util.h"
+#include "ml_metadata/proto/metadata_store.pb.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+
+namespace ml_metadata {
+namespace {
+
+using testing::ParseTextProtoOrDie;
+
+// Creates a pool of in-memory SQLite stores with the given pool config.
+std::unique_ptr<MetadataStorePool> CreateSqlitePool(
+    const ConnectionPoolConfig& pool_config) {
+  ConnectionConfig connection_config;
+  connection_config.mutable_sqlite();
+  std::unique_ptr<MetadataStorePool> pool;
+  TF_CHECK_OK(MetadataStorePool::Create(connection_config, pool_config, &pool));
+  return pool;
+}
+
+TEST(MetadataStorePoolTest, InvalidMaxPoolSize) {
+  ConnectionConfig connection_config;
+  connection_config.mutable_sqlite();
+  ConnectionPoolConfig pool_config;
+  pool_config.set_max_pool_size(0);
+  std::unique_ptr<MetadataStorePool> pool;
+  EXPECT_TRUE(tensorflow::errors::IsInvalidArgument(
+      MetadataStorePool::Create(connection_config, pool_config, &pool)));
+}
+
+TEST(MetadataStorePoolTest, BorrowReusesReturnedStore) {
+  std::unique_ptr<MetadataStorePool> pool =
+      CreateSqlitePool(ConnectionPoolConfig());
+  MetadataStorePool::Handle handle;
+  TF_ASSERT_OK(pool->Borrow(&handle));
+  ASSERT_TRUE(handle);
+  MetadataStore* const borrowed_store = handle.get();
+  EXPECT_EQ(pool->num_borrowed_stores(), 1);
+  EXPECT_EQ(pool->num_idle_stores(), 0);
+
+  handle.Reset();
+  EXPECT_FALSE(handle);
+  EXPECT_EQ(pool->num_borrowed_stores(), 0);
+  EXPECT_EQ(pool->num_idle_stores(), 1);
+
+  TF_ASSERT_OK(pool->Borrow(&handle));
+  EXPECT_EQ(handle.get(), borrowed_store);
+  EXPECT_EQ(pool->num_borrowed_stores(), 1);
+  EXPECT_EQ(pool->num_idle_stores(), 0);
+}
+
+TEST(MetadataStorePoolTest, BorrowWaitsWhenPoolIsFull) {
+  ConnectionPoolConfig pool_config;
+  pool_config.set_max_pool_size(2);
+  std::unique_ptr<MetadataStorePool> pool = CreateSqlitePool(pool_config);
+  MetadataStorePool::Handle handle1;
+  MetadataStorePool::Handle handle2;
+  TF_ASSERT_OK(pool->Borrow(&handle1));
+  TF_ASSERT_OK(pool->Borrow(&handle2));
+  EXPECT_NE(handle1.get(), handle2.get());
+  MetadataStore* const first_store = handle1.get();
+
+  MetadataStorePool::Handle handle3;
+  absl::Notification borrowed;
+  std::thread borrower([&]() {
+    TF_EXPECT_OK(pool->Borrow(&handle3));
+    borrowed.Notify();
+  });
+  EXPECT_FALSE(borrowed.WaitForNotificationWithTimeout(absl::Seconds(1)));
+
+  handle1.Reset();
+  borrowed.WaitForNotification();
+  borrower.join();
+  EXPECT_EQ(handle3.get(), first_store);
+  EXPECT_EQ(pool->num_borrowed_stores(), 2);
+}
+
+TEST(MetadataStorePoolTest, IdleStoresExpire) {
+  ConnectionPoolConfig pool_config;
+  pool_config.set_idle_timeout_sec(1);
+  std::unique_ptr<MetadataStorePool> pool = CreateSqlitePool(pool_config);
+  {
+    MetadataStorePool::Handle handle1;
+    MetadataStorePool::Handle handle2;
+    TF_ASSERT_OK(pool->Borrow(&handle1));
+    TF_ASSERT_OK(pool->Borrow(&handle2));
+  }
+  EXPECT_EQ(pool->num_idle_stores(), 2);
+
+  absl::SleepFor(absl::Milliseconds(1100));
+  MetadataStorePool::Handle handle;
+  TF_ASSERT_OK(pool->Borrow(&handle));
+  EXPECT_EQ(pool->num_idle_stores(), 0);
+  EXPECT_EQ(pool->num_borrowed_stores(), 1);
+}
+
+TEST(MetadataStorePoolTest, FakeDatabaseIsSharedAcrossBorrows) {
+  ConnectionConfig connection_config;
+  connection_config.mutable_fake_database();
+  std::unique_ptr<MetadataStorePool> pool;
+  TF_ASSERT_OK(MetadataStorePool::Create(
+      connection_config, ConnectionPoolConfig(), &pool));
+
+  const PutArtifactTypeRequest put_request =
+      ParseTextProtoOrDie<PutArtifactTypeRequest>(
+          R"(
+            all_fields_match: true
+            artifact_type: { name: 'test_type' }
+          )");
+  {
+    MetadataStorePool::Handle handle;
+    TF_ASSERT_OK(pool->Borrow(&handle));
+    PutArtifactTypeResponse put_response;
+    TF_ASSERT_OK(handle->PutArtifactType(put_request, &put_response));
+  }
+  MetadataStorePool::Handle handle;
+  TF_ASSERT_OK(pool->Borrow(&handle));
+  GetArtifactTypeRequest get_request;
+  get_request.set_type_name("test_type");
+  GetArtifactTypeResponse get_response;
+  TF_EXPECT_OK(handle->GetArtifactType(get_request, &get_response));
+}
+
+}  // namespace
+}  // namespace ml_metadata
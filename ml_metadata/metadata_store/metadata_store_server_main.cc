@@ -16,6 +16,7 @@ limitations under the License.
 // gRPC server binary, which supports methods to interact with ml.metadata store
 // defined in third_party/ml_metadata/proto/metadata_store_service.proto.
 
+#include <memory>
 #include <vector>
 
 #include "gflags/gflags.h"
@@ -24,6 +25,7 @@ limitations under the License.
 #include "grpcpp/server_builder.h"
 #include "absl/strings/str_cat.h"
 #include "ml_metadata/metadata_store/metadata_store.h"
+#include "ml_metadata/metadata_store/metadata_store_async_server.h"
 #include "ml_metadata/metadata_store/metadata_store_factory.h"
 #include "ml_metadata/metadata_store/metadata_store_service_impl.h"
 #include "ml_metadata/proto/metadata_store.pb.h"
@@ -142,6 +144,11 @@ DEFINE_int32(grpc_port, 8080, "Port to listen on for gRPC API. (default 8080)");
 DEFINE_string(grpc_channel_arguments, "",
               "A comma separated list of arguments to be passed to the grpc "
               "server. (e.g. grpc.max_connection_age_ms=2000)");
+DEFINE_bool(grpc_async_server, false,
+            "If true, the server receives the requests with the gRPC async "
+            "API, and runs them with a bounded pool of workers, with the "
+            "async_server_config of the server config or its defaults. It is "
+            "also enabled when the server config has an async_server_config.");
 
 // metadata store server options
 DEFINE_string(metadata_store_server_config_file, "",
@@ -222,8 +229,21 @@ int main(int argc, char** argv) {
   // At this point, schema initialization and migration are done.
   metadata_store.reset();
 
-  ml_metadata::MetadataStoreServiceImpl metadata_store_service(
-      connection_config);
+  std::unique_ptr<ml_metadata::MetadataStoreServiceImpl> metadata_store_service;
+  status = ml_metadata::MetadataStoreServiceImpl::Create(
+      connection_config, server_config.connection_pool_config(),
+      server_config.bulk_put_config(), &metadata_store_service);
+  if (!status.ok()) {
+    LOG(ERROR) << "The server cannot be created with the given config: "
+               << status;
+    return -1;
+  }
+  if (server_config.has_lineage_index_config()) {
+    TF_CHECK_OK(metadata_store_service->EnableLineageIndex(
+        server_config.lineage_index_config()))
+        << "The lineage index cannot be loaded with the config: "
+        << server_config.lineage_index_config().DebugString();
+  }
 
   const string server_address = absl::StrCat("0.0.0.0:", FLAGS_grpc_port);
   ::grpc::ServerBuilder builder;
@@ -236,8 +256,20 @@ int main(int argc, char** argv) {
 
   builder.AddListeningPort(server_address, credentials);
   AddGrpcChannelArgs(FLAGS_grpc_channel_arguments, &builder);
-  builder.RegisterService(&metadata_store_service);
+  std::unique_ptr<ml_metadata::MetadataStoreAsyncServer> async_server;
+  if (FLAGS_grpc_async_server || server_config.has_async_server_config()) {
+    TF_CHECK_OK(ml_metadata::MetadataStoreAsyncServer::Create(
+        server_config.async_server_config(), metadata_store_service.get(),
+        &builder, &async_server))
+        << "Invalid async server config: "
+        << server_config.async_server_config().DebugString();
+  } else {
+    builder.RegisterService(metadata_store_service.get());
+  }
   std::unique_ptr<::grpc::Server> server(builder.BuildAndStart());
+  if (async_server != nullptr) {
+    async_server->Start();
+  }
   LOG(INFO) << "Server listening on " << server_address;
 
   // keep the program running until the server shuts down.
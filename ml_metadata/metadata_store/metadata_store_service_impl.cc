@@ -14,10 +14,22 @@ limitations under the License.
 ==============================================================================*/
 #include "ml_metadata/metadata_store/metadata_store_service_impl.h"
 
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
 #include "grpcpp/support/status_code_enum.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "ml_metadata/metadata_store/lineage_index_loader.h"
 #include "ml_metadata/metadata_store/metadata_store.h"
-#include "ml_metadata/metadata_store/metadata_store_factory.h"
+#include "ml_metadata/metadata_store/metadata_store_pool.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/env.h"
 
 namespace ml_metadata {
 namespace {
@@ -29,25 +41,402 @@ namespace {
                         status.error_message());
 }
 
-// Creates a store on demand. The store created does not handle migration.
-::grpc::Status ConnectMetadataStore(
+// Borrows a connected store from the pool. The store created does not handle
+// migration.
+::grpc::Status ConnectMetadataStore(MetadataStorePool* metadata_store_pool,
+                                    MetadataStorePool::Handle* metadata_store) {
+  return ToGRPCStatus(metadata_store_pool->Borrow(metadata_store));
+}
+
+// Creates a pool of stores, and dies if the connection_pool_config is not
+// valid.
+std::unique_ptr<MetadataStorePool> CreateMetadataStorePoolOrDie(
     const ConnectionConfig& connection_config,
-    std::unique_ptr<MetadataStore>* metadata_store) {
-  return ToGRPCStatus(CreateMetadataStore(connection_config, metadata_store));
+    const ConnectionPoolConfig& connection_pool_config) {
+  std::unique_ptr<MetadataStorePool> metadata_store_pool;
+  TF_CHECK_OK(MetadataStorePool::Create(
+      connection_config, connection_pool_config, &metadata_store_pool))
+      << "Invalid connection pool config: "
+      << connection_pool_config.DebugString();
+  return metadata_store_pool;
+}
+
+// Returns INVALID_ARGUMENT error, if the bulk put config is not valid.
+tensorflow::Status ValidateBulkPutConfig(const BulkPutConfig& config) {
+  if (config.max_batch_size() <= 0) {
+    return tensorflow::errors::InvalidArgument(
+        "max_batch_size must be positive: ", config.max_batch_size());
+  }
+  if (config.max_batch_delay_ms() < 0) {
+    return tensorflow::errors::InvalidArgument(
+        "max_batch_delay_ms must not be negative: ",
+        config.max_batch_delay_ms());
+  }
+  if (config.max_batches_per_stream() <= 0) {
+    return tensorflow::errors::InvalidArgument(
+        "max_batches_per_stream must be positive: ",
+        config.max_batches_per_stream());
+  }
+  return tensorflow::Status::OK();
+}
+
+// The interval between the checks of the lineage index for added edges to
+// compact.
+constexpr absl::Duration kLineageIndexCompactionInterval = absl::Seconds(1);
+
+// Returns the number of nodes and edges of a BulkPut request.
+int NumBulkPutRecords(const BulkPutRequest& request) {
+  return request.artifacts_size() + request.executions_size() +
+         request.contexts_size() + request.events_size() +
+         request.attributions_size() + request.associations_size();
+}
+
+// Returns the events inserted by a PutExecution request, with the ids of the
+// artifacts and the execution of its response, index-aligned with the
+// event_ids of the response.
+std::vector<Event> PutExecutionEvents(const PutExecutionRequest& request,
+                                      const PutExecutionResponse& response) {
+  std::vector<Event> events;
+  for (int i = 0; i < request.artifact_event_pairs_size(); ++i) {
+    if (!request.artifact_event_pairs(i).has_event()) continue;
+    Event event = request.artifact_event_pairs(i).event();
+    event.set_artifact_id(response.artifact_ids(i));
+    event.set_execution_id(response.execution_id());
+    events.push_back(std::move(event));
+  }
+  return events;
+}
+
+// Returns a runner which borrows a store from the pool for each call, and
+// returns it once the call is done.
+MetadataStore::StoreRunner BorrowForEachCall(
+    MetadataStorePool* metadata_store_pool) {
+  return [metadata_store_pool](
+             const std::function<tensorflow::Status(MetadataStore*)>& run)
+             -> tensorflow::Status {
+    MetadataStorePool::Handle metadata_store;
+    TF_RETURN_IF_ERROR(metadata_store_pool->Borrow(&metadata_store));
+    return run(metadata_store.get());
+  };
+}
+
+// Adapts the `writer` of a stream to MetadataStore, which stops streaming
+// with the CANCELLED error once the stream is closed.
+template <typename Response>
+std::function<tensorflow::Status(const Response&)> WriteOrCancel(
+    ::grpc::ServerWriter<Response>* writer) {
+  return [writer](const Response& response) -> tensorflow::Status {
+    if (!writer->Write(response)) {
+      return tensorflow::errors::Cancelled("The stream is closed.");
+    }
+    return tensorflow::Status::OK();
+  };
 }
 
 }  // namespace
 
+class MetadataStoreServiceImpl::BulkPutTimer {
+ public:
+  BulkPutTimer() = default;
+
+  // Stops the thread, if it is started, and joins it.
+  ~BulkPutTimer() {
+    {
+      absl::MutexLock lock(&mu_);
+      stopped_ = true;
+      cv_.SignalAll();
+    }
+    // Destroying the thread joins it.
+    thread_.reset();
+  }
+
+  // Calls the OnBatchDue of `stream` at `deadline`, instead of at its previous
+  // deadline, if any. The thread is started by the first call.
+  void Schedule(BulkPutStream* stream, const absl::Time deadline) {
+    absl::MutexLock lock(&mu_);
+    UnscheduleLocked(stream);
+    deadlines_.emplace(deadline, stream);
+    stream_deadlines_[stream] = deadline;
+    if (thread_ == nullptr) {
+      thread_.reset(tensorflow::Env::Default()->StartThread(
+          tensorflow::ThreadOptions(), "mlmd_bulk_put_timer",
+          [this]() { Run(); }));
+    }
+    cv_.SignalAll();
+  }
+
+  // Cancels the call of `stream`, and waits for a running one to return. It
+  // must not be called by the OnBatchDue of `stream`.
+  void Cancel(BulkPutStream* stream) {
+    absl::MutexLock lock(&mu_);
+    UnscheduleLocked(stream);
+    while (running_stream_ == stream) {
+      cv_.Wait(&mu_);
+    }
+  }
+
+ private:
+  void UnscheduleLocked(BulkPutStream* stream)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    const auto it = stream_deadlines_.find(stream);
+    if (it == stream_deadlines_.end()) return;
+    deadlines_.erase({it->second, stream});
+    stream_deadlines_.erase(it);
+  }
+
+  // Calls the streams at their deadlines, one at a time, until it is stopped.
+  void Run() {
+    absl::MutexLock lock(&mu_);
+    while (!stopped_) {
+      if (deadlines_.empty()) {
+        cv_.Wait(&mu_);
+        continue;
+      }
+      const auto first = deadlines_.begin();
+      if (absl::Now() < first->first) {
+        cv_.WaitWithDeadline(&mu_, first->first);
+        continue;
+      }
+      BulkPutStream* stream = first->second;
+      stream_deadlines_.erase(stream);
+      deadlines_.erase(first);
+      running_stream_ = stream;
+      mu_.Unlock();
+      stream->OnBatchDue();
+      mu_.Lock();
+      running_stream_ = nullptr;
+      cv_.SignalAll();
+    }
+  }
+
+  absl::Mutex mu_;
+  absl::CondVar cv_;
+  // The deadlines of the streams, by time, and by stream.
+  std::set<std::pair<absl::Time, BulkPutStream*>> deadlines_
+      ABSL_GUARDED_BY(mu_);
+  absl::flat_hash_map<BulkPutStream*, absl::Time> stream_deadlines_
+      ABSL_GUARDED_BY(mu_);
+  // The stream whose OnBatchDue is running, if any.
+  BulkPutStream* running_stream_ ABSL_GUARDED_BY(mu_) = nullptr;
+  bool stopped_ ABSL_GUARDED_BY(mu_) = false;
+  std::unique_ptr<tensorflow::Thread> thread_ ABSL_GUARDED_BY(mu_);
+};
+
+MetadataStoreServiceImpl::BulkPutStream::BulkPutStream(
+    const BulkPutConfig& config, MetadataStorePool* metadata_store_pool,
+    LineageIndex* lineage_index, BulkPutTimer* timer,
+    BulkPutResponse* response, std::function<void()> on_batch_due)
+    : config_(config),
+      metadata_store_pool_(metadata_store_pool),
+      lineage_index_(lineage_index),
+      timer_(timer),
+      on_batch_due_(std::move(on_batch_due)),
+      response_(response) {}
+
+MetadataStoreServiceImpl::BulkPutStream::~BulkPutStream() {
+  timer_->Cancel(this);
+}
+
+bool MetadataStoreServiceImpl::BulkPutStream::Add(BulkPutRequest request) {
+  absl::MutexLock lock(&mu_);
+  if (IsDoneLocked()) return false;
+  if (requests_.empty()) {
+    first_request_time_ = absl::Now();
+    if (config_.max_batch_delay_ms() > 0) {
+      timer_->Schedule(this,
+                       first_request_time_ +
+                           absl::Milliseconds(config_.max_batch_delay_ms()));
+    }
+  }
+  num_records_ += NumBulkPutRecords(request);
+  requests_.push_back(std::move(request));
+  num_requests_++;
+  return true;
+}
+
+bool MetadataStoreServiceImpl::BulkPutStream::IsBatchDue() const {
+  absl::MutexLock lock(&mu_);
+  return IsBatchDueLocked();
+}
+
+bool MetadataStoreServiceImpl::BulkPutStream::IsDone() const {
+  absl::MutexLock lock(&mu_);
+  return IsDoneLocked();
+}
+
+void MetadataStoreServiceImpl::BulkPutStream::CommitDueBatch() {
+  CommitBatch(/*force=*/false);
+}
+
+::grpc::Status MetadataStoreServiceImpl::BulkPutStream::Finish(
+    const bool commit_pending_requests) {
+  if (commit_pending_requests) {
+    CommitBatch(/*force=*/true);
+  }
+  {
+    absl::MutexLock lock(&mu_);
+    finished_ = true;
+    requests_.clear();
+  }
+  timer_->Cancel(this);
+  absl::MutexLock lock(&mu_);
+  return status_;
+}
+
+void MetadataStoreServiceImpl::BulkPutStream::OnBatchDue() {
+  if (on_batch_due_) {
+    on_batch_due_();
+  } else {
+    CommitDueBatch();
+  }
+}
+
+bool MetadataStoreServiceImpl::BulkPutStream::IsDoneLocked() const {
+  return finished_ || !status_.ok() ||
+         num_batches_ >= config_.max_batches_per_stream();
+}
+
+bool MetadataStoreServiceImpl::BulkPutStream::IsBatchDueLocked() const {
+  return !requests_.empty() &&
+         (num_records_ >= config_.max_batch_size() ||
+          absl::Now() - first_request_time_ >=
+              absl::Milliseconds(config_.max_batch_delay_ms()));
+}
+
+void MetadataStoreServiceImpl::BulkPutStream::CommitBatch(const bool force) {
+  absl::MutexLock commit_lock(&commit_mu_);
+  // The batch is taken from the pending requests, and committed without mu_,
+  // so that the requests are added while it is committed.
+  std::vector<BulkPutRequest> requests;
+  BulkPutResponse::Batch batch;
+  {
+    absl::MutexLock lock(&mu_);
+    if (requests_.empty() || IsDoneLocked() ||
+        (!force && !IsBatchDueLocked())) {
+      return;
+    }
+    batch.set_first_request_index(num_requests_ - requests_.size());
+    batch.set_num_requests(requests_.size());
+    requests.swap(requests_);
+    num_records_ = 0;
+    num_batches_++;
+  }
+  MetadataStorePool::Handle metadata_store;
+  const ::grpc::Status connection_status =
+      ConnectMetadataStore(metadata_store_pool_, &metadata_store);
+  if (!connection_status.ok()) {
+    LOG(WARNING) << "Failed to connect to the database: "
+                 << connection_status.error_message();
+    absl::MutexLock lock(&mu_);
+    status_ = connection_status;
+    return;
+  }
+  std::vector<Event> events;
+  const ::grpc::Status transaction_status =
+      ToGRPCStatus(metadata_store->BulkPut(
+          requests, &batch, lineage_index_ != nullptr ? &events : nullptr));
+  if (!transaction_status.ok()) {
+    LOG(WARNING) << "BulkPut failed: " << transaction_status.error_message();
+    batch.clear_artifact_ids();
+    batch.clear_execution_ids();
+    batch.clear_context_ids();
+    batch.clear_event_ids();
+    batch.set_error_code(transaction_status.error_code());
+    batch.set_error_message(transaction_status.error_message());
+  } else if (lineage_index_ != nullptr) {
+    lineage_index_->AddEvents(
+        {batch.event_ids().begin(), batch.event_ids().end()}, events);
+  }
+  absl::MutexLock lock(&mu_);
+  *response_->add_batches() = std::move(batch);
+}
+
 MetadataStoreServiceImpl::MetadataStoreServiceImpl(
     const ConnectionConfig& connection_config)
-    : connection_config_(connection_config) {}
+    : MetadataStoreServiceImpl(connection_config, ConnectionPoolConfig()) {}
+
+MetadataStoreServiceImpl::MetadataStoreServiceImpl(
+    const ConnectionConfig& connection_config,
+    const ConnectionPoolConfig& connection_pool_config)
+    : MetadataStoreServiceImpl(
+          CreateMetadataStorePoolOrDie(connection_config,
+                                       connection_pool_config),
+          BulkPutConfig()) {}
+
+MetadataStoreServiceImpl::MetadataStoreServiceImpl(
+    std::unique_ptr<MetadataStorePool> metadata_store_pool,
+    const BulkPutConfig& bulk_put_config)
+    : metadata_store_pool_(std::move(metadata_store_pool)),
+      bulk_put_config_(bulk_put_config),
+      bulk_put_timer_(absl::make_unique<BulkPutTimer>()) {}
+
+tensorflow::Status MetadataStoreServiceImpl::Create(
+    const ConnectionConfig& connection_config,
+    const ConnectionPoolConfig& connection_pool_config,
+    const BulkPutConfig& bulk_put_config,
+    std::unique_ptr<MetadataStoreServiceImpl>* result) {
+  TF_RETURN_IF_ERROR(ValidateBulkPutConfig(bulk_put_config));
+  std::unique_ptr<MetadataStorePool> metadata_store_pool;
+  TF_RETURN_IF_ERROR(MetadataStorePool::Create(
+      connection_config, connection_pool_config, &metadata_store_pool));
+  *result = absl::WrapUnique(new MetadataStoreServiceImpl(
+      std::move(metadata_store_pool), bulk_put_config));
+  return tensorflow::Status::OK();
+}
+
+MetadataStoreServiceImpl::~MetadataStoreServiceImpl() {
+  stop_lineage_index_catch_up_.Notify();
+  // Destroying the thread joins it.
+  lineage_index_catch_up_thread_.reset();
+}
+
+tensorflow::Status MetadataStoreServiceImpl::EnableLineageIndex(
+    const LineageIndexConfig& config) {
+  if (lineage_index_ != nullptr) {
+    return tensorflow::errors::FailedPrecondition(
+        "The lineage index is enabled already.");
+  }
+  auto lineage_index = absl::make_unique<LineageIndex>();
+  TF_RETURN_IF_ERROR(LoadLineageIndex(config, metadata_store_pool_.get(),
+                                      lineage_index.get()));
+  LOG(INFO) << "Loaded the lineage index with " << lineage_index->num_edges()
+            << " edges of the events up to id "
+            << lineage_index->max_event_id();
+  lineage_index_ = std::move(lineage_index);
+  lineage_index_catch_up_thread_.reset(tensorflow::Env::Default()->StartThread(
+      tensorflow::ThreadOptions(), "mlmd_lineage_index_catch_up",
+      [this, config]() {
+        // The added edges are compacted in this thread, so that the writes
+        // adding them do not rebuild the rows.
+        const absl::Duration interval =
+            absl::Seconds(config.catch_up_interval_sec());
+        absl::Time next_catch_up = absl::Now() + interval;
+        while (!stop_lineage_index_catch_up_.WaitForNotificationWithTimeout(
+            kLineageIndexCompactionInterval)) {
+          if (config.catch_up_interval_sec() > 0 &&
+              absl::Now() >= next_catch_up) {
+            const tensorflow::Status status = CatchUpLineageIndex(
+                config, metadata_store_pool_.get(), lineage_index_.get());
+            if (!status.ok()) {
+              LOG(WARNING) << "Failed to catch up the lineage index: "
+                           << status.error_message();
+            }
+            next_catch_up = absl::Now() + interval;
+          }
+          if (lineage_index_->NeedsCompaction()) {
+            lineage_index_->Compact();
+          }
+        }
+      }));
+  return tensorflow::Status::OK();
+}
 
 ::grpc::Status MetadataStoreServiceImpl::PutArtifactType(
     ::grpc::ServerContext* context, const PutArtifactTypeRequest* request,
     PutArtifactTypeResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -65,9 +454,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::GetArtifactType(
     ::grpc::ServerContext* context, const GetArtifactTypeRequest* request,
     GetArtifactTypeResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -85,9 +474,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::GetArtifactTypesByID(
     ::grpc::ServerContext* context, const GetArtifactTypesByIDRequest* request,
     GetArtifactTypesByIDResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -105,9 +494,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::GetArtifactTypes(
     ::grpc::ServerContext* context, const GetArtifactTypesRequest* request,
     GetArtifactTypesResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -125,9 +514,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::PutExecutionType(
     ::grpc::ServerContext* context, const PutExecutionTypeRequest* request,
     PutExecutionTypeResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -145,9 +534,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::GetExecutionType(
     ::grpc::ServerContext* context, const GetExecutionTypeRequest* request,
     GetExecutionTypeResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -165,9 +554,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::GetExecutionTypesByID(
     ::grpc::ServerContext* context, const GetExecutionTypesByIDRequest* request,
     GetExecutionTypesByIDResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -185,9 +574,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::GetExecutionTypes(
     ::grpc::ServerContext* context, const GetExecutionTypesRequest* request,
     GetExecutionTypesResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -205,9 +594,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::PutContextType(
     ::grpc::ServerContext* context, const PutContextTypeRequest* request,
     PutContextTypeResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -225,9 +614,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::GetContextType(
     ::grpc::ServerContext* context, const GetContextTypeRequest* request,
     GetContextTypeResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -245,9 +634,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::GetContextTypesByID(
     ::grpc::ServerContext* context, const GetContextTypesByIDRequest* request,
     GetContextTypesByIDResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -265,9 +654,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::GetContextTypes(
     ::grpc::ServerContext* context, const GetContextTypesRequest* request,
     GetContextTypesResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -285,9 +674,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::PutArtifacts(
     ::grpc::ServerContext* context, const PutArtifactsRequest* request,
     PutArtifactsResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -305,9 +694,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::PutExecutions(
     ::grpc::ServerContext* context, const PutExecutionsRequest* request,
     PutExecutionsResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -325,9 +714,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::GetArtifactsByID(
     ::grpc::ServerContext* context, const GetArtifactsByIDRequest* request,
     GetArtifactsByIDResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -345,9 +734,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::GetExecutionsByID(
     ::grpc::ServerContext* context, const GetExecutionsByIDRequest* request,
     GetExecutionsByIDResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -365,9 +754,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::PutEvents(
     ::grpc::ServerContext* context, const PutEventsRequest* request,
     PutEventsResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -377,6 +766,10 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
       ToGRPCStatus(metadata_store->PutEvents(*request, response));
   if (!transaction_status.ok()) {
     LOG(WARNING) << "PutEvents failed: " << transaction_status.error_message();
+  } else if (lineage_index_ != nullptr) {
+    lineage_index_->AddEvents(
+        {response->event_ids().begin(), response->event_ids().end()},
+        {request->events().begin(), request->events().end()});
   }
   return transaction_status;
 }
@@ -384,9 +777,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::PutExecution(
     ::grpc::ServerContext* context, const PutExecutionRequest* request,
     PutExecutionResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -397,6 +790,10 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
   if (!transaction_status.ok()) {
     LOG(WARNING) << "PutExecution failed: "
                  << transaction_status.error_message();
+  } else if (lineage_index_ != nullptr) {
+    lineage_index_->AddEvents(
+        {response->event_ids().begin(), response->event_ids().end()},
+        PutExecutionEvents(*request, *response));
   }
   return transaction_status;
 }
@@ -405,9 +802,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
     ::grpc::ServerContext* context,
     const GetEventsByArtifactIDsRequest* request,
     GetEventsByArtifactIDsResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -426,9 +823,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
     ::grpc::ServerContext* context,
     const GetEventsByExecutionIDsRequest* request,
     GetEventsByExecutionIDsResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -443,12 +840,34 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
   return transaction_status;
 }
 
+::grpc::Status MetadataStoreServiceImpl::GetLineageGraph(
+    ::grpc::ServerContext* context, const GetLineageGraphRequest* request,
+    GetLineageGraphResponse* response) {
+  MetadataStorePool::Handle metadata_store;
+  const ::grpc::Status connection_status =
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
+  if (!connection_status.ok()) {
+    LOG(WARNING) << "Failed to connect to the database: "
+                 << connection_status.error_message();
+    return connection_status;
+  }
+  const ::grpc::Status transaction_status = ToGRPCStatus(
+      lineage_index_ != nullptr
+          ? metadata_store->GetLineageGraph(*request, *lineage_index_, response)
+          : metadata_store->GetLineageGraph(*request, response));
+  if (!transaction_status.ok()) {
+    LOG(WARNING) << "GetLineageGraph failed: "
+                 << transaction_status.error_message();
+  }
+  return transaction_status;
+}
+
 ::grpc::Status MetadataStoreServiceImpl::GetArtifacts(
     ::grpc::ServerContext* context, const GetArtifactsRequest* request,
     GetArtifactsResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -466,9 +885,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::GetArtifactsByType(
     ::grpc::ServerContext* context, const GetArtifactsByTypeRequest* request,
     GetArtifactsByTypeResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -487,9 +906,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
     ::grpc::ServerContext* context,
     const GetArtifactByTypeAndNameRequest* request,
     GetArtifactByTypeAndNameResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -507,9 +926,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::GetArtifactsByURI(
     ::grpc::ServerContext* context, const GetArtifactsByURIRequest* request,
     GetArtifactsByURIResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -524,12 +943,33 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
   return transaction_status;
 }
 
+::grpc::Status MetadataStoreServiceImpl::GetArtifactsByProperty(
+    ::grpc::ServerContext* context,
+    const GetArtifactsByPropertyRequest* request,
+    GetArtifactsByPropertyResponse* response) {
+  MetadataStorePool::Handle metadata_store;
+  const ::grpc::Status connection_status =
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
+  if (!connection_status.ok()) {
+    LOG(WARNING) << "Failed to connect to the database: "
+                 << connection_status.error_message();
+    return connection_status;
+  }
+  const ::grpc::Status transaction_status =
+      ToGRPCStatus(metadata_store->GetArtifactsByProperty(*request, response));
+  if (!transaction_status.ok()) {
+    LOG(WARNING) << "GetArtifactsByProperty failed: "
+                 << transaction_status.error_message();
+  }
+  return transaction_status;
+}
+
 ::grpc::Status MetadataStoreServiceImpl::GetExecutions(
     ::grpc::ServerContext* context, const GetExecutionsRequest* request,
     GetExecutionsResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -547,9 +987,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::GetExecutionsByType(
     ::grpc::ServerContext* context, const GetExecutionsByTypeRequest* request,
     GetExecutionsByTypeResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -568,9 +1008,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
     ::grpc::ServerContext* context,
     const GetExecutionByTypeAndNameRequest* request,
     GetExecutionByTypeAndNameResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -585,12 +1025,33 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
   return transaction_status;
 }
 
+::grpc::Status MetadataStoreServiceImpl::GetExecutionsByProperty(
+    ::grpc::ServerContext* context,
+    const GetExecutionsByPropertyRequest* request,
+    GetExecutionsByPropertyResponse* response) {
+  MetadataStorePool::Handle metadata_store;
+  const ::grpc::Status connection_status =
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
+  if (!connection_status.ok()) {
+    LOG(WARNING) << "Failed to connect to the database: "
+                 << connection_status.error_message();
+    return connection_status;
+  }
+  const ::grpc::Status transaction_status =
+      ToGRPCStatus(metadata_store->GetExecutionsByProperty(*request, response));
+  if (!transaction_status.ok()) {
+    LOG(WARNING) << "GetExecutionsByProperty failed: "
+                 << transaction_status.error_message();
+  }
+  return transaction_status;
+}
+
 ::grpc::Status MetadataStoreServiceImpl::PutContexts(
     ::grpc::ServerContext* context, const PutContextsRequest* request,
     PutContextsResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -608,9 +1069,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::GetContextsByID(
     ::grpc::ServerContext* context, const GetContextsByIDRequest* request,
     GetContextsByIDResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -628,9 +1089,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::GetContexts(
     ::grpc::ServerContext* context, const GetContextsRequest* request,
     GetContextsResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -648,9 +1109,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::GetContextsByType(
     ::grpc::ServerContext* context, const GetContextsByTypeRequest* request,
     GetContextsByTypeResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -669,9 +1130,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
     ::grpc::ServerContext* context,
     const GetContextByTypeAndNameRequest* request,
     GetContextByTypeAndNameResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -686,13 +1147,34 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
   return transaction_status;
 }
 
+::grpc::Status MetadataStoreServiceImpl::GetContextsByProperty(
+    ::grpc::ServerContext* context,
+    const GetContextsByPropertyRequest* request,
+    GetContextsByPropertyResponse* response) {
+  MetadataStorePool::Handle metadata_store;
+  const ::grpc::Status connection_status =
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
+  if (!connection_status.ok()) {
+    LOG(WARNING) << "Failed to connect to the database: "
+                 << connection_status.error_message();
+    return connection_status;
+  }
+  const ::grpc::Status transaction_status =
+      ToGRPCStatus(metadata_store->GetContextsByProperty(*request, response));
+  if (!transaction_status.ok()) {
+    LOG(WARNING) << "GetContextsByProperty failed: "
+                 << transaction_status.error_message();
+  }
+  return transaction_status;
+}
+
 ::grpc::Status MetadataStoreServiceImpl::PutAttributionsAndAssociations(
     ::grpc::ServerContext* context,
     const PutAttributionsAndAssociationsRequest* request,
     PutAttributionsAndAssociationsResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -710,9 +1192,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::GetContextsByArtifact(
     ::grpc::ServerContext* context, const GetContextsByArtifactRequest* request,
     GetContextsByArtifactResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -731,9 +1213,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
     ::grpc::ServerContext* context,
     const GetContextsByExecutionRequest* request,
     GetContextsByExecutionResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -751,9 +1233,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
 ::grpc::Status MetadataStoreServiceImpl::GetArtifactsByContext(
     ::grpc::ServerContext* context, const GetArtifactsByContextRequest* request,
     GetArtifactsByContextResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -772,9 +1254,9 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
     ::grpc::ServerContext* context,
     const GetExecutionsByContextRequest* request,
     GetExecutionsByContextResponse* response) {
-  std::unique_ptr<MetadataStore> metadata_store;
+  MetadataStorePool::Handle metadata_store;
   const ::grpc::Status connection_status =
-      ConnectMetadataStore(connection_config_, &metadata_store);
+      ConnectMetadataStore(metadata_store_pool_.get(), &metadata_store);
   if (!connection_status.ok()) {
     LOG(WARNING) << "Failed to connect to the database: "
                  << connection_status.error_message();
@@ -789,4 +1271,120 @@ MetadataStoreServiceImpl::MetadataStoreServiceImpl(
   return transaction_status;
 }
 
+::grpc::Status MetadataStoreServiceImpl::StreamArtifacts(
+    ::grpc::ServerContext* context, const StreamArtifactsRequest* request,
+    ::grpc::ServerWriter<StreamArtifactsResponse>* writer) {
+  // Each page borrows a store, which is returned before the page is written.
+  const ::grpc::Status transaction_status =
+      ToGRPCStatus(MetadataStore::StreamArtifacts(
+          *request, BorrowForEachCall(metadata_store_pool_.get()),
+          WriteOrCancel(writer)));
+  if (!transaction_status.ok()) {
+    LOG(WARNING) << "StreamArtifacts failed: "
+                 << transaction_status.error_message();
+  }
+  return transaction_status;
+}
+
+::grpc::Status MetadataStoreServiceImpl::StreamArtifactsPage(
+    ::grpc::ServerContext* context, const StreamArtifactsRequest* request,
+    StreamArtifactsResponse* response) {
+  const ::grpc::Status transaction_status =
+      ToGRPCStatus(MetadataStore::ReadArtifactsPage(
+          *request, BorrowForEachCall(metadata_store_pool_.get()), response));
+  if (!transaction_status.ok()) {
+    LOG(WARNING) << "StreamArtifacts failed: "
+                 << transaction_status.error_message();
+  }
+  return transaction_status;
+}
+
+::grpc::Status MetadataStoreServiceImpl::StreamExecutions(
+    ::grpc::ServerContext* context, const StreamExecutionsRequest* request,
+    ::grpc::ServerWriter<StreamExecutionsResponse>* writer) {
+  // Each page borrows a store, which is returned before the page is written.
+  const ::grpc::Status transaction_status =
+      ToGRPCStatus(MetadataStore::StreamExecutions(
+          *request, BorrowForEachCall(metadata_store_pool_.get()),
+          WriteOrCancel(writer)));
+  if (!transaction_status.ok()) {
+    LOG(WARNING) << "StreamExecutions failed: "
+                 << transaction_status.error_message();
+  }
+  return transaction_status;
+}
+
+::grpc::Status MetadataStoreServiceImpl::StreamExecutionsPage(
+    ::grpc::ServerContext* context, const StreamExecutionsRequest* request,
+    StreamExecutionsResponse* response) {
+  const ::grpc::Status transaction_status =
+      ToGRPCStatus(MetadataStore::ReadExecutionsPage(
+          *request, BorrowForEachCall(metadata_store_pool_.get()), response));
+  if (!transaction_status.ok()) {
+    LOG(WARNING) << "StreamExecutions failed: "
+                 << transaction_status.error_message();
+  }
+  return transaction_status;
+}
+
+::grpc::Status MetadataStoreServiceImpl::StreamContexts(
+    ::grpc::ServerContext* context, const StreamContextsRequest* request,
+    ::grpc::ServerWriter<StreamContextsResponse>* writer) {
+  // Each page borrows a store, which is returned before the page is written.
+  const ::grpc::Status transaction_status =
+      ToGRPCStatus(MetadataStore::StreamContexts(
+          *request, BorrowForEachCall(metadata_store_pool_.get()),
+          WriteOrCancel(writer)));
+  if (!transaction_status.ok()) {
+    LOG(WARNING) << "StreamContexts failed: "
+                 << transaction_status.error_message();
+  }
+  return transaction_status;
+}
+
+::grpc::Status MetadataStoreServiceImpl::StreamContextsPage(
+    ::grpc::ServerContext* context, const StreamContextsRequest* request,
+    StreamContextsResponse* response) {
+  const ::grpc::Status transaction_status =
+      ToGRPCStatus(MetadataStore::ReadContextsPage(
+          *request, BorrowForEachCall(metadata_store_pool_.get()), response));
+  if (!transaction_status.ok()) {
+    LOG(WARNING) << "StreamContexts failed: "
+                 << transaction_status.error_message();
+  }
+  return transaction_status;
+}
+
+::grpc::Status MetadataStoreServiceImpl::BulkPut(
+    ::grpc::ServerContext* context,
+    ::grpc::ServerReader<BulkPutRequest>* reader, BulkPutResponse* response) {
+  // The delayed batches are committed by the timer while the stream is read.
+  std::unique_ptr<BulkPutStream> stream =
+      StartBulkPut(response, /*on_batch_due=*/nullptr);
+  // Once the stream is done, the remaining requests are not read, and the
+  // client sends them again in a new stream.
+  BulkPutRequest request;
+  while (!stream->IsDone() && reader->Read(&request)) {
+    if (!stream->Add(std::move(request))) break;
+    stream->CommitDueBatch();
+    request.Clear();
+  }
+  // The requests of a cancelled stream are dropped, as its response is lost.
+  if (context != nullptr && context->IsCancelled()) {
+    stream->Finish(/*commit_pending_requests=*/false);
+    return ::grpc::Status(::grpc::StatusCode::CANCELLED,
+                          "The stream is cancelled.");
+  }
+  return stream->Finish(/*commit_pending_requests=*/true);
+}
+
+std::unique_ptr<MetadataStoreServiceImpl::BulkPutStream>
+MetadataStoreServiceImpl::StartBulkPut(BulkPutResponse* response,
+                                       std::function<void()> on_batch_due) {
+  response->Clear();
+  return absl::WrapUnique(new BulkPutStream(
+      bulk_put_config_, metadata_store_pool_.get(), lineage_index_.get(),
+      bulk_put_timer_.get(), response, std::move(on_batch_due)));
+}
+
 }  // namespace ml_metadata
@@ -15,26 +15,66 @@ limitations under the License.
 #ifndef ML_METADATA_METADATA_STORE_METADATA_STORE_SERVICE_IMPL_H_
 #define ML_METADATA_METADATA_STORE_METADATA_STORE_SERVICE_IMPL_H_
 
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
+#include "ml_metadata/metadata_store/lineage_index.h"
 #include "ml_metadata/metadata_store/metadata_store.h"
+#include "ml_metadata/metadata_store/metadata_store_pool.h"
 #include "ml_metadata/proto/metadata_store.pb.h"
 #include "ml_metadata/proto/metadata_store_service.grpc.pb.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/env.h"
 
 namespace ml_metadata {
 
 // A metadata store gRPC server that implements MetadataStoreService defined in
 // proto/metadata_store_service.proto. It is thread-safe.
-// Note, concurrent call to methods in different threads are sequential.
-// TODO(b/123039345) Add a connection pool in metadata_store or grpc service.
+// Each call borrows a connected store from a MetadataStorePool, so concurrent
+// calls in different threads use different connections, up to the
+// max_pool_size of the given ConnectionPoolConfig.
 class MetadataStoreServiceImpl final
     : public MetadataStoreService::Service {
  public:
+  // Uses the default ConnectionPoolConfig.
   explicit MetadataStoreServiceImpl(const ConnectionConfig& connection_config);
 
+  // Uses the default BulkPutConfig.
+  // Dies if the connection_pool_config is not valid.
+  MetadataStoreServiceImpl(const ConnectionConfig& connection_config,
+                           const ConnectionPoolConfig& connection_pool_config);
+
+  // Factory method that creates a service in `result`.
+  // Returns INVALID_ARGUMENT error, if the connection_pool_config or the
+  // bulk_put_config is not valid.
+  static tensorflow::Status Create(
+      const ConnectionConfig& connection_config,
+      const ConnectionPoolConfig& connection_pool_config,
+      const BulkPutConfig& bulk_put_config,
+      std::unique_ptr<MetadataStoreServiceImpl>* result);
+
   // default & copy constructors are disallowed.
   MetadataStoreServiceImpl() = delete;
   MetadataStoreServiceImpl(const MetadataStoreServiceImpl&) = delete;
   MetadataStoreServiceImpl& operator=(const MetadataStoreServiceImpl&) = delete;
 
+  // Stops the catch up of the lineage index, if it is enabled.
+  ~MetadataStoreServiceImpl() override;
+
+  // Loads a lineage index of the events of the metadata source, which then
+  // answers the GetLineageGraph requests. The index is updated with the events
+  // written by PutEvents, PutExecution and BulkPut, and catches up with the
+  // ones written by other clients every catch_up_interval_sec.
+  // The added events are compacted into the index by the same background
+  // thread. It must be called before the service receives requests.
+  // Returns FAILED_PRECONDITION error, if the lineage index is enabled already.
+  // Returns the errors of LoadLineageIndex.
+  tensorflow::Status EnableLineageIndex(const LineageIndexConfig& config);
+
   ::grpc::Status PutArtifactType(::grpc::ServerContext* context,
                                  const PutArtifactTypeRequest* request,
                                  PutArtifactTypeResponse* response) override;
@@ -119,6 +159,10 @@ class MetadataStoreServiceImpl final
       const GetEventsByExecutionIDsRequest* request,
       GetEventsByExecutionIDsResponse* response) override;
 
+  ::grpc::Status GetLineageGraph(::grpc::ServerContext* context,
+                                 const GetLineageGraphRequest* request,
+                                 GetLineageGraphResponse* response) override;
+
   ::grpc::Status GetArtifacts(::grpc::ServerContext* context,
                               const GetArtifactsRequest* request,
                               GetArtifactsResponse* response) override;
@@ -136,6 +180,11 @@ class MetadataStoreServiceImpl final
       ::grpc::ServerContext* context, const GetArtifactsByURIRequest* request,
       GetArtifactsByURIResponse* response) override;
 
+  ::grpc::Status GetArtifactsByProperty(
+      ::grpc::ServerContext* context,
+      const GetArtifactsByPropertyRequest* request,
+      GetArtifactsByPropertyResponse* response) override;
+
   ::grpc::Status GetExecutions(::grpc::ServerContext* context,
                                const GetExecutionsRequest* request,
                                GetExecutionsResponse* response) override;
@@ -149,6 +198,11 @@ class MetadataStoreServiceImpl final
       const GetExecutionByTypeAndNameRequest* request,
       GetExecutionByTypeAndNameResponse* response) override;
 
+  ::grpc::Status GetExecutionsByProperty(
+      ::grpc::ServerContext* context,
+      const GetExecutionsByPropertyRequest* request,
+      GetExecutionsByPropertyResponse* response) override;
+
   ::grpc::Status PutContexts(::grpc::ServerContext* context,
                              const PutContextsRequest* request,
                              PutContextsResponse* response) override;
@@ -170,6 +224,11 @@ class MetadataStoreServiceImpl final
       const GetContextByTypeAndNameRequest* request,
       GetContextByTypeAndNameResponse* response) override;
 
+  ::grpc::Status GetContextsByProperty(
+      ::grpc::ServerContext* context,
+      const GetContextsByPropertyRequest* request,
+      GetContextsByPropertyResponse* response) override;
+
   ::grpc::Status PutAttributionsAndAssociations(
       ::grpc::ServerContext* context,
       const PutAttributionsAndAssociationsRequest* request,
@@ -195,8 +254,151 @@ class MetadataStoreServiceImpl final
       const GetExecutionsByContextRequest* request,
       GetExecutionsByContextResponse* response) override;
 
+  ::grpc::Status StreamArtifacts(
+      ::grpc::ServerContext* context, const StreamArtifactsRequest* request,
+      ::grpc::ServerWriter<StreamArtifactsResponse>* writer) override;
+
+  ::grpc::Status StreamExecutions(
+      ::grpc::ServerContext* context, const StreamExecutionsRequest* request,
+      ::grpc::ServerWriter<StreamExecutionsResponse>* writer) override;
+
+  ::grpc::Status StreamContexts(
+      ::grpc::ServerContext* context, const StreamContextsRequest* request,
+      ::grpc::ServerWriter<StreamContextsResponse>* writer) override;
+
+  ::grpc::Status BulkPut(::grpc::ServerContext* context,
+                         ::grpc::ServerReader<BulkPutRequest>* reader,
+                         BulkPutResponse* response) override;
+
+  // Read the first page of a streaming request, i.e., its first response,
+  // with a store borrowed from the pool for the page only, so that
+  // asynchronous servers write each page from their completion queues, and
+  // read the next one with the next_page_token of the response.
+  ::grpc::Status StreamArtifactsPage(::grpc::ServerContext* context,
+                                     const StreamArtifactsRequest* request,
+                                     StreamArtifactsResponse* response);
+  ::grpc::Status StreamExecutionsPage(::grpc::ServerContext* context,
+                                      const StreamExecutionsRequest* request,
+                                      StreamExecutionsResponse* response);
+  ::grpc::Status StreamContextsPage(::grpc::ServerContext* context,
+                                    const StreamContextsRequest* request,
+                                    StreamContextsResponse* response);
+
+  // Calls the `on_batch_due` of the BulkPut streams at their deadlines, in one
+  // thread for all the streams of the service.
+  class BulkPutTimer;
+
+  // A BulkPut stream, which groups its requests into batches by the
+  // BulkPutConfig of the service, and commits them in its response. It is
+  // thread-safe, but the batches are committed one at a time.
+  //
+  // The reader of the stream adds the requests, and commits the pending batch
+  // with CommitDueBatch once IsBatchDue. If max_batch_delay_ms is positive,
+  // the timer of the service, whose thread is shared by all the streams, calls
+  // `on_batch_due` once the first request of the pending batch has waited
+  // max_batch_delay_ms, so that the batch is committed even if the client
+  // pauses. If `on_batch_due` is null, the timer commits the batch in its own
+  // thread. The stream is done once it has max_batches_per_stream batches, or
+  // a store cannot be borrowed.
+  class BulkPutStream {
+   public:
+    // Cancels the calls of `on_batch_due`, and waits for a running one.
+    ~BulkPutStream();
+
+    BulkPutStream(const BulkPutStream&) = delete;
+    BulkPutStream& operator=(const BulkPutStream&) = delete;
+
+    // Adds a request to the pending batch. Returns false, without adding the
+    // request, if the stream is done.
+    bool Add(BulkPutRequest request);
+
+    // Returns true if the pending batch has max_batch_size records, or its
+    // first request has waited max_batch_delay_ms.
+    bool IsBatchDue() const;
+
+    // Returns true if no request is added to the stream anymore.
+    bool IsDone() const;
+
+    // Commits the pending batch if it is due, with a store borrowed from the
+    // pool of the service. A failed batch is reported in its status, and the
+    // stream goes on.
+    void CommitDueBatch();
+
+    // Commits the pending requests if `commit_pending_requests`, or drops
+    // them, and cancels the calls of `on_batch_due`. Returns the status of the
+    // stream.
+    ::grpc::Status Finish(bool commit_pending_requests);
+
+   private:
+    friend class MetadataStoreServiceImpl;
+    friend class BulkPutTimer;
+
+    BulkPutStream(const BulkPutConfig& config,
+                  MetadataStorePool* metadata_store_pool,
+                  LineageIndex* lineage_index, BulkPutTimer* timer,
+                  BulkPutResponse* response,
+                  std::function<void()> on_batch_due);
+
+    // Calls `on_batch_due`, or commits the batch if it is null.
+    void OnBatchDue();
+
+    bool IsDoneLocked() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+    bool IsBatchDueLocked() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+    // Commits the pending batch, if any, and if it is due or `force`.
+    void CommitBatch(bool force);
+
+    const BulkPutConfig& config_;
+    MetadataStorePool* const metadata_store_pool_;
+    // The lineage index of the service, if it is enabled, to which the events
+    // of the committed batches are added.
+    LineageIndex* const lineage_index_;
+    BulkPutTimer* const timer_;
+    const std::function<void()> on_batch_due_;
+
+    // Held while a batch is committed, so that the batches are committed and
+    // added to the response in order.
+    absl::Mutex commit_mu_ ABSL_ACQUIRED_BEFORE(mu_);
+
+    mutable absl::Mutex mu_;
+    BulkPutResponse* const response_ ABSL_PT_GUARDED_BY(mu_);
+    // The requests of the pending batch, and the time the first one was added.
+    std::vector<BulkPutRequest> requests_ ABSL_GUARDED_BY(mu_);
+    absl::Time first_request_time_ ABSL_GUARDED_BY(mu_);
+    // The number of records of the pending batch.
+    int num_records_ ABSL_GUARDED_BY(mu_) = 0;
+    // The number of requests added to the batches.
+    int64 num_requests_ ABSL_GUARDED_BY(mu_) = 0;
+    // The number of batches taken from the pending requests.
+    int num_batches_ ABSL_GUARDED_BY(mu_) = 0;
+    // The error which ended the stream, if any.
+    ::grpc::Status status_ ABSL_GUARDED_BY(mu_);
+    bool finished_ ABSL_GUARDED_BY(mu_) = false;
+  };
+
+  // Starts a BulkPut stream, whose batches are returned in `response`. The
+  // stream must not outlive the service or the response. See BulkPutStream
+  // for `on_batch_due`, which must not block.
+  std::unique_ptr<BulkPutStream> StartBulkPut(
+      BulkPutResponse* response, std::function<void()> on_batch_due);
+
  private:
-  const ConnectionConfig connection_config_;
+  // To construct the object with a bulk_put_config, see Create(...).
+  MetadataStoreServiceImpl(
+      std::unique_ptr<MetadataStorePool> metadata_store_pool,
+      const BulkPutConfig& bulk_put_config);
+
+  std::unique_ptr<MetadataStorePool> metadata_store_pool_;
+  const BulkPutConfig bulk_put_config_;
+  // The timer of the delayed batches of all the BulkPut streams.
+  std::unique_ptr<BulkPutTimer> bulk_put_timer_;
+
+  // The lineage index, if it is enabled, and the thread catching it up with
+  // the metadata source and compacting it until stop_lineage_index_catch_up_
+  // is notified.
+  std::unique_ptr<LineageIndex> lineage_index_;
+  absl::Notification stop_lineage_index_catch_up_;
+  std::unique_ptr<tensorflow::Thread> lineage_index_catch_up_thread_;
 };
 
 }  // namespace ml_metadata
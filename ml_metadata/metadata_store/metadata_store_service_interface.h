@@ -67,8 +67,12 @@ class MetadataStoreServiceInterface {
   METADATA_STORE_SERVICE_INTERFACE_DECLARE(GetContextsByType)
   METADATA_STORE_SERVICE_INTERFACE_DECLARE(GetContextByTypeAndName)
   METADATA_STORE_SERVICE_INTERFACE_DECLARE(GetArtifactsByURI)
+  METADATA_STORE_SERVICE_INTERFACE_DECLARE(GetArtifactsByProperty)
+  METADATA_STORE_SERVICE_INTERFACE_DECLARE(GetExecutionsByProperty)
+  METADATA_STORE_SERVICE_INTERFACE_DECLARE(GetContextsByProperty)
   METADATA_STORE_SERVICE_INTERFACE_DECLARE(GetEventsByExecutionIDs)
   METADATA_STORE_SERVICE_INTERFACE_DECLARE(GetEventsByArtifactIDs)
+  METADATA_STORE_SERVICE_INTERFACE_DECLARE(GetLineageGraph)
   METADATA_STORE_SERVICE_INTERFACE_DECLARE(GetContextsByArtifact)
   METADATA_STORE_SERVICE_INTERFACE_DECLARE(GetContextsByExecution)
   METADATA_STORE_SERVICE_INTERFACE_DECLARE(GetParentContextsByContext)
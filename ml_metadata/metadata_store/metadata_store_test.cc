@@ -24,6 +24,7 @@ limitations under the License.
 #include "ml_metadata/metadata_store/test_util.h"
 #include "ml_metadata/proto/metadata_source.pb.h"
 #include "ml_metadata/util/metadata_source_query_config.h"
+#include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/env.h"
 
@@ -119,6 +120,97 @@ TEST(MetadataStoreExtendedTest, SpecifyDowngradeMigrationWhenCreate) {
   TF_EXPECT_OK(tensorflow::Env::Default()->DeleteFile(filename_uri));
 }
 
+TEST(MetadataStoreExtendedTest, SchemaCheckIsCachedPerDatabase) {
+  const MetadataSourceQueryConfig& query_config =
+      util::GetSqliteMetadataSourceQueryConfig();
+  const std::string filename_uri =
+      absl::StrCat(::testing::TempDir(), "test_schema_check_cache.db");
+  SqliteMetadataSourceConfig connection_config;
+  connection_config.set_filename_uri(filename_uri);
+  auto init_metadata_store = [&]() -> tensorflow::Status {
+    auto metadata_source =
+        absl::make_unique<SqliteMetadataSource>(connection_config);
+    auto transaction_executor =
+        absl::make_unique<RdbmsTransactionExecutor>(metadata_source.get());
+    std::unique_ptr<MetadataStore> metadata_store;
+    TF_RETURN_IF_ERROR(MetadataStore::Create(
+        query_config, {}, std::move(metadata_source),
+        std::move(transaction_executor), &metadata_store));
+    return metadata_store->InitMetadataStoreIfNotExists();
+  };
+  auto execute_query = [&](const std::string& query) {
+    SqliteMetadataSource metadata_source(connection_config);
+    TF_ASSERT_OK(metadata_source.Connect());
+    TF_ASSERT_OK(metadata_source.Begin());
+    TF_ASSERT_OK(metadata_source.ExecuteQuery(query, nullptr));
+    TF_ASSERT_OK(metadata_source.Commit());
+  };
+
+  // The first connection creates and verifies all the tables.
+  TF_ASSERT_OK(init_metadata_store());
+  // Later connections only check the schema version, so a missing table is not
+  // detected.
+  execute_query("DROP TABLE `Attribution`;");
+  TF_EXPECT_OK(init_metadata_store());
+  // Once the schema version changes, the full check runs again.
+  execute_query("UPDATE `MLMDEnv` SET `schema_version` = 0;");
+  EXPECT_TRUE(tensorflow::errors::IsFailedPrecondition(init_metadata_store()));
+  TF_EXPECT_OK(tensorflow::Env::Default()->DeleteFile(filename_uri));
+}
+
+TEST(MetadataStoreExtendedTest, TypeChangesOfOtherConnectionsAreSeen) {
+  const std::string filename_uri =
+      absl::StrCat(::testing::TempDir(), "test_type_cache.db");
+  SqliteMetadataSourceConfig connection_config;
+  connection_config.set_filename_uri(filename_uri);
+  auto create_metadata_store = [&]() {
+    auto metadata_source =
+        absl::make_unique<SqliteMetadataSource>(connection_config);
+    auto transaction_executor =
+        absl::make_unique<RdbmsTransactionExecutor>(metadata_source.get());
+    std::unique_ptr<MetadataStore> metadata_store;
+    TF_CHECK_OK(MetadataStore::Create(
+        util::GetSqliteMetadataSourceQueryConfig(), {},
+        std::move(metadata_source), std::move(transaction_executor),
+        &metadata_store));
+    TF_CHECK_OK(metadata_store->InitMetadataStoreIfNotExists());
+    return metadata_store;
+  };
+  std::unique_ptr<MetadataStore> type_writer = create_metadata_store();
+  std::unique_ptr<MetadataStore> artifact_writer = create_metadata_store();
+
+  PutArtifactTypeRequest put_type_request =
+      ParseTextProtoOrDie<PutArtifactTypeRequest>(R"(
+        all_fields_match: true
+        artifact_type: {
+          name: 'test_type'
+          properties { key: 'property_1' value: INT }
+        }
+      )");
+  PutArtifactTypeResponse put_type_response;
+  TF_ASSERT_OK(type_writer->PutArtifactType(put_type_request,
+                                            &put_type_response));
+  PutArtifactsRequest put_artifacts_request;
+  Artifact* artifact = put_artifacts_request.add_artifacts();
+  artifact->set_type_id(put_type_response.type_id());
+  (*artifact->mutable_properties())["property_1"].set_int_value(1);
+  PutArtifactsResponse put_artifacts_response;
+  TF_ASSERT_OK(artifact_writer->PutArtifacts(put_artifacts_request,
+                                             &put_artifacts_response));
+
+  // The other connection adds a property to the type, which is used right
+  // after by the connection that has read the type before.
+  put_type_request.set_can_add_fields(true);
+  (*put_type_request.mutable_artifact_type()
+        ->mutable_properties())["property_2"] = STRING;
+  TF_ASSERT_OK(type_writer->PutArtifactType(put_type_request,
+                                            &put_type_response));
+  (*artifact->mutable_properties())["property_2"].set_string_value("2");
+  TF_EXPECT_OK(artifact_writer->PutArtifacts(put_artifacts_request,
+                                             &put_artifacts_response));
+  TF_EXPECT_OK(tensorflow::Env::Default()->DeleteFile(filename_uri));
+}
+
 
 }  // namespace
 
@@ -14,7 +14,9 @@ limitations under the License.
 ==============================================================================*/
 #include "ml_metadata/metadata_store/metadata_store_test_suite.h"
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include "absl/strings/substitute.h"
@@ -29,6 +31,7 @@ namespace {
 
 using ::ml_metadata::testing::ParseTextProtoOrDie;
 using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
 using ::testing::IsEmpty;
 using ::testing::SizeIs;
 using ::testing::UnorderedElementsAre;
@@ -741,6 +744,78 @@ TEST_P(MetadataStoreTestSuite, PutArtifactsGetArtifactsWithListOptions) {
                                               "last_update_time_since_epoch"}));
 }
 
+TEST_P(MetadataStoreTestSuite, PutArtifactsStreamArtifacts) {
+  const PutArtifactTypeRequest put_artifact_type_request =
+      ParseTextProtoOrDie<PutArtifactTypeRequest>(
+          R"(
+            all_fields_match: true
+            artifact_type: { name: 'test_type' }
+          )");
+  PutArtifactTypeResponse put_artifact_type_response;
+  TF_ASSERT_OK(metadata_store_->PutArtifactType(put_artifact_type_request,
+                                                &put_artifact_type_response));
+  PutArtifactsRequest put_artifacts_request;
+  // Creating 3 artifacts.
+  for (int i = 0; i < 3; i++) {
+    put_artifacts_request.add_artifacts()->set_type_id(
+        put_artifact_type_response.type_id());
+  }
+  PutArtifactsResponse put_artifacts_response;
+  TF_ASSERT_OK(metadata_store_->PutArtifacts(put_artifacts_request,
+                                             &put_artifacts_response));
+
+  StreamArtifactsRequest stream_artifacts_request =
+      ParseTextProtoOrDie<StreamArtifactsRequest>(R"(
+        options {
+          max_result_size: 2,
+          order_by_field: { field: ID is_asc: true }
+        }
+      )");
+  std::vector<StreamArtifactsResponse> stream_artifacts_responses;
+  TF_ASSERT_OK(metadata_store_->StreamArtifacts(
+      stream_artifacts_request,
+      [&stream_artifacts_responses](const StreamArtifactsResponse& response) {
+        stream_artifacts_responses.push_back(response);
+        return tensorflow::Status::OK();
+      }));
+  ASSERT_THAT(stream_artifacts_responses, SizeIs(2));
+  EXPECT_THAT(stream_artifacts_responses[0].next_page_token(), Not(IsEmpty()));
+  EXPECT_THAT(stream_artifacts_responses[1].next_page_token(), IsEmpty());
+  std::vector<int64> streamed_ids;
+  for (const StreamArtifactsResponse& response : stream_artifacts_responses) {
+    for (const Artifact& artifact : response.artifacts()) {
+      streamed_ids.push_back(artifact.id());
+    }
+  }
+  EXPECT_THAT(streamed_ids,
+              ElementsAreArray(put_artifacts_response.artifact_ids()));
+
+  // The pages are read one at a time with their tokens.
+  const MetadataStore::StoreRunner with_store =
+      [this](const std::function<tensorflow::Status(MetadataStore*)>& run) {
+        return run(metadata_store_);
+      };
+  StreamArtifactsResponse page;
+  TF_ASSERT_OK(MetadataStore::ReadArtifactsPage(stream_artifacts_request,
+                                                with_store, &page));
+  EXPECT_THAT(page, testing::EqualsProto(stream_artifacts_responses[0]));
+  stream_artifacts_request.mutable_options()->set_next_page_token(
+      page.next_page_token());
+  TF_ASSERT_OK(MetadataStore::ReadArtifactsPage(stream_artifacts_request,
+                                                with_store, &page));
+  EXPECT_THAT(page, testing::EqualsProto(stream_artifacts_responses[1]));
+  stream_artifacts_request.mutable_options()->clear_next_page_token();
+
+  // An error of the writer stops the stream.
+  int num_writes = 0;
+  EXPECT_TRUE(tensorflow::errors::IsCancelled(metadata_store_->StreamArtifacts(
+      stream_artifacts_request, [&num_writes](const StreamArtifactsResponse&) {
+        num_writes++;
+        return tensorflow::errors::Cancelled("The stream is closed.");
+      })));
+  EXPECT_EQ(num_writes, 1);
+}
+
 // Test creating an execution and then updating one of its properties.
 TEST_P(MetadataStoreTestSuite, PutExecutionsUpdateGetExecutionsByID) {
   const PutExecutionTypeRequest put_execution_type_request =
@@ -1331,6 +1406,113 @@ TEST_P(MetadataStoreTestSuite, GetArtifactByURI) {
   }
 }
 
+TEST_P(MetadataStoreTestSuite, GetArtifactsByProperty) {
+  const PutArtifactTypeRequest put_artifact_type_request =
+      ParseTextProtoOrDie<PutArtifactTypeRequest>(
+          R"(all_fields_match: true
+             artifact_type: {
+               name: 'artifact_type'
+               properties { key: 'span' value: INT }
+             })");
+  PutArtifactTypeResponse put_artifact_type_response;
+  TF_ASSERT_OK(metadata_store_->PutArtifactType(put_artifact_type_request,
+                                                &put_artifact_type_response));
+  const int64 type_id = put_artifact_type_response.type_id();
+
+  PutArtifactsRequest put_artifacts_request;
+  for (int span = 0; span < 5; span++) {
+    Artifact* artifact = put_artifacts_request.add_artifacts();
+    artifact->set_type_id(type_id);
+    (*artifact->mutable_properties())["span"].set_int_value(span);
+    (*artifact->mutable_custom_properties())["owner"].set_string_value(
+        span % 2 == 0 ? "even" : "odd");
+  }
+  PutArtifactsResponse put_artifacts_response;
+  TF_ASSERT_OK(metadata_store_->PutArtifacts(put_artifacts_request,
+                                             &put_artifacts_response));
+  ASSERT_THAT(put_artifacts_response.artifact_ids(), SizeIs(5));
+  const auto& ids = put_artifacts_response.artifact_ids();
+
+  {
+    // equality on a property
+    GetArtifactsByPropertyRequest request =
+        ParseTextProtoOrDie<GetArtifactsByPropertyRequest>(R"(
+          type_name: 'artifact_type'
+          property_name: 'span'
+          value: { int_value: 3 }
+        )");
+    GetArtifactsByPropertyResponse response;
+    TF_ASSERT_OK(metadata_store_->GetArtifactsByProperty(request, &response));
+    ASSERT_THAT(response.artifacts(), SizeIs(1));
+    EXPECT_EQ(response.artifacts(0).id(), ids[3]);
+  }
+
+  {
+    // equality on a custom property
+    GetArtifactsByPropertyRequest request =
+        ParseTextProtoOrDie<GetArtifactsByPropertyRequest>(R"(
+          property_name: 'owner'
+          is_custom_property: true
+          value: { string_value: 'even' }
+        )");
+    GetArtifactsByPropertyResponse response;
+    TF_ASSERT_OK(metadata_store_->GetArtifactsByProperty(request, &response));
+    EXPECT_THAT(response.artifacts(), SizeIs(3));
+  }
+
+  {
+    // range over pages of one artifact
+    GetArtifactsByPropertyRequest request =
+        ParseTextProtoOrDie<GetArtifactsByPropertyRequest>(R"(
+          type_name: 'artifact_type'
+          property_name: 'span'
+          min_value: { int_value: 1 }
+          max_value: { int_value: 4 }
+          options: {
+            max_result_size: 1
+            order_by_field: { field: ID is_asc: true }
+          }
+        )");
+    std::vector<int64> got_ids;
+    do {
+      GetArtifactsByPropertyResponse response;
+      TF_ASSERT_OK(metadata_store_->GetArtifactsByProperty(request, &response));
+      ASSERT_THAT(response.artifacts(), SizeIs(1));
+      got_ids.push_back(response.artifacts(0).id());
+      request.mutable_options()->set_next_page_token(
+          response.next_page_token());
+    } while (!request.options().next_page_token().empty());
+    EXPECT_THAT(got_ids, ElementsAre(ids[1], ids[2], ids[3]));
+  }
+
+  {
+    // no matching artifacts
+    GetArtifactsByPropertyRequest request =
+        ParseTextProtoOrDie<GetArtifactsByPropertyRequest>(R"(
+          type_name: 'unknown_type'
+          property_name: 'span'
+          value: { int_value: 3 }
+        )");
+    GetArtifactsByPropertyResponse response;
+    TF_ASSERT_OK(metadata_store_->GetArtifactsByProperty(request, &response));
+    EXPECT_THAT(response.artifacts(), SizeIs(0));
+  }
+
+  for (const char* invalid_request :
+       {"value: { int_value: 3 }", "property_name: 'span'",
+        "property_name: 'span' value: { int_value: 3 } "
+        "min_value: { int_value: 1 }"}) {
+    GetArtifactsByPropertyResponse response;
+    EXPECT_EQ(metadata_store_
+                  ->GetArtifactsByProperty(
+                      ParseTextProtoOrDie<GetArtifactsByPropertyRequest>(
+                          invalid_request),
+                      &response)
+                  .code(),
+              tensorflow::error::INVALID_ARGUMENT);
+  }
+}
+
 TEST_P(MetadataStoreTestSuite, PutArtifactsGetArtifactsWithEmptyArtifact) {
   const PutArtifactTypeRequest put_artifact_type_request =
       ParseTextProtoOrDie<PutArtifactTypeRequest>(
@@ -1488,6 +1670,279 @@ TEST_P(MetadataStoreTestSuite, PutEventGetEvents) {
             put_artifacts_response.artifact_ids(0));
 }
 
+TEST_P(MetadataStoreTestSuite, GetLineageGraph) {
+  const PutTypesRequest put_types_request =
+      ParseTextProtoOrDie<PutTypesRequest>(R"(
+        artifact_types: { name: 'data' }
+        artifact_types: { name: 'model' }
+        execution_types: { name: 'trainer' }
+      )");
+  PutTypesResponse put_types_response;
+  TF_ASSERT_OK(
+      metadata_store_->PutTypes(put_types_request, &put_types_response));
+
+  // a0 -> e0 -> a1 -> e1 -> a2
+  //                      -> a3 (model)
+  PutArtifactsRequest put_artifacts_request;
+  for (int i = 0; i < 4; i++) {
+    put_artifacts_request.add_artifacts()->set_type_id(
+        put_types_response.artifact_type_ids(i < 3 ? 0 : 1));
+  }
+  PutArtifactsResponse put_artifacts_response;
+  TF_ASSERT_OK(metadata_store_->PutArtifacts(put_artifacts_request,
+                                             &put_artifacts_response));
+  const auto& a = put_artifacts_response.artifact_ids();
+  PutExecutionsRequest put_executions_request;
+  for (int i = 0; i < 2; i++) {
+    put_executions_request.add_executions()->set_type_id(
+        put_types_response.execution_type_ids(0));
+  }
+  PutExecutionsResponse put_executions_response;
+  TF_ASSERT_OK(metadata_store_->PutExecutions(put_executions_request,
+                                              &put_executions_response));
+  const auto& e = put_executions_response.execution_ids();
+  PutEventsRequest put_events_request;
+  const auto add_event = [&put_events_request](int64 artifact_id,
+                                               int64 execution_id,
+                                               Event::Type type) {
+    Event* event = put_events_request.add_events();
+    event->set_artifact_id(artifact_id);
+    event->set_execution_id(execution_id);
+    event->set_type(type);
+  };
+  add_event(a[0], e[0], Event::INPUT);
+  add_event(a[1], e[0], Event::OUTPUT);
+  add_event(a[1], e[1], Event::INPUT);
+  add_event(a[2], e[1], Event::OUTPUT);
+  add_event(a[3], e[1], Event::OUTPUT);
+  PutEventsResponse put_events_response;
+  TF_ASSERT_OK(
+      metadata_store_->PutEvents(put_events_request, &put_events_response));
+
+  const auto artifact_ids = [](const GetLineageGraphResponse& response) {
+    std::vector<int64> ids;
+    for (const Artifact& artifact : response.artifacts()) {
+      ids.push_back(artifact.id());
+    }
+    return ids;
+  };
+  const auto execution_ids = [](const GetLineageGraphResponse& response) {
+    std::vector<int64> ids;
+    for (const Execution& execution : response.executions()) {
+      ids.push_back(execution.id());
+    }
+    return ids;
+  };
+
+  {
+    GetLineageGraphRequest request;
+    request.add_artifact_ids(a[0]);
+    request.set_direction(GetLineageGraphRequest::DOWNSTREAM);
+    GetLineageGraphResponse response;
+    TF_ASSERT_OK(metadata_store_->GetLineageGraph(request, &response));
+    EXPECT_THAT(artifact_ids(response),
+                UnorderedElementsAre(a[0], a[1], a[2], a[3]));
+    EXPECT_THAT(execution_ids(response), ElementsAre(e[0], e[1]));
+    EXPECT_THAT(response.events(), SizeIs(5));
+    EXPECT_FALSE(response.is_truncated());
+  }
+
+  {
+    GetLineageGraphRequest request;
+    request.add_artifact_ids(a[2]);
+    request.set_direction(GetLineageGraphRequest::UPSTREAM);
+    GetLineageGraphResponse response;
+    TF_ASSERT_OK(metadata_store_->GetLineageGraph(request, &response));
+    EXPECT_THAT(artifact_ids(response), ElementsAre(a[2], a[1], a[0]));
+    EXPECT_THAT(execution_ids(response), ElementsAre(e[1], e[0]));
+    EXPECT_THAT(response.events(), SizeIs(4));
+  }
+
+  {
+    // one hop in both directions
+    GetLineageGraphRequest request;
+    request.add_artifact_ids(a[1]);
+    request.set_max_num_hops(1);
+    GetLineageGraphResponse response;
+    TF_ASSERT_OK(metadata_store_->GetLineageGraph(request, &response));
+    EXPECT_THAT(artifact_ids(response), ElementsAre(a[1]));
+    EXPECT_THAT(execution_ids(response), UnorderedElementsAre(e[0], e[1]));
+    EXPECT_THAT(response.events(), SizeIs(2));
+  }
+
+  {
+    // the events between the seeds are returned once
+    GetLineageGraphRequest request;
+    request.add_artifact_ids(a[1]);
+    request.add_execution_ids(e[0]);
+    request.set_max_num_hops(1);
+    GetLineageGraphResponse response;
+    TF_ASSERT_OK(metadata_store_->GetLineageGraph(request, &response));
+    EXPECT_THAT(artifact_ids(response), UnorderedElementsAre(a[0], a[1]));
+    EXPECT_THAT(execution_ids(response), UnorderedElementsAre(e[0], e[1]));
+    EXPECT_THAT(response.events(), SizeIs(3));
+  }
+
+  {
+    // the model is not traversed
+    GetLineageGraphRequest request;
+    request.add_artifact_ids(a[0]);
+    request.add_artifact_type_names("data");
+    GetLineageGraphResponse response;
+    TF_ASSERT_OK(metadata_store_->GetLineageGraph(request, &response));
+    EXPECT_THAT(artifact_ids(response), ElementsAre(a[0], a[1], a[2]));
+    EXPECT_THAT(response.events(), SizeIs(4));
+  }
+
+  {
+    GetLineageGraphRequest request;
+    request.add_artifact_ids(a[0]);
+    request.set_max_num_nodes(2);
+    GetLineageGraphResponse response;
+    TF_ASSERT_OK(metadata_store_->GetLineageGraph(request, &response));
+    EXPECT_THAT(artifact_ids(response), ElementsAre(a[0]));
+    EXPECT_THAT(execution_ids(response), ElementsAre(e[0]));
+    EXPECT_THAT(response.events(), SizeIs(1));
+    EXPECT_TRUE(response.is_truncated());
+  }
+
+  {
+    GetLineageGraphRequest request;
+    request.add_artifact_ids(a[0]);
+    request.set_max_num_nodes(0);
+    GetLineageGraphResponse response;
+    EXPECT_EQ(metadata_store_->GetLineageGraph(request, &response).code(),
+              tensorflow::error::INVALID_ARGUMENT);
+  }
+
+  {
+    GetLineageGraphRequest request;
+    request.add_execution_ids(e[1] + 100);
+    GetLineageGraphResponse response;
+    EXPECT_EQ(metadata_store_->GetLineageGraph(request, &response).code(),
+              tensorflow::error::NOT_FOUND);
+  }
+}
+
+TEST_P(MetadataStoreTestSuite, GetLineageGraphWithLineageIndex) {
+  const PutTypesRequest put_types_request =
+      ParseTextProtoOrDie<PutTypesRequest>(R"(
+        artifact_types: { name: 'data' }
+        execution_types: { name: 'trainer' }
+      )");
+  PutTypesResponse put_types_response;
+  TF_ASSERT_OK(
+      metadata_store_->PutTypes(put_types_request, &put_types_response));
+
+  // a0 -> e0 -> a1 -> e1 -> a2, where a1 is input of e1 twice.
+  PutArtifactsRequest put_artifacts_request;
+  for (int i = 0; i < 3; i++) {
+    put_artifacts_request.add_artifacts()->set_type_id(
+        put_types_response.artifact_type_ids(0));
+  }
+  PutArtifactsResponse put_artifacts_response;
+  TF_ASSERT_OK(metadata_store_->PutArtifacts(put_artifacts_request,
+                                             &put_artifacts_response));
+  const auto& a = put_artifacts_response.artifact_ids();
+  PutExecutionsRequest put_executions_request;
+  for (int i = 0; i < 2; i++) {
+    put_executions_request.add_executions()->set_type_id(
+        put_types_response.execution_type_ids(0));
+  }
+  PutExecutionsResponse put_executions_response;
+  TF_ASSERT_OK(metadata_store_->PutExecutions(put_executions_request,
+                                              &put_executions_response));
+  const auto& e = put_executions_response.execution_ids();
+  PutEventsRequest put_events_request;
+  const auto add_event = [&put_events_request](int64 artifact_id,
+                                               int64 execution_id,
+                                               Event::Type type) {
+    Event* event = put_events_request.add_events();
+    event->set_artifact_id(artifact_id);
+    event->set_execution_id(execution_id);
+    event->set_type(type);
+  };
+  add_event(a[0], e[0], Event::INPUT);
+  add_event(a[1], e[0], Event::OUTPUT);
+  add_event(a[1], e[1], Event::INPUT);
+  add_event(a[1], e[1], Event::INPUT);
+  add_event(a[2], e[1], Event::OUTPUT);
+  PutEventsResponse put_events_response;
+  TF_ASSERT_OK(
+      metadata_store_->PutEvents(put_events_request, &put_events_response));
+  ASSERT_THAT(put_events_response.event_ids(), SizeIs(5));
+
+  int64 max_event_id = 0;
+  TF_ASSERT_OK(metadata_store_->GetMaxEventId(&max_event_id));
+  std::vector<int64> event_ids;
+  std::vector<Event> events;
+  TF_ASSERT_OK(metadata_store_->GetEventsByIdRange(
+      /*min_event_id=*/0, max_event_id, &event_ids, &events));
+  ASSERT_THAT(events, SizeIs(5));
+  EXPECT_THAT(event_ids, ElementsAreArray(put_events_response.event_ids()));
+  std::vector<LineageIndex::Edge> edges;
+  for (size_t i = 0; i < events.size(); i++) {
+    edges.push_back(LineageIndex::ToEdge(event_ids[i], events[i]));
+  }
+  LineageIndex lineage_index;
+  lineage_index.Reset(edges, max_event_id);
+  EXPECT_EQ(lineage_index.num_edges(), 5);
+
+  const auto sorted_ids = [](const GetLineageGraphResponse& response) {
+    std::vector<int64> ids;
+    for (const Artifact& artifact : response.artifacts()) {
+      ids.push_back(artifact.id());
+    }
+    // The execution ids are negated to tell them from the artifact ones.
+    for (const Execution& execution : response.executions()) {
+      ids.push_back(-execution.id());
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+  };
+  const auto sorted_events = [](const GetLineageGraphResponse& response) {
+    std::vector<std::string> events;
+    for (const Event& event : response.events()) {
+      events.push_back(event.SerializeAsString());
+    }
+    std::sort(events.begin(), events.end());
+    return events;
+  };
+  std::vector<GetLineageGraphRequest> requests(5);
+  requests[0].add_artifact_ids(a[0]);
+  requests[0].set_direction(GetLineageGraphRequest::DOWNSTREAM);
+  requests[1].add_artifact_ids(a[2]);
+  requests[1].set_direction(GetLineageGraphRequest::UPSTREAM);
+  requests[2].add_artifact_ids(a[1]);
+  requests[2].set_max_num_hops(1);
+  requests[3].add_artifact_ids(a[0]);
+  requests[3].set_max_num_events(2);
+  requests[4].add_execution_ids(e[1]);
+  requests[4].add_artifact_type_names("data");
+  for (const GetLineageGraphRequest& request : requests) {
+    GetLineageGraphResponse want_response;
+    TF_ASSERT_OK(metadata_store_->GetLineageGraph(request, &want_response));
+    GetLineageGraphResponse got_response;
+    TF_ASSERT_OK(metadata_store_->GetLineageGraph(request, lineage_index,
+                                                  &got_response));
+    EXPECT_EQ(sorted_ids(got_response), sorted_ids(want_response))
+        << request.DebugString();
+    EXPECT_EQ(sorted_events(got_response), sorted_events(want_response))
+        << request.DebugString();
+    EXPECT_EQ(got_response.is_truncated(), want_response.is_truncated())
+        << request.DebugString();
+  }
+
+  GetLineageGraphRequest request;
+  request.add_artifact_ids(a[0]);
+  request.set_max_num_hops(-1);
+  GetLineageGraphResponse response;
+  EXPECT_EQ(
+      metadata_store_->GetLineageGraph(request, lineage_index, &response)
+          .code(),
+      tensorflow::error::INVALID_ARGUMENT);
+}
+
 TEST_P(MetadataStoreTestSuite, PutTypesGetTypes) {
   const PutTypesRequest put_request = ParseTextProtoOrDie<PutTypesRequest>(
       R"(
@@ -2236,6 +2691,100 @@ TEST_P(MetadataStoreTestSuite, PutContextGetContextsByTypeAndName) {
   EXPECT_FALSE(get_no_context_by_type_and_name_response.has_context());
 }
 
+TEST_P(MetadataStoreTestSuite, BulkPut) {
+  const PutTypesRequest put_types_request =
+      ParseTextProtoOrDie<PutTypesRequest>(R"(
+        artifact_types: { name: 'artifact_type' }
+        execution_types: { name: 'execution_type' }
+        context_types: { name: 'context_type' }
+      )");
+  PutTypesResponse put_types_response;
+  TF_ASSERT_OK(
+      metadata_store_->PutTypes(put_types_request, &put_types_response));
+
+  // The edges refer to the nodes of their request by index.
+  std::vector<BulkPutRequest> requests = {
+      ParseTextProtoOrDie<BulkPutRequest>(absl::Substitute(
+          R"(
+            artifacts: { type_id: $0 uri: 'uri_0' }
+            artifacts: { type_id: $0 uri: 'uri_1' }
+            executions: { type_id: $1 }
+            contexts: { type_id: $2 name: 'context_0' }
+            events: {
+              event: { type: INPUT }
+              artifact_index: 0
+              execution_index: 0
+            }
+            events: {
+              event: { type: OUTPUT }
+              artifact_index: 1
+              execution_index: 0
+            }
+            associations: { execution_index: 0 context_index: 0 }
+          )",
+          put_types_response.artifact_type_ids(0),
+          put_types_response.execution_type_ids(0),
+          put_types_response.context_type_ids(0))),
+      ParseTextProtoOrDie<BulkPutRequest>(absl::Substitute(
+          R"(
+            artifacts: { type_id: $0 uri: 'uri_2' }
+            contexts: { type_id: $1 name: 'context_1' }
+            attributions: { artifact_index: 0 context_index: 0 }
+          )",
+          put_types_response.artifact_type_ids(0),
+          put_types_response.context_type_ids(0)))};
+  BulkPutResponse::Batch batch;
+  std::vector<Event> events;
+  TF_ASSERT_OK(metadata_store_->BulkPut(requests, &batch, &events));
+  ASSERT_THAT(batch.artifact_ids(), SizeIs(3));
+  ASSERT_THAT(batch.execution_ids(), SizeIs(1));
+  ASSERT_THAT(batch.context_ids(), SizeIs(2));
+  ASSERT_THAT(batch.event_ids(), SizeIs(2));
+  ASSERT_THAT(events, SizeIs(2));
+  EXPECT_EQ(events[1].artifact_id(), batch.artifact_ids(1));
+  EXPECT_EQ(events[1].execution_id(), batch.execution_ids(0));
+  EXPECT_EQ(events[1].type(), Event::OUTPUT);
+
+  GetEventsByExecutionIDsRequest get_events_request;
+  get_events_request.add_execution_ids(batch.execution_ids(0));
+  GetEventsByExecutionIDsResponse get_events_response;
+  TF_ASSERT_OK(metadata_store_->GetEventsByExecutionIDs(get_events_request,
+                                                        &get_events_response));
+  std::vector<int64> event_artifact_ids;
+  for (const Event& event : get_events_response.events()) {
+    event_artifact_ids.push_back(event.artifact_id());
+  }
+  EXPECT_THAT(event_artifact_ids,
+              UnorderedElementsAre(batch.artifact_ids(0),
+                                   batch.artifact_ids(1)));
+
+  GetExecutionsByContextRequest get_executions_request;
+  get_executions_request.set_context_id(batch.context_ids(0));
+  GetExecutionsByContextResponse get_executions_response;
+  TF_ASSERT_OK(metadata_store_->GetExecutionsByContext(
+      get_executions_request, &get_executions_response));
+  ASSERT_THAT(get_executions_response.executions(), SizeIs(1));
+  EXPECT_EQ(get_executions_response.executions(0).id(),
+            batch.execution_ids(0));
+
+  GetArtifactsByContextRequest get_artifacts_request;
+  get_artifacts_request.set_context_id(batch.context_ids(1));
+  GetArtifactsByContextResponse get_artifacts_response;
+  TF_ASSERT_OK(metadata_store_->GetArtifactsByContext(
+      get_artifacts_request, &get_artifacts_response));
+  ASSERT_THAT(get_artifacts_response.artifacts(), SizeIs(1));
+  EXPECT_EQ(get_artifacts_response.artifacts(0).id(), batch.artifact_ids(2));
+
+  // The index of an edge must be in the range of the nodes of its request.
+  const BulkPutRequest invalid_request =
+      ParseTextProtoOrDie<BulkPutRequest>(R"(
+        events: { event: { type: INPUT } artifact_index: 0 }
+      )");
+  EXPECT_TRUE(tensorflow::errors::IsInvalidArgument(
+      metadata_store_->BulkPut({invalid_request}, &batch,
+                               /*events=*/nullptr)));
+}
+
 TEST_P(MetadataStoreTestSuite, PutAndUseAttributionsAndAssociations) {
   const PutTypesRequest put_types_request =
       ParseTextProtoOrDie<PutTypesRequest>(R"(
@@ -15,10 +15,12 @@ limitations under the License.
 // Test suite for a MySqlMetadataSource based MetadataAccessObject.
 
 #include <memory>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/memory/memory.h"
+#include "absl/strings/numbers.h"
 #include "ml_metadata/metadata_store/metadata_access_object_factory.h"
 #include "ml_metadata/metadata_store/metadata_access_object_test.h"
 #include "ml_metadata/metadata_store/metadata_source.h"
@@ -26,6 +28,7 @@ limitations under the License.
 #include "ml_metadata/metadata_store/test_mysql_metadata_source_initializer.h"
 #include "ml_metadata/proto/metadata_source.pb.h"
 #include "ml_metadata/util/metadata_source_query_config.h"
+#include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 
 namespace ml_metadata {
@@ -55,6 +58,7 @@ class MySqlMetadataAccessObjectContainer
   };
 
   MetadataSource* GetMetadataSource() override { return metadata_source_; }
+  MySqlMetadataSource* GetMySqlMetadataSource() { return metadata_source_; }
   MetadataAccessObject* GetMetadataAccessObject() override {
     return metadata_access_object_.get();
   }
@@ -70,6 +74,105 @@ class MySqlMetadataAccessObjectContainer
   std::unique_ptr<MetadataAccessObject> metadata_access_object_;
 };
 
+// Returns the number of INSERT statements run by the session of
+// `metadata_source` in `num_inserts`.
+tensorflow::Status GetNumInsertStatements(MetadataSource* metadata_source,
+                                          int64* num_inserts) {
+  RecordSet record_set;
+  TF_RETURN_IF_ERROR(metadata_source->ExecuteQuery(
+      "SHOW SESSION STATUS LIKE 'Com_insert';", &record_set));
+  if (record_set.records_size() != 1 ||
+      record_set.records(0).values_size() != 2 ||
+      !absl::SimpleAtoi(record_set.records(0).values(1), num_inserts)) {
+    return tensorflow::errors::Internal("Unexpected Com_insert status: ",
+                                        record_set.DebugString());
+  }
+  return tensorflow::Status::OK();
+}
+
+TEST(MySqlMetadataAccessObjectTest, CreateArtifactsWithMultiRowInserts) {
+  MySqlMetadataAccessObjectContainer container;
+  MetadataSource* metadata_source = container.GetMetadataSource();
+  MetadataAccessObject* metadata_access_object =
+      container.GetMetadataAccessObject();
+  TF_ASSERT_OK(metadata_source->Begin());
+  TF_ASSERT_OK(container.Init());
+  ArtifactType type;
+  type.set_name("test_type");
+  (*type.mutable_properties())["property"] = INT;
+  int64 type_id;
+  TF_ASSERT_OK(metadata_access_object->CreateType(type, &type_id));
+
+  std::vector<Artifact> artifacts(10);
+  for (int i = 0; i < artifacts.size(); i++) {
+    artifacts[i].set_type_id(type_id);
+    (*artifacts[i].mutable_properties())["property"].set_int_value(i);
+  }
+  int64 num_inserts_before;
+  TF_ASSERT_OK(GetNumInsertStatements(metadata_source, &num_inserts_before));
+  std::vector<int64> artifact_ids;
+  TF_ASSERT_OK(
+      metadata_access_object->CreateArtifacts(artifacts, &artifact_ids));
+  int64 num_inserts_after;
+  TF_ASSERT_OK(GetNumInsertStatements(metadata_source, &num_inserts_after));
+  // One insert for the artifacts, or one per artifact if their ids cannot be
+  // derived, and one for their properties.
+  const int64 num_artifact_inserts =
+      metadata_source->GetInsertIdIncrement() > 0 ? 1 : artifacts.size();
+  EXPECT_EQ(num_inserts_after - num_inserts_before, num_artifact_inserts + 1);
+
+  // The ids derived from the first one are the ones of the rows.
+  ASSERT_EQ(artifact_ids.size(), artifacts.size());
+  for (int i = 0; i < artifacts.size(); i++) {
+    EXPECT_EQ(artifact_ids[i], artifact_ids[0] + i);
+    Artifact got_artifact;
+    TF_ASSERT_OK(metadata_access_object->FindArtifactById(artifact_ids[i],
+                                                          &got_artifact));
+    EXPECT_EQ(got_artifact.properties().at("property").int_value(), i);
+  }
+  TF_ASSERT_OK(metadata_source->Commit());
+}
+
+TEST(MySqlMetadataAccessObjectTest, CreateArtifactsWithAutoIncrementStep) {
+  MySqlMetadataAccessObjectContainer container;
+  MySqlMetadataSource* metadata_source = container.GetMySqlMetadataSource();
+  MetadataAccessObject* metadata_access_object =
+      container.GetMetadataAccessObject();
+  TF_ASSERT_OK(metadata_source->Begin());
+  TF_ASSERT_OK(container.Init());
+  TF_ASSERT_OK(metadata_source->ExecuteQuery(
+      "SET SESSION auto_increment_increment = 2;", nullptr));
+  TF_ASSERT_OK(metadata_source->ReadInsertIdIncrement());
+  // The increment is used in the lock modes 0 and 1, and ignored in 2.
+  EXPECT_THAT(metadata_source->GetInsertIdIncrement(),
+              ::testing::AnyOf(0, 2));
+  ArtifactType type;
+  type.set_name("test_type");
+  (*type.mutable_properties())["property"] = INT;
+  int64 type_id;
+  TF_ASSERT_OK(metadata_access_object->CreateType(type, &type_id));
+
+  std::vector<Artifact> artifacts(10);
+  for (int i = 0; i < artifacts.size(); i++) {
+    artifacts[i].set_type_id(type_id);
+    (*artifacts[i].mutable_properties())["property"].set_int_value(i);
+  }
+  std::vector<int64> artifact_ids;
+  TF_ASSERT_OK(
+      metadata_access_object->CreateArtifacts(artifacts, &artifact_ids));
+
+  // The ids step by the increment, and each is the one of its artifact.
+  ASSERT_EQ(artifact_ids.size(), artifacts.size());
+  for (int i = 0; i < artifacts.size(); i++) {
+    EXPECT_EQ(artifact_ids[i], artifact_ids[0] + 2 * i);
+    Artifact got_artifact;
+    TF_ASSERT_OK(metadata_access_object->FindArtifactById(artifact_ids[i],
+                                                          &got_artifact));
+    EXPECT_EQ(got_artifact.properties().at("property").int_value(), i);
+  }
+  TF_ASSERT_OK(metadata_source->Commit());
+}
+
 }  // namespace
 
 INSTANTIATE_TEST_CASE_P(
@@ -17,6 +17,7 @@ limitations under the License.
 #include <string>
 #include <utility>
 
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "ml_metadata/metadata_store/constants.h"
@@ -35,6 +36,7 @@ namespace errors = tensorflow::errors;
 using ::tensorflow::Status;
 
 constexpr char kBeginTransaction[] = "START TRANSACTION";
+constexpr char kBeginReadOnlyTransaction[] = "START TRANSACTION READ ONLY";
 constexpr char kCommitTransaction[] = "COMMIT";
 constexpr char kRollbackTransaction[] = "ROLLBACK";
 
@@ -146,6 +148,9 @@ Status MySqlMetadataSource::ConnectImpl() {
       CheckTransactionSupport(),
       "checking transaction support of default storage engine");
 
+  TF_RETURN_WITH_CONTEXT_IF_ERROR(ReadInsertIdIncrement(),
+                                  "reading the auto increment settings");
+
   // Create the database if not already present and switch to it.
   const std::string create_database_cmd =
       absl::StrCat("CREATE DATABASE IF NOT EXISTS ", config_.database());
@@ -188,6 +193,18 @@ Status MySqlMetadataSource::ExecuteQueryImpl(const std::string& query,
   return Status::OK();
 }
 
+Status MySqlMetadataSource::ExecuteInsertQueryImpl(const std::string& query,
+                                                   int64* insert_id) {
+  TF_RETURN_WITH_CONTEXT_IF_ERROR(
+      ThreadInitAccess(), "MySql thread init failed at ExecuteInsertQueryImpl");
+  TF_RETURN_IF_ERROR(RunQuery(query));
+  // For a multi-row insert, mysql_insert_id returns the id of the first row,
+  // i.e., LAST_INSERT_ID(). The ids of the other rows are given by
+  // GetInsertIdIncrement.
+  *insert_id = mysql_insert_id(db_);
+  return Status::OK();
+}
+
 Status MySqlMetadataSource::CommitImpl() {
   TF_RETURN_WITH_CONTEXT_IF_ERROR(ThreadInitAccess(),
                                   "MySql thread init failed at CommitImpl");
@@ -206,6 +223,12 @@ Status MySqlMetadataSource::BeginImpl() {
   return RunQuery(kBeginTransaction);
 }
 
+Status MySqlMetadataSource::BeginReadOnlyImpl() {
+  TF_RETURN_WITH_CONTEXT_IF_ERROR(
+      ThreadInitAccess(), "MySql thread init failed at BeginReadOnlyImpl");
+  return RunQuery(kBeginReadOnlyTransaction);
+}
+
 Status MySqlMetadataSource::CheckTransactionSupport() {
   constexpr char kCheckTransactionSupport[] =
       "SELECT ENGINE, TRANSACTIONS FROM INFORMATION_SCHEMA.ENGINES WHERE "
@@ -231,6 +254,34 @@ Status MySqlMetadataSource::CheckTransactionSupport() {
   return Status::OK();
 }
 
+Status MySqlMetadataSource::ReadInsertIdIncrement() {
+  constexpr char kSelectAutoIncrementSettings[] =
+      "SELECT @@innodb_autoinc_lock_mode, @@auto_increment_increment";
+  TF_RETURN_WITH_CONTEXT_IF_ERROR(
+      ThreadInitAccess(), "MySql thread init failed at ReadInsertIdIncrement");
+  TF_RETURN_IF_ERROR(RunQuery(kSelectAutoIncrementSettings));
+
+  RecordSet record_set;
+  TF_RETURN_IF_ERROR(ConvertMySqlRowSetToRecordSet(&record_set));
+  int64 lock_mode;
+  int64 increment;
+  if (record_set.records_size() != 1 ||
+      record_set.records(0).values_size() != 2 ||
+      !absl::SimpleAtoi(record_set.records(0).values(0), &lock_mode) ||
+      !absl::SimpleAtoi(record_set.records(0).values(1), &increment)) {
+    return errors::Internal(
+        "Expected query ", kSelectAutoIncrementSettings,
+        " to generate exactly single row with 2 integer columns, but got ",
+        record_set.DebugString());
+  }
+  // In the traditional (0) and consecutive (1) lock modes, InnoDB reserves the
+  // ids of a simple multi-row insert at once, so they are the first id plus
+  // multiples of auto_increment_increment. In the interleaved mode (2), other
+  // inserts may take ids in between.
+  insert_id_increment_ = lock_mode == 0 || lock_mode == 1 ? increment : 0;
+  return Status::OK();
+}
+
 Status MySqlMetadataSource::RunQuery(const std::string& query) {
   DiscardResultSet();
 
@@ -240,7 +291,8 @@ Status MySqlMetadataSource::RunQuery(const std::string& query) {
     // 2006: sever closes the connection due to inactive client;
     // client reports server has gone away, we reconnect the server for the
     // client if the query is begin transaction.
-    if (error_number == 2006 && query == kBeginTransaction) {
+    if (error_number == 2006 && (query == kBeginTransaction ||
+                                 query == kBeginReadOnlyTransaction)) {
       TF_RETURN_IF_ERROR(CloseImpl());
       TF_RETURN_IF_ERROR(ConnectImpl());
       return RunQuery(query);
@@ -291,6 +343,8 @@ Status MySqlMetadataSource::ConvertMySqlRowSetToRecordSet(
   while ((row = mysql_fetch_row(result_set_)) != nullptr) {
     RecordSet::Record record;
     std::vector<std::string> col_names;
+    // The lengths of the values, which may be binary strings.
+    const unsigned long* lengths = mysql_fetch_lengths(result_set_);
 
     uint32 num_cols = mysql_num_fields(result_set_);
     for (uint32 col = 0; col < num_cols; ++col) {
@@ -307,7 +361,7 @@ Status MySqlMetadataSource::ConvertMySqlRowSetToRecordSet(
       if (row[col] == nullptr && !(field->flags & NOT_NULL_FLAG)) {
         record.add_values(kMetadataSourceNull);
       } else {
-        record.add_values(absl::StrCat(row[col]));
+        record.add_values(row[col], lengths[col]);
       }
     }
     *record_set.mutable_records()->Add() = record;
@@ -336,4 +390,9 @@ std::string MySqlMetadataSource::EscapeString(absl::string_view value) const {
   return result;
 }
 
+std::string MySqlMetadataSource::GetDatabaseIdentifier() const {
+  return absl::StrCat("mysql:", config_.host(), ":", config_.port(), ":",
+                      config_.socket(), "/", config_.database());
+}
+
 }  // namespace ml_metadata
@@ -44,6 +44,20 @@ class MySqlMetadataSource : public MetadataSource {
   // the metadata source is not connected.
   std::string EscapeString(absl::string_view value) const final;
 
+  // Returns the server address and the database name in the config.
+  std::string GetDatabaseIdentifier() const final;
+
+  // Returns the session's auto_increment_increment if InnoDB reserves the ids
+  // of a simple multi-row insert together, i.e., if innodb_autoinc_lock_mode
+  // is 0 or 1, and 0 in the interleaved mode 2, whose ids may have gaps.
+  int64 GetInsertIdIncrement() const final { return insert_id_increment_; }
+
+  // Reads innodb_autoinc_lock_mode and auto_increment_increment for
+  // GetInsertIdIncrement. It is run when connecting, and must be run again if
+  // the session changes auto_increment_increment.
+  // Returns an INTERNAL error upon any errors from the MYSQL backend.
+  tensorflow::Status ReadInsertIdIncrement();
+
  private:
   // Connects to the MYSQL backend specified in options_.
   // Returns an INTERNAL error upon any errors from the MYSQL backend.
@@ -56,11 +70,21 @@ class MySqlMetadataSource : public MetadataSource {
   // Opens a transaction.
   tensorflow::Status BeginImpl() final;
 
+  // Opens a transaction with START TRANSACTION READ ONLY, in which InnoDB
+  // skips assigning a transaction id and reads without locks.
+  tensorflow::Status BeginReadOnlyImpl() final;
+
   // Executes a SQL statement and returns the rows if any.
   // Returns an INTERNAL error upon any errors from the MYSQL backend.
   tensorflow::Status ExecuteQueryImpl(const std::string& query,
                                       RecordSet* results) final;
 
+  // Executes an INSERT statement and returns the AUTO_INCREMENT id of its
+  // first row.
+  // Returns an INTERNAL error upon any errors from the MYSQL backend.
+  tensorflow::Status ExecuteInsertQueryImpl(const std::string& query,
+                                            int64* insert_id) final;
+
   // Commits the currently open transaction.
   tensorflow::Status CommitImpl() final;
 
@@ -90,6 +114,10 @@ class MySqlMetadataSource : public MetadataSource {
   // The ResultSet from the previously executed query in RunQuery.
   MYSQL_RES* result_set_ = nullptr;
 
+  // The step between the ids of the rows of an insert, read by
+  // ReadInsertIdIncrement. 0 until it is read.
+  int64 insert_id_increment_ = 0;
+
   // Config to connect to the MYSQL backend.
   const MySQLDatabaseConfig config_;
 };
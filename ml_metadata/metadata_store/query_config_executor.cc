@@ -19,12 +19,17 @@ limitations under the License.
 
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/util/json_util.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_replace.h"
+#include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "ml_metadata/metadata_store/list_operation_query_helper.h"
@@ -34,22 +39,49 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 namespace ml_metadata {
+namespace {
+
+// The databases whose schema has been fully verified by
+// InitMetadataSourceIfNotExists in this process. The keys are composed by
+// GetVerifiedSchemaKey.
+absl::Mutex verified_schemas_mu(absl::kConstInit);
+absl::flat_hash_set<std::string>* verified_schemas
+    ABSL_GUARDED_BY(verified_schemas_mu) = nullptr;
+
+bool IsSchemaVerified(const std::string& key) {
+  absl::MutexLock lock(&verified_schemas_mu);
+  return verified_schemas != nullptr && verified_schemas->contains(key);
+}
+
+void SetSchemaVerified(const std::string& key, bool verified) {
+  absl::MutexLock lock(&verified_schemas_mu);
+  if (verified_schemas == nullptr) {
+    verified_schemas = new absl::flat_hash_set<std::string>();
+  }
+  if (verified) {
+    verified_schemas->insert(key);
+  } else {
+    verified_schemas->erase(key);
+  }
+}
+
+}  // namespace
 
 tensorflow::Status QueryConfigExecutor::InsertEventPath(
     int64 event_id, const Event::Path::Step& step) {
   // Inserts a path into the EventPath table. It has 4 parameters
   // $0 is the event_id
-  // $1 is the step value case, either index or key
-  // $2 is the is_index_step indicates the step value case
-  // $3 is the value of the step
+  // $1 is the is_index_step indicates the step value case
+  // $2 is the step_index, or NULL for a key step
+  // $3 is the step_key, or NULL for an index step
   if (step.has_index()) {
-    return ExecuteQuery(
-        query_config_.insert_event_path(),
-        {Bind(event_id), "step_index", Bind(true), Bind(step.index())});
+    return ExecuteQuery(query_config_.insert_event_path(),
+                        {Bind(event_id), Bind(true), Bind(step.index()),
+                         QueryParameter()});
   } else if (step.has_key()) {
-    return ExecuteQuery(
-        query_config_.insert_event_path(),
-        {Bind(event_id), "step_key", Bind(false), Bind(step.key())});
+    return ExecuteQuery(query_config_.insert_event_path(),
+                        {Bind(event_id), Bind(false), QueryParameter(),
+                         Bind(step.key())});
   }
   return tensorflow::Status::OK();
 }
@@ -134,6 +166,14 @@ tensorflow::Status QueryConfigExecutor::UpgradeMetadataSourceIfOutOfDate(
           ExecuteQuery(upgrade_query.query()),
           absl::StrCat("Upgrade query failed: ", upgrade_query.query()));
     }
+    for (const int data_migration :
+         migration_schemes.at(to_version).upgrade_data_migrations()) {
+      TF_RETURN_WITH_CONTEXT_IF_ERROR(
+          RunDataMigration(
+              static_cast<MetadataSourceQueryConfig::MigrationScheme::
+                              DataMigration>(data_migration)),
+          "Upgrade data migration failed.");
+    }
     TF_RETURN_WITH_CONTEXT_IF_ERROR(
         UpdateSchemaVersion(to_version), "Failed to update schema.");
     db_version = to_version;
@@ -141,27 +181,6 @@ tensorflow::Status QueryConfigExecutor::UpgradeMetadataSourceIfOutOfDate(
   return tensorflow::Status::OK();
 }
 
-tensorflow::Status QueryConfigExecutor::SelectLastInsertID(
-    int64* last_insert_id) {
-  RecordSet record_set;
-  TF_RETURN_IF_ERROR(
-      ExecuteQuery(query_config_.select_last_insert_id(), {}, &record_set));
-  if (record_set.records_size() == 0) {
-    return tensorflow::errors::Internal(
-        "Could not find last insert ID: no record");
-  }
-  const RecordSet::Record& record = record_set.records(0);
-  if (record.values_size() == 0) {
-    return tensorflow::errors::Internal(
-        "Could not find last insert ID: missing value");
-  }
-  if (!absl::SimpleAtoi(record.values(0), last_insert_id)) {
-    return tensorflow::errors::Internal(
-        "Could not parse last insert ID as string");
-  }
-  return tensorflow::Status::OK();
-}
-
 tensorflow::Status ml_metadata::QueryConfigExecutor::CheckTablesIn_V0_13_2() {
   return ExecuteQuery(query_config_.check_tables_in_v0_13_2());
 }
@@ -199,6 +218,15 @@ tensorflow::Status QueryConfigExecutor::DowngradeMetadataSource(
       return tensorflow::errors::Internal(
           "Cannot find migration_schemes to version ", to_version);
     }
+    for (const int data_migration :
+         migration_schemes.at(to_version).downgrade_data_migrations()) {
+      TF_RETURN_WITH_CONTEXT_IF_ERROR(
+          RunDataMigration(
+              static_cast<MetadataSourceQueryConfig::MigrationScheme::
+                              DataMigration>(data_migration)),
+          "Failed to migrate existing db; the "
+          "migration transaction rolls back.");
+    }
     for (const MetadataSourceQueryConfig::TemplateQuery& downgrade_query :
          migration_schemes.at(to_version).downgrade_queries()) {
       TF_RETURN_WITH_CONTEXT_IF_ERROR(
@@ -217,55 +245,137 @@ tensorflow::Status QueryConfigExecutor::DowngradeMetadataSource(
   return tensorflow::Status::OK();
 }
 
-std::string QueryConfigExecutor::Bind(const char* value) {
-  return absl::StrCat("'", metadata_source_->EscapeString(value), "'");
+tensorflow::Status QueryConfigExecutor::RunDataMigration(
+    MetadataSourceQueryConfig::MigrationScheme::DataMigration data_migration) {
+  switch (data_migration) {
+    case MetadataSourceQueryConfig::MigrationScheme::
+        EXECUTION_TYPE_SIGNATURES_TO_BINARY:
+    case MetadataSourceQueryConfig::MigrationScheme::
+        EXECUTION_TYPE_SIGNATURES_TO_TEXT: {
+      const bool to_binary = data_migration ==
+                             MetadataSourceQueryConfig::MigrationScheme::
+                                 EXECUTION_TYPE_SIGNATURES_TO_BINARY;
+      RecordSet record_set;
+      TF_RETURN_IF_ERROR(ExecuteQuery(
+          query_config_.select_execution_type_signatures(), {}, &record_set));
+      for (const RecordSet::Record& record : record_set.records()) {
+        int64 type_id;
+        if (record.values_size() != 3 ||
+            !absl::SimpleAtoi(record.values(0), &type_id)) {
+          return tensorflow::errors::DataLoss(
+              "Malformed execution type signatures: ", record.DebugString());
+        }
+        std::vector<QueryParameter> parameters;
+        // Converts the input_type and the output_type columns.
+        for (int i = 1; i <= 2; i++) {
+          const std::string& value = record.values(i);
+          ArtifactStructType signature;
+          // Empty JSON values are read as unset signatures.
+          if (value == kMetadataSourceNull || (to_binary && value.empty())) {
+            parameters.push_back(QueryParameter());
+          } else if (to_binary) {
+            if (!google::protobuf::util::JsonStringToMessage(value, &signature)
+                     .ok()) {
+              return tensorflow::errors::Internal(
+                  "Failed to parse the JSON of execution type ", type_id,
+                  ": ", value);
+            }
+            parameters.push_back(Bind(/*exists=*/true, signature));
+          } else {
+            std::string json;
+            if (!signature.ParseFromString(value) ||
+                !google::protobuf::util::MessageToJsonString(signature, &json)
+                     .ok()) {
+              return tensorflow::errors::Internal(
+                  "Failed to convert the signature of execution type ",
+                  type_id, " to JSON.");
+            }
+            parameters.push_back(std::move(json));
+          }
+        }
+        parameters.push_back(Bind(type_id));
+        TF_RETURN_IF_ERROR(ExecuteQuery(
+            query_config_.update_execution_type_signatures(), parameters));
+      }
+      return tensorflow::Status::OK();
+    }
+    default:
+      return tensorflow::errors::Internal("Unknown data migration: ",
+                                          data_migration);
+  }
 }
 
-std::string QueryConfigExecutor::Bind(absl::string_view value) {
-  return absl::StrCat("'", metadata_source_->EscapeString(value), "'");
+QueryParameter QueryConfigExecutor::Bind(const char* value) {
+  return std::string(value);
 }
 
-std::string QueryConfigExecutor::Bind(int value) {
-  return std::to_string(value);
+QueryParameter QueryConfigExecutor::Bind(absl::string_view value) {
+  return std::string(value);
 }
 
-std::string QueryConfigExecutor::Bind(int64 value) {
-  return std::to_string(value);
-}
+QueryParameter QueryConfigExecutor::Bind(int value) { return int64{value}; }
 
-std::string QueryConfigExecutor::Bind(double value) {
-  return std::to_string(value);
-}
+QueryParameter QueryConfigExecutor::Bind(int64 value) { return value; }
+
+QueryParameter QueryConfigExecutor::Bind(double value) { return value; }
 
-std::string QueryConfigExecutor::Bind(bool value) { return value ? "1" : "0"; }
+QueryParameter QueryConfigExecutor::Bind(bool value) {
+  return int64{value ? 1 : 0};
+}
 
-// Utility method to bind an Event::Type enum value to a SQL clause.
-// Event::Type is an enum (integer), EscapeString is not applicable.
-std::string QueryConfigExecutor::Bind(const Event::Type value) {
-  return std::to_string(value);
+// Utility method to bind an Event::Type enum value to a query parameter.
+QueryParameter QueryConfigExecutor::Bind(const Event::Type value) {
+  return static_cast<int64>(value);
 }
 
-std::string QueryConfigExecutor::Bind(PropertyType value) {
-  return std::to_string((int)value);
+QueryParameter QueryConfigExecutor::Bind(PropertyType value) {
+  return static_cast<int64>(value);
 }
 
-std::string QueryConfigExecutor::Bind(TypeKind value) {
-  return std::to_string((int)value);
+QueryParameter QueryConfigExecutor::Bind(TypeKind value) {
+  return static_cast<int64>(value);
 }
 
-std::string QueryConfigExecutor::Bind(Artifact::State value) {
-  return std::to_string((int)value);
+QueryParameter QueryConfigExecutor::Bind(Artifact::State value) {
+  return static_cast<int64>(value);
 }
 
-std::string QueryConfigExecutor::Bind(Execution::State value) {
-  return std::to_string((int)value);
+QueryParameter QueryConfigExecutor::Bind(Execution::State value) {
+  return static_cast<int64>(value);
 }
 
 std::string QueryConfigExecutor::Bind(const std::vector<int64>& value) {
   return absl::StrJoin(value, ", ");
 }
 
-std::string QueryConfigExecutor::BindValue(const Value& value) {
+std::string QueryConfigExecutor::BindRow(
+    const std::vector<QueryParameter>& values) {
+  std::string row = "(";
+  for (const QueryParameter& value : values) {
+    if (row.size() > 1) row.append(", ");
+    row.append(metadata_source_->BindParameter(value));
+  }
+  row.append(")");
+  return row;
+}
+
+template <typename Node>
+void QueryConfigExecutor::BindPropertyRows(const int64 node_id,
+                                           const Node& node,
+                                           std::vector<std::string>* rows) {
+  auto bind_properties =
+      [&](const google::protobuf::Map<std::string, Value>& properties,
+          const bool is_custom_property) {
+        for (const auto& p : properties) {
+          rows->push_back(BindRow(
+              BindPropertyRow(node_id, p.first, is_custom_property, p.second)));
+        }
+      };
+  bind_properties(node.properties(), /*is_custom_property=*/false);
+  bind_properties(node.custom_properties(), /*is_custom_property=*/true);
+}
+
+QueryParameter QueryConfigExecutor::BindValue(const Value& value) {
   switch (value.value_case()) {
     case PropertyType::INT:
       return Bind(value.int_value());
@@ -281,42 +391,53 @@ std::string QueryConfigExecutor::BindValue(const Value& value) {
   }
 }
 
-std::string QueryConfigExecutor::BindDataType(const Value& value) {
+std::vector<QueryParameter> QueryConfigExecutor::BindValueColumns(
+    const Value& value) {
+  // Only the value column of the property data type is set.
+  std::vector<QueryParameter> columns(3);
   switch (value.value_case()) {
-    case PropertyType::INT: {
-      return "int_value";
+    case Value::kIntValue:
+      columns[0] = Bind(value.int_value());
       break;
-    }
-    case PropertyType::DOUBLE: {
-      return "double_value";
+    case Value::kDoubleValue:
+      columns[1] = Bind(value.double_value());
       break;
-    }
-    case PropertyType::STRING: {
-      return "string_value";
+    case Value::kStringValue:
+      columns[2] = Bind(value.string_value());
       break;
-    }
-    default: {
+    default:
       LOG(FATAL) << "Unexpected oneof: " << value.DebugString();
-    }
   }
+  return columns;
 }
 
-std::string QueryConfigExecutor::Bind(bool exists,
-                                      const google::protobuf::Message& message) {
+std::vector<QueryParameter> QueryConfigExecutor::BindPropertyRow(
+    const int64 node_id, const absl::string_view name,
+    const bool is_custom_property, const Value& value) {
+  std::vector<QueryParameter> row = {Bind(node_id), Bind(name),
+                                     Bind(is_custom_property)};
+  for (QueryParameter& column : BindValueColumns(value)) {
+    row.push_back(std::move(column));
+  }
+  return row;
+}
+
+QueryParameter QueryConfigExecutor::Bind(
+    bool exists, const google::protobuf::Message& message) {
   if (exists) {
-    std::string json_output;
-    CHECK(::google::protobuf::util::MessageToJsonString(message, &json_output).ok())
-        << "Could not write proto to JSON: " << message.DebugString();
-    return Bind(json_output);
+    BlobParameter serialized_message;
+    CHECK(message.SerializeToString(&serialized_message.value))
+        << "Could not serialize proto: " << message.DebugString();
+    return serialized_message;
   } else {
-    return "null";
+    return QueryParameter();
   }
 }
 
 #if (!defined(__APPLE__) && !defined(_WIN32))
-string QueryConfigExecutor::Bind(
+QueryParameter QueryConfigExecutor::Bind(
     const google::protobuf::int64 value) {
-  return std::to_string(value);
+  return static_cast<int64>(value);
 }
 #endif
 
@@ -330,9 +451,9 @@ tensorflow::Status QueryConfigExecutor::ExecuteQuery(const std::string& query,
   return metadata_source_->ExecuteQuery(query, record_set);
 }
 
-tensorflow::Status QueryConfigExecutor::ExecuteQuery(
+tensorflow::Status QueryConfigExecutor::ComposeQuery(
     const MetadataSourceQueryConfig::TemplateQuery& template_query,
-    const std::vector<std::string>& parameters, RecordSet* record_set) {
+    const std::vector<std::string>& parameters, std::string* query) {
   if (parameters.size() > 10) {
     return tensorflow::errors::InvalidArgument(
         "Template query has too many parameters (at most 10 is supported).");
@@ -347,8 +468,282 @@ tensorflow::Status QueryConfigExecutor::ExecuteQuery(
   for (int i = 0; i < parameters.size(); i++) {
     replacements.push_back({absl::StrCat("$", i), parameters[i]});
   }
+  *query = absl::StrReplaceAll(template_query.query(), replacements);
+  return tensorflow::Status::OK();
+}
+
+tensorflow::Status QueryConfigExecutor::GetParameterizedQuery(
+    const MetadataSourceQueryConfig::TemplateQuery& template_query,
+    const std::vector<QueryParameter>& parameters,
+    const ParameterizedQuery** parameterized_query) {
+  if (parameters.size() > 10) {
+    return tensorflow::errors::InvalidArgument(
+        "Template query has too many parameters (at most 10 is supported).");
+  }
+  if (template_query.parameter_num() != parameters.size()) {
+    LOG(FATAL) << "Template query parameter_num does not match with given "
+               << "parameters size (" << parameters.size()
+               << "): " << template_query.DebugString();
+  }
+  auto iter = parameterized_queries_.find(&template_query);
+  if (iter != parameterized_queries_.end()) {
+    *parameterized_query = &iter->second;
+    return tensorflow::Status::OK();
+  }
+  ParameterizedQuery& result = parameterized_queries_[&template_query];
+  const std::string& query = template_query.query();
+  for (int i = 0; i < query.size(); i++) {
+    if (query[i] == '$' && i + 1 < query.size() &&
+        absl::ascii_isdigit(query[i + 1])) {
+      const int parameter_index = query[++i] - '0';
+      result.in_order =
+          result.in_order &&
+          parameter_index == static_cast<int>(result.parameter_indices.size());
+      result.parameter_indices.push_back(parameter_index);
+      result.query.push_back('?');
+    } else {
+      result.query.push_back(query[i]);
+    }
+  }
+  result.in_order =
+      result.in_order && result.parameter_indices.size() == parameters.size();
+  *parameterized_query = &result;
+  return tensorflow::Status::OK();
+}
+
+tensorflow::Status QueryConfigExecutor::ExecuteQuery(
+    const MetadataSourceQueryConfig::TemplateQuery& template_query,
+    const std::vector<QueryParameter>& parameters, RecordSet* record_set) {
+  const ParameterizedQuery* query;
+  TF_RETURN_IF_ERROR(GetParameterizedQuery(template_query, parameters, &query));
+  if (query->in_order) {
+    return metadata_source_->ExecuteQuery(query->query, parameters,
+                                          record_set);
+  }
   return metadata_source_->ExecuteQuery(
-      absl::StrReplaceAll(template_query.query(), replacements), record_set);
+      query->query, query->ArrangeParameters(parameters), record_set);
+}
+
+tensorflow::Status QueryConfigExecutor::ExecuteInsertQuery(
+    const MetadataSourceQueryConfig::TemplateQuery& template_query,
+    const std::vector<QueryParameter>& parameters, int64* insert_id) {
+  const ParameterizedQuery* query;
+  TF_RETURN_IF_ERROR(GetParameterizedQuery(template_query, parameters, &query));
+  if (query->in_order) {
+    return metadata_source_->ExecuteInsertQuery(query->query, parameters,
+                                                insert_id);
+  }
+  return metadata_source_->ExecuteInsertQuery(
+      query->query, query->ArrangeParameters(parameters), insert_id);
+}
+
+tensorflow::Status QueryConfigExecutor::ComposeQueriesByIDs(
+    const MetadataSourceQueryConfig::TemplateQuery& template_query,
+    const std::vector<int64>& ids,
+    const std::vector<QueryParameter>& parameters,
+    const std::function<tensorflow::Status(const std::string&)>&
+        execute_query) {
+  // An empty IN () clause is not valid SQL, and matches nothing anyway.
+  if (ids.empty()) return tensorflow::Status::OK();
+  const int max_num_ids = query_config_.max_num_ids_per_query() > 0
+                              ? query_config_.max_num_ids_per_query()
+                              : ids.size();
+  std::vector<std::string> chunk_parameters = {""};
+  for (const QueryParameter& parameter : parameters) {
+    chunk_parameters.push_back(metadata_source_->BindParameter(parameter));
+  }
+  for (auto begin = ids.begin(); begin != ids.end();) {
+    const auto end =
+        ids.end() - begin > max_num_ids ? begin + max_num_ids : ids.end();
+    chunk_parameters[0] = Bind(std::vector<int64>(begin, end));
+    std::string query;
+    TF_RETURN_IF_ERROR(ComposeQuery(template_query, chunk_parameters, &query));
+    TF_RETURN_IF_ERROR(execute_query(query));
+    begin = end;
+  }
+  return tensorflow::Status::OK();
+}
+
+tensorflow::Status QueryConfigExecutor::ExecuteQueryByIDs(
+    const MetadataSourceQueryConfig::TemplateQuery& template_query,
+    const std::vector<int64>& ids,
+    const std::vector<QueryParameter>& parameters, RecordSet* record_set) {
+  record_set->Clear();
+  bool is_first_chunk = true;
+  return ComposeQueriesByIDs(
+      template_query, ids, parameters,
+      [this, record_set, &is_first_chunk](const std::string& query) {
+        if (is_first_chunk) {
+          is_first_chunk = false;
+          return metadata_source_->ExecuteQuery(query, record_set);
+        }
+        RecordSet chunk_record_set;
+        TF_RETURN_IF_ERROR(
+            metadata_source_->ExecuteQuery(query, &chunk_record_set));
+        for (RecordSet::Record& record : *chunk_record_set.mutable_records()) {
+          record_set->add_records()->Swap(&record);
+        }
+        return tensorflow::Status::OK();
+      });
+}
+
+tensorflow::Status QueryConfigExecutor::ExecuteQueryByIDs(
+    const MetadataSourceQueryConfig::TemplateQuery& template_query,
+    const std::vector<int64>& ids, TypedRecordSet* record_set) {
+  record_set->Clear();
+  return ComposeQueriesByIDs(
+      template_query, ids, /*parameters=*/{},
+      [this, record_set](const std::string& query) {
+        return metadata_source_->ExecuteTypedQuery(query, record_set);
+      });
+}
+
+tensorflow::Status QueryConfigExecutor::ExecuteMultiRowInsert(
+    const MetadataSourceQueryConfig::TemplateQuery& template_query,
+    const std::vector<std::string>& rows, std::vector<int64>* row_ids) {
+  if (row_ids != nullptr) row_ids->clear();
+  const int64 insert_id_increment = metadata_source_->GetInsertIdIncrement();
+  // If the ids of the rows cannot be derived from the first one, the rows
+  // whose ids are returned are inserted one per query.
+  const int max_num_rows =
+      query_config_.max_num_rows_per_insert() > 0 &&
+              (row_ids == nullptr || insert_id_increment > 0)
+          ? query_config_.max_num_rows_per_insert()
+          : 1;
+  for (auto begin = rows.begin(); begin != rows.end();) {
+    const auto end =
+        rows.end() - begin > max_num_rows ? begin + max_num_rows : rows.end();
+    int64 first_insert_id;
+    std::string query;
+    TF_RETURN_IF_ERROR(ComposeQuery(
+        template_query, {absl::StrJoin(begin, end, ", ")}, &query));
+    TF_RETURN_IF_ERROR(
+        metadata_source_->ExecuteInsertQuery(query, &first_insert_id));
+    if (row_ids != nullptr) {
+      for (int64 i = 0; i < end - begin; i++) {
+        row_ids->push_back(first_insert_id + i * insert_id_increment);
+      }
+    }
+    begin = end;
+  }
+  return tensorflow::Status::OK();
+}
+
+tensorflow::Status QueryConfigExecutor::InsertArtifacts(
+    const std::vector<Artifact>& artifacts, const absl::Time create_time,
+    std::vector<int64>* artifact_ids) {
+  const int64 create_time_millis = absl::ToUnixMillis(create_time);
+  std::vector<std::string> rows;
+  rows.reserve(artifacts.size());
+  for (const Artifact& artifact : artifacts) {
+    rows.push_back(BindRow(
+        {Bind(artifact.type_id()), Bind(artifact.uri()),
+         artifact.has_state() ? Bind(artifact.state()) : QueryParameter(),
+         artifact.has_name() ? Bind(artifact.name()) : QueryParameter(),
+         Bind(create_time_millis), Bind(create_time_millis)}));
+  }
+  return ExecuteMultiRowInsert(query_config_.insert_artifacts(), rows,
+                               artifact_ids);
+}
+
+tensorflow::Status QueryConfigExecutor::InsertArtifactProperties(
+    const std::vector<int64>& artifact_ids,
+    const std::vector<Artifact>& artifacts) {
+  std::vector<std::string> rows;
+  for (int i = 0; i < artifacts.size(); i++) {
+    BindPropertyRows(artifact_ids[i], artifacts[i], &rows);
+  }
+  return ExecuteMultiRowInsert(query_config_.insert_artifact_properties(),
+                               rows, /*row_ids=*/nullptr);
+}
+
+tensorflow::Status QueryConfigExecutor::InsertExecutions(
+    const std::vector<Execution>& executions, const absl::Time create_time,
+    std::vector<int64>* execution_ids) {
+  const int64 create_time_millis = absl::ToUnixMillis(create_time);
+  std::vector<std::string> rows;
+  rows.reserve(executions.size());
+  for (const Execution& execution : executions) {
+    rows.push_back(BindRow(
+        {Bind(execution.type_id()),
+         execution.has_last_known_state() ? Bind(execution.last_known_state())
+                                          : QueryParameter(),
+         execution.has_name() ? Bind(execution.name()) : QueryParameter(),
+         Bind(create_time_millis), Bind(create_time_millis)}));
+  }
+  return ExecuteMultiRowInsert(query_config_.insert_executions(), rows,
+                               execution_ids);
+}
+
+tensorflow::Status QueryConfigExecutor::InsertExecutionProperties(
+    const std::vector<int64>& execution_ids,
+    const std::vector<Execution>& executions) {
+  std::vector<std::string> rows;
+  for (int i = 0; i < executions.size(); i++) {
+    BindPropertyRows(execution_ids[i], executions[i], &rows);
+  }
+  return ExecuteMultiRowInsert(query_config_.insert_execution_properties(),
+                               rows, /*row_ids=*/nullptr);
+}
+
+tensorflow::Status QueryConfigExecutor::InsertContexts(
+    const std::vector<Context>& contexts, const absl::Time create_time,
+    std::vector<int64>* context_ids) {
+  const int64 create_time_millis = absl::ToUnixMillis(create_time);
+  std::vector<std::string> rows;
+  rows.reserve(contexts.size());
+  for (const Context& context : contexts) {
+    rows.push_back(BindRow({Bind(context.type_id()), Bind(context.name()),
+                            Bind(create_time_millis),
+                            Bind(create_time_millis)}));
+  }
+  return ExecuteMultiRowInsert(query_config_.insert_contexts(), rows,
+                               context_ids);
+}
+
+tensorflow::Status QueryConfigExecutor::InsertContextProperties(
+    const std::vector<int64>& context_ids,
+    const std::vector<Context>& contexts) {
+  std::vector<std::string> rows;
+  for (int i = 0; i < contexts.size(); i++) {
+    BindPropertyRows(context_ids[i], contexts[i], &rows);
+  }
+  return ExecuteMultiRowInsert(query_config_.insert_context_properties(),
+                               rows, /*row_ids=*/nullptr);
+}
+
+tensorflow::Status QueryConfigExecutor::InsertEvents(
+    const std::vector<Event>& events, const absl::Time event_time,
+    std::vector<int64>* event_ids) {
+  const int64 event_time_millis = absl::ToUnixMillis(event_time);
+  std::vector<std::string> rows;
+  rows.reserve(events.size());
+  for (const Event& event : events) {
+    rows.push_back(BindRow({Bind(event.artifact_id()),
+                            Bind(event.execution_id()), Bind(event.type()),
+                            Bind(event.has_milliseconds_since_epoch()
+                                     ? event.milliseconds_since_epoch()
+                                     : event_time_millis)}));
+  }
+  return ExecuteMultiRowInsert(query_config_.insert_events(), rows, event_ids);
+}
+
+tensorflow::Status QueryConfigExecutor::InsertEventPaths(
+    const std::vector<int64>& event_ids, const std::vector<Event>& events) {
+  std::vector<std::string> rows;
+  for (int i = 0; i < events.size(); i++) {
+    for (const Event::Path::Step& step : events[i].path().steps()) {
+      if (step.has_index()) {
+        rows.push_back(BindRow({Bind(event_ids[i]), Bind(true),
+                                Bind(step.index()), QueryParameter()}));
+      } else if (step.has_key()) {
+        rows.push_back(BindRow({Bind(event_ids[i]), Bind(false),
+                                QueryParameter(), Bind(step.key())}));
+      }
+    }
+  }
+  return ExecuteMultiRowInsert(query_config_.insert_event_paths(), rows,
+                               /*row_ids=*/nullptr);
 }
 
 tensorflow::Status QueryConfigExecutor::IsCompatible(int64 db_version,
@@ -377,6 +772,10 @@ tensorflow::Status QueryConfigExecutor::InitMetadataSource() {
       ExecuteQuery(query_config_.create_context_property_table()));
   TF_RETURN_IF_ERROR(ExecuteQuery(query_config_.create_association_table()));
   TF_RETURN_IF_ERROR(ExecuteQuery(query_config_.create_attribution_table()));
+  for (const MetadataSourceQueryConfig::TemplateQuery& secondary_index :
+       query_config_.secondary_indices()) {
+    TF_RETURN_IF_ERROR(ExecuteQuery(secondary_index));
+  }
 
   int64 library_version = GetLibraryVersion();
   tensorflow::Status insert_schema_version_status =
@@ -396,8 +795,34 @@ tensorflow::Status QueryConfigExecutor::InitMetadataSource() {
   return tensorflow::Status::OK();
 }
 
+std::string QueryConfigExecutor::GetVerifiedSchemaKey() {
+  const std::string database = metadata_source_->GetDatabaseIdentifier();
+  if (database.empty()) return "";
+  return absl::StrCat(database, "@", GetLibraryVersion());
+}
+
 tensorflow::Status QueryConfigExecutor::InitMetadataSourceIfNotExists(
     const bool enable_upgrade_migration) {
+  // if the tables of the database were verified by another connection in this
+  // process, only checks that the schema version has not changed since.
+  const std::string verified_schema_key = GetVerifiedSchemaKey();
+  if (!verified_schema_key.empty() && IsSchemaVerified(verified_schema_key)) {
+    int64 db_version = -1;
+    if (GetSchemaVersion(&db_version).ok() &&
+        db_version == GetLibraryVersion()) {
+      return tensorflow::Status::OK();
+    }
+    SetSchemaVerified(verified_schema_key, false);
+  }
+  TF_RETURN_IF_ERROR(CheckOrInitMetadataSource(enable_upgrade_migration));
+  if (!verified_schema_key.empty()) {
+    SetSchemaVerified(verified_schema_key, true);
+  }
+  return tensorflow::Status::OK();
+}
+
+tensorflow::Status QueryConfigExecutor::CheckOrInitMetadataSource(
+    const bool enable_upgrade_migration) {
   // check db version, and make it to align with the lib version.
   TF_RETURN_IF_ERROR(
       UpgradeMetadataSourceIfOutOfDate(enable_upgrade_migration));
@@ -454,7 +879,7 @@ tensorflow::Status QueryConfigExecutor::InsertExecutionType(
     const std::string& type_name, bool has_input_type,
     const google::protobuf::Message& input_type, bool has_output_type,
     const google::protobuf::Message& output_type, int64* execution_type_id) {
-  return ExecuteQuerySelectLastInsertID(
+  return ExecuteInsertQuery(
       query_config_.insert_execution_type(),
       {Bind(type_name), Bind(has_input_type, input_type),
        Bind(has_output_type, output_type)},
@@ -478,21 +903,31 @@ tensorflow::Status QueryConfigExecutor::ListNodeIDsUsingOptions(
   }
 
   std::string sql_query;
+  TypeKind type_kind;
   if (std::is_same<Node, Artifact>::value) {
     sql_query = "SELECT `id` FROM `Artifact` WHERE";
+    type_kind = TypeKind::ARTIFACT_TYPE;
   } else if (std::is_same<Node, Execution>::value) {
     sql_query = "SELECT `id` FROM `Execution` WHERE";
+    type_kind = TypeKind::EXECUTION_TYPE;
   } else if (std::is_same<Node, Context>::value) {
     sql_query = "select `id` FROM `Context` WHERE";
+    type_kind = TypeKind::CONTEXT_TYPE;
   } else {
     return tensorflow::errors::InvalidArgument(
         "Invalid Node passed to ListNodeIDsUsingOptions");
   }
   TF_RETURN_IF_ERROR(AppendOrderingThresholdClause(options, id_offset,
                                                    field_offset, sql_query));
+  std::vector<QueryParameter> parameters;
+  TF_RETURN_IF_ERROR(
+      AppendFilterClause(options, type_kind, sql_query, parameters));
   TF_RETURN_IF_ERROR(AppendOrderByClause(options, sql_query));
   TF_RETURN_IF_ERROR(AppendLimitClause(options, sql_query));
-  return ExecuteQuery(sql_query, record_set);
+  // The query varies with the offsets and the filter, so it is not kept
+  // prepared.
+  return metadata_source_->ExecuteUncachedQuery(sql_query, parameters,
+                                                record_set);
 }
 
 tensorflow::Status QueryConfigExecutor::ListArtifactIDsUsingOptions(
@@ -15,9 +15,12 @@ limitations under the License.
 #ifndef ML_METADATA_METADATA_STORE_QUERY_CONFIG_EXECUTOR_H_
 #define ML_METADATA_METADATA_STORE_QUERY_CONFIG_EXECUTOR_H_
 
+#include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "ml_metadata/metadata_store/metadata_source.h"
 #include "ml_metadata/metadata_store/query_executor.h"
 #include "ml_metadata/proto/metadata_source.pb.h"
@@ -29,8 +32,11 @@ namespace ml_metadata {
 
 // A SQL version of the QueryExecutor. The text of most queries are
 // encoded in MetadataSourceQueryConfig. This class binds the relevant arguments
-// for each query using the Bind() methods. See notes on constructor for various
-// ways to construct this object.
+// for each query using the Bind() methods. The template queries whose
+// parameters are values are run as parameterized queries, so that the
+// MetadataSource can prepare them once per connection; the others, e.g., the
+// ones taking a list of ids, are composed as text. See notes on constructor for
+// various ways to construct this object.
 class QueryConfigExecutor : public QueryExecutor {
  public:
   // Note that the query config and the MetadataSource must be compatible.
@@ -67,8 +73,8 @@ class QueryConfigExecutor : public QueryExecutor {
 
   tensorflow::Status InsertArtifactType(const std::string& name,
                                         int64* artifact_type_id) final {
-    return ExecuteQuerySelectLastInsertID(query_config_.insert_artifact_type(),
-                                          {Bind(name)}, artifact_type_id);
+    return ExecuteInsertQuery(query_config_.insert_artifact_type(),
+                              {Bind(name)}, artifact_type_id);
   }
 
   tensorflow::Status InsertExecutionType(const std::string& type_name,
@@ -80,8 +86,8 @@ class QueryConfigExecutor : public QueryExecutor {
 
   tensorflow::Status InsertContextType(const std::string& type_name,
                                        int64* context_id) final {
-    return ExecuteQuerySelectLastInsertID(query_config_.insert_context_type(),
-                                          {Bind(type_name)}, context_id);
+    return ExecuteInsertQuery(query_config_.insert_context_type(),
+                              {Bind(type_name)}, context_id);
   }
 
   tensorflow::Status SelectTypeByID(int64 type_id, TypeKind type_kind,
@@ -90,6 +96,13 @@ class QueryConfigExecutor : public QueryExecutor {
                         {Bind(type_id), Bind(type_kind)}, record_set);
   }
 
+  tensorflow::Status SelectTypesByID(const std::vector<int64>& type_ids,
+                                     TypeKind type_kind,
+                                     RecordSet* record_set) final {
+    return ExecuteQueryByIDs(query_config_.select_types_by_id(), type_ids,
+                             {Bind(type_kind)}, record_set);
+  }
+
   tensorflow::Status SelectTypeByName(const absl::string_view type_name,
                                       TypeKind type_kind,
                                       RecordSet* record_set) final {
@@ -121,8 +134,16 @@ class QueryConfigExecutor : public QueryExecutor {
                         {Bind(type_id)}, record_set);
   }
 
-  // Queries the last inserted id.
-  tensorflow::Status SelectLastInsertID(int64* id);
+  tensorflow::Status SelectPropertyByTypeIDs(const std::vector<int64>& type_ids,
+                                             RecordSet* record_set) final {
+    return ExecuteQueryByIDs(query_config_.select_property_by_type_ids(),
+                             type_ids, record_set);
+  }
+
+  tensorflow::Status SelectTypeGeneration(RecordSet* record_set) final {
+    return ExecuteQuery(query_config_.select_type_generation(), {},
+                        record_set);
+  }
 
   tensorflow::Status CheckArtifactTable() final {
     return ExecuteQuery(query_config_.check_artifact_table());
@@ -133,7 +154,7 @@ class QueryConfigExecutor : public QueryExecutor {
       const absl::optional<Artifact::State>& state,
       const absl::optional<std::string>& name, const absl::Time create_time,
       const absl::Time update_time, int64* artifact_id) final {
-    return ExecuteQuerySelectLastInsertID(
+    return ExecuteInsertQuery(
         query_config_.insert_artifact(),
         {Bind(type_id), Bind(artifact_uri), Bind(state), Bind(name),
          Bind(absl::ToUnixMillis(create_time)),
@@ -141,12 +162,22 @@ class QueryConfigExecutor : public QueryExecutor {
         artifact_id);
   }
 
+  tensorflow::Status InsertArtifacts(const std::vector<Artifact>& artifacts,
+                                     absl::Time create_time,
+                                     std::vector<int64>* artifact_ids) final;
+
   tensorflow::Status SelectArtifactByID(int64 artifact_id,
                                         RecordSet* record_set) final {
     return ExecuteQuery(query_config_.select_artifact_by_id(),
                         {Bind(artifact_id)}, record_set);
   }
 
+  tensorflow::Status SelectArtifactsByID(const std::vector<int64>& artifact_ids,
+                                         TypedRecordSet* record_set) final {
+    return ExecuteQueryByIDs(query_config_.select_artifacts_by_id(),
+                             artifact_ids, record_set);
+  }
+
   tensorflow::Status SelectArtifactByTypeIDAndArtifactName(
       int64 artifact_type_id, const absl::string_view name,
       RecordSet* record_set) final {
@@ -183,24 +214,35 @@ class QueryConfigExecutor : public QueryExecutor {
       int64 artifact_id, absl::string_view artifact_property_name,
       bool is_custom_property, const Value& property_value) final {
     return ExecuteQuery(query_config_.insert_artifact_property(),
-                        {BindDataType(property_value), Bind(artifact_id),
-                         Bind(artifact_property_name), Bind(is_custom_property),
-                         BindValue(property_value)});
+                        BindPropertyRow(artifact_id, artifact_property_name,
+                                        is_custom_property, property_value));
   }
 
+  tensorflow::Status InsertArtifactProperties(
+      const std::vector<int64>& artifact_ids,
+      const std::vector<Artifact>& artifacts) final;
+
   tensorflow::Status SelectArtifactPropertyByArtifactID(
       int64 artifact_id, RecordSet* record_set) final {
     return ExecuteQuery(query_config_.select_artifact_property_by_artifact_id(),
                         {Bind(artifact_id)}, record_set);
   }
 
+  tensorflow::Status SelectArtifactPropertyByArtifactIDs(
+      const std::vector<int64>& artifact_ids,
+      TypedRecordSet* record_set) final {
+    return ExecuteQueryByIDs(
+        query_config_.select_artifact_property_by_artifact_ids(), artifact_ids,
+        record_set);
+  }
+
   tensorflow::Status UpdateArtifactProperty(
       int64 artifact_id, const absl::string_view property_name,
       const Value& property_value) final {
-    return ExecuteQuery(
-        query_config_.update_artifact_property(),
-        {BindDataType(property_value), BindValue(property_value),
-         Bind(artifact_id), Bind(property_name)});
+    std::vector<QueryParameter> parameters = BindValueColumns(property_value);
+    parameters.push_back(Bind(artifact_id));
+    parameters.push_back(Bind(property_name));
+    return ExecuteQuery(query_config_.update_artifact_property(), parameters);
   }
 
   tensorflow::Status DeleteArtifactProperty(
@@ -217,7 +259,7 @@ class QueryConfigExecutor : public QueryExecutor {
       int64 type_id, const absl::optional<Execution::State>& last_known_state,
       const absl::optional<std::string>& name, const absl::Time create_time,
       const absl::Time update_time, int64* execution_id) final {
-    return ExecuteQuerySelectLastInsertID(
+    return ExecuteInsertQuery(
         query_config_.insert_execution(),
         {Bind(type_id), Bind(last_known_state), Bind(name),
          Bind(absl::ToUnixMillis(create_time)),
@@ -225,12 +267,23 @@ class QueryConfigExecutor : public QueryExecutor {
         execution_id);
   }
 
+  tensorflow::Status InsertExecutions(const std::vector<Execution>& executions,
+                                      absl::Time create_time,
+                                      std::vector<int64>* execution_ids) final;
+
   tensorflow::Status SelectExecutionByID(int64 execution_id,
                                          RecordSet* record_set) final {
     return ExecuteQuery(query_config_.select_execution_by_id(),
                         {Bind(execution_id)}, record_set);
   }
 
+  tensorflow::Status SelectExecutionsByID(
+      const std::vector<int64>& execution_ids,
+      TypedRecordSet* record_set) final {
+    return ExecuteQueryByIDs(query_config_.select_executions_by_id(),
+                             execution_ids, record_set);
+  }
+
   tensorflow::Status SelectExecutionByTypeIDAndExecutionName(
       int64 execution_type_id, const absl::string_view name,
       RecordSet* record_set) final {
@@ -262,11 +315,15 @@ class QueryConfigExecutor : public QueryExecutor {
                                              const absl::string_view name,
                                              bool is_custom_property,
                                              const Value& value) final {
-    return ExecuteQuery(query_config_.insert_execution_property(),
-                        {BindDataType(value), Bind(execution_id), Bind(name),
-                         Bind(is_custom_property), BindValue(value)});
+    return ExecuteQuery(
+        query_config_.insert_execution_property(),
+        BindPropertyRow(execution_id, name, is_custom_property, value));
   }
 
+  tensorflow::Status InsertExecutionProperties(
+      const std::vector<int64>& execution_ids,
+      const std::vector<Execution>& executions) final;
+
   tensorflow::Status SelectExecutionPropertyByExecutionID(
       int64 execution_id, RecordSet* record_set) final {
     return ExecuteQuery(
@@ -274,12 +331,21 @@ class QueryConfigExecutor : public QueryExecutor {
         {Bind(execution_id)}, record_set);
   }
 
+  tensorflow::Status SelectExecutionPropertyByExecutionIDs(
+      const std::vector<int64>& execution_ids,
+      TypedRecordSet* record_set) final {
+    return ExecuteQueryByIDs(
+        query_config_.select_execution_property_by_execution_ids(),
+        execution_ids, record_set);
+  }
+
   tensorflow::Status UpdateExecutionProperty(int64 execution_id,
                                              const absl::string_view name,
                                              const Value& value) final {
-    return ExecuteQuery(query_config_.update_execution_property(),
-                        {BindDataType(value), BindValue(value),
-                         Bind(execution_id), Bind(name)});
+    std::vector<QueryParameter> parameters = BindValueColumns(value);
+    parameters.push_back(Bind(execution_id));
+    parameters.push_back(Bind(name));
+    return ExecuteQuery(query_config_.update_execution_property(), parameters);
   }
 
   tensorflow::Status DeleteExecutionProperty(
@@ -296,19 +362,29 @@ class QueryConfigExecutor : public QueryExecutor {
                                    const absl::Time create_time,
                                    const absl::Time update_time,
                                    int64* context_id) final {
-    return ExecuteQuerySelectLastInsertID(
+    return ExecuteInsertQuery(
         query_config_.insert_context(),
         {Bind(type_id), Bind(name), Bind(absl::ToUnixMillis(create_time)),
          Bind(absl::ToUnixMillis(update_time))},
         context_id);
   }
 
+  tensorflow::Status InsertContexts(const std::vector<Context>& contexts,
+                                    absl::Time create_time,
+                                    std::vector<int64>* context_ids) final;
+
   tensorflow::Status SelectContextByID(int64 context_id,
                                        RecordSet* record_set) final {
     return ExecuteQuery(query_config_.select_context_by_id(),
                         {Bind(context_id)}, record_set);
   }
 
+  tensorflow::Status SelectContextsByID(const std::vector<int64>& context_ids,
+                                        TypedRecordSet* record_set) final {
+    return ExecuteQueryByIDs(query_config_.select_contexts_by_id(),
+                             context_ids, record_set);
+  }
+
   tensorflow::Status SelectContextsByTypeID(int64 context_type_id,
                                             RecordSet* record_set) final {
     return ExecuteQuery(query_config_.select_contexts_by_type_id(),
@@ -340,24 +416,35 @@ class QueryConfigExecutor : public QueryExecutor {
                                            const absl::string_view name,
                                            bool custom_property,
                                            const Value& value) final {
-    return ExecuteQuery(query_config_.insert_context_property(),
-                        {BindDataType(value), Bind(context_id), Bind(name),
-                         Bind(custom_property), BindValue(value)});
+    return ExecuteQuery(
+        query_config_.insert_context_property(),
+        BindPropertyRow(context_id, name, custom_property, value));
   }
 
+  tensorflow::Status InsertContextProperties(
+      const std::vector<int64>& context_ids,
+      const std::vector<Context>& contexts) final;
+
   tensorflow::Status SelectContextPropertyByContextID(
       int64 context_id, RecordSet* record_set) final {
     return ExecuteQuery(query_config_.select_context_property_by_context_id(),
                         {Bind(context_id)}, record_set);
   }
 
+  tensorflow::Status SelectContextPropertyByContextIDs(
+      const std::vector<int64>& context_ids, TypedRecordSet* record_set) final {
+    return ExecuteQueryByIDs(
+        query_config_.select_context_property_by_context_ids(), context_ids,
+        record_set);
+  }
+
   tensorflow::Status UpdateContextProperty(
       int64 context_id, const absl::string_view property_name,
       const Value& property_value) final {
-    return ExecuteQuery(
-        query_config_.update_context_property(),
-        {BindDataType(property_value), BindValue(property_value),
-         Bind(context_id), Bind(property_name)});
+    std::vector<QueryParameter> parameters = BindValueColumns(property_value);
+    parameters.push_back(Bind(context_id));
+    parameters.push_back(Bind(property_name));
+    return ExecuteQuery(query_config_.update_context_property(), parameters);
   }
 
   tensorflow::Status DeleteContextProperty(
@@ -373,25 +460,47 @@ class QueryConfigExecutor : public QueryExecutor {
   tensorflow::Status InsertEvent(int64 artifact_id, int64 execution_id,
                                  int event_type, int64 event_time_milliseconds,
                                  int64* event_id) final {
-    return ExecuteQuerySelectLastInsertID(
+    return ExecuteInsertQuery(
         query_config_.insert_event(),
         {Bind(artifact_id), Bind(execution_id), Bind(event_type),
          Bind(event_time_milliseconds)},
         event_id);
   }
 
+  tensorflow::Status InsertEvents(const std::vector<Event>& events,
+                                  absl::Time event_time,
+                                  std::vector<int64>* event_ids) final;
+
   tensorflow::Status SelectEventByArtifactIDs(
       const std::vector<int64>& artifact_ids,
       RecordSet* event_record_set) final {
-    return ExecuteQuery(query_config_.select_event_by_artifact_ids(),
-                        {Bind(artifact_ids)}, event_record_set);
+    return ExecuteQueryByIDs(query_config_.select_event_by_artifact_ids(),
+                             artifact_ids, event_record_set);
   }
 
   tensorflow::Status SelectEventByExecutionIDs(
       const std::vector<int64>& execution_ids,
       RecordSet* event_record_set) final {
-    return ExecuteQuery(query_config_.select_event_by_execution_ids(),
-                        {Bind(execution_ids)}, event_record_set);
+    return ExecuteQueryByIDs(query_config_.select_event_by_execution_ids(),
+                             execution_ids, event_record_set);
+  }
+
+  tensorflow::Status SelectEventsByIDRange(int64 min_event_id,
+                                           int64 max_event_id,
+                                           RecordSet* event_record_set) final {
+    return ExecuteQuery(query_config_.select_events_by_id_range(),
+                        {Bind(min_event_id), Bind(max_event_id)},
+                        event_record_set);
+  }
+
+  tensorflow::Status SelectEventsByID(const std::vector<int64>& event_ids,
+                                      RecordSet* event_record_set) final {
+    return ExecuteQueryByIDs(query_config_.select_events_by_id(), event_ids,
+                             event_record_set);
+  }
+
+  tensorflow::Status SelectMaxEventID(RecordSet* record_set) final {
+    return ExecuteQuery(query_config_.select_max_event_id(), {}, record_set);
   }
 
   tensorflow::Status CheckEventPathTable() final {
@@ -401,10 +510,13 @@ class QueryConfigExecutor : public QueryExecutor {
   tensorflow::Status InsertEventPath(int64 event_id,
                                      const Event::Path::Step& step) final;
 
+  tensorflow::Status InsertEventPaths(const std::vector<int64>& event_ids,
+                                      const std::vector<Event>& events) final;
+
   tensorflow::Status SelectEventPathByEventIDs(
       const std::vector<int64>& event_ids, RecordSet* record_set) final {
-    return ExecuteQuery(query_config_.select_event_path_by_event_ids(),
-                        {Bind(event_ids)}, record_set);
+    return ExecuteQueryByIDs(query_config_.select_event_path_by_event_ids(),
+                             event_ids, record_set);
   }
 
   tensorflow::Status CheckAssociationTable() final {
@@ -413,7 +525,7 @@ class QueryConfigExecutor : public QueryExecutor {
 
   tensorflow::Status InsertAssociation(int64 context_id, int64 execution_id,
                                        int64* association_id) final {
-    return ExecuteQuerySelectLastInsertID(
+    return ExecuteInsertQuery(
         query_config_.insert_association(),
         {Bind(context_id), Bind(execution_id)}, association_id);
   }
@@ -437,9 +549,9 @@ class QueryConfigExecutor : public QueryExecutor {
   tensorflow::Status InsertAttributionDirect(int64 context_id,
                                              int64 artifact_id,
                                              int64* attribution_id) final {
-    return ExecuteQuerySelectLastInsertID(query_config_.insert_attribution(),
-                                          {Bind(context_id), Bind(artifact_id)},
-                                          attribution_id);
+    return ExecuteInsertQuery(query_config_.insert_attribution(),
+                              {Bind(context_id), Bind(artifact_id)},
+                              attribution_id);
   }
 
   tensorflow::Status SelectAttributionByContextID(int64 context_id,
@@ -489,6 +601,8 @@ class QueryConfigExecutor : public QueryExecutor {
     return query_config_.schema_version();
   }
 
+  int64 GetTransactionId() final { return metadata_source_->transaction_id(); }
+
   tensorflow::Status DowngradeMetadataSource(
       const int64 to_schema_version) final;
 
@@ -505,102 +619,205 @@ class QueryConfigExecutor : public QueryExecutor {
  private:
   // Utility method to bind an nullable value.
   template <typename T>
-  std::string Bind(const absl::optional<T>& v) {
-    return v ? Bind(v.value()) : "NULL";
+  QueryParameter Bind(const absl::optional<T>& v) {
+    return v ? Bind(v.value()) : QueryParameter();
   }
 
-  // Utility method to bind an string_view value to a SQL clause.
-  std::string Bind(absl::string_view value);
+  // Utility method to bind an string_view value to a query parameter.
+  QueryParameter Bind(absl::string_view value);
+
+  // Utility method to bind an string_view value to a query parameter.
+  QueryParameter Bind(const char* value);
 
-  // Utility method to bind an string_view value to a SQL clause.
-  std::string Bind(const char* value);
+  // Utility method to bind an int value to a query parameter.
+  QueryParameter Bind(int value);
 
-  // Utility method to bind an int value to a SQL clause.
-  std::string Bind(int value);
+  // Utility method to bind an int64 value to a query parameter.
+  QueryParameter Bind(int64 value);
 
-  // Utility method to bind an int64 value to a SQL clause.
-  std::string Bind(int64 value);
+  // Utility method to bind a boolean value to a query parameter.
+  QueryParameter Bind(bool value);
 
-  // Utility method to bind a boolean value to a SQL clause.
-  std::string Bind(bool value);
+  // Utility method to bind an double value to a query parameter.
+  QueryParameter Bind(const double value);
 
-  // Utility method to bind an double value to a SQL clause.
-  std::string Bind(const double value);
+  // Utility method to bind an PropertyType enum value to a query parameter.
+  QueryParameter Bind(const PropertyType value);
 
-  // Utility method to bind an PropertyType enum value to a SQL clause.
-  // PropertyType is an enum (integer), EscapeString is not applicable.
-  std::string Bind(const PropertyType value);
+  // Utility method to bind an Event::Type enum value to a query parameter.
+  QueryParameter Bind(const Event::Type value);
 
-  // Utility method to bind an Event::Type enum value to a SQL clause.
-  // Event::Type is an enum (integer), EscapeString is not applicable.
-  std::string Bind(const Event::Type value);
+  // Utility methods to bind the value to a query parameter.
+  QueryParameter BindValue(const Value& value);
+  QueryParameter Bind(bool exists, const google::protobuf::Message& message);
 
-  // Utility methods to bind the value to a SQL clause.
-  std::string BindValue(const Value& value);
-  std::string BindDataType(const Value& value);
-  std::string Bind(bool exists, const google::protobuf::Message& message);
+  // Utility method to bind the value to the (int_value, double_value,
+  // string_value) columns of a property, of which only the one of the value
+  // data type is not NULL.
+  std::vector<QueryParameter> BindValueColumns(const Value& value);
 
-  // Utility method to bind an TypeKind to a SQL clause.
-  // TypeKind is an enum (integer), EscapeString is not applicable.
-  std::string Bind(TypeKind value);
+  // Utility method to bind a property to a row of (node_id, name,
+  // is_custom_property, int_value, double_value, string_value).
+  std::vector<QueryParameter> BindPropertyRow(int64 node_id,
+                                              absl::string_view name,
+                                              bool is_custom_property,
+                                              const Value& value);
 
-  // Utility methods to bind Artifact::State/Execution::State to SQL clause.
-  std::string Bind(Artifact::State value);
-  std::string Bind(Execution::State value);
+  // Utility method to bind an TypeKind to a query parameter.
+  QueryParameter Bind(TypeKind value);
+
+  // Utility methods to bind Artifact::State/Execution::State to a query
+  // parameter.
+  QueryParameter Bind(Artifact::State value);
+  QueryParameter Bind(Execution::State value);
 
   // Utility method to bind an in64 vector to a string joined with "," that can
   // fit into SQL IN(...) clause.
   std::string Bind(const std::vector<int64>& value);
 
+  // Utility method to bind the values of a row to a SQL VALUES clause.
+  std::string BindRow(const std::vector<QueryParameter>& values);
+
+  // Utility method to bind the properties and custom properties of a stored
+  // node, which is one of {Artifact, Execution, Context}, to rows of
+  // (node_id, name, is_custom_property, int_value, double_value,
+  // string_value). The rows are appended to `rows`.
+  template <typename Node>
+  void BindPropertyRows(int64 node_id, const Node& node,
+                        std::vector<std::string>* rows);
+
   #if (!defined(__APPLE__) && !defined(_WIN32))
-  std::string Bind(const google::protobuf::int64 value);
+  QueryParameter Bind(const google::protobuf::int64 value);
   #endif
 
-  // Execute a template query. All strings in parameters should already be
-  // in a format appropriate for the SQL variant being used (at this point,
-  // they are just inserted).
+  // A template query rewritten to a parameterized query of the MetadataSource.
+  struct ParameterizedQuery {
+    // The query, where each occurrence of $0..$9 is replaced by a `?`.
+    std::string query;
+    // The template parameter bound to each `?`, in order.
+    std::vector<int> parameter_indices;
+    // Whether the `?` are bound to the template parameters $0, $1, ... in
+    // order, so that the parameters can be passed as they are.
+    bool in_order = true;
+
+    // Returns the template parameters in the order of the `?`.
+    std::vector<QueryParameter> ArrangeParameters(
+        const std::vector<QueryParameter>& parameters) const {
+      std::vector<QueryParameter> arranged_parameters;
+      arranged_parameters.reserve(parameter_indices.size());
+      for (const int i : parameter_indices) {
+        arranged_parameters.push_back(parameters[i]);
+      }
+      return arranged_parameters;
+    }
+  };
+
+  // Execute a template query as a parameterized query.
   // Results consist of zero or more rows represented in RecordSet.
   // Returns FAILED_PRECONDITION error, if Connection() is not opened.
   // Returns detailed INTERNAL error, if query execution fails.
   // Returns FAILED_PRECONDITION error, if a transaction has not begun.
   tensorflow::Status ExecuteQuery(
       const MetadataSourceQueryConfig::TemplateQuery& template_query,
-      const std::vector<std::string>& parameters, RecordSet* record_set);
+      const std::vector<QueryParameter>& parameters, RecordSet* record_set);
 
-  // Execute a template query and ignore the result.
-  // All strings in parameters should already be in a format appropriate for the
-  // SQL variant being used (at this point, they are just inserted).
+  // Execute a template query as a parameterized query and ignore the result.
   // Returns FAILED_PRECONDITION error, if Connection() is not opened.
   // Returns detailed INTERNAL error, if query execution fails.
   // Returns FAILED_PRECONDITION error, if a transaction has not begun.
   tensorflow::Status ExecuteQuery(
       const MetadataSourceQueryConfig::TemplateQuery& template_query,
-      const std::vector<std::string>& parameters) {
+      const std::vector<QueryParameter>& parameters) {
     RecordSet record_set;
     return ExecuteQuery(template_query, parameters, &record_set);
   }
 
-  // Execute a template query without arguments and ignore the result.
+  // Execute a template query without arguments and ignore the result. The
+  // query is run as text, as it may be a DDL query with several statements.
   // Returns FAILED_PRECONDITION error, if Connection() is not opened.
   // Returns detailed INTERNAL error, if query execution fails.
   // Returns FAILED_PRECONDITION error, if a transaction has not begun.
   tensorflow::Status ExecuteQuery(
       const MetadataSourceQueryConfig::TemplateQuery& query) {
-    return ExecuteQuery(query, {});
+    return ExecuteQuery(query.query());
   }
 
-  // Execute a template query without arguments and ignore the result.
+  // Executes a template query whose $0 is a collection of ids, and whose other
+  // parameters $1, $2, ... are given in `parameters`. If there are more than
+  // max_num_ids_per_query ids, the query is executed once per chunk of ids and
+  // the records are appended to `record_set` in order. As the number of ids
+  // varies, the query is composed as text.
   // Returns FAILED_PRECONDITION error, if Connection() is not opened.
   // Returns detailed INTERNAL error, if query execution fails.
   // Returns FAILED_PRECONDITION error, if a transaction has not begun.
-  // Returns INTERNAL error, if it cannot find the last insert ID.
-  tensorflow::Status ExecuteQuerySelectLastInsertID(
-      const MetadataSourceQueryConfig::TemplateQuery& query,
-      const std::vector<std::string>& arguments, int64* last_insert_id) {
-    TF_RETURN_IF_ERROR(ExecuteQuery(query, arguments));
-    return SelectLastInsertID(last_insert_id);
+  tensorflow::Status ExecuteQueryByIDs(
+      const MetadataSourceQueryConfig::TemplateQuery& template_query,
+      const std::vector<int64>& ids,
+      const std::vector<QueryParameter>& parameters, RecordSet* record_set);
+
+  // Executes a template query whose only parameter $0 is a collection of ids.
+  tensorflow::Status ExecuteQueryByIDs(
+      const MetadataSourceQueryConfig::TemplateQuery& template_query,
+      const std::vector<int64>& ids, RecordSet* record_set) {
+    return ExecuteQueryByIDs(template_query, ids, {}, record_set);
   }
 
+  // Executes a template query whose only parameter $0 is a collection of ids,
+  // and appends the typed records of all the chunks of ids to `record_set`.
+  tensorflow::Status ExecuteQueryByIDs(
+      const MetadataSourceQueryConfig::TemplateQuery& template_query,
+      const std::vector<int64>& ids, TypedRecordSet* record_set);
+
+  // Composes a template query whose $0 is a collection of ids, and whose other
+  // parameters are given in `parameters`, for each chunk of at most
+  // max_num_ids_per_query ids, and calls `execute_query` with the queries in
+  // order.
+  tensorflow::Status ComposeQueriesByIDs(
+      const MetadataSourceQueryConfig::TemplateQuery& template_query,
+      const std::vector<int64>& ids,
+      const std::vector<QueryParameter>& parameters,
+      const std::function<tensorflow::Status(const std::string&)>&
+          execute_query);
+
+  // Executes a multi-row insert whose only parameter $0 is a collection of
+  // rows bound by BindRow. If there are more than max_num_rows_per_insert
+  // rows, the query is executed once per chunk of rows. If `row_ids` is not
+  // null, the ids given to the rows are returned in it, in the order of
+  // `rows`. They are derived from the id of the first row of a query with
+  // MetadataSource::GetInsertIdIncrement, and if it is 0, each row is inserted
+  // by its own query.
+  // Returns FAILED_PRECONDITION error, if Connection() is not opened.
+  // Returns detailed INTERNAL error, if query execution fails.
+  // Returns FAILED_PRECONDITION error, if a transaction has not begun.
+  tensorflow::Status ExecuteMultiRowInsert(
+      const MetadataSourceQueryConfig::TemplateQuery& template_query,
+      const std::vector<std::string>& rows, std::vector<int64>* row_ids);
+
+  // Execute a template insert query as a parameterized query, and returns the
+  // id generated for the first inserted row in `insert_id`.
+  // Returns FAILED_PRECONDITION error, if Connection() is not opened.
+  // Returns detailed INTERNAL error, if query execution fails.
+  // Returns FAILED_PRECONDITION error, if a transaction has not begun.
+  tensorflow::Status ExecuteInsertQuery(
+      const MetadataSourceQueryConfig::TemplateQuery& template_query,
+      const std::vector<QueryParameter>& parameters, int64* insert_id);
+
+  // Returns the parameterized query of a template query, which is rewritten
+  // at its first use and cached.
+  // Returns INVALID_ARGUMENT error, if there are more than 10 parameters.
+  tensorflow::Status GetParameterizedQuery(
+      const MetadataSourceQueryConfig::TemplateQuery& template_query,
+      const std::vector<QueryParameter>& parameters,
+      const ParameterizedQuery** parameterized_query);
+
+  // Composes a template query with the given parameters. All strings in
+  // parameters should already be in a format appropriate for the SQL variant
+  // being used (at this point, they are just inserted).
+  // Returns INVALID_ARGUMENT error, if there are more than 10 parameters.
+  tensorflow::Status ComposeQuery(
+      const MetadataSourceQueryConfig::TemplateQuery& template_query,
+      const std::vector<std::string>& parameters, std::string* query);
+
   // Execute a query without arguments.
   // Results consist of zero or more rows represented in RecordSet.
   // Returns FAILED_PRECONDITION error, if Connection() is not opened.
@@ -640,6 +857,24 @@ class QueryConfigExecutor : public QueryExecutor {
   // TODO(martinz): consider promoting to MetadataAccessObject.
   tensorflow::Status UpgradeMetadataSourceIfOutOfDate(bool enable_migration);
 
+  // Runs a data migration of a migration scheme.
+  // Returns DATA_LOSS error, if a stored row is malformed.
+  // Returns INTERNAL error, if a stored value cannot be converted.
+  // Returns detailed INTERNAL error, if query execution fails.
+  tensorflow::Status RunDataMigration(
+      MetadataSourceQueryConfig::MigrationScheme::DataMigration data_migration);
+
+  // Upgrades the database if needed, then checks all the tables required by
+  // the library exist, or creates them if none of them exists.
+  // It implements InitMetadataSourceIfNotExists without the per process cache
+  // of verified databases.
+  tensorflow::Status CheckOrInitMetadataSource(bool enable_upgrade_migration);
+
+  // Returns the key of the database and library version in the per process
+  // cache of verified databases, or an empty string if the database cannot be
+  // identified across connections.
+  std::string GetVerifiedSchemaKey();
+
   // List Node IDs using `options`. Template parameter `Node` specifies the
   // table to use for listing.
   // On success `record_set` is updated with Node IDs.
@@ -649,6 +884,11 @@ class QueryConfigExecutor : public QueryExecutor {
 
   MetadataSourceQueryConfig query_config_;
 
+  // The parameterized queries of the template queries in `query_config_`.
+  absl::flat_hash_map<const MetadataSourceQueryConfig::TemplateQuery*,
+                      ParameterizedQuery>
+      parameterized_queries_;
+
   // This object does not own the MetadataSource.
   MetadataSource* metadata_source_;
 };
@@ -22,6 +22,7 @@ limitations under the License.
 #include "absl/types/optional.h"
 #include "ml_metadata/metadata_store/constants.h"
 #include "ml_metadata/metadata_store/metadata_source.h"
+#include "ml_metadata/metadata_store/typed_record_set.h"
 #include "ml_metadata/proto/metadata_source.pb.h"
 #include "ml_metadata/proto/metadata_store.pb.h"
 #include "tensorflow/core/lib/core/status.h"
@@ -54,6 +55,9 @@ class QueryExecutor {
   // Returns FAILED_PRECONDITION error, if library and db have incompatible
   //   schema versions, and upgrade migrations are not enabled.
   // Returns detailed INTERNAL error, if create schema query execution fails.
+  // Once all the tables of a database are verified, later calls in the same
+  // process for the same database only check its schema version, as long as it
+  // remains the library version.
   virtual tensorflow::Status InitMetadataSourceIfNotExists(
       bool enable_upgrade_migration = false) = 0;
 
@@ -100,6 +104,10 @@ class QueryExecutor {
   // needed.
   virtual int64 GetLibraryVersion() = 0;
 
+  // Returns the id of the current transaction of the metadata source. The ids
+  // of later transactions are greater.
+  virtual int64 GetTransactionId() = 0;
+
   // Each of the following methods roughly corresponds to a query (or two).
   virtual tensorflow::Status CheckTypeTable() = 0;
 
@@ -131,6 +139,14 @@ class QueryExecutor {
   virtual tensorflow::Status SelectTypeByID(int64 type_id, TypeKind type_kind,
                                             RecordSet* record_set) = 0;
 
+  // Queries types by a collection of type ids. The ids that cannot be found
+  // are skipped.
+  // Returns messages that can be converted to ArtifactTypes,
+  // ContextTypes, or ExecutionTypes.
+  virtual tensorflow::Status SelectTypesByID(
+      const std::vector<int64>& type_ids, TypeKind type_kind,
+      RecordSet* record_set) = 0;
+
   // Queries a type by its type name.
   // Returns a message that can be converted to an ArtifactType,
   // ContextType, or ExecutionType.
@@ -157,6 +173,15 @@ class QueryExecutor {
   virtual tensorflow::Status SelectPropertyByTypeID(int64 type_id,
                                                     RecordSet* record_set) = 0;
 
+  // Queries properties of types from the database by a collection of type ids.
+  // Returns a list of properties (type_id, name, data_type).
+  virtual tensorflow::Status SelectPropertyByTypeIDs(
+      const std::vector<int64>& type_ids, RecordSet* record_set) = 0;
+
+  // Queries the generation of the types, which changes whenever a type or a
+  // property of a type is added by any connection. The result has one record.
+  virtual tensorflow::Status SelectTypeGeneration(RecordSet* record_set) = 0;
+
   // Checks the existence of the Artifact table.
   virtual tensorflow::Status CheckArtifactTable() = 0;
 
@@ -167,11 +192,26 @@ class QueryExecutor {
       const absl::optional<std::string>& name, absl::Time create_time,
       absl::Time update_time, int64* artifact_id) = 0;
 
+  // Inserts a collection of artifacts into the database with multi-row
+  // inserts, ignoring their ids and properties. The ids given to the artifacts
+  // are returned in `artifact_ids`, in the order of `artifacts`.
+  virtual tensorflow::Status InsertArtifacts(
+      const std::vector<Artifact>& artifacts, absl::Time create_time,
+      std::vector<int64>* artifact_ids) = 0;
+
   // Queries an artifact from the Artifact table by its id.
   // Returns a list of records that can be converted to artifacts.
   virtual tensorflow::Status SelectArtifactByID(int64 artifact_id,
                                                 RecordSet* record_set) = 0;
 
+  // Queries artifacts from the Artifact table by a collection of ids. Unlike
+  // SelectArtifactByID, each record starts with the artifact id. The ids are
+  // split into multiple queries if there are too many of them. The records of
+  // this and the other queries by collections of node ids are returned in a
+  // TypedRecordSet, as they can be many.
+  virtual tensorflow::Status SelectArtifactsByID(
+      const std::vector<int64>& artifact_ids, TypedRecordSet* record_set) = 0;
+
   // Queries an artifact from the Artifact table by its type_id and name.
   // Returns the artifact ID.
   virtual tensorflow::Status SelectArtifactByTypeIDAndArtifactName(
@@ -201,11 +241,24 @@ class QueryExecutor {
       int64 artifact_id, absl::string_view artifact_property_name,
       bool is_custom_property, const Value& property_value) = 0;
 
+  // Inserts the properties and custom properties of a collection of stored
+  // artifacts into the database with multi-row inserts. `artifact_ids` are the
+  // ids of `artifacts`.
+  virtual tensorflow::Status InsertArtifactProperties(
+      const std::vector<int64>& artifact_ids,
+      const std::vector<Artifact>& artifacts) = 0;
+
   // Queries properties of an artifact from the database by the
   // artifact id.
   virtual tensorflow::Status SelectArtifactPropertyByArtifactID(
       int64 artifact_id, RecordSet* record_set) = 0;
 
+  // Queries properties of artifacts from the database by a collection of
+  // artifact ids. Each record starts with the artifact id, followed by the
+  // columns of SelectArtifactPropertyByArtifactID.
+  virtual tensorflow::Status SelectArtifactPropertyByArtifactIDs(
+      const std::vector<int64>& artifact_ids, TypedRecordSet* record_set) = 0;
+
   // Updates a property of an artifact in the database.
   virtual tensorflow::Status UpdateArtifactProperty(
       int64 artifact_id, const absl::string_view property_name,
@@ -224,11 +277,23 @@ class QueryExecutor {
       const absl::optional<std::string>& name, absl::Time create_time,
       absl::Time update_time, int64* execution_id) = 0;
 
+  // Inserts a collection of executions into the database with multi-row
+  // inserts, ignoring their ids and properties. The ids given to the
+  // executions are returned in `execution_ids`, in the order of `executions`.
+  virtual tensorflow::Status InsertExecutions(
+      const std::vector<Execution>& executions, absl::Time create_time,
+      std::vector<int64>* execution_ids) = 0;
+
   // Queries an execution from the database by its id. It has 1
   // parameter. The result can be parsed into an Execution.
   virtual tensorflow::Status SelectExecutionByID(int64 execution_id,
                                                  RecordSet* record_set) = 0;
 
+  // Queries executions from the database by a collection of ids. Each record
+  // starts with the execution id.
+  virtual tensorflow::Status SelectExecutionsByID(
+      const std::vector<int64>& execution_ids, TypedRecordSet* record_set) = 0;
+
   // Queries an execution from the database by its type_id and name.
   virtual tensorflow::Status SelectExecutionByTypeIDAndExecutionName(
       int64 execution_type_id, const absl::string_view name,
@@ -252,10 +317,22 @@ class QueryExecutor {
       int64 execution_id, const absl::string_view name, bool is_custom_property,
       const Value& value) = 0;
 
+  // Inserts the properties and custom properties of a collection of stored
+  // executions into the database with multi-row inserts. `execution_ids` are
+  // the ids of `executions`.
+  virtual tensorflow::Status InsertExecutionProperties(
+      const std::vector<int64>& execution_ids,
+      const std::vector<Execution>& executions) = 0;
+
   // Queries properties of an execution from the database by the execution id.
   virtual tensorflow::Status SelectExecutionPropertyByExecutionID(
       int64 execution_id, RecordSet* record_set) = 0;
 
+  // Queries properties of executions from the database by a collection of
+  // execution ids. Each record starts with the execution id.
+  virtual tensorflow::Status SelectExecutionPropertyByExecutionIDs(
+      const std::vector<int64>& execution_ids, TypedRecordSet* record_set) = 0;
+
   // Updates a property of an execution from the database.
   virtual tensorflow::Status UpdateExecutionProperty(
       int64 execution_id, const absl::string_view name, const Value& value) = 0;
@@ -274,10 +351,22 @@ class QueryExecutor {
                                            const absl::Time update_time,
                                            int64* context_id) = 0;
 
+  // Inserts a collection of contexts into the database with multi-row inserts,
+  // ignoring their ids and properties. The ids given to the contexts are
+  // returned in `context_ids`, in the order of `contexts`.
+  virtual tensorflow::Status InsertContexts(
+      const std::vector<Context>& contexts, absl::Time create_time,
+      std::vector<int64>* context_ids) = 0;
+
   // Queries a context from the database by its id.
   virtual tensorflow::Status SelectContextByID(int64 context_id,
                                                RecordSet* record_set) = 0;
 
+  // Queries contexts from the database by a collection of ids. Each record
+  // starts with the context id.
+  virtual tensorflow::Status SelectContextsByID(
+      const std::vector<int64>& context_ids, TypedRecordSet* record_set) = 0;
+
   // Queries a context from the Context table by its type_id.
   virtual tensorflow::Status SelectContextsByTypeID(int64 context_type_id,
                                                     RecordSet* record_set) = 0;
@@ -301,11 +390,23 @@ class QueryExecutor {
                                                    bool custom_property,
                                                    const Value& value) = 0;
 
+  // Inserts the properties and custom properties of a collection of stored
+  // contexts into the database with multi-row inserts. `context_ids` are the
+  // ids of `contexts`.
+  virtual tensorflow::Status InsertContextProperties(
+      const std::vector<int64>& context_ids,
+      const std::vector<Context>& contexts) = 0;
+
   // Queries properties of a context from the database by the
   // context id.
   virtual tensorflow::Status SelectContextPropertyByContextID(
       int64 context_id, RecordSet* record_set) = 0;
 
+  // Queries properties of contexts from the database by a collection of
+  // context ids. Each record starts with the context id.
+  virtual tensorflow::Status SelectContextPropertyByContextIDs(
+      const std::vector<int64>& context_ids, TypedRecordSet* record_set) = 0;
+
   // Updates a property of a context in the database.
   virtual tensorflow::Status UpdateContextProperty(
       int64 context_id, const absl::string_view property_name,
@@ -324,6 +425,13 @@ class QueryExecutor {
                                          int64 event_time_milliseconds,
                                          int64* event_id) = 0;
 
+  // Inserts a collection of events into the database with multi-row inserts,
+  // and returns their ids in the order of `events`. The events without
+  // milliseconds_since_epoch are given `event_time`.
+  virtual tensorflow::Status InsertEvents(const std::vector<Event>& events,
+                                          absl::Time event_time,
+                                          std::vector<int64>* event_ids) = 0;
+
   // Queries events from the Event table by a collection of artifact ids.
   virtual tensorflow::Status SelectEventByArtifactIDs(
       const std::vector<int64>& artifact_ids, RecordSet* event_record_set) = 0;
@@ -332,6 +440,19 @@ class QueryExecutor {
   virtual tensorflow::Status SelectEventByExecutionIDs(
       const std::vector<int64>& execution_ids, RecordSet* event_record_set) = 0;
 
+  // Queries the id, artifact_id, execution_id and type of the events with ids
+  // in (min_event_id, max_event_id], in the order of ids.
+  virtual tensorflow::Status SelectEventsByIDRange(
+      int64 min_event_id, int64 max_event_id, RecordSet* event_record_set) = 0;
+
+  // Queries events from the Event table by a collection of event ids.
+  virtual tensorflow::Status SelectEventsByID(
+      const std::vector<int64>& event_ids, RecordSet* event_record_set) = 0;
+
+  // Queries the largest event id. The record set has one row, whose value is
+  // NULL if there is no event.
+  virtual tensorflow::Status SelectMaxEventID(RecordSet* record_set) = 0;
+
   // Checks the existence of the EventPath table.
   virtual tensorflow::Status CheckEventPathTable() = 0;
 
@@ -339,6 +460,12 @@ class QueryExecutor {
   virtual tensorflow::Status InsertEventPath(int64 event_id,
                                              const Event::Path::Step& step) = 0;
 
+  // Inserts the path steps of a collection of stored events into the EventPath
+  // table with multi-row inserts. `event_ids` are the ids of `events`.
+  virtual tensorflow::Status InsertEventPaths(
+      const std::vector<int64>& event_ids,
+      const std::vector<Event>& events) = 0;
+
   // Queries paths from the database by a collection of event ids.
   virtual tensorflow::Status SelectEventPathByEventIDs(
       const std::vector<int64>& event_ids, RecordSet* record_set) = 0;
@@ -20,9 +20,9 @@ limitations under the License.
 #include <vector>
 
 #include "google/protobuf/descriptor.h"
-#include "google/protobuf/util/json_util.h"
 #include "google/protobuf/util/message_differencer.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
@@ -37,6 +37,8 @@ limitations under the License.
 #endif
 // clang-format on
 #include "ml_metadata/metadata_store/list_operation_util.h"
+#include "ml_metadata/metadata_store/row_decoder.h"
+#include "ml_metadata/metadata_store/typed_record_set.h"
 #include "ml_metadata/proto/metadata_source.pb.h"
 #include "ml_metadata/proto/metadata_store.pb.h"
 #include "tensorflow/core/lib/core/errors.h"
@@ -57,142 +59,57 @@ TypeKind ResolveTypeKind(const ContextType* const type) {
   return TypeKind::CONTEXT_TYPE;
 }
 
-// Parses and converts a string value to a specific field in a message.
-// If the given string `value` is NULL (encoded as kMetadataSourceNull), then
-// leave the field unset.
-// The field should be a scalar field. The field type must be one of {string,
-// int64, bool, enum, message}.
-tensorflow::Status ParseValueToField(
-    const google::protobuf::FieldDescriptor* field_descriptor,
-    const absl::string_view value, google::protobuf::Message* message) {
-  if (value == kMetadataSourceNull) {
-    return tensorflow::Status::OK();
-  }
-  const google::protobuf::Reflection* reflection = message->GetReflection();
-  switch (field_descriptor->cpp_type()) {
-    case google::protobuf::FieldDescriptor::CppType::CPPTYPE_STRING: {
-      if (field_descriptor->is_repeated())
-        reflection->AddString(message, field_descriptor, std::string(value));
-      else
-        reflection->SetString(message, field_descriptor, std::string(value));
-      break;
-    }
-    case google::protobuf::FieldDescriptor::CppType::CPPTYPE_INT64: {
-      int64 int64_value;
-      CHECK(absl::SimpleAtoi(value, &int64_value));
-      if (field_descriptor->is_repeated())
-        reflection->AddInt64(message, field_descriptor, int64_value);
-      else
-        reflection->SetInt64(message, field_descriptor, int64_value);
-      break;
-    }
-    case google::protobuf::FieldDescriptor::CppType::CPPTYPE_BOOL: {
-      bool bool_value;
-      CHECK(absl::SimpleAtob(value, &bool_value));
-      if (field_descriptor->is_repeated())
-        reflection->AddBool(message, field_descriptor, bool_value);
-      else
-        reflection->SetBool(message, field_descriptor, bool_value);
-      break;
-    }
-    case google::protobuf::FieldDescriptor::CppType::CPPTYPE_ENUM: {
-      int enum_value;
-      CHECK(absl::SimpleAtoi(value, &enum_value));
-      if (field_descriptor->is_repeated())
-        reflection->AddEnumValue(message, field_descriptor, enum_value);
-      else
-        reflection->SetEnumValue(message, field_descriptor, enum_value);
-      break;
-    }
-    case google::protobuf::FieldDescriptor::CppType::CPPTYPE_MESSAGE: {
-      CHECK(!field_descriptor->is_repeated())
-          << "Cannot handle a repeated message";
-      if (!value.empty()) {
-        ::google::protobuf::Message* sub_message =
-            reflection->MutableMessage(message, field_descriptor);
-        if (!::google::protobuf::util::JsonStringToMessage(
-                 std::string(value.begin(), value.size()), sub_message)
-                 .ok()) {
-          return tensorflow::errors::Internal(
-              ::absl::StrCat("Failed to parse proto: ", value));
-        }
-      }
-      break;
-    }
-    default: {
-      return tensorflow::errors::Internal(absl::StrCat(
-          "Unsupported field type: ", field_descriptor->cpp_type()));
-    }
-  }
-  return tensorflow::Status::OK();
-}
-
-// Converts a RecordSet in the query result to a MessageType. In the record at
-// the `record_index`, its value of each column is assigned to a message field
-// with the same field name as the column name.
-template <typename MessageType>
-tensorflow::Status ParseRecordSetToMessage(const RecordSet& record_set,
-                                           MessageType* message,
-                                           int record_index = 0) {
-  CHECK_LT(record_index, record_set.records_size());
-  const google::protobuf::Descriptor* descriptor = message->descriptor();
-  for (int i = 0; i < record_set.column_names_size(); i++) {
-    const std::string& column_name = record_set.column_names(i);
-    const google::protobuf::FieldDescriptor* field_descriptor =
-        descriptor->FindFieldByName(column_name);
-    if (field_descriptor != nullptr) {
-      const std::string& value = record_set.records(record_index).values(i);
-      TF_RETURN_IF_ERROR(ParseValueToField(field_descriptor, value, message));
-    }
-  }
-  return tensorflow::Status::OK();
-}
-
-// Converts a RecordSet in the query result to a MessageType array.
-template <typename MessageType>
-tensorflow::Status ParseRecordSetToMessageArray(
-    const RecordSet& record_set, std::vector<MessageType>* messages) {
-  for (int i = 0; i < record_set.records_size(); i++) {
-    messages->push_back(MessageType());
-    TF_RETURN_IF_ERROR(
-        ParseRecordSetToMessage(record_set, &messages->back(), i));
+// Parses a property record of a node, whose columns starting from
+// `first_column` are (key, is_custom_property, int_value, double_value,
+// string_value), and sets the property in the node.
+template <typename Node>
+void ParsePropertyRecordToNode(const RecordSet::Record& record,
+                               const int first_column, Node* node) {
+  const std::string& property_name = record.values(first_column);
+  bool is_custom_property;
+  CHECK(absl::SimpleAtob(record.values(first_column + 1),
+                         &is_custom_property));
+  auto& property_value =
+      (is_custom_property ? (*node->mutable_custom_properties())[property_name]
+                          : (*node->mutable_properties())[property_name]);
+  if (record.values(first_column + 2) != kMetadataSourceNull) {
+    int64 int_value;
+    CHECK(absl::SimpleAtoi(record.values(first_column + 2), &int_value));
+    property_value.set_int_value(int_value);
+  } else if (record.values(first_column + 3) != kMetadataSourceNull) {
+    double double_value;
+    CHECK(absl::SimpleAtod(record.values(first_column + 3), &double_value));
+    property_value.set_double_value(double_value);
+  } else {
+    const std::string& string_value = record.values(first_column + 4);
+    property_value.set_string_value(string_value);
   }
-  return tensorflow::Status::OK();
 }
 
-// Converts a RecordSet containing key-value pairs to a proto Map.
-// The field_name is the map field in the MessageType. The method fills the
-// message's map field with field_name using the rows in the given record_set.
-template <typename MessageType>
-tensorflow::Status ParseRecordSetToMapField(const RecordSet& record_set,
-                                            const std::string& field_name,
-                                            MessageType* message) {
-  const google::protobuf::Descriptor* descriptor = message->descriptor();
-  const google::protobuf::Reflection* reflection = message->GetReflection();
-  const google::protobuf::FieldDescriptor* map_field_descriptor =
-      descriptor->FindFieldByName(field_name);
-  if (map_field_descriptor == nullptr || !map_field_descriptor->is_map()) {
-    return tensorflow::errors::Internal(
-        absl::StrCat("Cannot find map field with field name: ", field_name));
-  }
-
-  const google::protobuf::FieldDescriptor* key_descriptor =
-      map_field_descriptor->message_type()->FindFieldByName("key");
-  const google::protobuf::FieldDescriptor* value_descriptor =
-      map_field_descriptor->message_type()->FindFieldByName("value");
-
-  for (const RecordSet::Record& record : record_set.records()) {
-    google::protobuf::Message* map_field_message =
-        reflection->AddMessage(message, map_field_descriptor);
-    const std::string& key = record.values(0);
-    const std::string& value = record.values(1);
-    TF_RETURN_IF_ERROR(
-        ParseValueToField(key_descriptor, key, map_field_message));
-    TF_RETURN_IF_ERROR(
-        ParseValueToField(value_descriptor, value, map_field_message));
+// Parses the property in the row `row` of a TypedRecordSet, whose columns
+// starting from `first_column` are (key, is_custom_property, int_value,
+// double_value, string_value), and sets the property in the node.
+template <typename Node>
+void ParseTypedPropertyRecordToNode(const TypedRecordSet& record_set,
+                                    const int row, const int first_column,
+                                    Node* node) {
+  const absl::string_view property_name =
+      record_set.GetString(row, first_column);
+  const bool is_custom_property = record_set.GetBool(row, first_column + 1);
+  auto& property_value =
+      (is_custom_property
+           ? (*node->mutable_custom_properties())[std::string(property_name)]
+           : (*node->mutable_properties())[std::string(property_name)]);
+  if (!record_set.IsNull(row, first_column + 2)) {
+    property_value.set_int_value(record_set.GetInt64(row, first_column + 2));
+  } else if (!record_set.IsNull(row, first_column + 3)) {
+    property_value.set_double_value(
+        record_set.GetDouble(row, first_column + 3));
+  } else {
+    const absl::string_view string_value =
+        record_set.GetString(row, first_column + 4);
+    property_value.set_string_value(string_value.data(), string_value.size());
   }
-
-  return tensorflow::Status::OK();
 }
 
 // Validates properties in a `Node` with the properties defined in a `Type`.
@@ -279,6 +196,50 @@ tensorflow::Status RDBMSMetadataAccessObject::CreateBasicNode(
                                   node_id);
 }
 
+// Creates Artifacts (without properties) with multi-row inserts.
+tensorflow::Status RDBMSMetadataAccessObject::CreateBasicNodes(
+    const std::vector<Artifact>& artifacts, std::vector<int64>* node_ids) {
+  return executor_->InsertArtifacts(artifacts, absl::Now(), node_ids);
+}
+
+// Creates Executions (without properties) with multi-row inserts.
+tensorflow::Status RDBMSMetadataAccessObject::CreateBasicNodes(
+    const std::vector<Execution>& executions, std::vector<int64>* node_ids) {
+  return executor_->InsertExecutions(executions, absl::Now(), node_ids);
+}
+
+// Creates Contexts (without properties) with multi-row inserts.
+tensorflow::Status RDBMSMetadataAccessObject::CreateBasicNodes(
+    const std::vector<Context>& contexts, std::vector<int64>* node_ids) {
+  for (const Context& context : contexts) {
+    if (!context.has_name() || context.name().empty()) {
+      return tensorflow::errors::InvalidArgument(
+          "Context name should not be empty");
+    }
+  }
+  return executor_->InsertContexts(contexts, absl::Now(), node_ids);
+}
+
+// Inserts the properties of created Artifacts with multi-row inserts.
+tensorflow::Status RDBMSMetadataAccessObject::InsertNodeProperties(
+    const std::vector<int64>& node_ids,
+    const std::vector<Artifact>& artifacts) {
+  return executor_->InsertArtifactProperties(node_ids, artifacts);
+}
+
+// Inserts the properties of created Executions with multi-row inserts.
+tensorflow::Status RDBMSMetadataAccessObject::InsertNodeProperties(
+    const std::vector<int64>& node_ids,
+    const std::vector<Execution>& executions) {
+  return executor_->InsertExecutionProperties(node_ids, executions);
+}
+
+// Inserts the properties of created Contexts with multi-row inserts.
+tensorflow::Status RDBMSMetadataAccessObject::InsertNodeProperties(
+    const std::vector<int64>& node_ids, const std::vector<Context>& contexts) {
+  return executor_->InsertContextProperties(node_ids, contexts);
+}
+
 // Lookup Artifact by id.
 tensorflow::Status RDBMSMetadataAccessObject::NodeLookups(
     const Artifact& artifact, RecordSet* header, RecordSet* properties) {
@@ -491,6 +452,7 @@ tensorflow::Status RDBMSMetadataAccessObject::CreateTypeImpl(const Type& type,
   if (type_properties.empty())
     LOG(WARNING) << "No property is defined for the Type";
 
+  InvalidateTypeCache();
   // insert a type and get its given id
   TF_RETURN_IF_ERROR(InsertTypeID(type, type_id));
 
@@ -540,21 +502,63 @@ tensorflow::Status RDBMSMetadataAccessObject::FindTypesFromRecordSet(
   // Query type with the given condition
   const int num_records = type_record_set.records_size();
   types->resize(num_records);
+  if (num_records == 0) return tensorflow::Status::OK();
+  std::vector<int64> type_ids;
+  type_ids.reserve(num_records);
+  absl::flat_hash_map<int64, MessageType*> type_id_to_type;
+  const RowDecoder<MessageType> decoder(type_record_set);
   for (int i = 0; i < num_records; ++i) {
     TF_RETURN_IF_ERROR(
-        ParseRecordSetToMessage(type_record_set, &types->at(i), i));
-
-    RecordSet property_record_set;
-    TF_RETURN_IF_ERROR(executor_->SelectPropertyByTypeID(types->at(i).id(),
-                                                         &property_record_set));
+        decoder.Decode(type_record_set.records(i), &types->at(i)));
+    type_ids.push_back(types->at(i).id());
+    type_id_to_type[types->at(i).id()] = &types->at(i);
+  }
 
-    TF_RETURN_IF_ERROR(ParseRecordSetToMapField(property_record_set,
-                                                "properties", &types->at(i)));
+  // Query the properties of all types at once.
+  RecordSet property_record_set;
+  TF_RETURN_IF_ERROR(
+      executor_->SelectPropertyByTypeIDs(type_ids, &property_record_set));
+  for (const RecordSet::Record& record : property_record_set.records()) {
+    int64 type_id;
+    CHECK(absl::SimpleAtoi(record.values(0), &type_id));
+    int data_type;
+    CHECK(absl::SimpleAtoi(record.values(2), &data_type));
+    auto iter = type_id_to_type.find(type_id);
+    CHECK(iter != type_id_to_type.end());
+    (*iter->second->mutable_properties())[record.values(1)] =
+        static_cast<PropertyType>(data_type);
   }
+  return tensorflow::Status::OK();
+}
 
+tensorflow::Status RDBMSMetadataAccessObject::CheckTypeCache(
+    bool* use_type_cache) {
+  const int64 transaction_id = executor_->GetTransactionId();
+  if (transaction_id != type_cache_transaction_id_) {
+    RecordSet record_set;
+    TF_RETURN_IF_ERROR(executor_->SelectTypeGeneration(&record_set));
+    std::string generation;
+    if (record_set.records_size() > 0) {
+      generation = absl::StrJoin(record_set.records(0).values(), ",");
+    }
+    if (generation != type_cache_generation_) {
+      type_cache_.Clear();
+      type_cache_generation_ = generation;
+    }
+    type_cache_transaction_id_ = transaction_id;
+    type_cache_invalidated_ = false;
+  }
+  *use_type_cache = !type_cache_invalidated_;
   return tensorflow::Status::OK();
 }
 
+void RDBMSMetadataAccessObject::InvalidateTypeCache() {
+  type_cache_.Clear();
+  type_cache_generation_.clear();
+  type_cache_transaction_id_ = executor_->GetTransactionId();
+  type_cache_invalidated_ = true;
+}
+
 // Finds a type by query conditions. Acceptable types are {ArtifactType,
 // ExecutionType, ContextType} (`MessageType`). The types can be queried by two
 // kinds of query conditions, which are type id (int64) or type
@@ -564,6 +568,12 @@ tensorflow::Status RDBMSMetadataAccessObject::FindTypesFromRecordSet(
 template <typename QueryCondition, typename MessageType>
 tensorflow::Status RDBMSMetadataAccessObject::FindTypeImpl(
     const QueryCondition condition, MessageType* type) {
+  bool use_type_cache;
+  TF_RETURN_IF_ERROR(CheckTypeCache(&use_type_cache));
+  if (use_type_cache && type_cache_.Find(condition, type)) {
+    return tensorflow::Status::OK();
+  }
+
   const TypeKind type_kind = ResolveTypeKind(type);
   RecordSet record_set;
   TF_RETURN_IF_ERROR(RunFindTypeByID(condition, type_kind, &record_set));
@@ -574,6 +584,7 @@ tensorflow::Status RDBMSMetadataAccessObject::FindTypeImpl(
     return tensorflow::errors::NotFound(
         absl::StrCat("No type found for query: ", condition));
   }
+  if (use_type_cache) type_cache_.Insert(types[0]);
   *type = std::move(types[0]);
   return tensorflow::Status::OK();
 }
@@ -591,6 +602,34 @@ tensorflow::Status RDBMSMetadataAccessObject::FindAllTypeInstancesImpl(
   return FindTypesFromRecordSet(record_set, types);
 }
 
+// Finds types of the type `MessageType` by a collection of ids, and appends
+// the found ones to `types` in the order of `type_ids`.
+// Returns detailed INTERNAL error, if query execution fails.
+template <typename MessageType>
+tensorflow::Status RDBMSMetadataAccessObject::FindTypesImpl(
+    const std::vector<int64>& type_ids, std::vector<MessageType>* types) {
+  if (type_ids.empty()) return tensorflow::Status::OK();
+  MessageType type;
+  const TypeKind type_kind = ResolveTypeKind(&type);
+  RecordSet record_set;
+  TF_RETURN_IF_ERROR(
+      executor_->SelectTypesByID(type_ids, type_kind, &record_set));
+  std::vector<MessageType> found_types;
+  TF_RETURN_IF_ERROR(FindTypesFromRecordSet(record_set, &found_types));
+
+  absl::flat_hash_map<int64, const MessageType*> type_id_to_type;
+  for (const MessageType& found_type : found_types) {
+    type_id_to_type[found_type.id()] = &found_type;
+  }
+  for (const int64 type_id : type_ids) {
+    auto iter = type_id_to_type.find(type_id);
+    if (iter != type_id_to_type.end()) {
+      types->push_back(*iter->second);
+    }
+  }
+  return tensorflow::Status::OK();
+}
+
 // Updates an existing type. A type is one of {ArtifactType, ExecutionType,
 // ContextType}
 // Returns INVALID_ARGUMENT error, if name field is not given.
@@ -603,6 +642,7 @@ tensorflow::Status RDBMSMetadataAccessObject::UpdateTypeImpl(const Type& type) {
   if (!type.has_name()) {
     return tensorflow::errors::InvalidArgument("No type name is specified.");
   }
+  InvalidateTypeCache();
   // find the current stored type and validate the id.
   Type stored_type;
   TF_RETURN_IF_ERROR(FindTypeImpl(type.name(), &stored_type));
@@ -674,6 +714,44 @@ tensorflow::Status RDBMSMetadataAccessObject::CreateNodeImpl(const Node& node,
   return tensorflow::Status::OK();
 }
 
+// Creates a collection of `Node`s, which are one of {`Artifact`, `Execution`,
+// `Context`}, then returns the assigned node ids in the order of `nodes`. The
+// nodes' id fields are ignored. All nodes are validated against their
+// `NodeType`s first, then the nodes and all their properties are inserted with
+// a few multi-row inserts, instead of a few queries per node.
+// Returns INVALID_ARGUMENT error, if any node does not align with its type.
+// Returns detailed INTERNAL error, if query execution fails.
+template <typename Node, typename NodeType>
+tensorflow::Status RDBMSMetadataAccessObject::CreateNodesImpl(
+    const std::vector<Node>& nodes, std::vector<int64>* node_ids) {
+  node_ids->clear();
+  // validate types and properties, looking up each type once
+  absl::flat_hash_map<int64, NodeType> node_types;
+  for (const Node& node : nodes) {
+    if (!node.has_type_id())
+      return tensorflow::errors::InvalidArgument("Type id is missing.");
+    auto node_type_it = node_types.find(node.type_id());
+    if (node_type_it == node_types.end()) {
+      NodeType node_type;
+      TF_RETURN_IF_ERROR(FindTypeImpl(node.type_id(), &node_type));
+      node_type_it =
+          node_types.insert({node.type_id(), std::move(node_type)}).first;
+    }
+    TF_RETURN_IF_ERROR(ValidatePropertiesWithType(node, node_type_it->second));
+  }
+
+  // insert the nodes and get the assigned ids
+  TF_RETURN_IF_ERROR(CreateBasicNodes(nodes, node_ids));
+  if (node_ids->size() != nodes.size()) {
+    return tensorflow::errors::Internal(
+        absl::StrCat("Expected ", nodes.size(), " inserted node ids, got ",
+                     node_ids->size()));
+  }
+
+  // insert properties
+  return InsertNodeProperties(*node_ids, nodes);
+}
+
 // Queries a `Node` which is one of {`Artifact`, `Execution`, `Context`} by
 // an id.
 // Returns NOT_FOUND error, if the given id cannot be found.
@@ -692,7 +770,8 @@ tensorflow::Status RDBMSMetadataAccessObject::FindNodeImpl(const int64 node_id,
     return tensorflow::errors::NotFound(
         absl::StrCat("Cannot find record by given id ", node_id));
 
-  TF_RETURN_IF_ERROR(ParseRecordSetToMessage(node_record_set, node));
+  TF_RETURN_IF_ERROR(RowDecoder<Node>(node_record_set)
+                         .Decode(node_record_set.records(0), node));
 
   // it is ok that there is no property associated with a node
   if (properties_record_set.records_size() == 0)
@@ -700,26 +779,83 @@ tensorflow::Status RDBMSMetadataAccessObject::FindNodeImpl(const int64 node_id,
   // if there are properties associated with the node, parse the returned values
   CHECK_EQ(properties_record_set.column_names_size(), 5);
   for (const RecordSet::Record& record : properties_record_set.records()) {
-    const std::string& property_name = record.values(0);
-    bool is_custom_property;
-    CHECK(absl::SimpleAtob(record.values(1), &is_custom_property));
-    auto& property_value =
-        (is_custom_property
-             ? (*node->mutable_custom_properties())[property_name]
-             : (*node->mutable_properties())[property_name]);
-    if (record.values(2) != kMetadataSourceNull) {
-      int64 int_value;
-      CHECK(absl::SimpleAtoi(record.values(2), &int_value));
-      property_value.set_int_value(int_value);
-    } else if (record.values(3) != kMetadataSourceNull) {
-      double double_value;
-      CHECK(absl::SimpleAtod(record.values(3), &double_value));
-      property_value.set_double_value(double_value);
-    } else {
-      const std::string& string_value = record.values(4);
-      property_value.set_string_value(string_value);
+    ParsePropertyRecordToNode(record, /*first_column=*/0, node);
+  }
+  return tensorflow::Status::OK();
+}
+
+// Queries `Node`s which are one of {`Artifact`, `Execution`, `Context`} by
+// a collection of ids. The headers and the properties of all nodes are fetched
+// with one query each (per chunk of ids), and the nodes are appended to
+// `nodes` in the order of `node_ids`. Duplicated ids are returned once.
+// Returns NOT_FOUND error, if any of the given ids cannot be found.
+// Returns detailed INTERNAL error, if query execution fails.
+template <typename Node>
+tensorflow::Status RDBMSMetadataAccessObject::FindNodesImpl(
+    const std::vector<int64>& node_ids, std::vector<Node>* nodes) {
+  const int first_index = nodes->size();
+  absl::flat_hash_map<int64, int> node_id_to_index;
+  std::vector<int64> unique_node_ids;
+  unique_node_ids.reserve(node_ids.size());
+  for (const int64 node_id : node_ids) {
+    if (node_id_to_index.insert({node_id, first_index + unique_node_ids.size()})
+            .second) {
+      unique_node_ids.push_back(node_id);
     }
   }
+  if (unique_node_ids.empty()) return tensorflow::Status::OK();
+
+  TypedRecordSet node_record_set;
+  TypedRecordSet properties_record_set;
+  if (std::is_same<Node, Artifact>::value) {
+    TF_RETURN_IF_ERROR(
+        executor_->SelectArtifactsByID(unique_node_ids, &node_record_set));
+    TF_RETURN_IF_ERROR(executor_->SelectArtifactPropertyByArtifactIDs(
+        unique_node_ids, &properties_record_set));
+  } else if (std::is_same<Node, Execution>::value) {
+    TF_RETURN_IF_ERROR(
+        executor_->SelectExecutionsByID(unique_node_ids, &node_record_set));
+    TF_RETURN_IF_ERROR(executor_->SelectExecutionPropertyByExecutionIDs(
+        unique_node_ids, &properties_record_set));
+  } else if (std::is_same<Node, Context>::value) {
+    TF_RETURN_IF_ERROR(
+        executor_->SelectContextsByID(unique_node_ids, &node_record_set));
+    TF_RETURN_IF_ERROR(executor_->SelectContextPropertyByContextIDs(
+        unique_node_ids, &properties_record_set));
+  } else {
+    return tensorflow::errors::InvalidArgument(
+        "Invalid Node passed to FindNodesImpl");
+  }
+
+  if (node_record_set.num_rows() != unique_node_ids.size()) {
+    absl::flat_hash_set<int64> found_node_ids;
+    for (int i = 0; i < node_record_set.num_rows(); i++) {
+      found_node_ids.insert(node_record_set.GetInt64(i, /*column=*/0));
+    }
+    for (const int64 node_id : unique_node_ids) {
+      if (!found_node_ids.contains(node_id)) {
+        return tensorflow::errors::NotFound(
+            absl::StrCat("Cannot find record by given id ", node_id));
+      }
+    }
+  }
+
+  nodes->resize(first_index + unique_node_ids.size());
+  const RowDecoder<Node> decoder(node_record_set);
+  for (int i = 0; i < node_record_set.num_rows(); i++) {
+    const int64 node_id = node_record_set.GetInt64(i, /*column=*/0);
+    Node* node = &(*nodes)[node_id_to_index.at(node_id)];
+    TF_RETURN_IF_ERROR(decoder.Decode(node_record_set, i, node));
+  }
+
+  if (properties_record_set.num_rows() == 0) return tensorflow::Status::OK();
+  CHECK_EQ(properties_record_set.num_columns(), 6);
+  for (int i = 0; i < properties_record_set.num_rows(); i++) {
+    const int64 node_id = properties_record_set.GetInt64(i, /*column=*/0);
+    ParseTypedPropertyRecordToNode(properties_record_set, i,
+                                   /*first_column=*/1,
+                                   &(*nodes)[node_id_to_index.at(node_id)]);
+  }
   return tensorflow::Status::OK();
 }
 
@@ -729,14 +865,14 @@ tensorflow::Status RDBMSMetadataAccessObject::FindManyNodesImpl(
     const RecordSet& record_set, std::vector<Node>* nodes) {
   if (record_set.records_size() == 0)
     return tensorflow::errors::NotFound(absl::StrCat("Cannot find any record"));
-  nodes->reserve(record_set.records_size());
+  std::vector<int64> node_ids;
+  node_ids.reserve(record_set.records_size());
   for (const RecordSet::Record& record : record_set.records()) {
     int64 node_id;
     CHECK(absl::SimpleAtoi(record.values(0), &node_id));
-    nodes->push_back(Node());
-    TF_RETURN_IF_ERROR(FindNodeImpl<Node>(node_id, &nodes->back()));
+    node_ids.push_back(node_id);
   }
-  return tensorflow::Status::OK();
+  return FindNodesImpl(node_ids, nodes);
 }
 
 // Updates a `Node` which is one of {`Artifact`, `Execution`, `Context`}.
@@ -798,7 +934,11 @@ tensorflow::Status RDBMSMetadataAccessObject::FindEventsFromRecordSet(
     return tensorflow::errors::InvalidArgument("Given events is NULL.");
 
   events->reserve(event_record_set.records_size());
-  TF_RETURN_IF_ERROR(ParseRecordSetToMessageArray(event_record_set, events));
+  const RowDecoder<Event> decoder(event_record_set);
+  for (const RecordSet::Record& record : event_record_set.records()) {
+    events->push_back(Event());
+    TF_RETURN_IF_ERROR(decoder.Decode(record, &events->back()));
+  }
 
   absl::flat_hash_map<int64, Event*> event_id_to_event_map;
   std::vector<int64> event_ids;
@@ -856,16 +996,15 @@ tensorflow::Status RDBMSMetadataAccessObject::FindContextsByNodeImpl(
         executor_->SelectAssociationByExecutionID(node_id, &node_ids));
   }
 
-  contexts->clear();
+  std::vector<int64> context_ids;
+  context_ids.reserve(node_ids.records_size());
   for (const RecordSet::Record& record : node_ids.records()) {
-    contexts->push_back(Context());
-    Context& curr_context = contexts->back();
-    TF_RETURN_IF_ERROR(
-        ParseValueToField(curr_context.descriptor()->FindFieldByName("id"),
-                          record.values(1), &curr_context));
-    TF_RETURN_IF_ERROR(FindNodeImpl(curr_context.id(), &curr_context));
+    int64 context_id;
+    CHECK(absl::SimpleAtoi(record.values(1), &context_id));
+    context_ids.push_back(context_id);
   }
-  return tensorflow::Status::OK();
+  contexts->clear();
+  return FindNodesImpl(context_ids, contexts);
 }
 
 // Queries nodes related to a context. Node is either `Artifact` or `Execution`.
@@ -888,16 +1027,15 @@ tensorflow::Status RDBMSMetadataAccessObject::FindNodesByContextImpl(
         executor_->SelectAssociationByContextID(context_id, &record_set));
   }
 
-  nodes->clear();
+  std::vector<int64> node_ids;
+  node_ids.reserve(record_set.records_size());
   for (const RecordSet::Record& record : record_set.records()) {
-    nodes->push_back(Node());
-    Node& curr_node = nodes->back();
-    TF_RETURN_IF_ERROR(
-        ParseValueToField(curr_node.descriptor()->FindFieldByName("id"),
-                          record.values(2), &curr_node));
-    TF_RETURN_IF_ERROR(FindNodeImpl(curr_node.id(), &curr_node));
+    int64 node_id;
+    CHECK(absl::SimpleAtoi(record.values(2), &node_id));
+    node_ids.push_back(node_id);
   }
-  return tensorflow::Status::OK();
+  nodes->clear();
+  return FindNodesImpl(node_ids, nodes);
 }
 
 tensorflow::Status RDBMSMetadataAccessObject::CreateType(
@@ -925,6 +1063,24 @@ tensorflow::Status RDBMSMetadataAccessObject::FindTypeById(
   return FindTypeImpl(type_id, execution_type);
 }
 
+tensorflow::Status RDBMSMetadataAccessObject::FindTypesByIds(
+    const std::vector<int64>& type_ids,
+    std::vector<ArtifactType>* artifact_types) {
+  return FindTypesImpl(type_ids, artifact_types);
+}
+
+tensorflow::Status RDBMSMetadataAccessObject::FindTypesByIds(
+    const std::vector<int64>& type_ids,
+    std::vector<ExecutionType>* execution_types) {
+  return FindTypesImpl(type_ids, execution_types);
+}
+
+tensorflow::Status RDBMSMetadataAccessObject::FindTypesByIds(
+    const std::vector<int64>& type_ids,
+    std::vector<ContextType>* context_types) {
+  return FindTypesImpl(type_ids, context_types);
+}
+
 tensorflow::Status RDBMSMetadataAccessObject::FindTypes(
     std::vector<ArtifactType>* artifact_types) {
   return FindAllTypeInstancesImpl(artifact_types);
@@ -980,11 +1136,22 @@ tensorflow::Status RDBMSMetadataAccessObject::CreateArtifact(
   return CreateNodeImpl<Artifact, ArtifactType>(artifact, artifact_id);
 }
 
+tensorflow::Status RDBMSMetadataAccessObject::CreateArtifacts(
+    const std::vector<Artifact>& artifacts, std::vector<int64>* artifact_ids) {
+  return CreateNodesImpl<Artifact, ArtifactType>(artifacts, artifact_ids);
+}
+
 tensorflow::Status RDBMSMetadataAccessObject::CreateExecution(
     const Execution& execution, int64* execution_id) {
   return CreateNodeImpl<Execution, ExecutionType>(execution, execution_id);
 }
 
+tensorflow::Status RDBMSMetadataAccessObject::CreateExecutions(
+    const std::vector<Execution>& executions,
+    std::vector<int64>* execution_ids) {
+  return CreateNodesImpl<Execution, ExecutionType>(executions, execution_ids);
+}
+
 tensorflow::Status RDBMSMetadataAccessObject::CreateContext(
     const Context& context, int64* context_id) {
   tensorflow::Status status =
@@ -997,16 +1164,47 @@ tensorflow::Status RDBMSMetadataAccessObject::CreateContext(
   return status;
 }
 
+tensorflow::Status RDBMSMetadataAccessObject::CreateContexts(
+    const std::vector<Context>& contexts, std::vector<int64>* context_ids) {
+  tensorflow::Status status =
+      CreateNodesImpl<Context, ContextType>(contexts, context_ids);
+  if (absl::StrContains(status.error_message(), "Duplicate") ||
+      absl::StrContains(status.error_message(), "UNIQUE")) {
+    return tensorflow::errors::AlreadyExists(
+        "Some of the given nodes already exist: ", status);
+  }
+  return status;
+}
+
 tensorflow::Status RDBMSMetadataAccessObject::FindArtifactById(
     const int64 artifact_id, Artifact* artifact) {
   return FindNodeImpl(artifact_id, artifact);
 }
 
+tensorflow::Status RDBMSMetadataAccessObject::FindArtifactsById(
+    const std::vector<int64>& artifact_ids, std::vector<Artifact>* artifacts) {
+  if (artifacts == nullptr) {
+    return tensorflow::errors::InvalidArgument("Given artifacts is NULL.");
+  }
+  artifacts->clear();
+  return FindNodesImpl(artifact_ids, artifacts);
+}
+
 tensorflow::Status RDBMSMetadataAccessObject::FindExecutionById(
     const int64 execution_id, Execution* execution) {
   return FindNodeImpl(execution_id, execution);
 }
 
+tensorflow::Status RDBMSMetadataAccessObject::FindExecutionsById(
+    const std::vector<int64>& execution_ids,
+    std::vector<Execution>* executions) {
+  if (executions == nullptr) {
+    return tensorflow::errors::InvalidArgument("Given executions is NULL.");
+  }
+  executions->clear();
+  return FindNodesImpl(execution_ids, executions);
+}
+
 tensorflow::Status RDBMSMetadataAccessObject::FindContextById(
     const int64 context_id, Context* context) {
   return FindNodeImpl(context_id, context);
@@ -1067,6 +1265,66 @@ tensorflow::Status RDBMSMetadataAccessObject::CreateEvent(const Event& event,
   return tensorflow::Status::OK();
 }
 
+tensorflow::Status RDBMSMetadataAccessObject::CreateEvents(
+    const std::vector<Event>& events, std::vector<int64>* event_ids) {
+  event_ids->clear();
+  if (events.empty()) return tensorflow::Status::OK();
+  // validate the given events
+  absl::flat_hash_set<int64> artifact_ids;
+  absl::flat_hash_set<int64> execution_ids;
+  for (const Event& event : events) {
+    if (!event.has_artifact_id())
+      return tensorflow::errors::InvalidArgument(
+          "No artifact id is specified.");
+    if (!event.has_execution_id())
+      return tensorflow::errors::InvalidArgument(
+          "No execution id is specified.");
+    if (!event.has_type() || event.type() == Event::UNKNOWN)
+      return tensorflow::errors::InvalidArgument("No event type is specified.");
+    artifact_ids.insert(event.artifact_id());
+    execution_ids.insert(event.execution_id());
+  }
+  // check that the artifacts and executions exist, the first column of the
+  // records being the node id
+  const auto find_missing_id =
+      [](const absl::flat_hash_set<int64>& ids,
+         const TypedRecordSet& record_set) -> absl::optional<int64> {
+    absl::flat_hash_set<int64> found_ids;
+    for (int row = 0; row < record_set.num_rows(); row++) {
+      found_ids.insert(record_set.GetInt64(row, 0));
+    }
+    for (const int64 id : ids) {
+      if (!found_ids.contains(id)) return id;
+    }
+    return absl::nullopt;
+  };
+  TypedRecordSet artifacts;
+  TF_RETURN_IF_ERROR(executor_->SelectArtifactsByID(
+      {artifact_ids.begin(), artifact_ids.end()}, &artifacts));
+  absl::optional<int64> missing_id = find_missing_id(artifact_ids, artifacts);
+  if (missing_id)
+    return tensorflow::errors::InvalidArgument(
+        absl::StrCat("No artifact with the given id ", *missing_id));
+  TypedRecordSet executions;
+  TF_RETURN_IF_ERROR(executor_->SelectExecutionsByID(
+      {execution_ids.begin(), execution_ids.end()}, &executions));
+  missing_id = find_missing_id(execution_ids, executions);
+  if (missing_id)
+    return tensorflow::errors::InvalidArgument(
+        absl::StrCat("No execution with the given id ", *missing_id));
+
+  // insert the events and get the assigned ids
+  TF_RETURN_IF_ERROR(executor_->InsertEvents(events, absl::Now(), event_ids));
+  if (event_ids->size() != events.size()) {
+    return tensorflow::errors::Internal(
+        absl::StrCat("Expected ", events.size(), " inserted event ids, got ",
+                     event_ids->size()));
+  }
+
+  // insert event paths
+  return executor_->InsertEventPaths(*event_ids, events);
+}
+
 tensorflow::Status RDBMSMetadataAccessObject::FindEventsByArtifacts(
     const std::vector<int64>& artifact_ids, std::vector<Event>* events) {
   if (events == nullptr) {
@@ -1105,6 +1363,74 @@ tensorflow::Status RDBMSMetadataAccessObject::FindEventsByExecutions(
   return FindEventsFromRecordSet(event_record_set, events);
 }
 
+tensorflow::Status RDBMSMetadataAccessObject::FindEventsByIdRange(
+    const int64 min_event_id, const int64 max_event_id,
+    std::vector<int64>* event_ids, std::vector<Event>* events) {
+  if (event_ids == nullptr || events == nullptr) {
+    return tensorflow::errors::InvalidArgument("Given array is NULL.");
+  }
+  RecordSet event_record_set;
+  TF_RETURN_IF_ERROR(executor_->SelectEventsByIDRange(
+      min_event_id, max_event_id, &event_record_set));
+  event_ids->clear();
+  events->clear();
+  event_ids->reserve(event_record_set.records_size());
+  events->reserve(event_record_set.records_size());
+  const RowDecoder<Event> decoder(event_record_set);
+  for (const RecordSet::Record& record : event_record_set.records()) {
+    int64 event_id;
+    CHECK(absl::SimpleAtoi(record.values(0), &event_id));
+    event_ids->push_back(event_id);
+    events->push_back(Event());
+    TF_RETURN_IF_ERROR(decoder.Decode(record, &events->back()));
+  }
+  return tensorflow::Status::OK();
+}
+
+tensorflow::Status RDBMSMetadataAccessObject::FindEventsById(
+    const std::vector<int64>& event_ids, std::vector<Event>* events) {
+  if (events == nullptr) {
+    return tensorflow::errors::InvalidArgument("Given events is NULL.");
+  }
+  events->clear();
+  if (event_ids.empty()) return tensorflow::Status::OK();
+  RecordSet event_record_set;
+  TF_RETURN_IF_ERROR(executor_->SelectEventsByID(event_ids, &event_record_set));
+  std::vector<Event> found_events;
+  if (event_record_set.records_size() > 0) {
+    TF_RETURN_IF_ERROR(
+        FindEventsFromRecordSet(event_record_set, &found_events));
+  }
+  absl::flat_hash_map<int64, const Event*> event_id_to_event_map;
+  for (int i = 0; i < event_record_set.records_size(); ++i) {
+    int64 event_id;
+    CHECK(absl::SimpleAtoi(event_record_set.records(i).values(0), &event_id));
+    event_id_to_event_map[event_id] = &found_events[i];
+  }
+  events->reserve(event_ids.size());
+  for (const int64 event_id : event_ids) {
+    const auto it = event_id_to_event_map.find(event_id);
+    if (it == event_id_to_event_map.end()) {
+      return tensorflow::errors::NotFound("Cannot find the event with id ",
+                                          event_id);
+    }
+    events->push_back(*it->second);
+  }
+  return tensorflow::Status::OK();
+}
+
+tensorflow::Status RDBMSMetadataAccessObject::FindMaxEventId(
+    int64* max_event_id) {
+  RecordSet record_set;
+  TF_RETURN_IF_ERROR(executor_->SelectMaxEventID(&record_set));
+  *max_event_id = 0;
+  if (record_set.records_size() > 0 &&
+      record_set.records(0).values(0) != kMetadataSourceNull) {
+    CHECK(absl::SimpleAtoi(record_set.records(0).values(0), max_event_id));
+  }
+  return tensorflow::Status::OK();
+}
+
 tensorflow::Status RDBMSMetadataAccessObject::CreateAssociation(
     const Association& association, int64* association_id) {
   if (!association.has_context_id())
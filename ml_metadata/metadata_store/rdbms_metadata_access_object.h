@@ -21,6 +21,7 @@ limitations under the License.
 #include "ml_metadata/metadata_store/metadata_access_object.h"
 #include "ml_metadata/metadata_store/metadata_source.h"
 #include "ml_metadata/metadata_store/query_executor.h"
+#include "ml_metadata/metadata_store/type_cache.h"
 #include "ml_metadata/proto/metadata_source.pb.h"
 #include "ml_metadata/proto/metadata_store.pb.h"
 #include "tensorflow/core/lib/core/status.h"
@@ -53,6 +54,7 @@ class RDBMSMetadataAccessObject : public MetadataAccessObject {
   // the MetadataSource is dropped.
   // Returns detailed INTERNAL error, if query execution fails.
   tensorflow::Status InitMetadataSource() final {
+    InvalidateTypeCache();
     return executor_->InitMetadataSource();
   }
 
@@ -66,6 +68,7 @@ class RDBMSMetadataAccessObject : public MetadataAccessObject {
   // Returns detailed INTERNAL error, if create schema query execution fails.
   tensorflow::Status InitMetadataSourceIfNotExists(
       bool enable_upgrade_migration = false) final {
+    InvalidateTypeCache();
     return executor_->InitMetadataSourceIfNotExists(enable_upgrade_migration);
   }
 
@@ -76,6 +79,7 @@ class RDBMSMetadataAccessObject : public MetadataAccessObject {
   //   library version.
   // Returns detailed INTERNAL error, if query execution fails.
   tensorflow::Status DowngradeMetadataSource(int64 to_schema_version) final {
+    InvalidateTypeCache();
     return executor_->DowngradeMetadataSource(to_schema_version);
   }
 
@@ -95,6 +99,16 @@ class RDBMSMetadataAccessObject : public MetadataAccessObject {
   tensorflow::Status FindTypeById(int64 type_id,
                                   ContextType* context_type) final;
 
+  tensorflow::Status FindTypesByIds(
+      const std::vector<int64>& type_ids,
+      std::vector<ArtifactType>* artifact_types) final;
+  tensorflow::Status FindTypesByIds(
+      const std::vector<int64>& type_ids,
+      std::vector<ExecutionType>* execution_types) final;
+  tensorflow::Status FindTypesByIds(
+      const std::vector<int64>& type_ids,
+      std::vector<ContextType>* context_types) final;
+
   tensorflow::Status FindTypeByName(absl::string_view name,
                                     ArtifactType* artifact_type) final;
   tensorflow::Status FindTypeByName(absl::string_view name,
@@ -110,9 +124,15 @@ class RDBMSMetadataAccessObject : public MetadataAccessObject {
   tensorflow::Status CreateArtifact(const Artifact& artifact,
                                     int64* artifact_id) final;
 
+  tensorflow::Status CreateArtifacts(const std::vector<Artifact>& artifacts,
+                                     std::vector<int64>* artifact_ids) final;
+
   tensorflow::Status FindArtifactById(int64 artifact_id,
                                       Artifact* artifact) final;
 
+  tensorflow::Status FindArtifactsById(const std::vector<int64>& artifact_ids,
+                                       std::vector<Artifact>* artifacts) final;
+
   tensorflow::Status FindArtifacts(std::vector<Artifact>* artifacts) final;
 
   tensorflow::Status ListArtifacts(const ListOperationOptions& options,
@@ -141,9 +161,16 @@ class RDBMSMetadataAccessObject : public MetadataAccessObject {
   tensorflow::Status CreateExecution(const Execution& execution,
                                      int64* execution_id) final;
 
+  tensorflow::Status CreateExecutions(const std::vector<Execution>& executions,
+                                      std::vector<int64>* execution_ids) final;
+
   tensorflow::Status FindExecutionById(int64 execution_id,
                                        Execution* execution) final;
 
+  tensorflow::Status FindExecutionsById(
+      const std::vector<int64>& execution_ids,
+      std::vector<Execution>* executions) final;
+
   tensorflow::Status FindExecutions(std::vector<Execution>* executions) final;
 
   tensorflow::Status FindExecutionByTypeIdAndExecutionName(
@@ -157,6 +184,9 @@ class RDBMSMetadataAccessObject : public MetadataAccessObject {
   tensorflow::Status CreateContext(const Context& context,
                                    int64* context_id) final;
 
+  tensorflow::Status CreateContexts(const std::vector<Context>& contexts,
+                                    std::vector<int64>* context_ids) final;
+
   tensorflow::Status FindContextById(int64 context_id, Context* context) final;
 
   tensorflow::Status FindContexts(std::vector<Context>* contexts) final;
@@ -172,6 +202,9 @@ class RDBMSMetadataAccessObject : public MetadataAccessObject {
 
   tensorflow::Status CreateEvent(const Event& event, int64* event_id) final;
 
+  tensorflow::Status CreateEvents(const std::vector<Event>& events,
+                                  std::vector<int64>* event_ids) final;
+
   tensorflow::Status FindEventsByArtifacts(
       const std::vector<int64>& artifact_ids, std::vector<Event>* events) final;
 
@@ -179,6 +212,16 @@ class RDBMSMetadataAccessObject : public MetadataAccessObject {
       const std::vector<int64>& execution_ids,
       std::vector<Event>* events) final;
 
+  tensorflow::Status FindEventsByIdRange(int64 min_event_id,
+                                         int64 max_event_id,
+                                         std::vector<int64>* event_ids,
+                                         std::vector<Event>* events) final;
+
+  tensorflow::Status FindEventsById(const std::vector<int64>& event_ids,
+                                    std::vector<Event>* events) final;
+
+  tensorflow::Status FindMaxEventId(int64* max_event_id) final;
+
   tensorflow::Status CreateAssociation(const Association& association,
                                        int64* association_id) final;
 
@@ -216,6 +259,32 @@ class RDBMSMetadataAccessObject : public MetadataAccessObject {
   // Creates a Context (without properties).
   tensorflow::Status CreateBasicNode(const Context& context, int64* node_id);
 
+  // Creates Artifacts (without properties) with multi-row inserts.
+  tensorflow::Status CreateBasicNodes(const std::vector<Artifact>& artifacts,
+                                      std::vector<int64>* node_ids);
+
+  // Creates Executions (without properties) with multi-row inserts.
+  tensorflow::Status CreateBasicNodes(const std::vector<Execution>& executions,
+                                      std::vector<int64>* node_ids);
+
+  // Creates Contexts (without properties) with multi-row inserts.
+  tensorflow::Status CreateBasicNodes(const std::vector<Context>& contexts,
+                                      std::vector<int64>* node_ids);
+
+  // Inserts the properties of created Artifacts with multi-row inserts.
+  tensorflow::Status InsertNodeProperties(
+      const std::vector<int64>& node_ids,
+      const std::vector<Artifact>& artifacts);
+
+  // Inserts the properties of created Executions with multi-row inserts.
+  tensorflow::Status InsertNodeProperties(
+      const std::vector<int64>& node_ids,
+      const std::vector<Execution>& executions);
+
+  // Inserts the properties of created Contexts with multi-row inserts.
+  tensorflow::Status InsertNodeProperties(
+      const std::vector<int64>& node_ids, const std::vector<Context>& contexts);
+
   // Lookup Artifact by id.
   tensorflow::Status NodeLookups(const Artifact& artifact, RecordSet* header,
                                  RecordSet* properties);
@@ -323,6 +392,13 @@ class RDBMSMetadataAccessObject : public MetadataAccessObject {
   template <typename MessageType>
   tensorflow::Status FindAllTypeInstancesImpl(std::vector<MessageType>* types);
 
+  // Finds types of the type `MessageType` by a collection of ids, and appends
+  // the found ones to `types` in the order of `type_ids`.
+  // Returns detailed INTERNAL error, if query execution fails.
+  template <typename MessageType>
+  tensorflow::Status FindTypesImpl(const std::vector<int64>& type_ids,
+                                   std::vector<MessageType>* types);
+
   // Updates an existing type. A type is one of {ArtifactType, ExecutionType,
   // ContextType}
   // Returns INVALID_ARGUMENT error, if name field is not given.
@@ -342,6 +418,16 @@ class RDBMSMetadataAccessObject : public MetadataAccessObject {
   template <typename Node, typename NodeType>
   tensorflow::Status CreateNodeImpl(const Node& node, int64* node_id);
 
+  // Creates a collection of `Node`s, which are one of {`Artifact`,
+  // `Execution`, `Context`}, then returns the assigned node ids in the order of
+  // `nodes`. The nodes and their properties are inserted with multi-row
+  // inserts, after all nodes are validated against their `NodeType`s.
+  // Returns INVALID_ARGUMENT error, if any node does not align with its type.
+  // Returns detailed INTERNAL error, if query execution fails.
+  template <typename Node, typename NodeType>
+  tensorflow::Status CreateNodesImpl(const std::vector<Node>& nodes,
+                                     std::vector<int64>* node_ids);
+
   // Queries a `Node` which is one of {`Artifact`, `Execution`, `Context`} by
   // an id.
   // Returns NOT_FOUND error, if the given id cannot be found.
@@ -349,6 +435,15 @@ class RDBMSMetadataAccessObject : public MetadataAccessObject {
   template <typename Node>
   tensorflow::Status FindNodeImpl(const int64 node_id, Node* node);
 
+  // Queries `Node`s which are one of {`Artifact`, `Execution`, `Context`} by
+  // a collection of ids, and appends them to `nodes` in the order of
+  // `node_ids`. The nodes and their properties are fetched in batches.
+  // Returns NOT_FOUND error, if any of the given ids cannot be found.
+  // Returns detailed INTERNAL error, if query execution fails.
+  template <typename Node>
+  tensorflow::Status FindNodesImpl(const std::vector<int64>& node_ids,
+                                   std::vector<Node>* nodes);
+
   // Find nodes by ID, where the IDs are encoded in a record set.
   template <typename Node>
   tensorflow::Status FindManyNodesImpl(const RecordSet& record_set,
@@ -399,7 +494,29 @@ class RDBMSMetadataAccessObject : public MetadataAccessObject {
                                std::vector<Node>* nodes,
                                std::string* next_page_token);
 
+  // Checks whether type_cache_ can be used in the current transaction. At the
+  // first call in a transaction, the cache is cleared if the types were
+  // changed by any connection since it was filled, which is detected by the
+  // generation of the types. The cache cannot be used in the transactions
+  // that change types, as the changes may be rolled back.
+  // Returns detailed INTERNAL error, if query execution fails.
+  tensorflow::Status CheckTypeCache(bool* use_type_cache);
+
+  // Clears type_cache_ and stops using it until the end of the current
+  // transaction. It is called before the types or the schema are changed.
+  void InvalidateTypeCache();
+
   std::unique_ptr<QueryExecutor> executor_;
+
+  // The types read in the earlier transactions, which are reused when creating
+  // and updating nodes. See CheckTypeCache.
+  TypeCache type_cache_;
+  // The generation of the types in type_cache_.
+  std::string type_cache_generation_;
+  // The last transaction in which type_cache_ was checked or invalidated.
+  int64 type_cache_transaction_id_ = -1;
+  // Whether type_cache_ is invalidated in type_cache_transaction_id_.
+  bool type_cache_invalidated_ = false;
 };
 
 }  // namespace ml_metadata
@@ -0,0 +1,224 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "ml_metadata/metadata_store/row_decoder.h"
+
+#include <string>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace ml_metadata {
+namespace {
+
+template <typename MessageType>
+constexpr ColumnBinder<MessageType> Int64Column(
+    const char* column_name, void (*set_int64)(int64, MessageType*)) {
+  return {column_name, set_int64, nullptr, nullptr};
+}
+
+template <typename MessageType>
+constexpr ColumnBinder<MessageType> StringColumn(
+    const char* column_name,
+    void (*set_string)(absl::string_view, MessageType*)) {
+  return {column_name, nullptr, set_string, nullptr};
+}
+
+template <typename MessageType>
+constexpr ColumnBinder<MessageType> MessageColumn(
+    const char* column_name,
+    google::protobuf::Message* (*mutable_message)(MessageType*)) {
+  return {column_name, nullptr, nullptr, mutable_message};
+}
+
+}  // namespace
+
+template <>
+absl::Span<const ColumnBinder<Artifact>> GetColumnBinders<Artifact>() {
+  static const ColumnBinder<Artifact> kBinders[] = {
+      Int64Column<Artifact>("id", [](int64 v, Artifact* m) { m->set_id(v); }),
+      Int64Column<Artifact>("type_id",
+                            [](int64 v, Artifact* m) { m->set_type_id(v); }),
+      StringColumn<Artifact>("type",
+                             [](absl::string_view v, Artifact* m) {
+                               m->set_type(v.data(), v.size());
+                             }),
+      StringColumn<Artifact>("uri",
+                             [](absl::string_view v, Artifact* m) {
+                               m->set_uri(v.data(), v.size());
+                             }),
+      Int64Column<Artifact>("state",
+                            [](int64 v, Artifact* m) {
+                              if (Artifact::State_IsValid(v)) {
+                                m->set_state(static_cast<Artifact::State>(v));
+                              }
+                            }),
+      StringColumn<Artifact>("name",
+                             [](absl::string_view v, Artifact* m) {
+                               m->set_name(v.data(), v.size());
+                             }),
+      Int64Column<Artifact>("create_time_since_epoch",
+                            [](int64 v, Artifact* m) {
+                              m->set_create_time_since_epoch(v);
+                            }),
+      Int64Column<Artifact>("last_update_time_since_epoch",
+                            [](int64 v, Artifact* m) {
+                              m->set_last_update_time_since_epoch(v);
+                            }),
+  };
+  return kBinders;
+}
+
+template <>
+absl::Span<const ColumnBinder<Execution>> GetColumnBinders<Execution>() {
+  static const ColumnBinder<Execution> kBinders[] = {
+      Int64Column<Execution>("id",
+                             [](int64 v, Execution* m) { m->set_id(v); }),
+      Int64Column<Execution>("type_id",
+                             [](int64 v, Execution* m) { m->set_type_id(v); }),
+      StringColumn<Execution>("type",
+                              [](absl::string_view v, Execution* m) {
+                                m->set_type(v.data(), v.size());
+                              }),
+      Int64Column<Execution>(
+          "last_known_state",
+          [](int64 v, Execution* m) {
+            if (Execution::State_IsValid(v)) {
+              m->set_last_known_state(static_cast<Execution::State>(v));
+            }
+          }),
+      StringColumn<Execution>("name",
+                              [](absl::string_view v, Execution* m) {
+                                m->set_name(v.data(), v.size());
+                              }),
+      Int64Column<Execution>("create_time_since_epoch",
+                             [](int64 v, Execution* m) {
+                               m->set_create_time_since_epoch(v);
+                             }),
+      Int64Column<Execution>("last_update_time_since_epoch",
+                             [](int64 v, Execution* m) {
+                               m->set_last_update_time_since_epoch(v);
+                             }),
+  };
+  return kBinders;
+}
+
+template <>
+absl::Span<const ColumnBinder<Context>> GetColumnBinders<Context>() {
+  static const ColumnBinder<Context> kBinders[] = {
+      Int64Column<Context>("id", [](int64 v, Context* m) { m->set_id(v); }),
+      Int64Column<Context>("type_id",
+                           [](int64 v, Context* m) { m->set_type_id(v); }),
+      StringColumn<Context>("type",
+                            [](absl::string_view v, Context* m) {
+                              m->set_type(v.data(), v.size());
+                            }),
+      StringColumn<Context>("name",
+                            [](absl::string_view v, Context* m) {
+                              m->set_name(v.data(), v.size());
+                            }),
+      Int64Column<Context>("create_time_since_epoch",
+                           [](int64 v, Context* m) {
+                             m->set_create_time_since_epoch(v);
+                           }),
+      Int64Column<Context>("last_update_time_since_epoch",
+                           [](int64 v, Context* m) {
+                             m->set_last_update_time_since_epoch(v);
+                           }),
+  };
+  return kBinders;
+}
+
+template <>
+absl::Span<const ColumnBinder<Event>> GetColumnBinders<Event>() {
+  static const ColumnBinder<Event> kBinders[] = {
+      Int64Column<Event>("artifact_id",
+                         [](int64 v, Event* m) { m->set_artifact_id(v); }),
+      Int64Column<Event>("execution_id",
+                         [](int64 v, Event* m) { m->set_execution_id(v); }),
+      Int64Column<Event>("type",
+                         [](int64 v, Event* m) {
+                           if (Event::Type_IsValid(v)) {
+                             m->set_type(static_cast<Event::Type>(v));
+                           }
+                         }),
+      Int64Column<Event>("milliseconds_since_epoch",
+                         [](int64 v, Event* m) {
+                           m->set_milliseconds_since_epoch(v);
+                         }),
+  };
+  return kBinders;
+}
+
+template <>
+absl::Span<const ColumnBinder<ArtifactType>> GetColumnBinders<ArtifactType>() {
+  static const ColumnBinder<ArtifactType> kBinders[] = {
+      Int64Column<ArtifactType>(
+          "id", [](int64 v, ArtifactType* m) { m->set_id(v); }),
+      StringColumn<ArtifactType>("name",
+                                 [](absl::string_view v, ArtifactType* m) {
+                                   m->set_name(v.data(), v.size());
+                                 }),
+  };
+  return kBinders;
+}
+
+template <>
+absl::Span<const ColumnBinder<ExecutionType>>
+GetColumnBinders<ExecutionType>() {
+  static const ColumnBinder<ExecutionType> kBinders[] = {
+      Int64Column<ExecutionType>(
+          "id", [](int64 v, ExecutionType* m) { m->set_id(v); }),
+      StringColumn<ExecutionType>("name",
+                                  [](absl::string_view v, ExecutionType* m) {
+                                    m->set_name(v.data(), v.size());
+                                  }),
+      MessageColumn<ExecutionType>(
+          "input_type",
+          [](ExecutionType* m) -> google::protobuf::Message* {
+            return m->mutable_input_type();
+          }),
+      MessageColumn<ExecutionType>(
+          "output_type",
+          [](ExecutionType* m) -> google::protobuf::Message* {
+            return m->mutable_output_type();
+          }),
+  };
+  return kBinders;
+}
+
+template <>
+absl::Span<const ColumnBinder<ContextType>> GetColumnBinders<ContextType>() {
+  static const ColumnBinder<ContextType> kBinders[] = {
+      Int64Column<ContextType>("id",
+                               [](int64 v, ContextType* m) { m->set_id(v); }),
+      StringColumn<ContextType>("name",
+                                [](absl::string_view v, ContextType* m) {
+                                  m->set_name(v.data(), v.size());
+                                }),
+  };
+  return kBinders;
+}
+
+tensorflow::Status ParseSerializedMessage(absl::string_view serialized_message,
+                                          google::protobuf::Message* message) {
+  if (!message->ParseFromArray(serialized_message.data(),
+                               serialized_message.size())) {
+    return tensorflow::errors::Internal(
+        absl::StrCat("Failed to parse proto: ", message->GetTypeName()));
+  }
+  return tensorflow::Status::OK();
+}
+
+}  // namespace ml_metadata
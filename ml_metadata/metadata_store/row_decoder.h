@@ -0,0 +1,164 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef ML_METADATA_METADATA_STORE_ROW_DECODER_H_
+#define ML_METADATA_METADATA_STORE_ROW_DECODER_H_
+
+#include <vector>
+
+#include "google/protobuf/message.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "ml_metadata/metadata_store/constants.h"
+#include "ml_metadata/metadata_store/typed_record_set.h"
+#include "ml_metadata/metadata_store/types.h"
+#include "ml_metadata/proto/metadata_source.pb.h"
+#include "ml_metadata/proto/metadata_store.pb.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace ml_metadata {
+
+// Binds a column of a query result to the field of MessageType with the same
+// name as the column. The field is set with its generated accessors: exactly
+// one of the setters is set, according to the field type.
+template <typename MessageType>
+struct ColumnBinder {
+  const char* column_name;
+  // Sets an int64 or an enum field.
+  void (*set_int64)(int64 value, MessageType* message);
+  void (*set_string)(absl::string_view value, MessageType* message);
+  // Returns a message field, which is parsed from the serialized proto of the
+  // column.
+  google::protobuf::Message* (*mutable_message)(MessageType* message);
+};
+
+// Returns the column binders of MessageType, one per scalar field. It is
+// specialized for Artifact, Execution, Context, Event, ArtifactType,
+// ExecutionType and ContextType.
+template <typename MessageType>
+absl::Span<const ColumnBinder<MessageType>> GetColumnBinders();
+
+template <>
+absl::Span<const ColumnBinder<Artifact>> GetColumnBinders<Artifact>();
+template <>
+absl::Span<const ColumnBinder<Execution>> GetColumnBinders<Execution>();
+template <>
+absl::Span<const ColumnBinder<Context>> GetColumnBinders<Context>();
+template <>
+absl::Span<const ColumnBinder<Event>> GetColumnBinders<Event>();
+template <>
+absl::Span<const ColumnBinder<ArtifactType>> GetColumnBinders<ArtifactType>();
+template <>
+absl::Span<const ColumnBinder<ExecutionType>>
+GetColumnBinders<ExecutionType>();
+template <>
+absl::Span<const ColumnBinder<ContextType>> GetColumnBinders<ContextType>();
+
+// Parses a serialized proto to a message.
+// Returns INTERNAL error, if the proto cannot be parsed.
+tensorflow::Status ParseSerializedMessage(absl::string_view serialized_message,
+                                          google::protobuf::Message* message);
+
+// Decodes the rows of a query result to MessageType messages. The columns of
+// the result are matched to the fields of MessageType once, when the decoder
+// is created; the value of each column is then assigned to the field with the
+// same name as the column, and the columns without a field are ignored. NULL
+// values leave the fields unset.
+//
+// Usage:
+//   RowDecoder<Artifact> decoder(record_set);
+//   for (const RecordSet::Record& record : record_set.records()) {
+//     Artifact artifact;
+//     TF_RETURN_IF_ERROR(decoder.Decode(record, &artifact));
+//   }
+template <typename MessageType>
+class RowDecoder {
+ public:
+  explicit RowDecoder(const RecordSet& record_set) {
+    binders_.reserve(record_set.column_names_size());
+    for (const std::string& column_name : record_set.column_names()) {
+      binders_.push_back(FindBinder(column_name));
+    }
+  }
+
+  explicit RowDecoder(const TypedRecordSet& record_set) {
+    binders_.reserve(record_set.num_columns());
+    for (int i = 0; i < record_set.num_columns(); i++) {
+      binders_.push_back(FindBinder(record_set.column_name(i)));
+    }
+  }
+
+  // Decodes a record of the RecordSet of the decoder.
+  tensorflow::Status Decode(const RecordSet::Record& record,
+                            MessageType* message) const {
+    CHECK_EQ(record.values_size(), binders_.size());
+    for (int i = 0; i < binders_.size(); i++) {
+      const ColumnBinder<MessageType>* binder = binders_[i];
+      const std::string& value = record.values(i);
+      if (binder == nullptr || value == kMetadataSourceNull) continue;
+      if (binder->set_int64 != nullptr) {
+        int64 int64_value;
+        CHECK(absl::SimpleAtoi(value, &int64_value));
+        binder->set_int64(int64_value, message);
+      } else if (binder->set_string != nullptr) {
+        binder->set_string(value, message);
+      } else {
+        TF_RETURN_IF_ERROR(
+            ParseSerializedMessage(value, binder->mutable_message(message)));
+      }
+    }
+    return tensorflow::Status::OK();
+  }
+
+  // Decodes the row `row` of the TypedRecordSet of the decoder.
+  tensorflow::Status Decode(const TypedRecordSet& record_set, int row,
+                            MessageType* message) const {
+    CHECK_EQ(record_set.num_columns(), binders_.size());
+    for (int i = 0; i < binders_.size(); i++) {
+      const ColumnBinder<MessageType>* binder = binders_[i];
+      if (binder == nullptr || record_set.IsNull(row, i)) continue;
+      if (binder->set_int64 != nullptr) {
+        binder->set_int64(record_set.GetInt64(row, i), message);
+      } else if (binder->set_string != nullptr) {
+        binder->set_string(record_set.GetString(row, i), message);
+      } else {
+        TF_RETURN_IF_ERROR(ParseSerializedMessage(
+            record_set.GetString(row, i), binder->mutable_message(message)));
+      }
+    }
+    return tensorflow::Status::OK();
+  }
+
+ private:
+  // Returns the binder of a column, or nullptr if MessageType has no field
+  // with the column name.
+  static const ColumnBinder<MessageType>* FindBinder(
+      absl::string_view column_name) {
+    for (const ColumnBinder<MessageType>& binder :
+         GetColumnBinders<MessageType>()) {
+      if (column_name == binder.column_name) return &binder;
+    }
+    return nullptr;
+  }
+
+  // The binder of each column, or nullptr for the columns without a field.
+  std::vector<const ColumnBinder<MessageType>*> binders_;
+};
+
+}  // namespace ml_metadata
+
+#endif  // ML_METADATA_METADATA_STORE_ROW_DECODER_H_
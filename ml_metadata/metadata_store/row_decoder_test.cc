@@ -0,0 +1,130 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "ml_metadata/metadata_store/row_decoder.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/substitute.h"
+#include "ml_metadata/metadata_store/constants.h"
+#include "ml_metadata/metadata_store/test_util.h"
+#include "ml_metadata/metadata_store/typed_record_set.h"
+#include "ml_metadata/proto/metadata_source.pb.h"
+#include "ml_metadata/proto/metadata_store.pb.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+
+namespace ml_metadata {
+namespace {
+
+using testing::EqualsProto;
+using testing::ParseTextProtoOrDie;
+
+// Checks that the binders of MessageType cover its scalar fields, and that
+// each binder has a field.
+template <typename MessageType>
+void ExpectBindersMatchFields() {
+  const google::protobuf::Descriptor* descriptor = MessageType::descriptor();
+  int num_scalar_fields = 0;
+  for (int i = 0; i < descriptor->field_count(); i++) {
+    const google::protobuf::FieldDescriptor* field = descriptor->field(i);
+    if (field->is_map() ||
+        field->cpp_type() ==
+            google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE) {
+      continue;
+    }
+    num_scalar_fields++;
+    bool has_binder = false;
+    for (const ColumnBinder<MessageType>& binder :
+         GetColumnBinders<MessageType>()) {
+      has_binder |= field->name() == binder.column_name;
+    }
+    EXPECT_TRUE(has_binder) << "No binder for " << field->full_name();
+  }
+  int num_message_binders = 0;
+  for (const ColumnBinder<MessageType>& binder :
+       GetColumnBinders<MessageType>()) {
+    EXPECT_NE(descriptor->FindFieldByName(binder.column_name), nullptr)
+        << "No field for " << binder.column_name;
+    num_message_binders += binder.mutable_message != nullptr;
+  }
+  EXPECT_EQ(GetColumnBinders<MessageType>().size(),
+            num_scalar_fields + num_message_binders);
+}
+
+TEST(RowDecoderTest, BindersMatchFields) {
+  ExpectBindersMatchFields<Artifact>();
+  ExpectBindersMatchFields<Execution>();
+  ExpectBindersMatchFields<Context>();
+  ExpectBindersMatchFields<Event>();
+  ExpectBindersMatchFields<ArtifactType>();
+  ExpectBindersMatchFields<ExecutionType>();
+  ExpectBindersMatchFields<ContextType>();
+}
+
+TEST(RowDecoderTest, DecodeRecordSet) {
+  const RecordSet record_set = ParseTextProtoOrDie<RecordSet>(absl::Substitute(
+      R"(column_names: "id"
+         column_names: "type_id"
+         column_names: "uri"
+         column_names: "state"
+         column_names: "name"
+         column_names: "unknown_column"
+         records: { values: "1" values: "2" values: "uri" values: "1"
+                    values: "$0" values: "x" }
+         records: { values: "3" values: "2" values: "" values: "$0"
+                    values: "a" values: "y" })",
+      kMetadataSourceNull));
+  const RowDecoder<Artifact> decoder(record_set);
+  Artifact artifact;
+  TF_ASSERT_OK(decoder.Decode(record_set.records(0), &artifact));
+  EXPECT_THAT(artifact, EqualsProto(ParseTextProtoOrDie<Artifact>(R"(
+                id: 1 type_id: 2 uri: "uri" state: PENDING)")));
+  artifact.Clear();
+  TF_ASSERT_OK(decoder.Decode(record_set.records(1), &artifact));
+  EXPECT_THAT(artifact, EqualsProto(ParseTextProtoOrDie<Artifact>(R"(
+                id: 3 type_id: 2 uri: "" name: "a")")));
+}
+
+TEST(RowDecoderTest, DecodeTypedRecordSet) {
+  TypedRecordSet record_set;
+  record_set.AddColumn("id", TypedRecordSet::ColumnType::kInt64);
+  record_set.AddColumn("name", TypedRecordSet::ColumnType::kString);
+  record_set.AddColumn("input_type", TypedRecordSet::ColumnType::kString);
+  record_set.AddColumn("output_type", TypedRecordSet::ColumnType::kString);
+  record_set.AddRow();
+  record_set.SetInt64(0, 1);
+  record_set.SetString(1, "type");
+  ArtifactStructType input_type;
+  input_type.mutable_none();
+  record_set.SetString(2, input_type.SerializeAsString());
+  record_set.SetString(3, "");
+  record_set.AddRow();
+  record_set.SetInt64(0, 2);
+  record_set.SetString(2, "\xff");
+
+  const RowDecoder<ExecutionType> decoder(record_set);
+  ExecutionType type;
+  TF_ASSERT_OK(decoder.Decode(record_set, 0, &type));
+  EXPECT_THAT(type, EqualsProto(ParseTextProtoOrDie<ExecutionType>(R"(
+                id: 1
+                name: "type"
+                input_type: { none: {} }
+                output_type: {})")));
+  type.Clear();
+  EXPECT_EQ(decoder.Decode(record_set, 1, &type).code(),
+            tensorflow::error::INTERNAL);
+}
+
+}  // namespace
+}  // namespace ml_metadata
@@ -38,14 +38,14 @@ namespace {
 class SqliteMetadataAccessObjectContainer
     : public QueryConfigMetadataAccessObjectContainer {
  public:
-  SqliteMetadataAccessObjectContainer()
-      : QueryConfigMetadataAccessObjectContainer(
-            util::GetSqliteMetadataSourceQueryConfig()) {
+  explicit SqliteMetadataAccessObjectContainer(
+      const MetadataSourceQueryConfig& query_config =
+          util::GetSqliteMetadataSourceQueryConfig())
+      : QueryConfigMetadataAccessObjectContainer(query_config) {
     SqliteMetadataSourceConfig config;
     metadata_source_ = absl::make_unique<SqliteMetadataSource>(config);
     TF_CHECK_OK(CreateMetadataAccessObject(
-        util::GetSqliteMetadataSourceQueryConfig(), metadata_source_.get(),
-        &metadata_access_object_));
+        query_config, metadata_source_.get(), &metadata_access_object_));
   }
 
   ~SqliteMetadataAccessObjectContainer() override = default;
@@ -70,5 +70,19 @@ INSTANTIATE_TEST_CASE_P(
       return absl::make_unique<SqliteMetadataAccessObjectContainer>();
     }));
 
+// Runs the tests with one id per query and one row per insert, so that the
+// queries by a collection of ids and the multi-row inserts are split into
+// multiple chunks.
+INSTANTIATE_TEST_CASE_P(
+    SqliteMetadataAccessObjectOneIdPerQueryTest, MetadataAccessObjectTest,
+    ::testing::Values([]() {
+      MetadataSourceQueryConfig query_config =
+          util::GetSqliteMetadataSourceQueryConfig();
+      query_config.set_max_num_ids_per_query(1);
+      query_config.set_max_num_rows_per_insert(1);
+      return absl::make_unique<SqliteMetadataAccessObjectContainer>(
+          query_config);
+    }));
+
 }  // namespace testing
 }  // namespace ml_metadata
@@ -14,16 +14,23 @@ limitations under the License.
 ==============================================================================*/
 #include "ml_metadata/metadata_store/sqlite_metadata_source.h"
 
+#include <algorithm>
 #include <random>
 
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/strip.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "ml_metadata/metadata_store/constants.h"
 #include "ml_metadata/metadata_store/sqlite_metadata_source_util.h"
+#include "ml_metadata/metadata_store/typed_record_set.h"
 #include "ml_metadata/proto/metadata_store.pb.h"
 #include "sqlite3.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/monitoring/counter.h"
 
 namespace ml_metadata {
 
@@ -31,8 +38,11 @@ namespace {
 
 constexpr char kInMemoryConnection[] = ":memory:";
 constexpr char kBeginTransaction[] = "BEGIN;";
+constexpr char kBeginImmediateTransaction[] = "BEGIN IMMEDIATE;";
 constexpr char kCommitTransaction[] = "COMMIT;";
 constexpr char kRollbackTransaction[] = "ROLLBACK;";
+constexpr char kEnableQueryOnly[] = "PRAGMA query_only = ON;";
+constexpr char kDisableQueryOnly[] = "PRAGMA query_only = OFF;";
 
 // Returns a Sqlite3 connection flags based on the SqliteMetadataSourceConfig.
 // (see https://www.sqlite.org/c3ref/open.html for details)
@@ -57,41 +67,145 @@ int GetConnectionFlag(const SqliteMetadataSourceConfig& config) {
   return result;
 }
 
-// A set of options when waiting for table locks in a sqlite3_busy_handler.
-// see WaitThenRetry for details.
-struct WaitThenRetryOptions {
-  // the min wait time in milliseconds.
-  absl::Duration min_sleep_time;
-  // the max wait time in milliseconds.
-  absl::Duration max_sleep_time;
-  // the max number of retries.
-  int max_num_retries;
-};
-
-// A callback of sqlite3_busy_handler. Concurrent access to a table may prevent
-// query to proceed, the callback returns zero to continue waiting, and non-zero
-// to abort the query and returns a SQLITE_BUSY error. The function takes a
-// WaitThenRetryOptions (`options`), waits for a lock and then indicates sqlite3
-// to retry. The default sleep time mean is 200 millisecond and sleep 10 times
-// at maximum (see https://www.sqlite.org/c3ref/busy_handler.html for details).
-int WaitThenRetry(void* options, int retried_times) {
-  static constexpr WaitThenRetryOptions kDefaultWaitThenRetryOptions = {
-      absl::Milliseconds(100), absl::Milliseconds(300), 10};
-  const WaitThenRetryOptions* opts =
-      (options != nullptr) ? static_cast<WaitThenRetryOptions*>(options)
-                           : &kDefaultWaitThenRetryOptions;
-  // aborts the query with SQLITE_BUSY
-  if (retried_times >= opts->max_num_retries) {
-    return 0;
-  }
-  std::minstd_rand0 gen(absl::ToUnixMillis(absl::Now()));
-  std::uniform_int_distribution<int64> uniform_dist(
-      opts->min_sleep_time / absl::Milliseconds(1),
-      opts->max_sleep_time / absl::Milliseconds(1));
-  const absl::Duration sleep_time = absl::Milliseconds(uniform_dist(gen));
-  absl::SleepFor(sleep_time);
-  // allow further retry
-  return 1;
+// The counters of the waits for the locks held by other connections, across
+// all the connections of the process.
+tensorflow::monitoring::Counter<0>* BusyRetriesCounter() {
+  static auto* counter = tensorflow::monitoring::Counter<0>::New(
+      "/ml_metadata/sqlite/busy_retries",
+      "The number of retries of the queries waiting for locks.");
+  return counter;
+}
+
+tensorflow::monitoring::Counter<0>* BusyWaitMicrosecondsCounter() {
+  static auto* counter = tensorflow::monitoring::Counter<0>::New(
+      "/ml_metadata/sqlite/busy_wait_microseconds",
+      "The time spent by the queries waiting for locks.");
+  return counter;
+}
+
+tensorflow::monitoring::Counter<0>* BusyTimeoutsCounter() {
+  static auto* counter = tensorflow::monitoring::Counter<0>::New(
+      "/ml_metadata/sqlite/busy_timeouts",
+      "The number of queries aborted after waiting for locks.");
+  return counter;
+}
+
+// Returns the type of a column of a statement with a row, from the declared
+// type of the column, following the affinity rules of Sqlite3 (see
+// https://www.sqlite.org/datatype3.html). If the declared type does not tell,
+// e.g., for an expression, the type of the value in the current row is used.
+TypedRecordSet::ColumnType GetColumnType(sqlite3_stmt* statement,
+                                         const int column) {
+  const char* declared_type = sqlite3_column_decltype(statement, column);
+  if (declared_type != nullptr) {
+    const std::string type = absl::AsciiStrToUpper(declared_type);
+    if (absl::StrContains(type, "INT")) {
+      return TypedRecordSet::ColumnType::kInt64;
+    }
+    if (absl::StrContains(type, "CHAR") || absl::StrContains(type, "CLOB") ||
+        absl::StrContains(type, "TEXT")) {
+      return TypedRecordSet::ColumnType::kString;
+    }
+    if (absl::StrContains(type, "REAL") || absl::StrContains(type, "FLOA") ||
+        absl::StrContains(type, "DOUB")) {
+      return TypedRecordSet::ColumnType::kDouble;
+    }
+  }
+  switch (sqlite3_column_type(statement, column)) {
+    case SQLITE_INTEGER:
+      return TypedRecordSet::ColumnType::kInt64;
+    case SQLITE_FLOAT:
+      return TypedRecordSet::ColumnType::kDouble;
+    default:
+      return TypedRecordSet::ColumnType::kString;
+  }
+}
+
+// Appends the current row of a statement to a RecordSet. Like sqlite3_exec,
+// the values are rendered as text, and the column names are only set if there
+// are rows.
+void AppendRowToRecordSet(sqlite3_stmt* statement, RecordSet* results) {
+  const int column_num = sqlite3_column_count(statement);
+  if (results->column_names_size() != column_num) {
+    results->clear_column_names();
+    for (int i = 0; i < column_num; ++i) {
+      results->add_column_names(sqlite3_column_name(statement, i));
+    }
+  }
+  RecordSet::Record* record = results->add_records();
+  for (int i = 0; i < column_num; ++i) {
+    const void* value;
+    switch (sqlite3_column_type(statement, i)) {
+      case SQLITE_NULL:
+        record->add_values(kMetadataSourceNull);
+        continue;
+      case SQLITE_BLOB:
+        value = sqlite3_column_blob(statement, i);
+        break;
+      default:
+        value = sqlite3_column_text(statement, i);
+    }
+    // The value must be read before its size.
+    record->add_values(static_cast<const char*>(value),
+                       sqlite3_column_bytes(statement, i));
+  }
+}
+
+// Appends the current row of a statement to a TypedRecordSet. The columns are
+// added at the first row, with the types of their declarations.
+void AppendRowToTypedRecordSet(sqlite3_stmt* statement,
+                               TypedRecordSet* results) {
+  const int column_num = sqlite3_column_count(statement);
+  if (results->num_columns() == 0) {
+    for (int i = 0; i < column_num; ++i) {
+      results->AddColumn(sqlite3_column_name(statement, i),
+                         GetColumnType(statement, i));
+    }
+  }
+  CHECK_EQ(results->num_columns(), column_num);
+  results->AddRow();
+  for (int i = 0; i < column_num; ++i) {
+    const int value_type = sqlite3_column_type(statement, i);
+    if (value_type == SQLITE_NULL) continue;
+    switch (results->column_type(i)) {
+      case TypedRecordSet::ColumnType::kInt64:
+        results->SetInt64(i, sqlite3_column_int64(statement, i));
+        break;
+      case TypedRecordSet::ColumnType::kDouble:
+        results->SetDouble(i, sqlite3_column_double(statement, i));
+        break;
+      case TypedRecordSet::ColumnType::kString: {
+        // The value must be read before its size.
+        const void* value = value_type == SQLITE_BLOB
+                                ? sqlite3_column_blob(statement, i)
+                                : sqlite3_column_text(statement, i);
+        results->SetString(
+            i, absl::string_view(static_cast<const char*>(value),
+                                 sqlite3_column_bytes(statement, i)));
+        break;
+      }
+    }
+  }
+}
+
+// Returns InvalidArgument if the busy handler settings of `profile` are
+// negative, or the max backoff is less than the initial one.
+tensorflow::Status ValidateBusyBackoff(
+    const SqliteMetadataSourceConfig::PerformanceProfile& profile) {
+  if (profile.busy_timeout_ms() < 0 || profile.busy_initial_backoff_us() < 0 ||
+      profile.busy_max_backoff_us() < 0) {
+    return tensorflow::errors::InvalidArgument(
+        "The busy_* settings of the performance profile must not be "
+        "negative: ",
+        profile.DebugString());
+  }
+  if (profile.busy_max_backoff_us() < profile.busy_initial_backoff_us()) {
+    return tensorflow::errors::InvalidArgument(
+        "The busy_max_backoff_us of the performance profile must not be less "
+        "than its busy_initial_backoff_us: ",
+        profile.DebugString());
+  }
+  return tensorflow::Status::OK();
 }
 
 }  // namespace
@@ -109,6 +223,7 @@ SqliteMetadataSource::SqliteMetadataSource(
 SqliteMetadataSource::~SqliteMetadataSource() { TF_CHECK_OK(CloseImpl()); }
 
 tensorflow::Status SqliteMetadataSource::ConnectImpl() {
+  TF_RETURN_IF_ERROR(ValidateBusyBackoff(config_.performance_profile()));
   if (sqlite3_open_v2(config_.filename_uri().c_str(), &db_,
                       GetConnectionFlag(config_), nullptr) != SQLITE_OK) {
     std::string error_message = sqlite3_errmsg(db_);
@@ -118,12 +233,112 @@ tensorflow::Status SqliteMetadataSource::ConnectImpl() {
                                         error_message);
   }
   // required to handle cases when tables are locked when executing queries
-  sqlite3_busy_handler(db_, &WaitThenRetry, nullptr);
+  sqlite3_busy_handler(db_, &BusyHandler, this);
+  const tensorflow::Status status = ApplyPerformanceProfile();
+  if (!status.ok()) {
+    sqlite3_close(db_);
+    db_ = nullptr;
+    return status;
+  }
   return tensorflow::Status::OK();
 }
 
+int SqliteMetadataSource::BusyHandler(void* metadata_source,
+                                      const int retried_times) {
+  return static_cast<SqliteMetadataSource*>(metadata_source)
+      ->WaitForLocks(retried_times);
+}
+
+bool SqliteMetadataSource::WaitForLocks(const int retried_times) {
+  const SqliteMetadataSourceConfig::PerformanceProfile& profile =
+      config_.performance_profile();
+  if (retried_times == 0) busy_wait_time_ = absl::ZeroDuration();
+  const absl::Duration timeout = absl::Milliseconds(profile.busy_timeout_ms());
+  if (busy_wait_time_ >= timeout) {
+    BusyTimeoutsCounter()->GetCell()->IncrementBy(1);
+    return false;
+  }
+  // The doubling saturates at the max backoff, so that large settings or
+  // many retries do not overflow.
+  const int64 max_backoff_us = profile.busy_max_backoff_us();
+  int64 backoff_us =
+      std::min(profile.busy_initial_backoff_us(), max_backoff_us);
+  for (int i = 0; i < retried_times && backoff_us < max_backoff_us; ++i) {
+    if (backoff_us == 0) break;
+    backoff_us += std::min(backoff_us, max_backoff_us - backoff_us);
+  }
+  backoff_us = std::max<int64>(backoff_us, 1);
+  // Half of the backoff is random, so that the connections waiting for the
+  // same lock do not retry in lockstep.
+  static thread_local std::minstd_rand0 generator(std::random_device{}());
+  std::uniform_int_distribution<int64> jitter_us(0, backoff_us / 2);
+  const absl::Duration sleep_time =
+      std::min(absl::Microseconds(backoff_us - backoff_us / 2 +
+                                  jitter_us(generator)),
+               timeout - busy_wait_time_);
+  absl::SleepFor(sleep_time);
+  busy_wait_time_ += sleep_time;
+  BusyRetriesCounter()->GetCell()->IncrementBy(1);
+  BusyWaitMicrosecondsCounter()->GetCell()->IncrementBy(
+      absl::ToInt64Microseconds(sleep_time));
+  return true;
+}
+
+tensorflow::Status SqliteMetadataSource::ApplyPerformanceProfile() {
+  using PerformanceProfile = SqliteMetadataSourceConfig::PerformanceProfile;
+  const PerformanceProfile& profile = config_.performance_profile();
+  if (profile.journal_mode() != PerformanceProfile::UNKNOWN_JOURNAL_MODE &&
+      config_.connection_mode() != SqliteMetadataSourceConfig::READONLY) {
+    const std::string journal_mode(absl::StripPrefix(
+        PerformanceProfile::JournalMode_Name(profile.journal_mode()),
+        "JOURNAL_MODE_"));
+    RecordSet record_set;
+    TF_RETURN_IF_ERROR(RunStatement(
+        absl::StrCat("PRAGMA journal_mode = ", journal_mode, ";"),
+        &record_set));
+    // The pragma returns the journal mode in use, which is kept if it cannot
+    // be changed, e.g., in memory databases only use MEMORY or OFF.
+    if (record_set.records_size() != 1 ||
+        !absl::EqualsIgnoreCase(record_set.records(0).values(0),
+                                journal_mode)) {
+      LOG(WARNING) << "Cannot set the journal mode of "
+                   << config_.filename_uri() << " to " << journal_mode;
+    }
+  }
+  std::string pragmas;
+  if (profile.synchronous() != PerformanceProfile::UNKNOWN_SYNCHRONOUS) {
+    absl::StrAppend(
+        &pragmas, "PRAGMA synchronous = ",
+        absl::StripPrefix(
+            PerformanceProfile::Synchronous_Name(profile.synchronous()),
+            "SYNCHRONOUS_"),
+        "; ");
+  }
+  if (profile.has_mmap_size()) {
+    absl::StrAppend(&pragmas, "PRAGMA mmap_size = ", profile.mmap_size(),
+                    "; ");
+  }
+  if (profile.has_cache_size()) {
+    absl::StrAppend(&pragmas, "PRAGMA cache_size = ", profile.cache_size(),
+                    "; ");
+  }
+  if (profile.temp_store() != PerformanceProfile::UNKNOWN_TEMP_STORE) {
+    absl::StrAppend(
+        &pragmas, "PRAGMA temp_store = ",
+        absl::StripPrefix(
+            PerformanceProfile::TempStore_Name(profile.temp_store()),
+            "TEMP_STORE_"),
+        "; ");
+  }
+  return RunStatement(pragmas, nullptr);
+}
+
 tensorflow::Status SqliteMetadataSource::CloseImpl() {
   if (db_ != nullptr) {
+    for (const auto& query_and_statement : prepared_statements_) {
+      sqlite3_finalize(query_and_statement.second);
+    }
+    prepared_statements_.clear();
     int error_code = sqlite3_close(db_);
     if (error_code != SQLITE_OK) {
       return tensorflow::errors::Internal(
@@ -131,45 +346,260 @@ tensorflow::Status SqliteMetadataSource::CloseImpl() {
     }
     db_ = nullptr;
   }
+  read_only_transaction_ = false;
   return tensorflow::Status::OK();
 }
 
-tensorflow::Status SqliteMetadataSource::RunStatement(
-    const std::string& query, RecordSet* results = nullptr) {
-  char* error_message;
-  if (sqlite3_exec(db_, query.c_str(), &ConvertSqliteResultsToRecordSet,
-                   results, &error_message) != SQLITE_OK) {
-    std::string error_details = error_message;
-    sqlite3_free(error_message);
-    if (absl::StrContains(error_details, "database is locked")) {
+tensorflow::Status SqliteMetadataSource::RunStatements(
+    const std::string& query, absl::FunctionRef<void(sqlite3_stmt*)> on_row) {
+  const char* next = query.data();
+  const char* const end = query.data() + query.size();
+  while (next < end) {
+    sqlite3_stmt* statement = nullptr;
+    if (sqlite3_prepare_v3(db_, next, end - next, /*prepFlags=*/0, &statement,
+                           &next) != SQLITE_OK) {
+      return SqliteError("Error when preparing query", query);
+    }
+    // Whitespace, comments and empty statements have no prepared statement.
+    if (statement == nullptr) continue;
+    const tensorflow::Status status = StepStatement(query, statement, on_row);
+    sqlite3_finalize(statement);
+    TF_RETURN_IF_ERROR(status);
+  }
+  return tensorflow::Status::OK();
+}
+
+tensorflow::Status SqliteMetadataSource::RunStatement(const std::string& query,
+                                                      RecordSet* results) {
+  return RunStatements(query, [results](sqlite3_stmt* statement) {
+    if (results != nullptr) AppendRowToRecordSet(statement, results);
+  });
+}
+
+tensorflow::Status SqliteMetadataSource::StepStatement(
+    const std::string& query, sqlite3_stmt* statement,
+    absl::FunctionRef<void(sqlite3_stmt*)> on_row) {
+  int error_code;
+  while ((error_code = sqlite3_step(statement)) == SQLITE_ROW) {
+    on_row(statement);
+  }
+  const tensorflow::Status status =
+      error_code == SQLITE_DONE
+          ? tensorflow::Status::OK()
+          : SqliteError("Error when executing query", query);
+  sqlite3_reset(statement);
+  return status;
+}
+
+tensorflow::Status SqliteMetadataSource::SqliteError(
+    absl::string_view message, const std::string& query) {
+  // The busy handler has given up waiting for the locks of other connections,
+  // or, for shared cache connections, a table is locked by another one.
+  switch (sqlite3_extended_errcode(db_) & 0xff) {
+    case SQLITE_BUSY:
+    case SQLITE_LOCKED:
       return tensorflow::errors::Aborted(
           "Concurrent writes aborted after max number of retries.");
+    default:
+      return tensorflow::errors::Internal(message, ": ", sqlite3_errmsg(db_),
+                                          " query: ", query);
+  }
+}
+
+tensorflow::Status SqliteMetadataSource::PrepareSingleStatement(
+    const std::string& query, const unsigned int prepare_flags,
+    sqlite3_stmt** statement) {
+  const char* tail = nullptr;
+  if (sqlite3_prepare_v3(db_, query.data(), query.size(), prepare_flags,
+                         statement, &tail) != SQLITE_OK) {
+    return SqliteError("Error when preparing query", query);
+  }
+  if (*statement == nullptr ||
+      !absl::StripAsciiWhitespace(
+           absl::string_view(tail, query.data() + query.size() - tail))
+           .empty()) {
+    sqlite3_finalize(*statement);
+    return tensorflow::errors::InvalidArgument(
+        "A parameterized query must have a single statement: ", query);
+  }
+  return tensorflow::Status::OK();
+}
+
+tensorflow::Status SqliteMetadataSource::PrepareStatement(
+    const std::string& query, const std::vector<QueryParameter>& parameters,
+    sqlite3_stmt** statement) {
+  auto iter = prepared_statements_.find(query);
+  if (iter != prepared_statements_.end()) {
+    *statement = iter->second;
+  } else {
+    TF_RETURN_IF_ERROR(
+        PrepareSingleStatement(query, SQLITE_PREPARE_PERSISTENT, statement));
+    prepared_statements_[query] = *statement;
+  }
+  return BindParameters(query, parameters, *statement);
+}
+
+tensorflow::Status SqliteMetadataSource::BindParameters(
+    const std::string& query, const std::vector<QueryParameter>& parameters,
+    sqlite3_stmt* statement) {
+  if (sqlite3_bind_parameter_count(statement) !=
+      static_cast<int>(parameters.size())) {
+    return tensorflow::errors::InvalidArgument(
+        "The number of placeholders does not match the ", parameters.size(),
+        " parameters of query: ", query);
+  }
+  for (int i = 0; i < static_cast<int>(parameters.size()); ++i) {
+    const QueryParameter& parameter = parameters[i];
+    // The placeholders are numbered from 1.
+    int error_code;
+    if (absl::holds_alternative<int64>(parameter)) {
+      error_code =
+          sqlite3_bind_int64(statement, i + 1, absl::get<int64>(parameter));
+    } else if (absl::holds_alternative<double>(parameter)) {
+      error_code =
+          sqlite3_bind_double(statement, i + 1, absl::get<double>(parameter));
+    } else if (absl::holds_alternative<std::string>(parameter)) {
+      // The parameters outlive the execution of the statement.
+      const std::string& value = absl::get<std::string>(parameter);
+      error_code = sqlite3_bind_text(statement, i + 1, value.data(),
+                                     value.size(), SQLITE_STATIC);
+    } else if (absl::holds_alternative<BlobParameter>(parameter)) {
+      const std::string& value = absl::get<BlobParameter>(parameter).value;
+      error_code = sqlite3_bind_blob(statement, i + 1, value.data(),
+                                     value.size(), SQLITE_STATIC);
+    } else {
+      error_code = sqlite3_bind_null(statement, i + 1);
+    }
+    if (error_code != SQLITE_OK) {
+      sqlite3_clear_bindings(statement);
+      return tensorflow::errors::Internal(
+          "Error when binding parameter ", i, ": ", sqlite3_errmsg(db_),
+          " query: ", query);
     }
-    return tensorflow::errors::Internal(
-        "Error when executing query: ", error_details, " query: ", query);
   }
   return tensorflow::Status::OK();
 }
 
+tensorflow::Status SqliteMetadataSource::RunPreparedStatement(
+    const std::string& query, sqlite3_stmt* statement, RecordSet* results) {
+  const tensorflow::Status status =
+      StepStatement(query, statement, [results](sqlite3_stmt* statement) {
+        if (results != nullptr) AppendRowToRecordSet(statement, results);
+      });
+  sqlite3_clear_bindings(statement);
+  return status;
+}
+
+tensorflow::Status SqliteMetadataSource::ExecuteParameterizedQueryImpl(
+    const std::string& query, const std::vector<QueryParameter>& parameters,
+    RecordSet* results) {
+  sqlite3_stmt* statement;
+  TF_RETURN_IF_ERROR(PrepareStatement(query, parameters, &statement));
+  return RunPreparedStatement(query, statement, results);
+}
+
+tensorflow::Status SqliteMetadataSource::ExecuteUncachedQueryImpl(
+    const std::string& query, const std::vector<QueryParameter>& parameters,
+    RecordSet* results) {
+  sqlite3_stmt* statement;
+  TF_RETURN_IF_ERROR(
+      PrepareSingleStatement(query, /*prepare_flags=*/0, &statement));
+  tensorflow::Status status = BindParameters(query, parameters, statement);
+  if (status.ok()) status = RunPreparedStatement(query, statement, results);
+  sqlite3_finalize(statement);
+  return status;
+}
+
+tensorflow::Status SqliteMetadataSource::ExecuteParameterizedInsertQueryImpl(
+    const std::string& query, const std::vector<QueryParameter>& parameters,
+    int64* insert_id) {
+  sqlite3_stmt* statement;
+  TF_RETURN_IF_ERROR(PrepareStatement(query, parameters, &statement));
+  TF_RETURN_IF_ERROR(RunPreparedStatement(query, statement, nullptr));
+  *insert_id = sqlite3_last_insert_rowid(db_) - sqlite3_changes(db_) + 1;
+  return tensorflow::Status::OK();
+}
+
 tensorflow::Status SqliteMetadataSource::ExecuteQueryImpl(
     const std::string& query, RecordSet* results) {
   return RunStatement(query, results);
 }
 
+tensorflow::Status SqliteMetadataSource::ExecuteTypedQueryImpl(
+    const std::string& query, TypedRecordSet* results) {
+  return RunStatements(query, [results](sqlite3_stmt* statement) {
+    AppendRowToTypedRecordSet(statement, results);
+  });
+}
+
+tensorflow::Status SqliteMetadataSource::ExecuteInsertQueryImpl(
+    const std::string& query, int64* insert_id) {
+  TF_RETURN_IF_ERROR(RunStatement(query, nullptr));
+  // The rows of an INSERT statement are given consecutive rowids, as writes to
+  // a database are serialized.
+  *insert_id = sqlite3_last_insert_rowid(db_) - sqlite3_changes(db_) + 1;
+  return tensorflow::Status::OK();
+}
+
 tensorflow::Status SqliteMetadataSource::BeginImpl() {
-  return RunStatement(kBeginTransaction);
+  // The write lock is taken when the transaction begins, as a transaction
+  // upgrading its read lock fails at once, without the busy handler, if
+  // another transaction is writing. Read only connections cannot take it.
+  return ExecuteParameterizedQueryImpl(
+      config_.connection_mode() == SqliteMetadataSourceConfig::READONLY
+          ? kBeginTransaction
+          : kBeginImmediateTransaction,
+      {}, nullptr);
+}
+
+tensorflow::Status SqliteMetadataSource::BeginReadOnlyImpl() {
+  TF_RETURN_IF_ERROR(
+      ExecuteParameterizedQueryImpl(kBeginTransaction, {}, nullptr));
+  const tensorflow::Status status =
+      ExecuteParameterizedQueryImpl(kEnableQueryOnly, {}, nullptr);
+  if (!status.ok()) {
+    ExecuteParameterizedQueryImpl(kRollbackTransaction, {}, nullptr)
+        .IgnoreError();
+    return status;
+  }
+  read_only_transaction_ = true;
+  return tensorflow::Status::OK();
+}
+
+tensorflow::Status SqliteMetadataSource::EndTransaction(const char* query) {
+  tensorflow::Status status =
+      ExecuteParameterizedQueryImpl(query, {}, nullptr);
+  // The connection is made writable again even if the transaction fails to
+  // end, as it is reused by the next transactions.
+  if (read_only_transaction_) {
+    read_only_transaction_ = false;
+    status.Update(
+        ExecuteParameterizedQueryImpl(kDisableQueryOnly, {}, nullptr));
+  }
+  return status;
 }
 
 tensorflow::Status SqliteMetadataSource::CommitImpl() {
-  return RunStatement(kCommitTransaction);
+  return EndTransaction(kCommitTransaction);
 }
 
 tensorflow::Status SqliteMetadataSource::RollbackImpl() {
-  return RunStatement(kRollbackTransaction);
+  return EndTransaction(kRollbackTransaction);
 }
 
 std::string SqliteMetadataSource::EscapeString(absl::string_view value) const {
   return SqliteEscapeString(value);
 }
 
+std::string SqliteMetadataSource::GetDatabaseIdentifier() const {
+  const std::string& filename_uri = config_.filename_uri();
+  // In memory databases are not shared across connections, unless they are
+  // opened with shared cache, which is still limited to the process.
+  if (filename_uri == kInMemoryConnection ||
+      absl::StrContains(filename_uri, "mode=memory")) {
+    return "";
+  }
+  return absl::StrCat("sqlite:", filename_uri);
+}
+
 }  // namespace ml_metadata
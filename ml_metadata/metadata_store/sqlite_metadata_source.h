@@ -15,6 +15,13 @@ limitations under the License.
 #ifndef ML_METADATA_METADATA_STORE_SQLITE_METADATA_SOURCE_H_
 #define ML_METADATA_METADATA_STORE_SQLITE_METADATA_SOURCE_H_
 
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "ml_metadata/metadata_store/metadata_source.h"
 #include "ml_metadata/proto/metadata_store.pb.h"
 #include "sqlite3.h"
@@ -26,6 +33,15 @@ namespace ml_metadata {
 // database, and destroys it when the metadata source is destructed. It can be
 // configured via a SqliteMetadataSourceConfig to use physical Sqlite3 and open
 // it in read only, read and write, and create if not exists modes.
+// The performance_profile of the config is applied with PRAGMA statements
+// when connecting. Queries waiting for the locks held by other connections are
+// retried with exponential backoff, and transactions take the write lock when
+// they begin.
+// Queries are run by stepping their prepared statements, and the values of the
+// rows are read with their storage types. Parameterized queries and the
+// transaction statements are prepared once per connection, and the prepared
+// statements are kept until the connection is closed, except for the uncached
+// queries, which are finalized once they run.
 // This class is thread-unsafe. Multiple objects can be created by using the
 // same SqliteMetadataSourceConfig to use the same Sqlite3 database.
 class SqliteMetadataSource : public MetadataSource {
@@ -40,11 +56,31 @@ class SqliteMetadataSource : public MetadataSource {
   // Escape strings having single quotes using built-in printf in Sqlite3 C API.
   std::string EscapeString(absl::string_view value) const final;
 
+  // Returns the filename_uri, or an empty string for in memory databases.
+  std::string GetDatabaseIdentifier() const final;
+
  private:
   // Creates an in memory db.
+  // Returns INVALID_ARGUMENT if the busy_* settings of the performance profile
+  // are negative, or busy_max_backoff_us is less than busy_initial_backoff_us.
   // If error happens, Returns INTERNAL error.
   tensorflow::Status ConnectImpl() final;
 
+  // A callback of sqlite3_busy_handler, which waits for the locks held by
+  // other connections with the WaitForLocks of `metadata_source`. It returns
+  // non-zero to retry the query, and zero to fail it with SQLITE_BUSY.
+  // (see https://www.sqlite.org/c3ref/busy_handler.html for details)
+  static int BusyHandler(void* metadata_source, int retried_times);
+
+  // Sleeps for the backoff of the `retried_times` retry of a query, and
+  // returns true, or returns false if the query has waited for the busy
+  // timeout of the performance profile.
+  bool WaitForLocks(int retried_times);
+
+  // Applies the performance profile of the config to the connection.
+  // Returns detailed INTERNAL error, if a PRAGMA statement fails.
+  tensorflow::Status ApplyPerformanceProfile();
+
   // Closes in memory db. All data stored will be cleaned up.
   tensorflow::Status CloseImpl() final;
 
@@ -52,6 +88,33 @@ class SqliteMetadataSource : public MetadataSource {
   tensorflow::Status ExecuteQueryImpl(const std::string& query,
                                       RecordSet* results) final;
 
+  // Executes a SQL statement and appends the rows to `results`, reading each
+  // column with the type of its declaration.
+  tensorflow::Status ExecuteTypedQueryImpl(const std::string& query,
+                                           TypedRecordSet* results) final;
+
+  // Executes an INSERT statement and returns the rowid of its first row.
+  tensorflow::Status ExecuteInsertQueryImpl(const std::string& query,
+                                            int64* insert_id) final;
+
+  // Executes a parameterized SQL statement with its cached prepared statement
+  // and returns the rows if any.
+  tensorflow::Status ExecuteParameterizedQueryImpl(
+      const std::string& query, const std::vector<QueryParameter>& parameters,
+      RecordSet* results) final;
+
+  // Executes a parameterized SQL statement with a prepared statement which is
+  // finalized once it runs, and returns the rows if any.
+  tensorflow::Status ExecuteUncachedQueryImpl(
+      const std::string& query, const std::vector<QueryParameter>& parameters,
+      RecordSet* results) final;
+
+  // Executes a parameterized INSERT statement with its cached prepared
+  // statement and returns the rowid of its first row.
+  tensorflow::Status ExecuteParameterizedInsertQueryImpl(
+      const std::string& query, const std::vector<QueryParameter>& parameters,
+      int64* insert_id) final;
+
   // Commits a transaction.
   tensorflow::Status CommitImpl() final;
 
@@ -61,14 +124,83 @@ class SqliteMetadataSource : public MetadataSource {
   // Begins a transaction
   tensorflow::Status BeginImpl() final;
 
-  // Util methods to execute query.
+  // Begins a deferred transaction, which takes no lock until its first read,
+  // and sets the connection query only until the transaction ends.
+  tensorflow::Status BeginReadOnlyImpl() final;
+
+  // Ends a transaction with `query`, i.e., COMMIT or ROLLBACK, and lets the
+  // connection write again if the transaction was read only.
+  tensorflow::Status EndTransaction(const char* query);
+
+  // Prepares and steps the statements of `query` in turn, and calls `on_row`
+  // for each row of their results.
+  // Returns ABORTED error, if the database stays locked by other connections.
+  // Returns detailed INTERNAL error, if a statement fails.
+  tensorflow::Status RunStatements(
+      const std::string& query, absl::FunctionRef<void(sqlite3_stmt*)> on_row);
+
+  // Runs the statements of `query` and returns the rows if any.
   tensorflow::Status RunStatement(const std::string& query, RecordSet* results);
 
+  // Prepares the single statement of `query` with `prepare_flags`.
+  // Returns INVALID_ARGUMENT error, if the query has more than one statement.
+  // Returns detailed INTERNAL error, if the query cannot be prepared.
+  tensorflow::Status PrepareSingleStatement(const std::string& query,
+                                            unsigned int prepare_flags,
+                                            sqlite3_stmt** statement);
+
+  // Finds the prepared statement of `query` in the cache, or prepares and
+  // caches it, then binds the `parameters` to it.
+  // Returns INVALID_ARGUMENT error, if the query has more than one statement,
+  // or if the number of parameters does not match the query.
+  // Returns detailed INTERNAL error, if the query cannot be prepared.
+  tensorflow::Status PrepareStatement(
+      const std::string& query, const std::vector<QueryParameter>& parameters,
+      sqlite3_stmt** statement);
+
+  // Binds the `parameters` to the placeholders of a prepared statement. The
+  // strings and blobs are bound with their sizes, so they may have NULs.
+  // Returns INVALID_ARGUMENT error, if the number of parameters does not
+  // match the query.
+  // Returns detailed INTERNAL error, if a parameter cannot be bound.
+  tensorflow::Status BindParameters(
+      const std::string& query, const std::vector<QueryParameter>& parameters,
+      sqlite3_stmt* statement);
+
+  // Steps a bound prepared statement to completion and returns the rows if
+  // any. The statement is reset for its next use.
+  // Returns ABORTED error, if the database stays locked by other connections.
+  tensorflow::Status RunPreparedStatement(const std::string& query,
+                                          sqlite3_stmt* statement,
+                                          RecordSet* results);
+
+  // Steps a prepared statement to completion, calls `on_row` for each row, and
+  // resets the statement for its next use.
+  tensorflow::Status StepStatement(
+      const std::string& query, sqlite3_stmt* statement,
+      absl::FunctionRef<void(sqlite3_stmt*)> on_row);
+
+  // Returns the error of the last failed call on the connection, from its
+  // extended result code: ABORTED for the lock conflicts, otherwise INTERNAL
+  // with `message` and the error message of Sqlite3.
+  tensorflow::Status SqliteError(absl::string_view message,
+                                 const std::string& query);
+
   // The sqlite3 handle to a database.
   sqlite3* db_ = nullptr;
 
+  // The prepared statements of the parameterized queries run by the
+  // connection, keyed by query text. They are finalized when it is closed.
+  absl::flat_hash_map<std::string, sqlite3_stmt*> prepared_statements_;
+
   // A config including connection parameters.
   SqliteMetadataSourceConfig config_;
+
+  // The time the current query has waited for locks.
+  absl::Duration busy_wait_time_;
+
+  // Whether the open transaction is read only.
+  bool read_only_transaction_ = false;
 };
 
 }  // namespace ml_metadata
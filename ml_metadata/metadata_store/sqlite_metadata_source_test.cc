@@ -15,10 +15,14 @@ limitations under the License.
 #include "ml_metadata/metadata_store/sqlite_metadata_source.h"
 
 #include <memory>
+#include <thread>  // NOLINT
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/memory/memory.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "ml_metadata/metadata_store/metadata_source_test_suite.h"
 #include "ml_metadata/metadata_store/test_util.h"
 #include "tensorflow/core/platform/env.h"
@@ -28,6 +32,7 @@ namespace testing {
 
 namespace {
 using ml_metadata::testing::EqualsProto;
+using ml_metadata::testing::ParseTextProtoOrDie;
 
 class SqliteMetadataSourceContainer : public MetadataSourceContainer {
  public:
@@ -121,6 +126,235 @@ TEST(SqliteMetadataSourceExtendedTest, TestEscapeString) {
   EXPECT_EQ(metadata_source->EscapeString("'\"text\"'"), "''\"text\"''");
 }
 
+TEST(SqliteMetadataSourceExtendedTest, TestGetDatabaseIdentifier) {
+  SqliteMetadataSourceContainer in_memory_container;
+  EXPECT_EQ(in_memory_container.GetMetadataSource()->GetDatabaseIdentifier(),
+            "");
+
+  SqliteMetadataSourceConfig shared_memory_config;
+  shared_memory_config.set_filename_uri("file:db?mode=memory&cache=shared");
+  SqliteMetadataSourceContainer shared_memory_container(shared_memory_config);
+  EXPECT_EQ(
+      shared_memory_container.GetMetadataSource()->GetDatabaseIdentifier(),
+      "");
+
+  SqliteMetadataSourceConfig file_config;
+  file_config.set_filename_uri("/tmp/test.db");
+  SqliteMetadataSourceContainer file_container(file_config);
+  SqliteMetadataSourceContainer other_file_container(file_config);
+  EXPECT_NE(file_container.GetMetadataSource()->GetDatabaseIdentifier(), "");
+  EXPECT_EQ(file_container.GetMetadataSource()->GetDatabaseIdentifier(),
+            other_file_container.GetMetadataSource()->GetDatabaseIdentifier());
+}
+
+TEST(SqliteMetadataSourceExtendedTest, TestExecuteInsertQuery) {
+  SqliteMetadataSourceContainer container;
+  MetadataSource* metadata_source = container.GetMetadataSource();
+  TF_ASSERT_OK(metadata_source->Connect());
+  TF_ASSERT_OK(metadata_source->Begin());
+  TF_ASSERT_OK(metadata_source->ExecuteQuery(
+      "CREATE TABLE t1 (id INTEGER PRIMARY KEY AUTOINCREMENT, c1 INT);",
+      nullptr));
+  int64 insert_id;
+  TF_ASSERT_OK(metadata_source->ExecuteInsertQuery(
+      "INSERT INTO t1 (c1) VALUES (1);", &insert_id));
+  EXPECT_EQ(insert_id, 1);
+  // The id of the first row is returned for a multi-row insert.
+  TF_ASSERT_OK(metadata_source->ExecuteInsertQuery(
+      "INSERT INTO t1 (c1) VALUES (2), (3), (4);", &insert_id));
+  EXPECT_EQ(insert_id, 2);
+  TF_ASSERT_OK(metadata_source->ExecuteInsertQuery(
+      "INSERT INTO t1 (c1) VALUES (5);", &insert_id));
+  EXPECT_EQ(insert_id, 5);
+  TF_ASSERT_OK(metadata_source->Commit());
+}
+
+TEST(SqliteMetadataSourceExtendedTest, TestExecuteUncachedQuery) {
+  SqliteMetadataSourceContainer container;
+  MetadataSource* metadata_source = container.GetMetadataSource();
+  TF_ASSERT_OK(metadata_source->Connect());
+  TF_ASSERT_OK(metadata_source->Begin());
+  TF_ASSERT_OK(metadata_source->ExecuteQuery(
+      "CREATE TABLE t1 (c1 TEXT); INSERT INTO t1 VALUES ('a'), ('ab');",
+      nullptr));
+  // The bound strings are compared with their NULs, instead of being cut at
+  // the first one.
+  const std::string value("a\0b", 3);
+  RecordSet results;
+  TF_ASSERT_OK(metadata_source->ExecuteUncachedQuery(
+      "SELECT COUNT(*) FROM t1 WHERE c1 = ?;", {value}, &results));
+  EXPECT_THAT(results, EqualsProto(ParseTextProtoOrDie<RecordSet>(R"(
+                column_names: "COUNT(*)"
+                records: { values: "0" })")));
+  TF_ASSERT_OK(metadata_source->ExecuteQuery(
+      "INSERT INTO t1 VALUES (?);", {value}, nullptr));
+  results.Clear();
+  TF_ASSERT_OK(metadata_source->ExecuteUncachedQuery(
+      "SELECT LENGTH(CAST(c1 AS BLOB)) FROM t1 WHERE c1 = ?;", {value},
+      &results));
+  EXPECT_THAT(results, EqualsProto(ParseTextProtoOrDie<RecordSet>(R"(
+                column_names: "LENGTH(CAST(c1 AS BLOB))"
+                records: { values: "3" })")));
+  EXPECT_EQ(metadata_source
+                ->ExecuteUncachedQuery("SELECT ?; SELECT 1;", {value},
+                                       &results)
+                .code(),
+            tensorflow::error::INVALID_ARGUMENT);
+  TF_ASSERT_OK(metadata_source->Commit());
+}
+
+TEST(SqliteMetadataSourceExtendedTest, TestPerformanceProfile) {
+  const std::string filename_uri =
+      absl::StrCat(::testing::TempDir(), "test_performance_profile.db");
+  SqliteMetadataSourceConfig config = ParseTextProtoOrDie<
+      SqliteMetadataSourceConfig>(R"(
+        performance_profile {
+          journal_mode: JOURNAL_MODE_WAL
+          synchronous: SYNCHRONOUS_NORMAL
+          cache_size: -4096
+          temp_store: TEMP_STORE_MEMORY
+        })");
+  config.set_filename_uri(filename_uri);
+  {
+    SqliteMetadataSourceContainer container(config);
+    MetadataSource* metadata_source = container.GetMetadataSource();
+    TF_ASSERT_OK(metadata_source->Connect());
+    TF_ASSERT_OK(metadata_source->Begin());
+    RecordSet results;
+    TF_ASSERT_OK(metadata_source->ExecuteQuery(
+        "PRAGMA journal_mode; PRAGMA synchronous; PRAGMA cache_size; "
+        "PRAGMA temp_store;",
+        &results));
+    TF_ASSERT_OK(metadata_source->Commit());
+    EXPECT_THAT(results, EqualsProto(ParseTextProtoOrDie<RecordSet>(R"(
+                  column_names: "journal_mode"
+                  records: { values: "wal" }
+                  records: { values: "1" }
+                  records: { values: "-4096" }
+                  records: { values: "2" })")));
+    TF_ASSERT_OK(metadata_source->Close());
+  }
+  TF_CHECK_OK(tensorflow::Env::Default()->DeleteFile(filename_uri));
+
+  // In memory databases keep their journal mode.
+  SqliteMetadataSourceContainer in_memory_container(
+      ParseTextProtoOrDie<SqliteMetadataSourceConfig>(
+          "performance_profile { journal_mode: JOURNAL_MODE_WAL }"));
+  TF_EXPECT_OK(in_memory_container.GetMetadataSource()->Connect());
+}
+
+TEST(SqliteMetadataSourceExtendedTest, TestInvalidBusyBackoff) {
+  SqliteMetadataSourceContainer negative_container(
+      ParseTextProtoOrDie<SqliteMetadataSourceConfig>(
+          "performance_profile { busy_initial_backoff_us: -1 }"));
+  EXPECT_EQ(negative_container.GetMetadataSource()->Connect().code(),
+            tensorflow::error::INVALID_ARGUMENT);
+
+  SqliteMetadataSourceContainer decreasing_container(
+      ParseTextProtoOrDie<SqliteMetadataSourceConfig>(R"(
+        performance_profile {
+          busy_initial_backoff_us: 100
+          busy_max_backoff_us: 10
+        })"));
+  EXPECT_EQ(decreasing_container.GetMetadataSource()->Connect().code(),
+            tensorflow::error::INVALID_ARGUMENT);
+}
+
+TEST(SqliteMetadataSourceExtendedTest, TestExecuteMultipleStatements) {
+  SqliteMetadataSourceContainer container;
+  MetadataSource* metadata_source = container.GetMetadataSource();
+  TF_ASSERT_OK(metadata_source->Connect());
+  TF_ASSERT_OK(metadata_source->Begin());
+  TF_ASSERT_OK(metadata_source->ExecuteQuery(
+      "CREATE TABLE t1 (c1 INT, c2 BLOB); -- a comment \n"
+      "INSERT INTO t1 VALUES (1, X'00FF'), (2, NULL);;",
+      nullptr));
+  RecordSet results;
+  TF_ASSERT_OK(metadata_source->ExecuteQuery(
+      "SELECT c1 FROM t1 WHERE c2 IS NULL; SELECT c1, c2 FROM t1 LIMIT 1; ",
+      &results));
+  ASSERT_EQ(results.records_size(), 2);
+  EXPECT_EQ(results.records(0).values(0), "2");
+  EXPECT_EQ(results.records(1).values(1), std::string("\x00\xff", 2));
+  TF_ASSERT_OK(metadata_source->Commit());
+}
+
+TEST(SqliteMetadataSourceExtendedTest, TestReadOnlyTransaction) {
+  SqliteMetadataSourceContainer container;
+  container.InitTestSchema();
+  MetadataSource* metadata_source = container.GetMetadataSource();
+  TF_ASSERT_OK(metadata_source->BeginReadOnly());
+  TF_ASSERT_OK(metadata_source->ExecuteQuery("SELECT * FROM t1", nullptr));
+  EXPECT_FALSE(
+      metadata_source->ExecuteQuery("INSERT INTO t1 VALUES (1, 'v1')", nullptr)
+          .ok());
+  TF_ASSERT_OK(metadata_source->Rollback());
+
+  // The transactions after it can write.
+  TF_ASSERT_OK(metadata_source->Begin());
+  TF_EXPECT_OK(metadata_source->ExecuteQuery(
+      "INSERT INTO t1 VALUES (1, 'v1')", nullptr));
+  TF_ASSERT_OK(metadata_source->Commit());
+
+  // Even if the read only transaction fails to end: its COMMIT fails when
+  // it has already been committed, and the transaction is then rolled back.
+  TF_ASSERT_OK(metadata_source->BeginReadOnly());
+  TF_ASSERT_OK(metadata_source->ExecuteQuery("COMMIT;", nullptr));
+  EXPECT_FALSE(metadata_source->Commit().ok());
+  TF_ASSERT_OK(metadata_source->ExecuteQuery("BEGIN;", nullptr));
+  TF_ASSERT_OK(metadata_source->Rollback());
+  TF_ASSERT_OK(metadata_source->Begin());
+  TF_EXPECT_OK(metadata_source->ExecuteQuery(
+      "INSERT INTO t1 VALUES (2, 'v2')", nullptr));
+  TF_ASSERT_OK(metadata_source->Commit());
+}
+
+TEST(SqliteMetadataSourceExtendedTest, TestWaitForLockedDatabase) {
+  const std::string filename_uri =
+      absl::StrCat(::testing::TempDir(), "test_locked_database.db");
+  SqliteMetadataSourceConfig config;
+  config.set_filename_uri(filename_uri);
+  config.mutable_performance_profile()->set_busy_timeout_ms(200);
+  SqliteMetadataSourceContainer container(config);
+  container.InitTestSchema();
+  MetadataSource* metadata_source = container.GetMetadataSource();
+  TF_ASSERT_OK(metadata_source->Begin());
+  TF_ASSERT_OK(metadata_source->ExecuteQuery(
+      "INSERT INTO t1 VALUES (1, 'v1')", nullptr));
+
+  // Transactions take the write lock when they begin, and fail once the busy
+  // timeout is over.
+  SqliteMetadataSourceContainer other_container(config);
+  MetadataSource* other_metadata_source = other_container.GetMetadataSource();
+  TF_ASSERT_OK(other_metadata_source->Connect());
+  const absl::Time start_time = absl::Now();
+  EXPECT_EQ(other_metadata_source->Begin().code(),
+            tensorflow::error::ABORTED);
+  EXPECT_GE(absl::Now() - start_time, absl::Milliseconds(200));
+
+  // They get the lock once it is released. The waiting transaction has a
+  // long busy timeout, so that it does not depend on when the lock is
+  // released.
+  config.mutable_performance_profile()->set_busy_timeout_ms(60000);
+  SqliteMetadataSourceContainer waiting_container(config);
+  MetadataSource* waiting_metadata_source =
+      waiting_container.GetMetadataSource();
+  TF_ASSERT_OK(waiting_metadata_source->Connect());
+  absl::Notification waiting;
+  std::thread waiting_thread([waiting_metadata_source, &waiting]() {
+    waiting.Notify();
+    TF_EXPECT_OK(waiting_metadata_source->Begin());
+  });
+  // The lock is held until the other transaction starts waiting for it.
+  waiting.WaitForNotification();
+  TF_ASSERT_OK(metadata_source->Commit());
+  waiting_thread.join();
+  TF_ASSERT_OK(waiting_metadata_source->ExecuteQuery(
+      "INSERT INTO t1 VALUES (2, 'v2')", nullptr));
+  TF_ASSERT_OK(waiting_metadata_source->Commit());
+  TF_CHECK_OK(tensorflow::Env::Default()->DeleteFile(filename_uri));
+}
+
 }  // namespace
 
 INSTANTIATE_TEST_CASE_P(
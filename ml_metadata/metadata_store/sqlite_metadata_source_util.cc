@@ -14,8 +14,6 @@ limitations under the License.
 ==============================================================================*/
 #include "ml_metadata/metadata_store/sqlite_metadata_source_util.h"
 
-#include "ml_metadata/proto/metadata_source.pb.h"
-#include "ml_metadata/metadata_store/constants.h"
 #include "sqlite3.h"
 
 namespace ml_metadata {
@@ -27,24 +25,4 @@ std::string SqliteEscapeString(absl::string_view value) {
   return result;
 }
 
-int ConvertSqliteResultsToRecordSet(void* results, int column_num,
-                                    char** column_vals, char** column_names) {
-  // return if queries return no result, e.g., create, insert, update, etc.
-  if (column_num == 0) return SQLITE_OK;
-  RecordSet* record_set = static_cast<RecordSet*>(results);
-  // ignore the results of the query, if the user passes a nullptr for results.
-  if (record_set == nullptr) return SQLITE_OK;
-  // parse the query results to the record_sets (column_names and records)
-  // as sqlite calls the callback repetitively for each row, it sets the column
-  // names at the first time.
-  bool is_column_name_initted = (record_set->column_names_size() == column_num);
-  if (!is_column_name_initted) record_set->clear_column_names();
-  RecordSet::Record* record = record_set->add_records();
-  for (int i = 0; i < column_num; i++) {
-    if (!is_column_name_initted) record_set->add_column_names(column_names[i]);
-    record->add_values(column_vals[i] ? column_vals[i] : kMetadataSourceNull);
-  }
-  return SQLITE_OK;
-}
-
 }  // namespace ml_metadata
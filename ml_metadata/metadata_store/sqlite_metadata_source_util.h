@@ -24,14 +24,6 @@ namespace ml_metadata {
 // Escapes strings having single quotes using built-in printf in Sqlite3 C API.
 std::string SqliteEscapeString(absl::string_view value);
 
-// Converts the query results (`column_vals`) if any to a RecordSet (`results`).
-// It is used as a callback of sqlite3_exec. The `results` should be owned by
-// the caller of sqlite3_exec. If the given RecordSet (`results`) is nullptr,
-// the query result is ignored.
-// (see https://www.sqlite.org/c3ref/exec.html for details)
-int ConvertSqliteResultsToRecordSet(void* results, int column_num,
-                                    char** column_vals, char** column_names);
-
 }  // namespace ml_metadata
 
 #endif  // ML_METADATA_METADATA_STORE_SQLITE_METADATA_SOURCE_UTIL_H_
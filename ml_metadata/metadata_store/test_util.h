@@ -23,6 +23,7 @@ limitations under the License.
 #include "google/protobuf/util/message_differencer.h"
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "tensorflow/core/platform/logging.h"
 
 namespace ml_metadata {
 namespace testing {
@@ -15,18 +15,123 @@ limitations under the License.
 
 #include "ml_metadata/metadata_store/transaction_executor.h"
 
+#include <algorithm>
+#include <random>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/monitoring/counter.h"
 
 namespace ml_metadata {
 
+namespace {
+
+// The counters of the attempts of the transactions by their status, i.e., ok,
+// aborted or error, across all the executors of the process.
+tensorflow::monitoring::Counter<1>* TransactionAttemptsCounter() {
+  static auto* counter = tensorflow::monitoring::Counter<1>::New(
+      "/ml_metadata/transaction/attempts",
+      "The number of attempts of the transactions.", "status");
+  return counter;
+}
+
+tensorflow::monitoring::Counter<0>* TransactionRetriesCounter() {
+  static auto* counter = tensorflow::monitoring::Counter<0>::New(
+      "/ml_metadata/transaction/retries",
+      "The number of retries of the aborted transactions.");
+  return counter;
+}
+
+tensorflow::monitoring::Counter<0>* TransactionBackoffMicrosecondsCounter() {
+  static auto* counter = tensorflow::monitoring::Counter<0>::New(
+      "/ml_metadata/transaction/backoff_microseconds",
+      "The time waited before the retries of the aborted transactions.");
+  return counter;
+}
+
+// Returns the label of `status` in TransactionAttemptsCounter.
+const char* AttemptStatusLabel(const tensorflow::Status& status) {
+  if (status.ok()) return "ok";
+  return tensorflow::errors::IsAborted(status) ? "aborted" : "error";
+}
+
+// Returns the wait before the `retried_times` retry of a transaction: the
+// initial backoff doubled at each retry up to the max backoff, half of which
+// is random so that the conflicting transactions do not retry in lockstep.
+absl::Duration GetBackoff(
+    const RetryOptions::TransactionRetryOptions& retry_options,
+    const int retried_times) {
+  // The doubling saturates at the max backoff, so that large options or many
+  // retries do not overflow.
+  const int64 max_backoff_ms =
+      std::max<int64>(retry_options.max_backoff_ms(), 0);
+  int64 backoff_ms = std::min(
+      std::max<int64>(retry_options.initial_backoff_ms(), 0), max_backoff_ms);
+  for (int i = 0; i < retried_times && backoff_ms < max_backoff_ms; ++i) {
+    if (backoff_ms == 0) break;
+    backoff_ms += std::min(backoff_ms, max_backoff_ms - backoff_ms);
+  }
+  // The conversion saturates at the max int64 microseconds.
+  const int64 backoff_us = std::max<int64>(
+      absl::ToInt64Microseconds(absl::Milliseconds(backoff_ms)), 1);
+  static thread_local std::minstd_rand0 generator(std::random_device{}());
+  std::uniform_int_distribution<int64> jitter_us(0, backoff_us / 2);
+  return absl::Microseconds(backoff_us - backoff_us / 2 + jitter_us(generator));
+}
+
+}  // namespace
+
 tensorflow::Status RdbmsTransactionExecutor::Execute(
     const std::function<tensorflow::Status()>& txn_body) const {
+  return ExecuteInTransaction(
+      [this]() -> tensorflow::Status { return metadata_source_->Begin(); },
+      txn_body);
+}
+
+tensorflow::Status RdbmsTransactionExecutor::ExecuteReadOnly(
+    const std::function<tensorflow::Status()>& txn_body) const {
+  return ExecuteInTransaction(
+      [this]() -> tensorflow::Status {
+        return metadata_source_->BeginReadOnly();
+      },
+      txn_body);
+}
+
+tensorflow::Status RdbmsTransactionExecutor::ExecuteInTransaction(
+    const std::function<tensorflow::Status()>& begin,
+    const std::function<tensorflow::Status()>& txn_body) const {
   if (metadata_source_ == nullptr || !metadata_source_->is_connected()) {
     return tensorflow::errors::FailedPrecondition(
         "To use ExecuteTransaction, the metadata_source should be created and "
         "connected");
   }
-  TF_RETURN_IF_ERROR(metadata_source_->Begin());
+  const absl::Time deadline =
+      retry_options_.deadline_ms() > 0
+          ? absl::Now() + absl::Milliseconds(retry_options_.deadline_ms())
+          : absl::InfiniteFuture();
+  for (int retried_times = 0;; ++retried_times) {
+    const tensorflow::Status status = RunTransaction(begin, txn_body);
+    TransactionAttemptsCounter()
+        ->GetCell(AttemptStatusLabel(status))
+        ->IncrementBy(1);
+    if (!tensorflow::errors::IsAborted(status) ||
+        retried_times >= retry_options_.max_num_retries()) {
+      return status;
+    }
+    const absl::Duration backoff = GetBackoff(retry_options_, retried_times);
+    if (absl::Now() + backoff > deadline) return status;
+    absl::SleepFor(backoff);
+    TransactionRetriesCounter()->GetCell()->IncrementBy(1);
+    TransactionBackoffMicrosecondsCounter()->GetCell()->IncrementBy(
+        absl::ToInt64Microseconds(backoff));
+  }
+}
+
+tensorflow::Status RdbmsTransactionExecutor::RunTransaction(
+    const std::function<tensorflow::Status()>& begin,
+    const std::function<tensorflow::Status()>& txn_body) const {
+  TF_RETURN_IF_ERROR(begin());
   tensorflow::Status transaction_status = txn_body();
   if (transaction_status.ok()) {
     transaction_status.Update(metadata_source_->Commit());
@@ -17,6 +17,7 @@ limitations under the License.
 #define THIRD_PARTY_ML_METADATA_METADATA_STORE_TRANSACTION_EXECUTOR_H_
 
 #include "ml_metadata/metadata_store/metadata_source.h"
+#include "ml_metadata/proto/metadata_store.pb.h"
 #include "tensorflow/core/lib/core/status.h"
 
 namespace ml_metadata {
@@ -37,20 +38,38 @@ class TransactionExecutor {
   // Runs txn_body and return the transaction status.
   virtual tensorflow::Status Execute(
       const std::function<tensorflow::Status()>& txn_body) const = 0;
+
+  // Runs txn_body, which only reads, and return the transaction status. The
+  // executors may run it in a read only transaction. By default, it is run
+  // with Execute.
+  virtual tensorflow::Status ExecuteReadOnly(
+      const std::function<tensorflow::Status()>& txn_body) const {
+    return Execute(txn_body);
+  }
 };
 
 // An implementation of TransactionExecutor.
 // It contains a method to execute the transaction body and tries to commit
 // the execution result in the database by using Begin/Commit/Rollback
-// methods in MetadataSource.
+// methods in MetadataSource. The transactions aborted by the database are
+// retried with the given retry options.
 class RdbmsTransactionExecutor : public TransactionExecutor {
  public:
   explicit RdbmsTransactionExecutor(MetadataSource* metadata_source)
       : metadata_source_(metadata_source) {}
+  RdbmsTransactionExecutor(
+      MetadataSource* metadata_source,
+      const RetryOptions::TransactionRetryOptions& retry_options)
+      : metadata_source_(metadata_source), retry_options_(retry_options) {}
   ~RdbmsTransactionExecutor() override = default;
 
   // Tries to commit the execution result of txn_body.
   // When the txn_body returns OK, it calls Commit, otherwise it calls Rollback.
+  // If the transaction returns ABORTED, it is rolled back and run again after
+  // a backoff, for up to the max number of retries and the deadline of the
+  // retry options. The aborted transactions are rolled back by the database,
+  // so txn_body must only change the database and its own outputs, which it
+  // must reset when it begins.
   //
   // Returns FAILED_PRECONDITION if metadata_source is null or not connected.
   // Returns detailed internal errors of transaction, i.e.
@@ -58,11 +77,36 @@ class RdbmsTransactionExecutor : public TransactionExecutor {
   tensorflow::Status Execute(
       const std::function<tensorflow::Status()>& txn_body) const override;
 
+  // Runs txn_body in a transaction opened with BeginReadOnly, and commits it.
+  // The backends skip the write locks of the transaction, and the queries
+  // writing to the database may fail in it.
+  //
+  // Returns FAILED_PRECONDITION if metadata_source is null or not connected.
+  // Returns detailed internal errors of transaction, i.e.
+  //   BeginReadOnly, Rollback and Commit.
+  tensorflow::Status ExecuteReadOnly(
+      const std::function<tensorflow::Status()>& txn_body) const override;
+
  private:
+  // Runs txn_body in a transaction opened with `begin`, and commits or rolls
+  // back the transaction. Retries the aborted transactions.
+  tensorflow::Status ExecuteInTransaction(
+      const std::function<tensorflow::Status()>& begin,
+      const std::function<tensorflow::Status()>& txn_body) const;
+
+  // Runs a single attempt of ExecuteInTransaction.
+  tensorflow::Status RunTransaction(
+      const std::function<tensorflow::Status()>& begin,
+      const std::function<tensorflow::Status()>& txn_body) const;
+
   // The MetadataSource which has the connection to a database.
   // It also supports other database primitves like Commit and Abort.
   // Not owned by this class.
   MetadataSource* metadata_source_;
+
+  // The options of the retries of the aborted transactions. By default, the
+  // transactions are not retried.
+  const RetryOptions::TransactionRetryOptions retry_options_;
 };
 
 }  // namespace ml_metadata
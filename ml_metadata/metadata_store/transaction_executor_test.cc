@@ -16,6 +16,7 @@ limitations under the License.
 #include "ml_metadata/metadata_store/transaction_executor.h"
 
 #include <functional>
+#include <limits>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -31,12 +32,15 @@ using ::testing::Return;
 class MockMetadataSource : public MetadataSource {
  public:
   MOCK_METHOD(tensorflow::Status, BeginImpl, (), (override));
+  MOCK_METHOD(tensorflow::Status, BeginReadOnlyImpl, (), (override));
   MOCK_METHOD(tensorflow::Status, ConnectImpl, (), (override));
   MOCK_METHOD(tensorflow::Status, CloseImpl, (), (override));
   MOCK_METHOD(tensorflow::Status, RollbackImpl, (), (override));
   MOCK_METHOD(tensorflow::Status, CommitImpl, (), ());
   MOCK_METHOD(tensorflow::Status, ExecuteQueryImpl,
               (const std::string& query, RecordSet* results), (override));
+  MOCK_METHOD(tensorflow::Status, ExecuteInsertQueryImpl,
+              (const std::string& query, int64* insert_id), (override));
   MOCK_METHOD(std::string, EscapeString, (absl::string_view value),
               (const, override));
 };
@@ -52,6 +56,8 @@ const tensorflow::Status kTfRollbackErrorStatus =
     tensorflow::errors::Internal("Fake rollback error.");
 const tensorflow::Status kTfBeginErrorStatus =
     tensorflow::errors::Internal("Fake begin error.");
+const tensorflow::Status kTfAbortedStatus =
+    tensorflow::errors::Aborted("Fake deadlock.");
 
 // Fake transaction body that always return OK status.
 const std::function<tensorflow::Status()> kFuncReturnOk =
@@ -136,6 +142,116 @@ TEST(TransactionExecutorTest, ReturnErrorWhenTxnBodyReturnsOkButCommitFails) {
   EXPECT_EQ(txn_executor.Execute(kFuncReturnOk), kTfCommitErrorStatus);
 }
 
+TEST(TransactionExecutorTest, ExecuteReadOnlyBeginsReadOnlyTransaction) {
+  MockMetadataSource mock_metadata_source;
+  // These calls should be called once and only once.
+  EXPECT_CALL(mock_metadata_source, BeginReadOnlyImpl())
+      .Times(1)
+      .WillOnce(Return(tensorflow::Status::OK()));
+  EXPECT_CALL(mock_metadata_source, ConnectImpl())
+      .Times(1)
+      .WillOnce(Return(tensorflow::Status::OK()));
+  EXPECT_CALL(mock_metadata_source, CommitImpl())
+      .Times(1)
+      .WillOnce(Return(tensorflow::Status::OK()));
+  // These methods should not be called.
+  EXPECT_CALL(mock_metadata_source, BeginImpl())
+      .Times(0);
+  EXPECT_CALL(mock_metadata_source, RollbackImpl())
+      .Times(0);
+  EXPECT_CALL(mock_metadata_source, CloseImpl())
+      .Times(0);
+
+  // Initialize the mock_metadata_source.
+  TF_ASSERT_OK(mock_metadata_source.Connect());
+  RdbmsTransactionExecutor txn_executor(&mock_metadata_source);
+
+  TF_EXPECT_OK(txn_executor.ExecuteReadOnly(kFuncReturnOk));
+}
+
+TEST(TransactionExecutorTest, RetryAbortedTransaction) {
+  MockMetadataSource mock_metadata_source;
+  EXPECT_CALL(mock_metadata_source, ConnectImpl())
+      .WillOnce(Return(tensorflow::Status::OK()));
+  EXPECT_CALL(mock_metadata_source, BeginImpl())
+      .Times(2)
+      .WillRepeatedly(Return(tensorflow::Status::OK()));
+  // The first attempt is aborted at commit time, and rolled back.
+  EXPECT_CALL(mock_metadata_source, CommitImpl())
+      .Times(2)
+      .WillOnce(Return(kTfAbortedStatus))
+      .WillOnce(Return(tensorflow::Status::OK()));
+  EXPECT_CALL(mock_metadata_source, RollbackImpl())
+      .Times(1)
+      .WillOnce(Return(tensorflow::Status::OK()));
+
+  TF_ASSERT_OK(mock_metadata_source.Connect());
+  RetryOptions::TransactionRetryOptions retry_options;
+  retry_options.set_max_num_retries(3);
+  retry_options.set_initial_backoff_ms(1);
+  RdbmsTransactionExecutor txn_executor(&mock_metadata_source, retry_options);
+
+  int num_attempts = 0;
+  TF_EXPECT_OK(txn_executor.Execute([&num_attempts]() -> tensorflow::Status {
+    num_attempts++;
+    return tensorflow::Status::OK();
+  }));
+  EXPECT_EQ(num_attempts, 2);
+}
+
+TEST(TransactionExecutorTest, ReturnAbortedWhenRetriesAreExhausted) {
+  MockMetadataSource mock_metadata_source;
+  EXPECT_CALL(mock_metadata_source, ConnectImpl())
+      .WillOnce(Return(tensorflow::Status::OK()));
+  EXPECT_CALL(mock_metadata_source, BeginReadOnlyImpl())
+      .Times(3)
+      .WillRepeatedly(Return(tensorflow::Status::OK()));
+  EXPECT_CALL(mock_metadata_source, RollbackImpl())
+      .Times(3)
+      .WillRepeatedly(Return(tensorflow::Status::OK()));
+  EXPECT_CALL(mock_metadata_source, CommitImpl()).Times(0);
+
+  TF_ASSERT_OK(mock_metadata_source.Connect());
+  RetryOptions::TransactionRetryOptions retry_options;
+  retry_options.set_max_num_retries(2);
+  retry_options.set_initial_backoff_ms(1);
+  RdbmsTransactionExecutor txn_executor(&mock_metadata_source, retry_options);
+
+  EXPECT_EQ(txn_executor.ExecuteReadOnly(
+                []() -> tensorflow::Status { return kTfAbortedStatus; }),
+            kTfAbortedStatus);
+  // The other errors are not retried.
+  EXPECT_CALL(mock_metadata_source, BeginReadOnlyImpl())
+      .WillOnce(Return(tensorflow::Status::OK()));
+  EXPECT_CALL(mock_metadata_source, RollbackImpl())
+      .WillOnce(Return(tensorflow::Status::OK()));
+  EXPECT_EQ(txn_executor.ExecuteReadOnly(kFuncReturnInternalError),
+            kTfFuncErrorStatus);
+}
+
+TEST(TransactionExecutorTest, ReturnAbortedWhenTheBackoffPassesTheDeadline) {
+  MockMetadataSource mock_metadata_source;
+  EXPECT_CALL(mock_metadata_source, ConnectImpl())
+      .WillOnce(Return(tensorflow::Status::OK()));
+  EXPECT_CALL(mock_metadata_source, BeginImpl())
+      .WillOnce(Return(tensorflow::Status::OK()));
+  EXPECT_CALL(mock_metadata_source, RollbackImpl())
+      .WillOnce(Return(tensorflow::Status::OK()));
+
+  TF_ASSERT_OK(mock_metadata_source.Connect());
+  // The backoff saturates instead of overflowing, and is beyond the deadline.
+  RetryOptions::TransactionRetryOptions retry_options;
+  retry_options.set_max_num_retries(100);
+  retry_options.set_initial_backoff_ms(int64{1} << 40);
+  retry_options.set_max_backoff_ms(std::numeric_limits<int64>::max());
+  retry_options.set_deadline_ms(1000);
+  RdbmsTransactionExecutor txn_executor(&mock_metadata_source, retry_options);
+
+  EXPECT_EQ(txn_executor.Execute(
+                []() -> tensorflow::Status { return kTfAbortedStatus; }),
+            kTfAbortedStatus);
+}
+
 TEST(TransactionExecutorTest, ReturnConnectErrorWhenConnectFails) {
   MockMetadataSource mock_metadata_source;
   // These calls should be called once and only once.
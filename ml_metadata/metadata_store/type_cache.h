@@ -0,0 +1,93 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef ML_METADATA_METADATA_STORE_TYPE_CACHE_H_
+#define ML_METADATA_METADATA_STORE_TYPE_CACHE_H_
+
+#include <string>
+#include <tuple>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "ml_metadata/metadata_store/types.h"
+#include "ml_metadata/proto/metadata_store.pb.h"
+
+namespace ml_metadata {
+
+// An in-memory copy of the types of a metadata source, which can be looked up
+// by type id or by type name. ArtifactType, ExecutionType and ContextType are
+// kept apart, as type names are only unique within a kind of type.
+//
+// The cache does not know when the stored types change; its owner is
+// responsible for clearing it. The class is not thread-safe.
+class TypeCache {
+ public:
+  TypeCache() = default;
+
+  // Disallows copy.
+  TypeCache(const TypeCache&) = delete;
+  TypeCache& operator=(const TypeCache&) = delete;
+
+  // Finds a cached `Type`, which is one of {ArtifactType, ExecutionType,
+  // ContextType}, by its id. Returns false if the type is not cached.
+  template <typename Type>
+  bool Find(int64 type_id, Type* type) const {
+    const Entries<Type>& entries = std::get<Entries<Type>>(entries_);
+    auto iter = entries.types_by_id.find(type_id);
+    if (iter == entries.types_by_id.end()) return false;
+    *type = iter->second;
+    return true;
+  }
+
+  // Finds a cached `Type` by its name. Returns false if the type is not cached.
+  template <typename Type>
+  bool Find(absl::string_view type_name, Type* type) const {
+    const Entries<Type>& entries = std::get<Entries<Type>>(entries_);
+    auto iter = entries.type_ids_by_name.find(type_name);
+    if (iter == entries.type_ids_by_name.end()) return false;
+    return Find(iter->second, type);
+  }
+
+  // Caches a stored type, which must have its id and name. Replaces the cached
+  // version of the type, if any.
+  template <typename Type>
+  void Insert(const Type& type) {
+    Entries<Type>& entries = std::get<Entries<Type>>(entries_);
+    entries.types_by_id[type.id()] = type;
+    entries.type_ids_by_name[type.name()] = type.id();
+  }
+
+  // Removes all cached types.
+  void Clear() {
+    std::get<Entries<ArtifactType>>(entries_) = {};
+    std::get<Entries<ExecutionType>>(entries_) = {};
+    std::get<Entries<ContextType>>(entries_) = {};
+  }
+
+ private:
+  // The cached types of one kind.
+  template <typename Type>
+  struct Entries {
+    absl::flat_hash_map<int64, Type> types_by_id;
+    absl::flat_hash_map<std::string, int64> type_ids_by_name;
+  };
+
+  std::tuple<Entries<ArtifactType>, Entries<ExecutionType>,
+             Entries<ContextType>>
+      entries_;
+};
+
+}  // namespace ml_metadata
+
+#endif  // ML_METADATA_METADATA_STORE_TYPE_CACHE_H_
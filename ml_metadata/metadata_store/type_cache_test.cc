@@ -0,0 +1,80 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "ml_metadata/metadata_store/type_cache.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "ml_metadata/metadata_store/test_util.h"
+#include "ml_metadata/proto/metadata_store.pb.h"
+
+namespace ml_metadata {
+namespace {
+
+using testing::EqualsProto;
+using testing::ParseTextProtoOrDie;
+
+TEST(TypeCacheTest, FindByIdAndName) {
+  TypeCache type_cache;
+  const ArtifactType want_type = ParseTextProtoOrDie<ArtifactType>(R"(
+    id: 1
+    name: 'test_type'
+    properties { key: 'property_1' value: INT }
+  )");
+  ArtifactType got_type;
+  EXPECT_FALSE(type_cache.Find(1, &got_type));
+
+  type_cache.Insert(want_type);
+  ASSERT_TRUE(type_cache.Find(1, &got_type));
+  EXPECT_THAT(got_type, EqualsProto(want_type));
+  ArtifactType got_type_by_name;
+  ASSERT_TRUE(type_cache.Find("test_type", &got_type_by_name));
+  EXPECT_THAT(got_type_by_name, EqualsProto(want_type));
+  EXPECT_FALSE(type_cache.Find(2, &got_type));
+  EXPECT_FALSE(type_cache.Find("unknown_type", &got_type));
+}
+
+TEST(TypeCacheTest, KindsOfTypesAreSeparate) {
+  TypeCache type_cache;
+  type_cache.Insert(ParseTextProtoOrDie<ArtifactType>("id: 1 name: 'a'"));
+  type_cache.Insert(ParseTextProtoOrDie<ExecutionType>("id: 2 name: 'a'"));
+
+  ExecutionType execution_type;
+  EXPECT_FALSE(type_cache.Find(1, &execution_type));
+  ASSERT_TRUE(type_cache.Find("a", &execution_type));
+  EXPECT_EQ(execution_type.id(), 2);
+  ContextType context_type;
+  EXPECT_FALSE(type_cache.Find("a", &context_type));
+}
+
+TEST(TypeCacheTest, InsertReplacesAndClearRemoves) {
+  TypeCache type_cache;
+  type_cache.Insert(ParseTextProtoOrDie<ContextType>("id: 1 name: 'a'"));
+  const ContextType updated_type = ParseTextProtoOrDie<ContextType>(R"(
+    id: 1
+    name: 'a'
+    properties { key: 'property_1' value: STRING }
+  )");
+  type_cache.Insert(updated_type);
+  ContextType got_type;
+  ASSERT_TRUE(type_cache.Find("a", &got_type));
+  EXPECT_THAT(got_type, EqualsProto(updated_type));
+
+  type_cache.Clear();
+  EXPECT_FALSE(type_cache.Find(1, &got_type));
+  EXPECT_FALSE(type_cache.Find("a", &got_type));
+}
+
+}  // namespace
+}  // namespace ml_metadata
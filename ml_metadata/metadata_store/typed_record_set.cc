@@ -0,0 +1,181 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "ml_metadata/metadata_store/typed_record_set.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "absl/strings/numbers.h"
+#include "ml_metadata/metadata_store/constants.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace ml_metadata {
+namespace {
+
+// The size of the blocks of the string pool. Larger strings get a block of
+// their own.
+constexpr size_t kPoolBlockSize = 64 * 1024;
+
+}  // namespace
+
+void TypedRecordSet::Clear() {
+  columns_.clear();
+  num_rows_ = 0;
+  pool_blocks_.clear();
+  pool_block_used_ = 0;
+  pool_block_size_ = 0;
+}
+
+void TypedRecordSet::AddColumn(absl::string_view name, ColumnType type) {
+  CHECK_EQ(num_rows_, 0) << "Columns must be added before the rows.";
+  columns_.push_back(Column());
+  columns_.back().name = std::string(name);
+  columns_.back().type = type;
+}
+
+void TypedRecordSet::AddRow() {
+  for (Column& column : columns_) {
+    switch (column.type) {
+      case ColumnType::kInt64:
+        column.int64_values.push_back(0);
+        break;
+      case ColumnType::kDouble:
+        column.double_values.push_back(0.0);
+        break;
+      case ColumnType::kString:
+        column.string_values.push_back(absl::string_view());
+        break;
+    }
+    column.nulls.push_back(true);
+  }
+  num_rows_++;
+}
+
+void TypedRecordSet::SetInt64(int column, int64 value) {
+  Column& c = columns_[column];
+  CHECK(c.type == ColumnType::kInt64) << "Column is not int64: " << c.name;
+  c.int64_values.back() = value;
+  c.nulls.back() = false;
+}
+
+void TypedRecordSet::SetDouble(int column, double value) {
+  Column& c = columns_[column];
+  CHECK(c.type == ColumnType::kDouble) << "Column is not double: " << c.name;
+  c.double_values.back() = value;
+  c.nulls.back() = false;
+}
+
+void TypedRecordSet::SetString(int column, absl::string_view value) {
+  Column& c = columns_[column];
+  CHECK(c.type == ColumnType::kString) << "Column is not string: " << c.name;
+  c.string_values.back() = CopyToPool(value);
+  c.nulls.back() = false;
+}
+
+void TypedRecordSet::AppendRecordSet(const RecordSet& record_set) {
+  // The columns of a RecordSet are only set if it has rows.
+  if (record_set.records_size() == 0) return;
+  if (columns_.empty()) {
+    for (const std::string& column_name : record_set.column_names()) {
+      AddColumn(column_name, ColumnType::kString);
+    }
+  }
+  CHECK_EQ(columns_.size(), record_set.column_names_size());
+  for (const RecordSet::Record& record : record_set.records()) {
+    AddRow();
+    for (int i = 0; i < record.values_size(); i++) {
+      if (record.values(i) != kMetadataSourceNull) {
+        SetString(i, record.values(i));
+      }
+    }
+  }
+}
+
+int TypedRecordSet::FindColumn(absl::string_view name) const {
+  for (int i = 0; i < columns_.size(); i++) {
+    if (columns_[i].name == name) return i;
+  }
+  return -1;
+}
+
+int64 TypedRecordSet::GetInt64(int row, int column) const {
+  const Column& c = columns_[column];
+  switch (c.type) {
+    case ColumnType::kInt64:
+      return c.int64_values[row];
+    case ColumnType::kDouble:
+      return static_cast<int64>(c.double_values[row]);
+    case ColumnType::kString: {
+      if (c.nulls[row]) return 0;
+      int64 value;
+      CHECK(absl::SimpleAtoi(c.string_values[row], &value))
+          << "Not an int64 in column " << c.name << ": "
+          << c.string_values[row];
+      return value;
+    }
+  }
+  return 0;
+}
+
+double TypedRecordSet::GetDouble(int row, int column) const {
+  const Column& c = columns_[column];
+  switch (c.type) {
+    case ColumnType::kInt64:
+      return c.int64_values[row];
+    case ColumnType::kDouble:
+      return c.double_values[row];
+    case ColumnType::kString: {
+      if (c.nulls[row]) return 0.0;
+      double value;
+      CHECK(absl::SimpleAtod(c.string_values[row], &value))
+          << "Not a double in column " << c.name << ": "
+          << c.string_values[row];
+      return value;
+    }
+  }
+  return 0.0;
+}
+
+bool TypedRecordSet::GetBool(int row, int column) const {
+  const Column& c = columns_[column];
+  if (c.type != ColumnType::kString) return GetInt64(row, column) != 0;
+  if (c.nulls[row]) return false;
+  bool value;
+  CHECK(absl::SimpleAtob(c.string_values[row], &value))
+      << "Not a bool in column " << c.name << ": " << c.string_values[row];
+  return value;
+}
+
+absl::string_view TypedRecordSet::GetString(int row, int column) const {
+  const Column& c = columns_[column];
+  CHECK(c.type == ColumnType::kString) << "Column is not string: " << c.name;
+  return c.string_values[row];
+}
+
+absl::string_view TypedRecordSet::CopyToPool(absl::string_view value) {
+  if (value.empty()) return absl::string_view();
+  if (pool_block_size_ - pool_block_used_ < value.size()) {
+    // The rest of the current block is left unused.
+    pool_block_size_ = std::max(kPoolBlockSize, value.size());
+    pool_blocks_.push_back(std::unique_ptr<char[]>(new char[pool_block_size_]));
+    pool_block_used_ = 0;
+  }
+  char* copy = pool_blocks_.back().get() + pool_block_used_;
+  std::memcpy(copy, value.data(), value.size());
+  pool_block_used_ += value.size();
+  return absl::string_view(copy, value.size());
+}
+
+}  // namespace ml_metadata
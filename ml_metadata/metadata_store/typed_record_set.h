@@ -0,0 +1,133 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef ML_METADATA_METADATA_STORE_TYPED_RECORD_SET_H_
+#define ML_METADATA_METADATA_STORE_TYPED_RECORD_SET_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "ml_metadata/metadata_store/types.h"
+#include "ml_metadata/proto/metadata_source.pb.h"
+
+namespace ml_metadata {
+
+// The result rows of a query, stored column by column with typed values. It is
+// the in-memory counterpart of RecordSet for the queries returning many rows:
+// the values are kept as int64, double or string per column, NULLs are kept in
+// a bitmap, and the strings of all the cells are copied to a pool of large
+// blocks, so that filling and reading a cell does not allocate or parse.
+//
+// A MetadataSource appends the rows of a query with AddRow() and the Set*()
+// methods. The column types are chosen by the source. The getters convert the
+// values of a column of another type, e.g., GetInt64() parses the values of a
+// string column, which is the only column type of the sources without typed
+// results.
+//
+// The class is movable but not copyable, as the strings are views of its pool.
+class TypedRecordSet {
+ public:
+  enum class ColumnType { kInt64, kDouble, kString };
+
+  TypedRecordSet() = default;
+
+  // Disallows copy.
+  TypedRecordSet(const TypedRecordSet&) = delete;
+  TypedRecordSet& operator=(const TypedRecordSet&) = delete;
+
+  TypedRecordSet(TypedRecordSet&&) = default;
+  TypedRecordSet& operator=(TypedRecordSet&&) = default;
+
+  // Removes all the columns and rows.
+  void Clear();
+
+  // Adds a column. The columns must be added before the first row.
+  void AddColumn(absl::string_view name, ColumnType type);
+
+  // Appends a row, of which all the cells are NULL.
+  void AddRow();
+
+  // Sets the value of a cell in the last row. The value type must be the
+  // column type.
+  void SetInt64(int column, int64 value);
+  void SetDouble(int column, double value);
+  void SetString(int column, absl::string_view value);
+
+  // Appends the rows of a RecordSet, whose values are parsed as string
+  // columns. If there are no columns yet, the columns of the RecordSet are
+  // added; otherwise they must be the same.
+  void AppendRecordSet(const RecordSet& record_set);
+
+  int num_columns() const { return columns_.size(); }
+  int num_rows() const { return num_rows_; }
+
+  const std::string& column_name(int column) const {
+    return columns_[column].name;
+  }
+  ColumnType column_type(int column) const { return columns_[column].type; }
+
+  // Returns the index of the column with the given name, or -1 if there is
+  // none.
+  int FindColumn(absl::string_view name) const;
+
+  // Returns whether a cell is NULL. The getters below return 0, 0.0 or an
+  // empty string for the NULL cells.
+  bool IsNull(int row, int column) const {
+    return columns_[column].nulls[row];
+  }
+
+  // Returns the value of a cell as an int64. Double values are truncated, and
+  // string values are parsed.
+  int64 GetInt64(int row, int column) const;
+
+  // Returns the value of a cell as a double. String values are parsed.
+  double GetDouble(int row, int column) const;
+
+  // Returns the value of a cell as a bool. String values are parsed.
+  bool GetBool(int row, int column) const;
+
+  // Returns the value of a cell of a string column. The view is valid until
+  // the record set is cleared or destroyed.
+  absl::string_view GetString(int row, int column) const;
+
+ private:
+  // The values of a column. Only the vector of the column type is used, and
+  // it has a value for each row.
+  struct Column {
+    std::string name;
+    ColumnType type;
+    std::vector<int64> int64_values;
+    std::vector<double> double_values;
+    std::vector<absl::string_view> string_values;
+    std::vector<bool> nulls;
+  };
+
+  // Copies a string to the pool, and returns the view of the copy.
+  absl::string_view CopyToPool(absl::string_view value);
+
+  std::vector<Column> columns_;
+  int num_rows_ = 0;
+
+  // The pool of the strings of the cells. Strings are copied to the end of
+  // the last block, and a new block is allocated when it is full.
+  std::vector<std::unique_ptr<char[]>> pool_blocks_;
+  size_t pool_block_used_ = 0;
+  size_t pool_block_size_ = 0;
+};
+
+}  // namespace ml_metadata
+
+#endif  // ML_METADATA_METADATA_STORE_TYPED_RECORD_SET_H_
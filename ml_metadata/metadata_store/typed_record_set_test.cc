@@ -0,0 +1,103 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "ml_metadata/metadata_store/typed_record_set.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+#include "ml_metadata/metadata_store/constants.h"
+#include "ml_metadata/proto/metadata_source.pb.h"
+
+namespace ml_metadata {
+namespace {
+
+TEST(TypedRecordSetTest, SetAndGetTypedValues) {
+  TypedRecordSet record_set;
+  record_set.AddColumn("id", TypedRecordSet::ColumnType::kInt64);
+  record_set.AddColumn("value", TypedRecordSet::ColumnType::kDouble);
+  record_set.AddColumn("name", TypedRecordSet::ColumnType::kString);
+  record_set.AddRow();
+  record_set.SetInt64(0, 1);
+  record_set.SetDouble(1, 2.5);
+  record_set.SetString(2, "a");
+  record_set.AddRow();
+  record_set.SetInt64(0, 2);
+
+  ASSERT_EQ(record_set.num_columns(), 3);
+  ASSERT_EQ(record_set.num_rows(), 2);
+  EXPECT_EQ(record_set.column_name(2), "name");
+  EXPECT_EQ(record_set.FindColumn("value"), 1);
+  EXPECT_EQ(record_set.FindColumn("unknown"), -1);
+  EXPECT_EQ(record_set.GetInt64(0, 0), 1);
+  EXPECT_EQ(record_set.GetDouble(0, 1), 2.5);
+  EXPECT_EQ(record_set.GetString(0, 2), "a");
+  EXPECT_TRUE(record_set.GetBool(0, 0));
+  EXPECT_EQ(record_set.GetInt64(1, 0), 2);
+  EXPECT_FALSE(record_set.IsNull(1, 0));
+  EXPECT_TRUE(record_set.IsNull(1, 1));
+  EXPECT_TRUE(record_set.IsNull(1, 2));
+  EXPECT_EQ(record_set.GetString(1, 2), "");
+
+  record_set.Clear();
+  EXPECT_EQ(record_set.num_columns(), 0);
+  EXPECT_EQ(record_set.num_rows(), 0);
+}
+
+TEST(TypedRecordSetTest, StringsOutliveThePoolBlocks) {
+  TypedRecordSet record_set;
+  record_set.AddColumn("name", TypedRecordSet::ColumnType::kString);
+  const std::string large_string(100 * 1024, 'x');
+  for (int i = 0; i < 1000; i++) {
+    record_set.AddRow();
+    record_set.SetString(0, i % 100 == 0 ? large_string : std::to_string(i));
+  }
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_EQ(record_set.GetString(i, 0),
+              i % 100 == 0 ? large_string : std::to_string(i));
+  }
+}
+
+TEST(TypedRecordSetTest, AppendRecordSet) {
+  RecordSet record_set;
+  record_set.add_column_names("id");
+  record_set.add_column_names("is_custom");
+  record_set.add_column_names("value");
+  RecordSet::Record* record = record_set.add_records();
+  record->add_values("1");
+  record->add_values("1");
+  record->add_values("0.5");
+  record = record_set.add_records();
+  record->add_values("2");
+  record->add_values("0");
+  record->add_values(kMetadataSourceNull);
+
+  TypedRecordSet typed_record_set;
+  typed_record_set.AppendRecordSet(RecordSet());
+  EXPECT_EQ(typed_record_set.num_columns(), 0);
+  typed_record_set.AppendRecordSet(record_set);
+  typed_record_set.AppendRecordSet(record_set);
+  ASSERT_EQ(typed_record_set.num_columns(), 3);
+  ASSERT_EQ(typed_record_set.num_rows(), 4);
+  EXPECT_EQ(typed_record_set.column_type(0),
+            TypedRecordSet::ColumnType::kString);
+  EXPECT_EQ(typed_record_set.GetInt64(3, 0), 2);
+  EXPECT_TRUE(typed_record_set.GetBool(2, 1));
+  EXPECT_FALSE(typed_record_set.GetBool(3, 1));
+  EXPECT_EQ(typed_record_set.GetDouble(2, 2), 0.5);
+  EXPECT_TRUE(typed_record_set.IsNull(3, 2));
+}
+
+}  // namespace
+}  // namespace ml_metadata
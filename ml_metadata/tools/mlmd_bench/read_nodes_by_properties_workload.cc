@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "ml_metadata/tools/mlmd_bench/read_nodes_by_properties_workload.h"
 
+#include <algorithm>
 #include <random>
 #include <vector>
 
@@ -35,6 +36,17 @@ constexpr int64 kInt64TypeIdSize = 8;
 constexpr int64 kInt64CreateTimeSize = 8;
 constexpr int64 kInt64LastUpdateTimeSize = 8;
 constexpr int64 kEnumStateSize = 1;
+// The page size of the requests reading nodes by property.
+constexpr int kReadNodesByPropertyPageSize = 100;
+
+// Returns true if the node has neither properties nor custom properties, so
+// that it cannot be read by property.
+struct HasNoProperties {
+  template <typename NT>
+  bool operator()(const NT& node) const {
+    return node.properties().empty() && node.custom_properties().empty();
+  }
+};
 
 // Gets all nodes inside db. Returns detailed error if query executions failed.
 // Returns FAILED_PRECONDITION if there is no nodes inside db to read from.
@@ -296,6 +308,97 @@ tensorflow::Status SetUpImplForReadNodeByTypeAndName(
   return tensorflow::Status::OK();
 }
 
+// Prepares a `Request` reading the first page of the nodes of type `NT` whose
+// property equals the first property, or custom property, of the picked node,
+// and adds the bytes of that page to `curr_bytes`. The nodes are filtered by
+// the type id of the picked node, as the nodes read from the store do not have
+// type names. The picked node must have a property or a custom property.
+template <typename NT, typename Request>
+void SetUpReadNodesByPropertyRequest(const std::vector<Node>& existing_nodes,
+                                     const int64 node_index,
+                                     ReadNodesByPropertiesWorkItemType& request,
+                                     int64& curr_bytes) {
+  const NT& picked_node = absl::get<NT>(existing_nodes[node_index]);
+  const bool is_custom_property = picked_node.properties().empty();
+  const auto& picked_properties = is_custom_property
+                                      ? picked_node.custom_properties()
+                                      : picked_node.properties();
+  const std::string& property_name = picked_properties.begin()->first;
+  const Value& property_value = picked_properties.begin()->second;
+
+  Request property_request;
+  property_request.set_property_name(property_name);
+  property_request.set_is_custom_property(is_custom_property);
+  *property_request.mutable_value() = property_value;
+  ListOperationOptions* options = property_request.mutable_options();
+  options->set_max_result_size(kReadNodesByPropertyPageSize);
+  options->mutable_order_by_field()->set_field(
+      ListOperationOptions::OrderByField::ID);
+  options->mutable_order_by_field()->set_is_asc(true);
+  options->mutable_filter()->set_type_id(picked_node.type_id());
+  request = property_request;
+
+  // The page has the matched nodes with the smallest ids.
+  const std::string serialized_value = property_value.SerializeAsString();
+  std::vector<const NT*> matched_nodes;
+  for (const Node& existing_node : existing_nodes) {
+    const NT& node = absl::get<NT>(existing_node);
+    if (node.type_id() != picked_node.type_id()) continue;
+    const auto& properties =
+        is_custom_property ? node.custom_properties() : node.properties();
+    const auto it = properties.find(property_name);
+    if (it == properties.end() ||
+        it->second.SerializeAsString() != serialized_value) {
+      continue;
+    }
+    matched_nodes.push_back(&node);
+  }
+  std::sort(matched_nodes.begin(), matched_nodes.end(),
+            [](const NT* lhs, const NT* rhs) { return lhs->id() < rhs->id(); });
+  if (matched_nodes.size() >
+      static_cast<size_t>(kReadNodesByPropertyPageSize)) {
+    matched_nodes.resize(kReadNodesByPropertyPageSize);
+  }
+  for (const NT* node : matched_nodes) {
+    curr_bytes += GetTransferredBytes(*node);
+  }
+}
+
+// SetUpImpl() for the specifications to read nodes by property in db.
+// Returns detailed error if query executions failed.
+tensorflow::Status SetUpImplForReadNodesByProperty(
+    const ReadNodesByPropertiesConfig& read_nodes_by_properties_config,
+    const std::vector<Node>& existing_nodes,
+    std::uniform_int_distribution<int64>& node_index_dist,
+    std::minstd_rand0& gen, ReadNodesByPropertiesWorkItemType& request,
+    int64& curr_bytes) {
+  if (read_nodes_by_properties_config.has_num_of_parameters()) {
+    LOG(FATAL) << "ReadNodesByProperty specification should not have a "
+                  "`num_of_parameters` field!";
+  }
+  // Selects from existing nodes uniformly to get a type and a property.
+  const int64 node_index = node_index_dist(gen);
+  switch (read_nodes_by_properties_config.specification()) {
+    case ReadNodesByPropertiesConfig::ARTIFACTS_BY_PROPERTY:
+      SetUpReadNodesByPropertyRequest<Artifact, GetArtifactsByPropertyRequest>(
+          existing_nodes, node_index, request, curr_bytes);
+      break;
+    case ReadNodesByPropertiesConfig::EXECUTIONS_BY_PROPERTY:
+      SetUpReadNodesByPropertyRequest<Execution,
+                                      GetExecutionsByPropertyRequest>(
+          existing_nodes, node_index, request, curr_bytes);
+      break;
+    case ReadNodesByPropertiesConfig::CONTEXTS_BY_PROPERTY:
+      SetUpReadNodesByPropertyRequest<Context, GetContextsByPropertyRequest>(
+          existing_nodes, node_index, request, curr_bytes);
+      break;
+    default:
+      LOG(FATAL) << "Wrong ReadNodesByProperties specification for read nodes "
+                    "by property in db.";
+  }
+  return tensorflow::Status::OK();
+}
+
 }  // namespace
 
 ReadNodesByProperties::ReadNodesByProperties(
@@ -315,6 +418,23 @@ tensorflow::Status ReadNodesByProperties::SetUpImpl(MetadataStore* store) {
   std::vector<Node> existing_nodes;
   TF_RETURN_IF_ERROR(GetAndValidateExistingNodes(
       read_nodes_by_properties_config_, *store, existing_nodes));
+  const ReadNodesByPropertiesConfig::Specification specification =
+      read_nodes_by_properties_config_.specification();
+  if (specification == ReadNodesByPropertiesConfig::ARTIFACTS_BY_PROPERTY ||
+      specification == ReadNodesByPropertiesConfig::EXECUTIONS_BY_PROPERTY ||
+      specification == ReadNodesByPropertiesConfig::CONTEXTS_BY_PROPERTY) {
+    // Only the nodes with properties can be read by property.
+    existing_nodes.erase(
+        std::remove_if(existing_nodes.begin(), existing_nodes.end(),
+                       [](const Node& node) {
+                         return absl::visit(HasNoProperties(), node);
+                       }),
+        existing_nodes.end());
+    if (existing_nodes.empty()) {
+      return tensorflow::errors::FailedPrecondition(
+          "There are no nodes with properties inside db to read from!");
+    }
+  }
   // Uniform distribution to select existing nodes uniformly.
   std::uniform_int_distribution<int64> node_index_dist{
       0, (int64)(existing_nodes.size() - 1)};
@@ -350,6 +470,13 @@ tensorflow::Status ReadNodesByProperties::SetUpImpl(MetadataStore* store) {
             read_nodes_by_properties_config_, existing_nodes, node_index_dist,
             gen, read_request, curr_bytes));
         break;
+      case ReadNodesByPropertiesConfig::ARTIFACTS_BY_PROPERTY:
+      case ReadNodesByPropertiesConfig::EXECUTIONS_BY_PROPERTY:
+      case ReadNodesByPropertiesConfig::CONTEXTS_BY_PROPERTY:
+        TF_RETURN_IF_ERROR(SetUpImplForReadNodesByProperty(
+            read_nodes_by_properties_config_, existing_nodes, node_index_dist,
+            gen, read_request, curr_bytes));
+        break;
       default:
         LOG(FATAL) << "Wrong specification for ReadNodesByProperties!";
     }
@@ -422,6 +549,24 @@ tensorflow::Status ReadNodesByProperties::RunOpImpl(
       GetArtifactsByURIResponse response;
       return store->GetArtifactsByURI(request, &response);
     }
+    case ReadNodesByPropertiesConfig::ARTIFACTS_BY_PROPERTY: {
+      auto request = absl::get<GetArtifactsByPropertyRequest>(
+          work_items_[work_items_index].first);
+      GetArtifactsByPropertyResponse response;
+      return store->GetArtifactsByProperty(request, &response);
+    }
+    case ReadNodesByPropertiesConfig::EXECUTIONS_BY_PROPERTY: {
+      auto request = absl::get<GetExecutionsByPropertyRequest>(
+          work_items_[work_items_index].first);
+      GetExecutionsByPropertyResponse response;
+      return store->GetExecutionsByProperty(request, &response);
+    }
+    case ReadNodesByPropertiesConfig::CONTEXTS_BY_PROPERTY: {
+      auto request = absl::get<GetContextsByPropertyRequest>(
+          work_items_[work_items_index].first);
+      GetContextsByPropertyResponse response;
+      return store->GetContextsByProperty(request, &response);
+    }
     default:
       return tensorflow::errors::InvalidArgument("Wrong specification!");
   }
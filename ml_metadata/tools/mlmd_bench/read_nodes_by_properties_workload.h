@@ -33,7 +33,10 @@ using ReadNodesByPropertiesWorkItemType =
                   GetExecutionsByTypeRequest, GetContextsByTypeRequest,
                   GetArtifactByTypeAndNameRequest,
                   GetExecutionByTypeAndNameRequest,
-                  GetContextByTypeAndNameRequest, GetArtifactsByURIRequest>;
+                  GetContextByTypeAndNameRequest, GetArtifactsByURIRequest,
+                  GetArtifactsByPropertyRequest,
+                  GetExecutionsByPropertyRequest,
+                  GetContextsByPropertyRequest>;
 
 // A specific workload for getting nodes: Artifacts / Executions / Contexts by
 // their properties.
@@ -54,6 +57,10 @@ class ReadNodesByProperties
   // specification of current workload is ARTIFACTS_BY_ID / EXECUTIONS_BY_ID /
   // CONTEXTS_BY_ID or ARTIFACTS_BY_URI, the number of ids or uris per request
   // will be generated w.r.t. the uniform distribution `num_of_parameters`.
+  // If the specification is ARTIFACTS_BY_PROPERTY / EXECUTIONS_BY_PROPERTY /
+  // CONTEXTS_BY_PROPERTY, only the nodes with properties are selected, and
+  // FAILED_PRECONDITION is returned if there is none. The requests match the
+  // type id and a property value of a selected node.
   // Returns detailed error if query executions failed.
   tensorflow::Status SetUpImpl(MetadataStore* store) final;
 
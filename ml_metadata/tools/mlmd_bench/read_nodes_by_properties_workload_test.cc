@@ -14,6 +14,10 @@ limitations under the License.
 ==============================================================================*/
 #include "ml_metadata/tools/mlmd_bench/read_nodes_by_properties_workload.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include <gtest/gtest.h>
 #include "absl/memory/memory.h"
 #include "ml_metadata/metadata_store/metadata_store.h"
@@ -47,7 +51,10 @@ std::vector<WorkloadConfig> EnumerateConfigs() {
       ReadNodesByPropertiesConfig::ARTIFACT_BY_TYPE_AND_NAME,
       ReadNodesByPropertiesConfig::EXECUTION_BY_TYPE_AND_NAME,
       ReadNodesByPropertiesConfig::CONTEXT_BY_TYPE_AND_NAME,
-      ReadNodesByPropertiesConfig::ARTIFACTS_BY_URI};
+      ReadNodesByPropertiesConfig::ARTIFACTS_BY_URI,
+      ReadNodesByPropertiesConfig::ARTIFACTS_BY_PROPERTY,
+      ReadNodesByPropertiesConfig::EXECUTIONS_BY_PROPERTY,
+      ReadNodesByPropertiesConfig::CONTEXTS_BY_PROPERTY};
 
   for (const ReadNodesByPropertiesConfig::Specification& specification :
        specifications) {
@@ -132,6 +139,69 @@ TEST_P(ReadNodesByPropertiesParameterizedTestFixture, RunOpImplTest) {
   EXPECT_GT(stats.bytes(), 0);
 }
 
+// A ReadNodesByProperties workload whose work items can be inspected.
+class ReadNodesByPropertiesForTest : public ReadNodesByProperties {
+ public:
+  using ReadNodesByProperties::ReadNodesByProperties;
+
+  const std::vector<std::pair<ReadNodesByPropertiesWorkItemType, int64>>&
+  work_items() const {
+    return work_items_;
+  }
+};
+
+// Tests that each work item of ARTIFACTS_BY_PROPERTY reads the artifacts of
+// the type of the picked artifact whose property has the picked value.
+TEST(ReadNodesByPropertiesTest, ArtifactsByPropertyReadTheMatchedArtifacts) {
+  ConnectionConfig mlmd_config;
+  mlmd_config.mutable_fake_database();
+  std::unique_ptr<MetadataStore> store;
+  TF_ASSERT_OK(CreateMetadataStore(mlmd_config, &store));
+  TF_ASSERT_OK(InsertTypesInDb(
+      /*num_artifact_types=*/kNumberOfExistedTypesInDb,
+      /*num_execution_types=*/kNumberOfExistedTypesInDb,
+      /*num_context_types=*/kNumberOfExistedTypesInDb, *store));
+  TF_ASSERT_OK(InsertNodesInDb(
+      /*num_artifact_nodes=*/kNumberOfExistedNodesInDb,
+      /*num_execution_nodes=*/kNumberOfExistedNodesInDb,
+      /*num_context_nodes=*/kNumberOfExistedNodesInDb, *store));
+  GetArtifactsResponse get_artifacts_response;
+  TF_ASSERT_OK(store->GetArtifacts(/*request=*/{}, &get_artifacts_response));
+
+  ReadNodesByPropertiesConfig config;
+  config.set_specification(ReadNodesByPropertiesConfig::ARTIFACTS_BY_PROPERTY);
+  ReadNodesByPropertiesForTest workload(config, kNumberOfOperations);
+  TF_ASSERT_OK(workload.SetUp(store.get()));
+  for (const auto& work_item : workload.work_items()) {
+    const GetArtifactsByPropertyRequest& request =
+        absl::get<GetArtifactsByPropertyRequest>(work_item.first);
+    ASSERT_TRUE(request.options().filter().has_type_id());
+    const int64 type_id = request.options().filter().type_id();
+    int expected_num_artifacts = 0;
+    for (const Artifact& artifact : get_artifacts_response.artifacts()) {
+      const auto& properties = request.is_custom_property()
+                                   ? artifact.custom_properties()
+                                   : artifact.properties();
+      const auto it = properties.find(request.property_name());
+      if (artifact.type_id() == type_id && it != properties.end() &&
+          it->second.SerializeAsString() ==
+              request.value().SerializeAsString()) {
+        ++expected_num_artifacts;
+      }
+    }
+    GetArtifactsByPropertyResponse response;
+    TF_ASSERT_OK(store->GetArtifactsByProperty(request, &response));
+    EXPECT_GT(expected_num_artifacts, 0);
+    EXPECT_EQ(response.artifacts_size(),
+              std::min(expected_num_artifacts,
+                       request.options().max_result_size()));
+    for (const Artifact& artifact : response.artifacts()) {
+      EXPECT_EQ(artifact.type_id(), type_id);
+    }
+    EXPECT_GT(work_item.second, 0);
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(ReadNodesByPropertiesTest,
                         ReadNodesByPropertiesParameterizedTestFixture,
                         ::testing::ValuesIn(EnumerateConfigs()));
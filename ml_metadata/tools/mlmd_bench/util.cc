@@ -255,14 +255,17 @@ tensorflow::Status GetExistingNodes(
     case ReadNodesByPropertiesConfig::ARTIFACTS_BY_TYPE:
     case ReadNodesByPropertiesConfig::ARTIFACT_BY_TYPE_AND_NAME:
     case ReadNodesByPropertiesConfig::ARTIFACTS_BY_URI:
+    case ReadNodesByPropertiesConfig::ARTIFACTS_BY_PROPERTY:
       return GetExistingNodesImpl(FetchArtifact, store, existing_nodes);
     case ReadNodesByPropertiesConfig::EXECUTIONS_BY_ID:
     case ReadNodesByPropertiesConfig::EXECUTIONS_BY_TYPE:
     case ReadNodesByPropertiesConfig::EXECUTION_BY_TYPE_AND_NAME:
+    case ReadNodesByPropertiesConfig::EXECUTIONS_BY_PROPERTY:
       return GetExistingNodesImpl(FetchExecution, store, existing_nodes);
     case ReadNodesByPropertiesConfig::CONTEXTS_BY_ID:
     case ReadNodesByPropertiesConfig::CONTEXTS_BY_TYPE:
     case ReadNodesByPropertiesConfig::CONTEXT_BY_TYPE_AND_NAME:
+    case ReadNodesByPropertiesConfig::CONTEXTS_BY_PROPERTY:
       return GetExistingNodesImpl(FetchContext, store, existing_nodes);
     default:
       LOG(FATAL) << "Unknown ReadNodesByPropertiesConfig specification.";
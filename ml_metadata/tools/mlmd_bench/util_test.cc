@@ -339,19 +339,24 @@ TEST(UtilGetTest, GetNodesWithReadNodesByPropertiesConfigTest) {
       ReadNodesByPropertiesConfig::ARTIFACTS_BY_TYPE,
       ReadNodesByPropertiesConfig::ARTIFACT_BY_TYPE_AND_NAME,
       ReadNodesByPropertiesConfig::ARTIFACTS_BY_URI,
+      ReadNodesByPropertiesConfig::ARTIFACTS_BY_PROPERTY,
       ReadNodesByPropertiesConfig::EXECUTIONS_BY_ID,
       ReadNodesByPropertiesConfig::EXECUTIONS_BY_TYPE,
       ReadNodesByPropertiesConfig::EXECUTION_BY_TYPE_AND_NAME,
+      ReadNodesByPropertiesConfig::EXECUTIONS_BY_PROPERTY,
       ReadNodesByPropertiesConfig::CONTEXTS_BY_ID,
       ReadNodesByPropertiesConfig::CONTEXTS_BY_TYPE,
-      ReadNodesByPropertiesConfig::CONTEXT_BY_TYPE_AND_NAME};
+      ReadNodesByPropertiesConfig::CONTEXT_BY_TYPE_AND_NAME,
+      ReadNodesByPropertiesConfig::CONTEXTS_BY_PROPERTY};
 
   std::vector<int> num_nodes{
       kNumberOfInsertedArtifacts,  kNumberOfInsertedArtifacts,
       kNumberOfInsertedArtifacts,  kNumberOfInsertedArtifacts,
+      kNumberOfInsertedArtifacts,  kNumberOfInsertedExecutions,
       kNumberOfInsertedExecutions, kNumberOfInsertedExecutions,
       kNumberOfInsertedExecutions, kNumberOfInsertedContexts,
-      kNumberOfInsertedContexts,   kNumberOfInsertedContexts};
+      kNumberOfInsertedContexts,   kNumberOfInsertedContexts,
+      kNumberOfInsertedContexts};
 
   for (int i = 0; i < num_nodes.size(); ++i) {
     std::vector<Node> exisiting_nodes;
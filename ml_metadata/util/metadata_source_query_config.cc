@@ -28,15 +28,17 @@ namespace {
 // no-lint to support vc (C2026) 16380 max length for char[].
 const std::string kBaseQueryConfig = absl::StrCat( // NOLINT
 R"pb(
-  schema_version: 5
+  schema_version: 8
+  max_num_ids_per_query: 1000
+  max_num_rows_per_insert: 500
   drop_type_table { query: " DROP TABLE IF EXISTS `Type`; " }
   create_type_table {
     query: " CREATE TABLE IF NOT EXISTS `Type` ( "
            "   `id` INTEGER PRIMARY KEY AUTOINCREMENT, "
            "   `name` VARCHAR(255) NOT NULL, "
            "   `type_kind` TINYINT(1) NOT NULL, "
-           "   `input_type` TEXT, "
-           "   `output_type` TEXT"
+           "   `input_type` BLOB, "
+           "   `output_type` BLOB"
            " ); "
   }
   check_type_table {
@@ -73,6 +75,13 @@ R"pb(
     parameter_num: 2
   }
 
+  select_types_by_id {
+    query: " SELECT `id`, `name`, `input_type`, `output_type` "
+           " from `Type` "
+           " WHERE id IN ($0) and type_kind = $1; "
+    parameter_num: 2
+  }
+
   select_type_by_name {
     query: " SELECT `id`, `name`, `input_type`, `output_type` "
            " from `Type` "
@@ -110,7 +119,16 @@ R"pb(
            " WHERE `type_id` = $0; "
     parameter_num: 1
   }
-  select_last_insert_id { query: " SELECT last_insert_rowid(); " }
+  select_property_by_type_ids {
+    query: " SELECT `type_id`, `name` as `key`, `data_type` as `value` "
+           " from `TypeProperty` "
+           " WHERE `type_id` IN ($0); "
+    parameter_num: 1
+  }
+  select_type_generation {
+    query: " SELECT (SELECT COUNT(*) FROM `Type`), "
+           "        (SELECT COUNT(*) FROM `TypeProperty`); "
+  }
 )pb",
 R"pb(
   drop_artifact_table { query: " DROP TABLE IF EXISTS `Artifact`; " }
@@ -138,6 +156,13 @@ R"pb(
            ") VALUES($0, $1, $2, $3, $4, $5);"
     parameter_num: 6
   }
+  insert_artifacts {
+    query: " INSERT INTO `Artifact`( "
+           "   `type_id`, `uri`, `state`, `name`, `create_time_since_epoch`, "
+           "   `last_update_time_since_epoch` "
+           ") VALUES $0;"
+    parameter_num: 1
+  }
   select_artifact_by_id {
     query: " SELECT `type_id`, `uri`, `state`, `name`, "
            "        `create_time_since_epoch`, `last_update_time_since_epoch` "
@@ -145,6 +170,13 @@ R"pb(
            " WHERE id = $0; "
     parameter_num: 1
   }
+  select_artifacts_by_id {
+    query: " SELECT `id`, `type_id`, `uri`, `state`, `name`, "
+           "        `create_time_since_epoch`, `last_update_time_since_epoch` "
+           " from `Artifact` "
+           " WHERE id IN ($0); "
+    parameter_num: 1
+  }
   select_artifact_by_type_id_and_name {
     query: " SELECT `id` from `Artifact` WHERE `type_id` = $0 and `name` = $1; "
     parameter_num: 2
@@ -184,9 +216,17 @@ R"pb(
   }
   insert_artifact_property {
     query: " INSERT INTO `ArtifactProperty`( "
-           "   `artifact_id`, `name`, `is_custom_property`, `$0` "
-           ") VALUES($1, $2, $3, $4);"
-    parameter_num: 5
+           "   `artifact_id`, `name`, `is_custom_property`, `int_value`, "
+           "   `double_value`, `string_value` "
+           ") VALUES($0, $1, $2, $3, $4, $5);"
+    parameter_num: 6
+  }
+  insert_artifact_properties {
+    query: " INSERT INTO `ArtifactProperty`( "
+           "   `artifact_id`, `name`, `is_custom_property`, `int_value`, "
+           "   `double_value`, `string_value` "
+           ") VALUES $0;"
+    parameter_num: 1
   }
   select_artifact_property_by_artifact_id {
     query: " SELECT `name` as `key`, `is_custom_property`, "
@@ -195,11 +235,19 @@ R"pb(
            " WHERE `artifact_id` = $0; "
     parameter_num: 1
   }
+  select_artifact_property_by_artifact_ids {
+    query: " SELECT `artifact_id` as `id`, `name` as `key`, "
+           "        `is_custom_property`, "
+           "        `int_value`, `double_value`, `string_value` "
+           " from `ArtifactProperty` "
+           " WHERE `artifact_id` IN ($0); "
+    parameter_num: 1
+  }
   update_artifact_property {
     query: " UPDATE `ArtifactProperty` "
-           " SET `$0` = $1 "
-           " WHERE `artifact_id` = $2 and `name` = $3;"
-    parameter_num: 4
+           " SET `int_value` = $0, `double_value` = $1, `string_value` = $2 "
+           " WHERE `artifact_id` = $3 and `name` = $4;"
+    parameter_num: 5
   }
   delete_artifact_property {
     query: " DELETE FROM `ArtifactProperty` "
@@ -232,6 +280,13 @@ R"pb(
            ") VALUES($0, $1, $2, $3, $4);"
     parameter_num: 5
   }
+  insert_executions {
+    query: " INSERT INTO `Execution`( "
+           "   `type_id`, `last_known_state`, `name`, "
+           "   `create_time_since_epoch`, `last_update_time_since_epoch` "
+           ") VALUES $0;"
+    parameter_num: 1
+  }
   select_execution_by_id {
     query: " SELECT `type_id`, `last_known_state`, `name`, "
            "        `create_time_since_epoch`, `last_update_time_since_epoch` "
@@ -239,6 +294,13 @@ R"pb(
            " WHERE id = $0; "
     parameter_num: 1
   }
+  select_executions_by_id {
+    query: " SELECT `id`, `type_id`, `last_known_state`, `name`, "
+           "        `create_time_since_epoch`, `last_update_time_since_epoch` "
+           " from `Execution` "
+           " WHERE id IN ($0); "
+    parameter_num: 1
+  }
   select_execution_by_type_id_and_name {
     query: " SELECT `id` from `Execution` WHERE `type_id` = $0 and `name` = $1; "
     parameter_num: 2
@@ -274,9 +336,17 @@ R"pb(
   }
   insert_execution_property {
     query: " INSERT INTO `ExecutionProperty`( "
-           "   `execution_id`, `name`, `is_custom_property`, `$0` "
-           ") VALUES($1, $2, $3, $4);"
-    parameter_num: 5
+           "   `execution_id`, `name`, `is_custom_property`, `int_value`, "
+           "   `double_value`, `string_value` "
+           ") VALUES($0, $1, $2, $3, $4, $5);"
+    parameter_num: 6
+  }
+  insert_execution_properties {
+    query: " INSERT INTO `ExecutionProperty`( "
+           "   `execution_id`, `name`, `is_custom_property`, `int_value`, "
+           "   `double_value`, `string_value` "
+           ") VALUES $0;"
+    parameter_num: 1
   }
   select_execution_property_by_execution_id {
     query: " SELECT `name` as `key`, `is_custom_property`, "
@@ -285,11 +355,19 @@ R"pb(
            " WHERE `execution_id` = $0; "
     parameter_num: 1
   }
+  select_execution_property_by_execution_ids {
+    query: " SELECT `execution_id` as `id`, `name` as `key`, "
+           "        `is_custom_property`, "
+           "        `int_value`, `double_value`, `string_value` "
+           " from `ExecutionProperty` "
+           " WHERE `execution_id` IN ($0); "
+    parameter_num: 1
+  }
   update_execution_property {
     query: " UPDATE `ExecutionProperty` "
-           " SET `$0` = $1 "
-           " WHERE `execution_id` = $2 and `name` = $3;"
-    parameter_num: 4
+           " SET `int_value` = $0, `double_value` = $1, `string_value` = $2 "
+           " WHERE `execution_id` = $3 and `name` = $4;"
+    parameter_num: 5
   }
   delete_execution_property {
     query: " DELETE FROM `ExecutionProperty` "
@@ -321,12 +399,25 @@ R"pb(
            ") VALUES($0, $1, $2, $3);"
     parameter_num: 4
   }
+  insert_contexts {
+    query: " INSERT INTO `Context`( "
+           "   `type_id`, `name`, "
+           "   `create_time_since_epoch`, `last_update_time_since_epoch` "
+           ") VALUES $0;"
+    parameter_num: 1
+  }
   select_context_by_id {
     query: " SELECT `type_id`, `name`, `create_time_since_epoch`, "
            "        `last_update_time_since_epoch` "
            " from `Context` WHERE id = $0; "
     parameter_num: 1
   }
+  select_contexts_by_id {
+    query: " SELECT `id`, `type_id`, `name`, `create_time_since_epoch`, "
+           "        `last_update_time_since_epoch` "
+           " from `Context` WHERE id IN ($0); "
+    parameter_num: 1
+  }
   select_contexts_by_type_id {
     query: " SELECT `id` from `Context` WHERE `type_id` = $0; "
     parameter_num: 1
@@ -362,9 +453,17 @@ R"pb(
   }
   insert_context_property {
     query: " INSERT INTO `ContextProperty`( "
-           "   `context_id`, `name`, `is_custom_property`, `$0` "
-           ") VALUES($1, $2, $3, $4);"
-    parameter_num: 5
+           "   `context_id`, `name`, `is_custom_property`, `int_value`, "
+           "   `double_value`, `string_value` "
+           ") VALUES($0, $1, $2, $3, $4, $5);"
+    parameter_num: 6
+  }
+  insert_context_properties {
+    query: " INSERT INTO `ContextProperty`( "
+           "   `context_id`, `name`, `is_custom_property`, `int_value`, "
+           "   `double_value`, `string_value` "
+           ") VALUES $0;"
+    parameter_num: 1
   }
   select_context_property_by_context_id {
     query: " SELECT `name` as `key`, `is_custom_property`, "
@@ -373,11 +472,19 @@ R"pb(
            " WHERE `context_id` = $0; "
     parameter_num: 1
   }
+  select_context_property_by_context_ids {
+    query: " SELECT `context_id` as `id`, `name` as `key`, "
+           "        `is_custom_property`, "
+           "        `int_value`, `double_value`, `string_value` "
+           " from `ContextProperty` "
+           " WHERE `context_id` IN ($0); "
+    parameter_num: 1
+  }
   update_context_property {
     query: " UPDATE `ContextProperty` "
-           " SET `$0` = $1 "
-           " WHERE `context_id` = $2 and `name` = $3;"
-    parameter_num: 4
+           " SET `int_value` = $0, `double_value` = $1, `string_value` = $2 "
+           " WHERE `context_id` = $3 and `name` = $4;"
+    parameter_num: 5
   }
   delete_context_property {
     query: " DELETE FROM `ContextProperty` "
@@ -408,6 +515,13 @@ R"pb(
            ") VALUES($0, $1, $2, $3);"
     parameter_num: 4
   }
+  insert_events {
+    query: " INSERT INTO `Event`( "
+           "   `artifact_id`, `execution_id`, `type`, "
+           "   `milliseconds_since_epoch` "
+           ") VALUES $0;"
+    parameter_num: 1
+  }
   select_event_by_artifact_ids {
     query: " SELECT `id`, `artifact_id`, `execution_id`, "
            "        `type`, `milliseconds_since_epoch` "
@@ -422,6 +536,21 @@ R"pb(
            " WHERE `execution_id` IN ($0); "
     parameter_num: 1
   }
+  select_events_by_id_range {
+    query: " SELECT `id`, `artifact_id`, `execution_id`, `type` "
+           " FROM `Event` "
+           " WHERE `id` > $0 AND `id` <= $1 "
+           " ORDER BY `id`; "
+    parameter_num: 2
+  }
+  select_events_by_id {
+    query: " SELECT `id`, `artifact_id`, `execution_id`, "
+           "        `type`, `milliseconds_since_epoch` "
+           " FROM `Event` "
+           " WHERE `id` IN ($0); "
+    parameter_num: 1
+  }
+  select_max_event_id { query: " SELECT MAX(`id`) FROM `Event`; " }
   drop_event_path_table { query: " DROP TABLE IF EXISTS `EventPath`; " }
   create_event_path_table {
     query: " CREATE TABLE IF NOT EXISTS `EventPath` ( "
@@ -437,10 +566,16 @@ R"pb(
   }
   insert_event_path {
     query: " INSERT INTO `EventPath`( "
-           "   `event_id`, `is_index_step`, `$1` "
-           ") VALUES($0, $2, $3);"
+           "   `event_id`, `is_index_step`, `step_index`, `step_key` "
+           ") VALUES($0, $1, $2, $3);"
     parameter_num: 4
   }
+  insert_event_paths {
+    query: " INSERT INTO `EventPath`( "
+           "   `event_id`, `is_index_step`, `step_index`, `step_key` "
+           ") VALUES $0;"
+    parameter_num: 1
+  }
   select_event_path_by_event_ids {
     query: " SELECT `event_id`, `is_index_step`, `step_index`, `step_key` "
            " from `EventPath` "
@@ -531,6 +666,15 @@ R"pb(
            " `Artifact`, `Event`, `Execution`, `Type`, `ArtifactProperty`, "
            " `EventPath`, `ExecutionProperty`, `TypeProperty` LIMIT 1; "
   }
+  select_execution_type_signatures {
+    query: " SELECT `id`, `input_type`, `output_type` "
+           " FROM `Type` WHERE `type_kind` = 0; "
+  }
+  update_execution_type_signatures {
+    query: " UPDATE `Type` SET `input_type` = $0, `output_type` = $1 "
+           " WHERE `id` = $2; "
+    parameter_num: 3
+  }
 )pb");
 
 // no-lint to support vc (C2026) 16380 max length for char[].
@@ -1069,6 +1213,406 @@ R"pb(
                  " ) as T1; "
         }
       }
+      # downgrade queries from version 6
+      downgrade_data_migrations: EXECUTION_TYPE_SIGNATURES_TO_TEXT
+      downgrade_queries {
+        query: " CREATE TABLE IF NOT EXISTS `TypeTemp` ( "
+               "   `id` INTEGER PRIMARY KEY AUTOINCREMENT, "
+               "   `name` VARCHAR(255) NOT NULL, "
+               "   `type_kind` TINYINT(1) NOT NULL, "
+               "   `input_type` TEXT, "
+               "   `output_type` TEXT"
+               " ); "
+      }
+      downgrade_queries {
+        query: " INSERT INTO `TypeTemp` SELECT * FROM `Type`; "
+      }
+      downgrade_queries { query: " DROP TABLE `Type`; " }
+      downgrade_queries {
+        query: " ALTER TABLE `TypeTemp` RENAME TO `Type`; "
+      }
+      # verify the signatures are stored as JSON again
+      downgrade_verification {
+        previous_version_setup_queries {
+          query: " INSERT INTO `Type` "
+                 " (`name`, `type_kind`, `input_type`, `output_type`) "
+                 " VALUES ('execution_type_with_signature', 0, X'2A00', NULL); "
+        }
+        post_migration_verification_queries {
+          query: " SELECT count(*) = 1 FROM `Type` "
+                 " WHERE `name` = 'execution_type_with_signature' AND "
+                 "       `input_type` = '{\"none\":{}}' AND "
+                 "       `output_type` IS NULL; "
+        }
+      }
+    }
+  }
+)pb",
+R"pb(
+  # In v6, the input_type and output_type of the execution types are stored as
+  # serialized protos instead of JSON, which are faster to parse.
+  migration_schemes {
+    key: 6
+    value: {
+      # upgrade Type table
+      upgrade_queries {
+        query: " CREATE TABLE IF NOT EXISTS `TypeTemp` ( "
+               "   `id` INTEGER PRIMARY KEY AUTOINCREMENT, "
+               "   `name` VARCHAR(255) NOT NULL, "
+               "   `type_kind` TINYINT(1) NOT NULL, "
+               "   `input_type` BLOB, "
+               "   `output_type` BLOB"
+               " ); "
+      }
+      upgrade_queries {
+        query: " INSERT INTO `TypeTemp` SELECT * FROM `Type`; "
+      }
+      upgrade_queries { query: " DROP TABLE `Type`; " }
+      upgrade_queries {
+        query: " ALTER TABLE `TypeTemp` RENAME TO `Type`; "
+      }
+      upgrade_data_migrations: EXECUTION_TYPE_SIGNATURES_TO_BINARY
+      # check the existing signatures are converted. The Type rows are inserted
+      # by position, as the columns are the same since v1.
+      upgrade_verification {
+        previous_version_setup_queries { query: " DELETE FROM `Type`; " }
+        previous_version_setup_queries {
+          query: " INSERT INTO `Type` VALUES "
+                 " (1, 'artifact_type', 1, NULL, NULL); "
+        }
+        previous_version_setup_queries {
+          query: " INSERT INTO `Type` VALUES "
+                 " (2, 'execution_type', 0, '{\"none\": {}}', ''); "
+        }
+        previous_version_setup_queries {
+          query: " INSERT INTO `Type` VALUES "
+                 " (3, 'execution_type_without_signature', 0, NULL, NULL); "
+        }
+        post_migration_verification_queries {
+          query: " SELECT count(*) = 3 FROM `Type`; "
+        }
+        post_migration_verification_queries {
+          query: " SELECT count(*) = 1 FROM `Type` "
+                 " WHERE `id` = 2 AND `input_type` = X'2A00' AND "
+                 "       `output_type` IS NULL; "
+        }
+        post_migration_verification_queries {
+          query: " SELECT count(*) = 1 FROM `Type` "
+                 " WHERE `id` = 3 AND `input_type` IS NULL AND "
+                 "       `output_type` IS NULL; "
+        }
+      }
+      # downgrade queries from version 7
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS `idx_artifact_uri`; "
+      }
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS `idx_artifact_create_time_since_epoch`; "
+      }
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS "
+               "   `idx_artifact_last_update_time_since_epoch`; "
+      }
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS `idx_execution_create_time_since_epoch`; "
+      }
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS "
+               "   `idx_execution_last_update_time_since_epoch`; "
+      }
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS `idx_context_create_time_since_epoch`; "
+      }
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS "
+               "   `idx_context_last_update_time_since_epoch`; "
+      }
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS `idx_event_artifact_id`; "
+      }
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS `idx_event_execution_id`; "
+      }
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS `idx_eventpath_event_id`; "
+      }
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS `idx_association_execution_id`; "
+      }
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS `idx_attribution_artifact_id`; "
+      }
+      # check the indices are dropped
+      downgrade_verification {
+        post_migration_verification_queries {
+          # `_` matches any character in LIKE, so it is escaped.
+          query: " SELECT count(*) = 0 FROM `sqlite_master` "
+                 " WHERE `type` = 'index' AND `name` LIKE 'idx!_%' ESCAPE '!'; "
+        }
+      }
+    }
+  }
+)pb",
+R"pb(
+  # The secondary indices of the lookups which are not served by the primary
+  # keys and the unique constraints.
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS `idx_artifact_uri` "
+           " ON `Artifact`(`uri`); "
+  }
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS `idx_artifact_create_time_since_epoch` "
+           " ON `Artifact`(`create_time_since_epoch`); "
+  }
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS "
+           "   `idx_artifact_last_update_time_since_epoch` "
+           " ON `Artifact`(`last_update_time_since_epoch`); "
+  }
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS "
+           "   `idx_execution_create_time_since_epoch` "
+           " ON `Execution`(`create_time_since_epoch`); "
+  }
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS "
+           "   `idx_execution_last_update_time_since_epoch` "
+           " ON `Execution`(`last_update_time_since_epoch`); "
+  }
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS `idx_context_create_time_since_epoch` "
+           " ON `Context`(`create_time_since_epoch`); "
+  }
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS "
+           "   `idx_context_last_update_time_since_epoch` "
+           " ON `Context`(`last_update_time_since_epoch`); "
+  }
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS `idx_event_artifact_id` "
+           " ON `Event`(`artifact_id`); "
+  }
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS `idx_event_execution_id` "
+           " ON `Event`(`execution_id`); "
+  }
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS `idx_eventpath_event_id` "
+           " ON `EventPath`(`event_id`); "
+  }
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS `idx_association_execution_id` "
+           " ON `Association`(`execution_id`); "
+  }
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS `idx_attribution_artifact_id` "
+           " ON `Attribution`(`artifact_id`); "
+  }
+  # In v7, the secondary indices are added.
+  migration_schemes {
+    key: 7
+    value: {
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS `idx_artifact_uri` "
+               " ON `Artifact`(`uri`); "
+      }
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS "
+               "   `idx_artifact_create_time_since_epoch` "
+               " ON `Artifact`(`create_time_since_epoch`); "
+      }
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS "
+               "   `idx_artifact_last_update_time_since_epoch` "
+               " ON `Artifact`(`last_update_time_since_epoch`); "
+      }
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS "
+               "   `idx_execution_create_time_since_epoch` "
+               " ON `Execution`(`create_time_since_epoch`); "
+      }
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS "
+               "   `idx_execution_last_update_time_since_epoch` "
+               " ON `Execution`(`last_update_time_since_epoch`); "
+      }
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS "
+               "   `idx_context_create_time_since_epoch` "
+               " ON `Context`(`create_time_since_epoch`); "
+      }
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS "
+               "   `idx_context_last_update_time_since_epoch` "
+               " ON `Context`(`last_update_time_since_epoch`); "
+      }
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS `idx_event_artifact_id` "
+               " ON `Event`(`artifact_id`); "
+      }
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS `idx_event_execution_id` "
+               " ON `Event`(`execution_id`); "
+      }
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS `idx_eventpath_event_id` "
+               " ON `EventPath`(`event_id`); "
+      }
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS `idx_association_execution_id` "
+               " ON `Association`(`execution_id`); "
+      }
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS `idx_attribution_artifact_id` "
+               " ON `Attribution`(`artifact_id`); "
+      }
+      upgrade_verification {
+        post_migration_verification_queries {
+          query: " SELECT count(*) = 12 FROM `sqlite_master` "
+                 " WHERE `type` = 'index' AND `name` LIKE 'idx!_%' ESCAPE '!'; "
+        }
+      }
+      # downgrade queries from version 8
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS `idx_artifact_property_int`; "
+      }
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS `idx_artifact_property_double`; "
+      }
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS `idx_artifact_property_string`; "
+      }
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS `idx_execution_property_int`; "
+      }
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS `idx_execution_property_double`; "
+      }
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS `idx_execution_property_string`; "
+      }
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS `idx_context_property_int`; "
+      }
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS `idx_context_property_double`; "
+      }
+      downgrade_queries {
+        query: " DROP INDEX IF EXISTS `idx_context_property_string`; "
+      }
+      # check the property value indices are dropped
+      downgrade_verification {
+        post_migration_verification_queries {
+          query: " SELECT count(*) = 12 FROM `sqlite_master` "
+                 " WHERE `type` = 'index' AND `name` LIKE 'idx!_%' ESCAPE '!'; "
+        }
+      }
+    }
+  }
+)pb",
+R"pb(
+  # The indices of the property values, which look up the nodes by the value
+  # of a property.
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS `idx_artifact_property_int` "
+           " ON `ArtifactProperty` "
+           "   (`name`, `is_custom_property`, `int_value`); "
+  }
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS `idx_artifact_property_double` "
+           " ON `ArtifactProperty` "
+           "   (`name`, `is_custom_property`, `double_value`); "
+  }
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS `idx_artifact_property_string` "
+           " ON `ArtifactProperty` "
+           "   (`name`, `is_custom_property`, `string_value`); "
+  }
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS `idx_execution_property_int` "
+           " ON `ExecutionProperty` "
+           "   (`name`, `is_custom_property`, `int_value`); "
+  }
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS `idx_execution_property_double` "
+           " ON `ExecutionProperty` "
+           "   (`name`, `is_custom_property`, `double_value`); "
+  }
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS `idx_execution_property_string` "
+           " ON `ExecutionProperty` "
+           "   (`name`, `is_custom_property`, `string_value`); "
+  }
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS `idx_context_property_int` "
+           " ON `ContextProperty` "
+           "   (`name`, `is_custom_property`, `int_value`); "
+  }
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS `idx_context_property_double` "
+           " ON `ContextProperty` "
+           "   (`name`, `is_custom_property`, `double_value`); "
+  }
+  secondary_indices {
+    query: " CREATE INDEX IF NOT EXISTS `idx_context_property_string` "
+           " ON `ContextProperty` "
+           "   (`name`, `is_custom_property`, `string_value`); "
+  }
+  # In v8, the indices of the property values are added.
+  migration_schemes {
+    key: 8
+    value: {
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS `idx_artifact_property_int` "
+               " ON `ArtifactProperty` "
+               "   (`name`, `is_custom_property`, `int_value`); "
+      }
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS `idx_artifact_property_double` "
+               " ON `ArtifactProperty` "
+               "   (`name`, `is_custom_property`, `double_value`); "
+      }
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS `idx_artifact_property_string` "
+               " ON `ArtifactProperty` "
+               "   (`name`, `is_custom_property`, `string_value`); "
+      }
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS `idx_execution_property_int` "
+               " ON `ExecutionProperty` "
+               "   (`name`, `is_custom_property`, `int_value`); "
+      }
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS `idx_execution_property_double` "
+               " ON `ExecutionProperty` "
+               "   (`name`, `is_custom_property`, `double_value`); "
+      }
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS `idx_execution_property_string` "
+               " ON `ExecutionProperty` "
+               "   (`name`, `is_custom_property`, `string_value`); "
+      }
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS `idx_context_property_int` "
+               " ON `ContextProperty` "
+               "   (`name`, `is_custom_property`, `int_value`); "
+      }
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS `idx_context_property_double` "
+               " ON `ContextProperty` "
+               "   (`name`, `is_custom_property`, `double_value`); "
+      }
+      upgrade_queries {
+        query: " CREATE INDEX IF NOT EXISTS `idx_context_property_string` "
+               " ON `ContextProperty` "
+               "   (`name`, `is_custom_property`, `string_value`); "
+      }
+      upgrade_verification {
+        post_migration_verification_queries {
+          query: " SELECT count(*) = 21 FROM `sqlite_master` "
+                 " WHERE `type` = 'index' AND `name` LIKE 'idx!_%' ESCAPE '!'; "
+        }
+      }
     }
   }
 )pb");
@@ -1078,14 +1622,13 @@ R"pb(
 const std::string kMySQLMetadataSourceQueryConfig = absl::StrCat( // NOLINT
 R"pb(
   metadata_source_type: MYSQL_METADATA_SOURCE
-  select_last_insert_id { query: " SELECT last_insert_id(); " }
   create_type_table {
     query: " CREATE TABLE IF NOT EXISTS `Type` ( "
            "   `id` INT PRIMARY KEY AUTO_INCREMENT, "
            "   `name` VARCHAR(255) NOT NULL, "
            "   `type_kind` TINYINT(1) NOT NULL, "
-           "   `input_type` TEXT, "
-           "   `output_type` TEXT"
+           "   `input_type` BLOB, "
+           "   `output_type` BLOB"
            " ); "
   }
   create_artifact_table {
@@ -1097,7 +1640,12 @@ R"pb(
            "   `name` VARCHAR(255), "
            "   `create_time_since_epoch` BIGINT NOT NULL DEFAULT 0, "
            "   `last_update_time_since_epoch` BIGINT NOT NULL DEFAULT 0, "
-           "   CONSTRAINT UniqueArtifactTypeName UNIQUE(`type_id`, `name`) "
+           "   CONSTRAINT UniqueArtifactTypeName UNIQUE(`type_id`, `name`), "
+           "   INDEX `idx_artifact_uri`(`uri`(255)), "
+           "   INDEX `idx_artifact_create_time_since_epoch` "
+           "     (`create_time_since_epoch`), "
+           "   INDEX `idx_artifact_last_update_time_since_epoch` "
+           "     (`last_update_time_since_epoch`) "
            " ); "
   }
   create_execution_table {
@@ -1108,7 +1656,11 @@ R"pb(
            "   `name` VARCHAR(255), "
            "   `create_time_since_epoch` BIGINT NOT NULL DEFAULT 0, "
            "   `last_update_time_since_epoch` BIGINT NOT NULL DEFAULT 0, "
-           "   CONSTRAINT UniqueExecutionTypeName UNIQUE(`type_id`, `name`) "
+           "   CONSTRAINT UniqueExecutionTypeName UNIQUE(`type_id`, `name`), "
+           "   INDEX `idx_execution_create_time_since_epoch` "
+           "     (`create_time_since_epoch`), "
+           "   INDEX `idx_execution_last_update_time_since_epoch` "
+           "     (`last_update_time_since_epoch`) "
            " ); "
   }
   create_context_table {
@@ -1118,7 +1670,11 @@ R"pb(
            "   `name` VARCHAR(255) NOT NULL, "
            "   `create_time_since_epoch` BIGINT NOT NULL DEFAULT 0, "
            "   `last_update_time_since_epoch` BIGINT NOT NULL DEFAULT 0, "
-           "   UNIQUE(`type_id`, `name`) "
+           "   UNIQUE(`type_id`, `name`), "
+           "   INDEX `idx_context_create_time_since_epoch` "
+           "     (`create_time_since_epoch`), "
+           "   INDEX `idx_context_last_update_time_since_epoch` "
+           "     (`last_update_time_since_epoch`) "
            " ); "
   }
   create_event_table {
@@ -1127,7 +1683,18 @@ R"pb(
            "   `artifact_id` INT NOT NULL, "
            "   `execution_id` INT NOT NULL, "
            "   `type` INT NOT NULL, "
-           "   `milliseconds_since_epoch` BIGINT "
+           "   `milliseconds_since_epoch` BIGINT, "
+           "   INDEX `idx_event_artifact_id`(`artifact_id`), "
+           "   INDEX `idx_event_execution_id`(`execution_id`) "
+           " ); "
+  }
+  create_event_path_table {
+    query: " CREATE TABLE IF NOT EXISTS `EventPath` ( "
+           "   `event_id` INT NOT NULL, "
+           "   `is_index_step` TINYINT(1) NOT NULL, "
+           "   `step_index` INT, "
+           "   `step_key` TEXT, "
+           "   INDEX `idx_eventpath_event_id`(`event_id`) "
            " ); "
   }
   create_association_table {
@@ -1135,7 +1702,8 @@ R"pb(
            "   `id` INTEGER PRIMARY KEY AUTO_INCREMENT, "
            "   `context_id` INT NOT NULL, "
            "   `execution_id` INT NOT NULL, "
-           "   UNIQUE(`context_id`, `execution_id`) "
+           "   UNIQUE(`context_id`, `execution_id`), "
+           "   INDEX `idx_association_execution_id`(`execution_id`) "
            " ); "
   }
   create_attribution_table {
@@ -1143,7 +1711,59 @@ R"pb(
            "   `id` INTEGER PRIMARY KEY AUTO_INCREMENT, "
            "   `context_id` INT NOT NULL, "
            "   `artifact_id` INT NOT NULL, "
-           "   UNIQUE(`context_id`, `artifact_id`) "
+           "   UNIQUE(`context_id`, `artifact_id`), "
+           "   INDEX `idx_attribution_artifact_id`(`artifact_id`) "
+           " ); "
+  }
+  create_artifact_property_table {
+    query: " CREATE TABLE IF NOT EXISTS `ArtifactProperty` ( "
+           "   `artifact_id` INT NOT NULL, "
+           "   `name` VARCHAR(255) NOT NULL, "
+           "   `is_custom_property` TINYINT(1) NOT NULL, "
+           "   `int_value` INT, "
+           "   `double_value` DOUBLE, "
+           "   `string_value` TEXT, "
+           "   PRIMARY KEY (`artifact_id`, `name`, `is_custom_property`), "
+           "   INDEX `idx_artifact_property_int` "
+           "     (`name`, `is_custom_property`, `int_value`), "
+           "   INDEX `idx_artifact_property_double` "
+           "     (`name`, `is_custom_property`, `double_value`), "
+           "   INDEX `idx_artifact_property_string` "
+           "     (`name`, `is_custom_property`, `string_value`(255)) "
+           " ); "
+  }
+  create_execution_property_table {
+    query: " CREATE TABLE IF NOT EXISTS `ExecutionProperty` ( "
+           "   `execution_id` INT NOT NULL, "
+           "   `name` VARCHAR(255) NOT NULL, "
+           "   `is_custom_property` TINYINT(1) NOT NULL, "
+           "   `int_value` INT, "
+           "   `double_value` DOUBLE, "
+           "   `string_value` TEXT, "
+           "   PRIMARY KEY (`execution_id`, `name`, `is_custom_property`), "
+           "   INDEX `idx_execution_property_int` "
+           "     (`name`, `is_custom_property`, `int_value`), "
+           "   INDEX `idx_execution_property_double` "
+           "     (`name`, `is_custom_property`, `double_value`), "
+           "   INDEX `idx_execution_property_string` "
+           "     (`name`, `is_custom_property`, `string_value`(255)) "
+           " ); "
+  }
+  create_context_property_table {
+    query: " CREATE TABLE IF NOT EXISTS `ContextProperty` ( "
+           "   `context_id` INT NOT NULL, "
+           "   `name` VARCHAR(255) NOT NULL, "
+           "   `is_custom_property` TINYINT(1) NOT NULL, "
+           "   `int_value` INT, "
+           "   `double_value` DOUBLE, "
+           "   `string_value` TEXT, "
+           "   PRIMARY KEY (`context_id`, `name`, `is_custom_property`), "
+           "   INDEX `idx_context_property_int` "
+           "     (`name`, `is_custom_property`, `int_value`), "
+           "   INDEX `idx_context_property_double` "
+           "     (`name`, `is_custom_property`, `double_value`), "
+           "   INDEX `idx_context_property_string` "
+           "     (`name`, `is_custom_property`, `string_value`(255)) "
            " ); "
   }
   # downgrade to 0.13.2 (i.e., v0), and drops the MLMDEnv table.
@@ -1609,36 +2229,289 @@ R"pb(
                  " ) as T1; "
         }
       }
+      # downgrade queries from version 6
+      downgrade_data_migrations: EXECUTION_TYPE_SIGNATURES_TO_TEXT
+      downgrade_queries {
+        query: " ALTER TABLE `Type` "
+               " MODIFY COLUMN `input_type` TEXT, "
+               " MODIFY COLUMN `output_type` TEXT; "
+      }
+      # verify the signatures are stored as JSON again
+      downgrade_verification {
+        previous_version_setup_queries {
+          query: " INSERT INTO `Type` "
+                 " (`name`, `type_kind`, `input_type`, `output_type`) "
+                 " VALUES ('execution_type_with_signature', 0, X'2A00', NULL); "
+        }
+        post_migration_verification_queries {
+          query: " SELECT count(*) = 1 FROM `Type` "
+                 " WHERE `name` = 'execution_type_with_signature' AND "
+                 "       `input_type` = '{\"none\":{}}' AND "
+                 "       `output_type` IS NULL; "
+        }
+      }
+    }
+  }
+)pb",
+R"pb(
+  # In v6, the input_type and output_type of the execution types are stored as
+  # serialized protos instead of JSON, which are faster to parse.
+  migration_schemes {
+    key: 6
+    value: {
+      # upgrade Type table
+      upgrade_queries {
+        query: " ALTER TABLE `Type` "
+               " MODIFY COLUMN `input_type` BLOB, "
+               " MODIFY COLUMN `output_type` BLOB; "
+      }
+      upgrade_data_migrations: EXECUTION_TYPE_SIGNATURES_TO_BINARY
+      # check the existing signatures are converted. The Type rows are inserted
+      # by position, as the columns are the same since v1.
+      upgrade_verification {
+        previous_version_setup_queries { query: " DELETE FROM `Type`; " }
+        previous_version_setup_queries {
+          query: " INSERT INTO `Type` VALUES "
+                 " (1, 'artifact_type', 1, NULL, NULL); "
+        }
+        previous_version_setup_queries {
+          query: " INSERT INTO `Type` VALUES "
+                 " (2, 'execution_type', 0, '{\"none\": {}}', ''); "
+        }
+        previous_version_setup_queries {
+          query: " INSERT INTO `Type` VALUES "
+                 " (3, 'execution_type_without_signature', 0, NULL, NULL); "
+        }
+        post_migration_verification_queries {
+          query: " SELECT count(*) = 3 FROM `Type`; "
+        }
+        post_migration_verification_queries {
+          query: " SELECT count(*) = 1 FROM `Type` "
+                 " WHERE `id` = 2 AND `input_type` = X'2A00' AND "
+                 "       `output_type` IS NULL; "
+        }
+        post_migration_verification_queries {
+          query: " SELECT count(*) = 1 FROM `Type` "
+                 " WHERE `id` = 3 AND `input_type` IS NULL AND "
+                 "       `output_type` IS NULL; "
+        }
+      }
+      # downgrade queries from version 7
+      downgrade_queries {
+        query: " ALTER TABLE `Artifact` "
+               "   DROP INDEX `idx_artifact_uri`, "
+               "   DROP INDEX `idx_artifact_create_time_since_epoch`, "
+               "   DROP INDEX `idx_artifact_last_update_time_since_epoch`; "
+      }
+      downgrade_queries {
+        query: " ALTER TABLE `Execution` "
+               "   DROP INDEX `idx_execution_create_time_since_epoch`, "
+               "   DROP INDEX `idx_execution_last_update_time_since_epoch`; "
+      }
+      downgrade_queries {
+        query: " ALTER TABLE `Context` "
+               "   DROP INDEX `idx_context_create_time_since_epoch`, "
+               "   DROP INDEX `idx_context_last_update_time_since_epoch`; "
+      }
+      downgrade_queries {
+        query: " ALTER TABLE `Event` "
+               "   DROP INDEX `idx_event_artifact_id`, "
+               "   DROP INDEX `idx_event_execution_id`; "
+      }
+      downgrade_queries {
+        query: " ALTER TABLE `EventPath` "
+               "   DROP INDEX `idx_eventpath_event_id`; "
+      }
+      downgrade_queries {
+        query: " ALTER TABLE `Association` "
+               "   DROP INDEX `idx_association_execution_id`; "
+      }
+      downgrade_queries {
+        query: " ALTER TABLE `Attribution` "
+               "   DROP INDEX `idx_attribution_artifact_id`; "
+      }
+      # check the indices are dropped
+      downgrade_verification {
+        post_migration_verification_queries {
+          # `_` matches any character in LIKE, so it is escaped.
+          query: " SELECT count(*) = 0 FROM `information_schema`.`statistics` "
+                 " WHERE `table_schema` = (SELECT DATABASE()) AND "
+                 "       `index_name` LIKE 'idx!_%' ESCAPE '!'; "
+        }
+      }
+    }
+  }
+)pb",
+R"pb(
+  # In v7, the secondary indices are added. InnoDB builds them in place,
+  # without blocking the concurrent reads and writes of the tables.
+  migration_schemes {
+    key: 7
+    value: {
+      upgrade_queries {
+        query: " ALTER TABLE `Artifact` "
+               "   ADD INDEX `idx_artifact_uri`(`uri`(255)), "
+               "   ADD INDEX `idx_artifact_create_time_since_epoch` "
+               "     (`create_time_since_epoch`), "
+               "   ADD INDEX `idx_artifact_last_update_time_since_epoch` "
+               "     (`last_update_time_since_epoch`), "
+               "   ALGORITHM = INPLACE, LOCK = NONE; "
+      }
+      upgrade_queries {
+        query: " ALTER TABLE `Execution` "
+               "   ADD INDEX `idx_execution_create_time_since_epoch` "
+               "     (`create_time_since_epoch`), "
+               "   ADD INDEX `idx_execution_last_update_time_since_epoch` "
+               "     (`last_update_time_since_epoch`), "
+               "   ALGORITHM = INPLACE, LOCK = NONE; "
+      }
+      upgrade_queries {
+        query: " ALTER TABLE `Context` "
+               "   ADD INDEX `idx_context_create_time_since_epoch` "
+               "     (`create_time_since_epoch`), "
+               "   ADD INDEX `idx_context_last_update_time_since_epoch` "
+               "     (`last_update_time_since_epoch`), "
+               "   ALGORITHM = INPLACE, LOCK = NONE; "
+      }
+      upgrade_queries {
+        query: " ALTER TABLE `Event` "
+               "   ADD INDEX `idx_event_artifact_id`(`artifact_id`), "
+               "   ADD INDEX `idx_event_execution_id`(`execution_id`), "
+               "   ALGORITHM = INPLACE, LOCK = NONE; "
+      }
+      upgrade_queries {
+        query: " ALTER TABLE `EventPath` "
+               "   ADD INDEX `idx_eventpath_event_id`(`event_id`), "
+               "   ALGORITHM = INPLACE, LOCK = NONE; "
+      }
+      upgrade_queries {
+        query: " ALTER TABLE `Association` "
+               "   ADD INDEX `idx_association_execution_id`(`execution_id`), "
+               "   ALGORITHM = INPLACE, LOCK = NONE; "
+      }
+      upgrade_queries {
+        query: " ALTER TABLE `Attribution` "
+               "   ADD INDEX `idx_attribution_artifact_id`(`artifact_id`), "
+               "   ALGORITHM = INPLACE, LOCK = NONE; "
+      }
+      upgrade_verification {
+        post_migration_verification_queries {
+          query: " SELECT count(DISTINCT `index_name`) = 12 "
+                 " FROM `information_schema`.`statistics` "
+                 " WHERE `table_schema` = (SELECT DATABASE()) AND "
+                 "       `index_name` LIKE 'idx!_%' ESCAPE '!'; "
+        }
+      }
+      # downgrade queries from version 8
+      downgrade_queries {
+        query: " ALTER TABLE `ArtifactProperty` "
+               "   DROP INDEX `idx_artifact_property_int`, "
+               "   DROP INDEX `idx_artifact_property_double`, "
+               "   DROP INDEX `idx_artifact_property_string`; "
+      }
+      downgrade_queries {
+        query: " ALTER TABLE `ExecutionProperty` "
+               "   DROP INDEX `idx_execution_property_int`, "
+               "   DROP INDEX `idx_execution_property_double`, "
+               "   DROP INDEX `idx_execution_property_string`; "
+      }
+      downgrade_queries {
+        query: " ALTER TABLE `ContextProperty` "
+               "   DROP INDEX `idx_context_property_int`, "
+               "   DROP INDEX `idx_context_property_double`, "
+               "   DROP INDEX `idx_context_property_string`; "
+      }
+      # check the property value indices are dropped
+      downgrade_verification {
+        post_migration_verification_queries {
+          query: " SELECT count(DISTINCT `index_name`) = 12 "
+                 " FROM `information_schema`.`statistics` "
+                 " WHERE `table_schema` = (SELECT DATABASE()) AND "
+                 "       `index_name` LIKE 'idx!_%' ESCAPE '!'; "
+        }
+      }
+    }
+  }
+)pb",
+R"pb(
+  # In v8, the indices of the property values are added in place.
+  migration_schemes {
+    key: 8
+    value: {
+      upgrade_queries {
+        query: " ALTER TABLE `ArtifactProperty` "
+               "   ADD INDEX `idx_artifact_property_int` "
+               "     (`name`, `is_custom_property`, `int_value`), "
+               "   ADD INDEX `idx_artifact_property_double` "
+               "     (`name`, `is_custom_property`, `double_value`), "
+               "   ADD INDEX `idx_artifact_property_string` "
+               "     (`name`, `is_custom_property`, `string_value`(255)), "
+               "   ALGORITHM = INPLACE, LOCK = NONE; "
+      }
+      upgrade_queries {
+        query: " ALTER TABLE `ExecutionProperty` "
+               "   ADD INDEX `idx_execution_property_int` "
+               "     (`name`, `is_custom_property`, `int_value`), "
+               "   ADD INDEX `idx_execution_property_double` "
+               "     (`name`, `is_custom_property`, `double_value`), "
+               "   ADD INDEX `idx_execution_property_string` "
+               "     (`name`, `is_custom_property`, `string_value`(255)), "
+               "   ALGORITHM = INPLACE, LOCK = NONE; "
+      }
+      upgrade_queries {
+        query: " ALTER TABLE `ContextProperty` "
+               "   ADD INDEX `idx_context_property_int` "
+               "     (`name`, `is_custom_property`, `int_value`), "
+               "   ADD INDEX `idx_context_property_double` "
+               "     (`name`, `is_custom_property`, `double_value`), "
+               "   ADD INDEX `idx_context_property_string` "
+               "     (`name`, `is_custom_property`, `string_value`(255)), "
+               "   ALGORITHM = INPLACE, LOCK = NONE; "
+      }
+      upgrade_verification {
+        post_migration_verification_queries {
+          query: " SELECT count(DISTINCT `index_name`) = 21 "
+                 " FROM `information_schema`.`statistics` "
+                 " WHERE `table_schema` = (SELECT DATABASE()) AND "
+                 "       `index_name` LIKE 'idx!_%' ESCAPE '!'; "
+        }
+      }
     }
   }
 )pb");
 
-}  // namespace
-
+// Parses the base query config and merges the given backend specific query
+// config into it. The result is never deleted, as it is shared by all the
+// callers in the process.
 // The `MetadataSourceQueryConfig` protobuf messages are merged to the query
 // config with `MergeFrom`.
 // Note: Singular fields overwrite the `kBaseQueryConfig` message. Repeated
 // fields by default are concatenated to it and should be used with caution.
-MetadataSourceQueryConfig GetMySqlMetadataSourceQueryConfig() {
-  MetadataSourceQueryConfig config;
+const MetadataSourceQueryConfig* ParseQueryConfig(
+    const std::string& backend_query_config) {
+  auto* config = new MetadataSourceQueryConfig();
   CHECK(tensorflow::protobuf::TextFormat::ParseFromString(kBaseQueryConfig,
-                                                          &config));
-  MetadataSourceQueryConfig mysql_config;
-  CHECK(tensorflow::protobuf::TextFormat::ParseFromString(
-      kMySQLMetadataSourceQueryConfig, &mysql_config));
-  config.MergeFrom(mysql_config);
+                                                          config));
+  MetadataSourceQueryConfig backend_config;
+  CHECK(tensorflow::protobuf::TextFormat::ParseFromString(backend_query_config,
+                                                          &backend_config));
+  config->MergeFrom(backend_config);
   return config;
 }
 
-MetadataSourceQueryConfig GetSqliteMetadataSourceQueryConfig() {
-  MetadataSourceQueryConfig config;
-  CHECK(tensorflow::protobuf::TextFormat::ParseFromString(kBaseQueryConfig,
-                                                          &config));
-  MetadataSourceQueryConfig sqlite_config;
-  CHECK(tensorflow::protobuf::TextFormat::ParseFromString(
-      kSQLiteMetadataSourceQueryConfig, &sqlite_config));
-  config.MergeFrom(sqlite_config);
-  return config;
+}  // namespace
+
+// Function-local statics are initialized once, in a thread-safe way.
+const MetadataSourceQueryConfig& GetMySqlMetadataSourceQueryConfig() {
+  static const MetadataSourceQueryConfig* const config =
+      ParseQueryConfig(kMySQLMetadataSourceQueryConfig);
+  return *config;
+}
+
+const MetadataSourceQueryConfig& GetSqliteMetadataSourceQueryConfig() {
+  static const MetadataSourceQueryConfig* const config =
+      ParseQueryConfig(kSQLiteMetadataSourceQueryConfig);
+  return *config;
 }
 
 
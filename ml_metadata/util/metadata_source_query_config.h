@@ -20,11 +20,15 @@ limitations under the License.
 namespace ml_metadata {
 namespace util {
 
+// The query configs below are parsed on the first call only, and the returned
+// objects are immutable and shared by all the callers in the process. The
+// methods are thread-safe.
+
 // Gets the MetadataSourceQueryConfig for MySQLMetadataSource.
-MetadataSourceQueryConfig GetMySqlMetadataSourceQueryConfig();
+const MetadataSourceQueryConfig& GetMySqlMetadataSourceQueryConfig();
 
 // Gets the MetadataSourceQueryConfig for SQLiteMetadataSource.
-MetadataSourceQueryConfig GetSqliteMetadataSourceQueryConfig();
+const MetadataSourceQueryConfig& GetSqliteMetadataSourceQueryConfig();
 
 // Gets the MetadataSourceQueryConfig for FakeMetadataSource.
 MetadataSourceQueryConfig GetFakeMetadataSourceQueryConfig();
@@ -30,6 +30,13 @@ TEST(MetadataSourceQueryConfig, GetSqliteMetadataSourceQueryConfig) {
   EXPECT_EQ(config.metadata_source_type(), SQLITE_METADATA_SOURCE);
 }
 
+TEST(MetadataSourceQueryConfig, QueryConfigIsParsedOnce) {
+  EXPECT_EQ(&GetMySqlMetadataSourceQueryConfig(),
+            &GetMySqlMetadataSourceQueryConfig());
+  EXPECT_EQ(&GetSqliteMetadataSourceQueryConfig(),
+            &GetSqliteMetadataSourceQueryConfig());
+}
+
 
 }  // namespace
 }  // namespace util